@@ -0,0 +1,152 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Reuses the stubs the miral tests drive BasicWindowManager with
+#include "test_window_manager_tools.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+using namespace miral;
+
+namespace
+{
+struct BenchmarkPolicy : CanonicalWindowManagerPolicy
+{
+    using CanonicalWindowManagerPolicy::CanonicalWindowManagerPolicy;
+
+    bool handle_keyboard_event(MirKeyboardEvent const*) override { return false; }
+    bool handle_touch_event(MirTouchEvent const*) override { return false; }
+    bool handle_pointer_event(MirPointerEvent const*) override { return false; }
+
+    void handle_request_drag_and_drop(WindowInfo&) override {}
+    void handle_request_move(WindowInfo&, MirInputEvent const*) override {}
+    void handle_request_resize(WindowInfo&, MirInputEvent const*, MirResizeEdge) override {}
+
+    auto confirm_placement_on_display(WindowInfo const&, MirWindowState, Rectangle const& new_placement)
+    -> Rectangle override
+    {
+        return new_placement;
+    }
+};
+
+void measure(char const* name, size_t operations, std::function<void()> const& run)
+{
+    auto const start = std::chrono::steady_clock::now();
+    run();
+    std::chrono::duration<double, std::nano> const duration = std::chrono::steady_clock::now() - start;
+
+    std::cout << name << ": " << duration.count() / operations << " ns" << std::endl;
+}
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+    {
+        std::cout<<"Usage: "<<argv[0]<<" <number of windows> <iterations>"<<std::endl;
+        exit(1);
+    }
+
+    size_t const window_count = std::atoi(argv[1]);
+    size_t const iterations = std::atoi(argv[2]);
+
+    StubFocusController focus_controller;
+    StubDisplayLayout display_layout;
+    StubPersistentSurfaceStore persistent_surface_store;
+    StubDisplayConfigurationObserver display_configuration_observer;
+    auto const session = std::make_shared<StubStubSession>();
+
+    WindowManagerTools tools{nullptr};
+
+    BasicWindowManager basic_window_manager{
+        &focus_controller,
+        mir::test::fake_shared(display_layout),
+        mir::test::fake_shared(persistent_surface_store),
+        display_configuration_observer,
+        [&](WindowManagerTools const& wm_tools) -> std::unique_ptr<WindowManagementPolicy>
+            {
+                tools = wm_tools;
+                return std::make_unique<BenchmarkPolicy>(wm_tools);
+            }
+    };
+
+    basic_window_manager.add_display_for_testing({{0, 0}, {1920, 1080}});
+    basic_window_manager.add_session(session);
+
+    std::vector<Window> windows;
+    windows.reserve(window_count);
+
+    measure("add window", window_count, [&]
+        {
+            mir::scene::SurfaceCreationParameters creation_parameters;
+            creation_parameters.type = mir_window_type_normal;
+            creation_parameters.size = Size{640, 480};
+
+            for (size_t i = 0; i != window_count; ++i)
+                basic_window_manager.add_surface(session, creation_parameters, &TestWindowManagerTools::create_surface);
+
+            for (auto const& window : tools.info_for(session).windows())
+                windows.push_back(window);
+        });
+
+    measure("info_for(window)", window_count * iterations, [&]
+        {
+            basic_window_manager.invoke_under_lock([&]
+                {
+                    size_t children = 0;
+                    for (size_t i = 0; i != iterations; ++i)
+                        for (auto const& window : windows)
+                            children += tools.info_for(window).children().size();
+
+                    if (children) std::cout << children; // Keep the optimizer honest
+                });
+        });
+
+    measure("info_for(surface)", window_count * iterations, [&]
+        {
+            basic_window_manager.invoke_under_lock([&]
+                {
+                    size_t children = 0;
+                    for (size_t i = 0; i != iterations; ++i)
+                        for (auto const& window : windows)
+                            children += tools.info_for(std::weak_ptr<mir::scene::Surface>(window)).children().size();
+
+                    if (children) std::cout << children;
+                });
+        });
+
+    measure("select_active_window", window_count * iterations, [&]
+        {
+            basic_window_manager.invoke_under_lock([&]
+                {
+                    for (size_t i = 0; i != iterations; ++i)
+                        for (auto const& window : windows)
+                            tools.select_active_window(window);
+                });
+        });
+
+    measure("remove window", window_count, [&]
+        {
+            for (auto const& window : windows)
+                basic_window_manager.remove_surface(session, window);
+        });
+
+    exit(0);
+}
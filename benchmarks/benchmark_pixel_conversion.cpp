@@ -0,0 +1,75 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/graphics/pixel_conversion.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+namespace mg = mir::graphics;
+
+namespace
+{
+void measure(char const* name, int iterations, size_t pixel_count, std::function<void()> const& convert)
+{
+    convert(); // Warm up caches and pick the kernels
+
+    auto const start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+        convert();
+    std::chrono::duration<double> const duration = std::chrono::steady_clock::now() - start;
+
+    auto const megapixels = pixel_count * double(iterations) / 1e6;
+    std::cout << name << ": " << megapixels / duration.count() << " Mpixel/s" << std::endl;
+}
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 4)
+    {
+        std::cout<<"Usage: "<<argv[0]<<" <width> <height> <iterations>"<<std::endl;
+        exit(1);
+    }
+
+    size_t const width = std::atoi(argv[1]);
+    size_t const height = std::atoi(argv[2]);
+    int const iterations = std::atoi(argv[3]);
+    size_t const pixel_count = width * height;
+
+    std::vector<unsigned char> src(pixel_count * 4, 0x7f);
+    std::vector<unsigned char> dst(pixel_count * 4);
+
+    measure("swap_red_blue_8888", iterations, pixel_count,
+        [&] { mg::swap_red_blue_8888(src.data(), dst.data(), pixel_count); });
+    measure("expand_888_to_8888", iterations, pixel_count,
+        [&] { mg::expand_888_to_8888(src.data(), dst.data(), pixel_count, true); });
+    measure("pack_8888_to_888", iterations, pixel_count,
+        [&] { mg::pack_8888_to_888(src.data(), dst.data(), pixel_count, true); });
+    measure("expand_565_to_8888", iterations, pixel_count,
+        [&] { mg::expand_565_to_8888(src.data(), dst.data(), pixel_count); });
+    measure("premultiply_alpha_8888", iterations, pixel_count,
+        [&] { mg::premultiply_alpha_8888(src.data(), dst.data(), pixel_count); });
+    measure("copy_flipped", iterations, pixel_count,
+        [&] { mg::copy_flipped(src.data(), width * 4, dst.data(), width * 4, width * 4, height); });
+    measure("flip_in_place_8888 (swapping red and blue)", iterations, pixel_count,
+        [&] { mg::flip_in_place_8888(dst.data(), width * 4, width, height, true); });
+
+    exit(0);
+}
@@ -18,6 +18,7 @@
 
 #include "frame_uniformity_test.h"
 #include "mir_test_framework/executable_path.h"
+#include "mir_test_framework/temporary_environment_value.h"
 #include "mir/geometry/displacement.h"
 
 #include <assert.h>
@@ -117,35 +118,44 @@ TEST(FrameUniformity, average_frame_offset)
     std::chrono::milliseconds touch_duration{1000};
     
     int const run_count = 1;
-    double average_lag = 0, average_uniformity = 0;
 
     // Ensure we load the correct platform libraries
     setenv("MIR_CLIENT_PLATFORM_PATH",
            (mtf::library_path() + "/client-modules").c_str(),
            true);
-    
-    for (int i = 0; i < run_count; i++)
+
+    // Measure with and without server side touch resampling so the two can be compared
+    for (bool const touch_resampling : {false, true})
     {
-        FrameUniformityTest t({screen_size, touch_start_point, touch_end_point, touch_duration});
-
-        t.run_test();
-  
-        auto touch_timings = t.server_timings();
-        auto touch_start_time = touch_timings.touch_start;
-        auto touch_end_time = touch_timings.touch_end;
-        auto samples = t.client_results()->get();
-
-        auto results = compute_frame_uniformity(samples, touch_start_point, touch_end_point,
-            touch_start_time, touch_end_time);
-        
-        average_lag += results.average_pixel_offset;
-        average_uniformity += results.frame_uniformity;
+        mtf::TemporaryEnvironmentValue const resampling_option{
+            "MIR_SERVER_TOUCH_RESAMPLING", touch_resampling ? "true" : "false"};
+
+        double average_lag = 0, average_uniformity = 0;
+
+        for (int i = 0; i < run_count; i++)
+        {
+            FrameUniformityTest t({screen_size, touch_start_point, touch_end_point, touch_duration});
+
+            t.run_test();
+
+            auto touch_timings = t.server_timings();
+            auto touch_start_time = touch_timings.touch_start;
+            auto touch_end_time = touch_timings.touch_end;
+            auto samples = t.client_results()->get();
+
+            auto results = compute_frame_uniformity(samples, touch_start_point, touch_end_point,
+                touch_start_time, touch_end_time);
+
+            average_lag += results.average_pixel_offset;
+            average_uniformity += results.frame_uniformity;
+        }
+
+        average_lag /= run_count;
+        average_uniformity /= run_count;
+
+        std::cout << "Touch resampling " << (touch_resampling ? "on" : "off") << ":" << std::endl;
+        std::cout << "Average pixel lag: " << average_lag << "px" << std::endl;
+        std::cout << "Frame Uniformity (smaller scores are more uniform): " << average_uniformity << "px per sample\n"
+            << std::endl;
     }
-    
-    average_lag /= run_count;
-    average_uniformity /= run_count;
-    
-    std::cout << "Average pixel lag: " << average_lag << "px" << std::endl;
-    std::cout << "Frame Uniformity (smaller scores are more uniform): " << average_uniformity << "px per sample\n"
-        << std::endl;
 }
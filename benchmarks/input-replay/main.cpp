@@ -0,0 +1,187 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "replaying_server.h"
+
+#include "mir/input/input_recording.h"
+#include "mir_test_framework/server_runner.h"
+#include "mir_test_framework/temporary_environment_value.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+namespace mi = mir::input;
+namespace mtf = mir_test_framework;
+
+using namespace std::chrono_literals;
+
+namespace
+{
+struct InputReplay : mtf::ServerRunner
+{
+    mir::DefaultServerConfiguration& server_config() override
+    {
+        return server_configuration;
+    }
+
+    ReplayingServer server_configuration;
+};
+
+/// A few seconds of typing, pointer motion and two finger touch at 1kHz
+void write_synthetic_recording(std::string const& path)
+{
+    mi::InputRecordWriter writer{path};
+
+    MirInputDeviceId const keyboard{1}, mouse{2}, touchscreen{3};
+    writer.device_added(keyboard, mi::DeviceCapability::keyboard | mi::DeviceCapability::alpha_numeric,
+                        "replay keyboard", "replay-keyboard-uid");
+    writer.device_added(mouse, mi::DeviceCapability::pointer, "replay mouse", "replay-mouse-uid");
+    writer.device_added(touchscreen, mi::DeviceCapability::touchscreen | mi::DeviceCapability::multitouch,
+                        "replay touchscreen", "replay-touchscreen-uid");
+
+    int const events_per_device = 1000;
+    mi::InputRecordHandler::Timestamp time{0};
+
+    for (int i = 0; i != events_per_device; ++i)
+    {
+        int const scan_code = 16 + (i / 2) % 10; // KEY_Q through KEY_P
+        writer.key_event(keyboard, time, i % 2 ? mir_keyboard_action_up : mir_keyboard_action_down, scan_code);
+        time += 1ms;
+
+        writer.pointer_event(mouse, time, mir_pointer_action_motion, 0, 0, 0, std::sin(i * 0.01f), 1);
+        time += 1ms;
+
+        auto const action = i == 0 ? mir_touch_action_down :
+                            i == events_per_device - 1 ? mir_touch_action_up : mir_touch_action_change;
+        float const x = i % 500;
+        writer.touch_event(touchscreen, time,
+            {{0, action, mir_touch_tooltype_finger, x, 100, 1, 5, 5, 0},
+             {1, action, mir_touch_tooltype_finger, x, 300, 1, 5, 5, 0}});
+        time += 1ms;
+    }
+
+    writer.device_removed(touchscreen);
+    writer.device_removed(mouse);
+    writer.device_removed(keyboard);
+}
+
+void print_stage(char const* name, std::vector<std::chrono::nanoseconds> latencies)
+{
+    if (latencies.empty())
+    {
+        std::cout << std::setw(20) << name << ": no events" << std::endl;
+        return;
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+
+    auto const to_us = [](std::chrono::nanoseconds value) { return value.count() / 1000.0; };
+    auto const percentile = [&](double p) { return to_us(latencies[(latencies.size() - 1) * p]); };
+
+    std::chrono::nanoseconds sum{0};
+    for (auto const latency : latencies)
+        sum += latency;
+
+    std::cout << std::setw(20) << name << ": "
+              << latencies.size() << " events, "
+              << "mean " << to_us(sum / latencies.size()) << "us, "
+              << "median " << percentile(0.5) << "us, "
+              << "99th percentile " << percentile(0.99) << "us, "
+              << "max " << to_us(latencies.back()) << "us" << std::endl;
+}
+
+void print_results(ReplayingServer::Results const& results, LatencyCollectingReport const& report)
+{
+    // Nothing is connected, so the last stage all events reach is the filter chain
+    auto const last_stage = mi::InputPipelineStage::filtered;
+    std::chrono::duration<double> const elapsed = report.last_arrival(last_stage) - results.first_injection;
+
+    std::cout << "Injected " << results.injected_events << " events";
+    if (results.skipped_events)
+        std::cout << " (skipped " << results.skipped_events << " from unknown devices)";
+    std::cout << std::endl;
+
+    if (elapsed.count() > 0)
+        std::cout << "Throughput: " << report.event_count(last_stage) / elapsed.count() << " events/s" << std::endl;
+
+    print_stage("seat dispatched", report.latencies(mi::InputPipelineStage::seat_dispatched));
+    print_stage("filtered", report.latencies(mi::InputPipelineStage::filtered));
+    print_stage("surface dispatched", report.latencies(mi::InputPipelineStage::surface_dispatched));
+    std::cout << std::endl;
+}
+}
+
+// Main is inside a test to work around mir_test_framework 'issues' (e.g. mir_test_framework contains
+// a main function).
+TEST(InputReplay, throughput_and_latency)
+{
+    // Repeats are generated by the server and would muddle the figures
+    mtf::TemporaryEnvironmentValue const no_key_repeat{"MIR_SERVER_ENABLE_KEY_REPEAT", "false"};
+
+    std::string recording;
+    char temporary_recording[] = "/tmp/mir_input_replay_XXXXXX";
+
+    if (auto const path = getenv("MIR_INPUT_REPLAY_RECORDING"))
+    {
+        recording = path;
+    }
+    else
+    {
+        auto const fd = mkstemp(temporary_recording);
+        ASSERT_GE(fd, 0);
+        close(fd);
+
+        recording = temporary_recording;
+        write_synthetic_recording(recording);
+    }
+
+    std::vector<std::pair<char const*, ReplayingServer::Pacing>> pacings{
+        {"real-time", ReplayingServer::Pacing::real_time},
+        {"as-fast-as-possible", ReplayingServer::Pacing::as_fast_as_possible}};
+
+    if (auto const pacing = getenv("MIR_INPUT_REPLAY_PACING"))
+    {
+        pacings.erase(
+            std::remove_if(pacings.begin(), pacings.end(),
+                [pacing](auto const& candidate) { return candidate.first != std::string{pacing}; }),
+            pacings.end());
+    }
+
+    for (auto const& pacing : pacings)
+    {
+        InputReplay replay;
+        replay.start_server();
+        auto const results = replay.server_configuration.replay(recording, pacing.second);
+        replay.stop_server();
+
+        std::cout << "Replaying " << recording << " " << pacing.first << ":" << std::endl;
+        print_results(results, replay.server_configuration.report());
+
+        EXPECT_EQ(
+            results.injected_events,
+            replay.server_configuration.report().event_count(mi::InputPipelineStage::seat_dispatched));
+    }
+
+    if (recording == temporary_recording)
+        unlink(temporary_recording);
+}
@@ -0,0 +1,340 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "replaying_server.h"
+
+#include "mir/input/input_recording.h"
+#include "mir/input/input_device.h"
+#include "mir/input/input_device_info.h"
+#include "mir/input/input_device_registry.h"
+#include "mir/input/input_sink.h"
+#include "mir/input/event_builder.h"
+#include "mir/input/pointer_settings.h"
+#include "mir/input/touchpad_settings.h"
+#include "mir/input/touchscreen_settings.h"
+#include "mir/dispatch/action_queue.h"
+#include "mir/dispatch/multiplexing_dispatchable.h"
+
+#include <future>
+#include <map>
+#include <thread>
+
+namespace mi = mir::input;
+namespace md = mir::dispatch;
+namespace mev = mir::events;
+
+namespace
+{
+/// Stands in for a recorded device and emits its events on the input thread
+class ReplayDevice : public mi::InputDevice
+{
+public:
+    explicit ReplayDevice(mi::InputDeviceInfo const& info)
+        : info(info)
+    {
+    }
+
+    void start(mi::InputSink* destination, mi::EventBuilder* event_builder) override
+    {
+        sink = destination;
+        builder = event_builder;
+    }
+
+    void stop() override
+    {
+        sink = nullptr;
+        builder = nullptr;
+    }
+
+    mi::InputDeviceInfo get_device_info() override
+    {
+        return info;
+    }
+
+    mir::optional_value<mi::PointerSettings> get_pointer_settings() const override
+    {
+        mir::optional_value<mi::PointerSettings> ret;
+        if (contains(info.capabilities, mi::DeviceCapability::pointer))
+            ret = mi::PointerSettings();
+        return ret;
+    }
+
+    void apply_settings(mi::PointerSettings const&) override
+    {
+        // Recorded events have been interpreted already
+    }
+
+    mir::optional_value<mi::TouchpadSettings> get_touchpad_settings() const override
+    {
+        mir::optional_value<mi::TouchpadSettings> ret;
+        if (contains(info.capabilities, mi::DeviceCapability::touchpad))
+            ret = mi::TouchpadSettings();
+        return ret;
+    }
+
+    void apply_settings(mi::TouchpadSettings const&) override
+    {
+    }
+
+    mir::optional_value<mi::TouchscreenSettings> get_touchscreen_settings() const override
+    {
+        mir::optional_value<mi::TouchscreenSettings> ret;
+        if (contains(info.capabilities, mi::DeviceCapability::touchscreen))
+            ret = mi::TouchscreenSettings();
+        return ret;
+    }
+
+    void apply_settings(mi::TouchscreenSettings const&) override
+    {
+    }
+
+    template<typename BuildEvent>
+    void emit(BuildEvent const& build_event)
+    {
+        if (sink && builder)
+            sink->handle_input(build_event(*builder));
+    }
+
+private:
+    mi::InputDeviceInfo const info;
+    mi::InputSink* sink{nullptr};
+    mi::EventBuilder* builder{nullptr};
+};
+
+/**
+ * Turns the records into actions on the input thread. Events are stamped
+ * with the time they are queued for injection: that plays the part of the
+ * kernel timestamp, so the reported latencies include the wait for the input
+ * thread just as they would with a real device.
+ */
+class Injector : public mi::InputRecordHandler
+{
+public:
+    Injector(
+        std::shared_ptr<mi::InputDeviceRegistry> const& registry,
+        std::shared_ptr<md::ActionQueue> const& queue,
+        ReplayingServer::Pacing pacing)
+        : registry{registry},
+          queue{queue},
+          pacing{pacing}
+    {
+    }
+
+    void device_added(
+        MirInputDeviceId id,
+        mi::DeviceCapabilities capabilities,
+        std::string const& name,
+        std::string const& unique_id) override
+    {
+        auto const device = std::make_shared<ReplayDevice>(mi::InputDeviceInfo{name, unique_id, capabilities});
+        devices[id] = device;
+        auto const registry = this->registry;
+        queue->enqueue([registry, device] { registry->add_device(device); });
+    }
+
+    void device_removed(MirInputDeviceId id) override
+    {
+        auto const found = devices.find(id);
+        if (found == devices.end())
+            return;
+
+        auto const device = found->second;
+        devices.erase(found);
+        auto const registry = this->registry;
+        queue->enqueue([registry, device] { registry->remove_device(device); });
+    }
+
+    void key_event(MirInputDeviceId id, Timestamp timestamp, MirKeyboardAction action, int scan_code) override
+    {
+        inject(id, timestamp,
+            [action, scan_code](mi::EventBuilder& builder, Timestamp now)
+            {
+                return builder.key_event(now, action, 0, scan_code);
+            });
+    }
+
+    void pointer_event(
+        MirInputDeviceId id,
+        Timestamp timestamp,
+        MirPointerAction action,
+        MirPointerButtons buttons,
+        float hscroll,
+        float vscroll,
+        float relative_x,
+        float relative_y) override
+    {
+        inject(id, timestamp,
+            [=](mi::EventBuilder& builder, Timestamp now)
+            {
+                return builder.pointer_event(now, action, buttons, hscroll, vscroll, relative_x, relative_y);
+            });
+    }
+
+    void touch_event(MirInputDeviceId id, Timestamp timestamp, std::vector<mev::ContactState> const& contacts) override
+    {
+        inject(id, timestamp,
+            [contacts](mi::EventBuilder& builder, Timestamp now)
+            {
+                return builder.touch_event(now, contacts);
+            });
+    }
+
+    /// Unplugs the devices still attached at the end of the recording
+    void remove_remaining_devices()
+    {
+        while (!devices.empty())
+            device_removed(devices.begin()->first);
+    }
+
+    ReplayingServer::Results results() const
+    {
+        return {injected, skipped, replay_start};
+    }
+
+private:
+    template<typename BuildEvent>
+    void inject(MirInputDeviceId id, Timestamp recorded_time, BuildEvent const& build_event)
+    {
+        auto const found = devices.find(id);
+        if (found == devices.end())
+        {
+            ++skipped;
+            return;
+        }
+
+        if (injected == 0)
+        {
+            replay_start = std::chrono::steady_clock::now();
+            recording_start = recorded_time;
+        }
+        else if (pacing == ReplayingServer::Pacing::real_time)
+        {
+            std::this_thread::sleep_until(replay_start + (recorded_time - recording_start));
+        }
+
+        ++injected;
+
+        auto const device = found->second;
+        Timestamp const now{std::chrono::steady_clock::now().time_since_epoch()};
+        queue->enqueue(
+            [device, build_event, now]
+            {
+                device->emit([&](mi::EventBuilder& builder) { return build_event(builder, now); });
+            });
+    }
+
+    std::shared_ptr<mi::InputDeviceRegistry> const registry;
+    std::shared_ptr<md::ActionQueue> const queue;
+    ReplayingServer::Pacing const pacing;
+
+    std::map<MirInputDeviceId, std::shared_ptr<ReplayDevice>> devices;
+    size_t injected{0};
+    size_t skipped{0};
+    std::chrono::steady_clock::time_point replay_start;
+    Timestamp recording_start;
+};
+}
+
+void LatencyCollectingReport::received_event_from_kernel(int64_t, int, int, int)
+{
+}
+
+void LatencyCollectingReport::published_key_event(int, uint32_t, int64_t)
+{
+}
+
+void LatencyCollectingReport::published_motion_event(int, uint32_t, int64_t)
+{
+}
+
+void LatencyCollectingReport::opened_input_device(char const*, char const*)
+{
+}
+
+void LatencyCollectingReport::failed_to_open_input_device(char const*, char const*)
+{
+}
+
+void LatencyCollectingReport::event_reached_stage(mi::InputPipelineStage stage, int64_t event_time)
+{
+    auto const now = std::chrono::steady_clock::now();
+    auto const latency = now.time_since_epoch() - std::chrono::nanoseconds{event_time};
+    auto const index = static_cast<size_t>(stage);
+
+    std::lock_guard<std::mutex> lock{mutex};
+    stage_latencies[index].push_back(latency);
+    stage_last_arrival[index] = now;
+}
+
+std::vector<std::chrono::nanoseconds> LatencyCollectingReport::latencies(mi::InputPipelineStage stage) const
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    return stage_latencies[static_cast<size_t>(stage)];
+}
+
+size_t LatencyCollectingReport::event_count(mi::InputPipelineStage stage) const
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    return stage_latencies[static_cast<size_t>(stage)].size();
+}
+
+std::chrono::steady_clock::time_point LatencyCollectingReport::last_arrival(mi::InputPipelineStage stage) const
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    return stage_last_arrival[static_cast<size_t>(stage)];
+}
+
+ReplayingServer::ReplayingServer()
+    : latency_report{std::make_shared<LatencyCollectingReport>()},
+      injection_queue{std::make_shared<md::ActionQueue>()}
+{
+}
+
+ReplayingServer::~ReplayingServer() = default;
+
+std::shared_ptr<mi::InputReport> ReplayingServer::the_input_report()
+{
+    return latency_report;
+}
+
+ReplayingServer::Results ReplayingServer::replay(std::string const& path, Pacing pacing)
+{
+    mi::InputRecordReader reader{path};
+    Injector injector{the_input_device_registry(), injection_queue, pacing};
+
+    auto const multiplexer = the_input_reading_multiplexer();
+    multiplexer->add_watch(injection_queue);
+
+    while (reader.read_next(injector))
+        ;
+
+    injector.remove_remaining_devices();
+
+    // The pipeline up to the surface dispatcher runs on the input thread, so
+    // once the queue has drained every injected event has been reported
+    std::promise<void> drained;
+    injection_queue->enqueue([&drained] { drained.set_value(); });
+    drained.get_future().wait();
+
+    multiplexer->remove_watch(injection_queue);
+
+    return injector.results();
+}
+
+LatencyCollectingReport const& ReplayingServer::report() const
+{
+    return *latency_report;
+}
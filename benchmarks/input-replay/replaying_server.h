@@ -0,0 +1,92 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REPLAYING_SERVER_H_
+#define REPLAYING_SERVER_H_
+
+#include "mir_test_framework/fake_input_server_configuration.h"
+#include "mir/input/input_report.h"
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mir
+{
+namespace dispatch
+{
+class ActionQueue;
+}
+}
+
+/// Collects the latency of every event at each stage of the input pipeline
+class LatencyCollectingReport : public mir::input::InputReport
+{
+public:
+    static size_t const stage_count = static_cast<size_t>(mir::input::InputPipelineStage::sent_to_client) + 1;
+
+    void received_event_from_kernel(int64_t when, int type, int code, int value) override;
+    void published_key_event(int dest_fd, uint32_t seq_id, int64_t event_time) override;
+    void published_motion_event(int dest_fd, uint32_t seq_id, int64_t event_time) override;
+    void opened_input_device(char const* device_name, char const* input_platform) override;
+    void failed_to_open_input_device(char const* device_name, char const* input_platform) override;
+    void event_reached_stage(mir::input::InputPipelineStage stage, int64_t event_time) override;
+
+    std::vector<std::chrono::nanoseconds> latencies(mir::input::InputPipelineStage stage) const;
+    size_t event_count(mir::input::InputPipelineStage stage) const;
+    std::chrono::steady_clock::time_point last_arrival(mir::input::InputPipelineStage stage) const;
+
+private:
+    mutable std::mutex mutex;
+    std::array<std::vector<std::chrono::nanoseconds>, stage_count> stage_latencies;
+    std::array<std::chrono::steady_clock::time_point, stage_count> stage_last_arrival;
+};
+
+class ReplayingServer : public mir_test_framework::FakeInputServerConfiguration
+{
+public:
+    enum class Pacing
+    {
+        real_time,          /**< keep the gaps between events as recorded */
+        as_fast_as_possible /**< inject each event as soon as the last one is queued */
+    };
+
+    struct Results
+    {
+        size_t injected_events;
+        size_t skipped_events;
+        std::chrono::steady_clock::time_point first_injection;
+    };
+
+    ReplayingServer();
+    ~ReplayingServer();
+
+    std::shared_ptr<mir::input::InputReport> the_input_report() override;
+
+    /// Injects the recording at \a path into the running server
+    Results replay(std::string const& path, Pacing pacing);
+
+    LatencyCollectingReport const& report() const;
+
+private:
+    std::shared_ptr<LatencyCollectingReport> const latency_report;
+    std::shared_ptr<mir::dispatch::ActionQueue> const injection_queue;
+};
+
+#endif // REPLAYING_SERVER_H_
@@ -115,6 +115,12 @@ bool KioskWindowManagerPolicy::handle_pointer_event(MirPointerEvent const* event
     return false;
 }
 
+bool KioskWindowManagerPolicy::pointer_motion_needs_handling(MirPointerEvent const*, miral::WindowLayoutSnapshot const&)
+{
+    // We only act on button presses
+    return false;
+}
+
 void KioskWindowManagerPolicy::advise_focus_gained(WindowInfo const& info)
 {
     CanonicalWindowManagerPolicy::advise_focus_gained(info);
@@ -22,10 +22,11 @@
 #include "sw_splash.h"
 
 #include <miral/canonical_window_manager.h>
+#include <miral/pointer_motion_policy.h>
 
 using namespace mir::geometry;
 
-class KioskWindowManagerPolicy : public miral::CanonicalWindowManagerPolicy
+class KioskWindowManagerPolicy : public miral::CanonicalWindowManagerPolicy, public miral::PointerMotionPolicy
 {
 public:
     KioskWindowManagerPolicy(miral::WindowManagerTools const& tools, SwSplash const&);
@@ -38,6 +39,7 @@ public:
     bool handle_keyboard_event(MirKeyboardEvent const* event) override;
     bool handle_touch_event(MirTouchEvent const* event) override;
     bool handle_pointer_event(MirPointerEvent const* event) override;
+    bool pointer_motion_needs_handling(MirPointerEvent const* event, miral::WindowLayoutSnapshot const& layout) override;
     void handle_modify_window(miral::WindowInfo& window_info, miral::WindowSpecification const& modifications) override;
 
     void handle_request_drag_and_drop(miral::WindowInfo& window_info) override;
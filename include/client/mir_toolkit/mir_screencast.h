@@ -200,6 +200,31 @@ void mir_screencast_capture_to_buffer(
  **/
 MirScreencastResult mir_screencast_capture_to_buffer_sync(MirScreencast* screencast, MirBuffer* buffer);
 
+/** Get the number of rectangles of the buffer that changed in the most
+ *  recently completed capture, compared with the capture before it.
+ *
+ *  Zero means nothing changed: the server may then have left the buffer as
+ *  it was, so its content is only current if the buffer is not modified
+ *  between captures. The first capture reports the whole buffer.
+ *
+ *  \warning   The damage is valid until the next capture completes, so
+ *              query it from the available callback or after
+ *              mir_screencast_capture_to_buffer_sync().
+ *   \param [in] screencast         The screencast
+ *   \return                        The number of damaged rectangles
+ **/
+unsigned int mir_screencast_get_damage_count(MirScreencast* screencast);
+
+/** Get a rectangle of the buffer that changed in the most recently completed
+ *  capture, in buffer coordinates with the first row at the top.
+ *
+ *   \param [in] screencast         The screencast
+ *   \param [in] index              The index of the rectangle, less than
+ *                                  mir_screencast_get_damage_count()
+ *   \return                        The damaged rectangle
+ **/
+MirRectangle mir_screencast_get_damage(MirScreencast* screencast, unsigned int index);
+
 #ifdef __cplusplus
 }
 /**@}*/
@@ -19,25 +19,34 @@
 #ifndef MIR_CACHED_PTR_H_
 #define MIR_CACHED_PTR_H_
 
+#include "mir/startup_trace.h"
+
 #include <functional>
 #include <memory>
+#include <mutex>
 
 namespace mir
 {
 template<typename Type>
 class CachedPtr
 {
+    std::recursive_mutex mutex;
     std::weak_ptr<Type> cache;
     CachedPtr(CachedPtr const&) = delete;
     CachedPtr& operator=(CachedPtr const&) = delete;
 public:
     CachedPtr() = default;
 
+    /// Safe to call from several threads: the first makes the object, the others wait for it
     std::shared_ptr<Type> operator()(std::function<std::shared_ptr<Type>()> make)
     {
+        std::lock_guard<decltype(mutex)> lock{mutex};
+
         auto result = cache.lock();
         if (!result)
         {
+                // Named after CachedPtr as typeid(Type) needs Type to be complete
+                StartupTrace::Scope const step{typeid(CachedPtr)};
                 cache = result = make();
         }
         return result;
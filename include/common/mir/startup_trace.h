@@ -0,0 +1,90 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_STARTUP_TRACE_H_
+#define MIR_STARTUP_TRACE_H_
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+namespace mir
+{
+/**
+ * Records how long each step of starting the server takes, so the critical
+ * path to a usable screen can be seen. Every object a CachedPtr makes is a
+ * step, named after its type.
+ *
+ * Only one trace is recorded at a time: steps are added to the trace most
+ * recently constructed, until it is destroyed.
+ */
+class StartupTrace
+{
+    struct Recording;
+
+public:
+    struct Step
+    {
+        std::string name;
+        unsigned thread;                    ///< 0 for the first thread to take a step, 1 for the next...
+        unsigned depth;                     ///< Steps taken within a step are one deeper
+        std::chrono::nanoseconds start;     ///< Since the trace started
+        std::chrono::nanoseconds duration;
+        std::chrono::nanoseconds exclusive; ///< duration, less that of the steps taken within it
+    };
+
+    StartupTrace();
+    ~StartupTrace();
+
+    /// The steps completed so far, in the order they started
+    std::vector<Step> steps() const;
+
+    /// Logs the steps completed so far, one per line
+    void log() const;
+
+    /// Times the enclosing scope as a step of the current trace, if there is one
+    class Scope
+    {
+    public:
+        explicit Scope(char const* name);
+        explicit Scope(std::type_info const& type);
+        ~Scope();
+
+    private:
+        Scope(char const* name, std::type_info const* type);
+        Scope(Scope const&) = delete;
+        Scope& operator=(Scope const&) = delete;
+
+        std::shared_ptr<Recording> const recording;
+        char const* const name;
+        std::type_info const* const type;
+        Scope* const parent;
+        unsigned const depth;
+        std::chrono::steady_clock::time_point const start;
+        std::chrono::nanoseconds nested{0};
+    };
+
+private:
+    StartupTrace(StartupTrace const&) = delete;
+    StartupTrace& operator=(StartupTrace const&) = delete;
+
+    std::shared_ptr<Recording> const recording;
+};
+}
+
+#endif /* MIR_STARTUP_TRACE_H_ */
@@ -0,0 +1,77 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIRAL_POINTER_MOTION_POLICY_H
+#define MIRAL_POINTER_MOTION_POLICY_H
+
+#include "miral/window.h"
+
+#include <mir/geometry/point.h>
+#include <mir_toolkit/event.h>
+
+namespace miral
+{
+using namespace mir::geometry;
+
+/// A read-only view of the windows, as they were when window management last
+/// changed them. Unlike WindowManagerTools, it may be used without the window
+/// management lock.
+class WindowLayoutSnapshot
+{
+public:
+    /// The window that was active
+    virtual auto active_window() const -> Window = 0;
+
+    /// The window (if any) under point, of those in the snapshot
+    virtual auto window_at(Point point) const -> Window = 0;
+
+    virtual ~WindowLayoutSnapshot();
+    WindowLayoutSnapshot();
+    WindowLayoutSnapshot(WindowLayoutSnapshot const&) = delete;
+    WindowLayoutSnapshot& operator=(WindowLayoutSnapshot const&) = delete;
+};
+
+/**
+ * Optionally implemented by a WindowManagementPolicy that can screen pointer
+ * motion without excluding all other window management.
+ *
+ * Without this, every pointer event waits for any window management in
+ * progress (such as a client creating or modifying a window) to finish.
+ */
+class PointerMotionPolicy
+{
+public:
+    /** Screen pointer motion while no buttons are pressed
+     *
+     * This is called *without* the window management lock, so may run
+     * concurrently with other policy calls. It must neither use
+     * WindowManagerTools nor modify any WindowInfo or ApplicationInfo.
+     *
+     * @param event   the motion event
+     * @param layout  a snapshot of the windows
+     * @return        whether handle_pointer_event() needs to handle the event.
+     *                If not, the event is not consumed.
+     */
+    virtual bool pointer_motion_needs_handling(MirPointerEvent const* event, WindowLayoutSnapshot const& layout) = 0;
+
+    virtual ~PointerMotionPolicy();
+    PointerMotionPolicy();
+    PointerMotionPolicy(PointerMotionPolicy const&) = delete;
+    PointerMotionPolicy& operator=(PointerMotionPolicy const&) = delete;
+};
+}
+
+#endif //MIRAL_POINTER_MOTION_POLICY_H
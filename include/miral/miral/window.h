@@ -64,6 +64,7 @@ private:
     friend bool operator==(std::shared_ptr<mir::scene::Surface> const& lhs, Window const& rhs);
     friend bool operator==(Window const& lhs, std::shared_ptr<mir::scene::Surface> const& rhs);
     friend bool operator<(Window const& lhs, Window const& rhs);
+    friend class BasicWindowManager;
 };
 
 bool operator==(Window const& lhs, Window const& rhs);
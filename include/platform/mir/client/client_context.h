@@ -23,6 +23,8 @@
 #include "mir/mir_render_surface.h"
 #include "mir/geometry/size.h"
 
+#include <string>
+
 namespace mir
 {
 namespace client
@@ -46,6 +48,9 @@ public:
         MirBufferCallback callback, void* context) = 0;
     virtual void release_buffer(mir::client::MirBuffer* buffer) = 0;
 
+    /// The client platform module the server names in its platform package, if any
+    virtual std::string client_module_hint() { return {}; }
+
 protected:
     ClientContext() = default;
     ClientContext(const ClientContext&) = delete;
@@ -206,6 +206,22 @@ public:
 
     Display() = default;
     virtual ~Display() = default;
+
+    /**
+     * Executes a functor for each output group that configure(conf) would
+     * destroy or modify.
+     *
+     * Output groups not passed to the functor are left untouched by
+     * configure(conf): they and their DisplayBuffers remain valid and may
+     * keep being composited to while it runs. The default is to report every
+     * output group, for platforms that rebuild them all on each configure().
+     */
+    virtual void for_each_display_sync_group_invalidated_by(
+        DisplayConfiguration const& /*conf*/,
+        std::function<void(DisplaySyncGroup&)> const& f)
+    {
+        for_each_display_sync_group(f);
+    }
 private:
     Display(Display const&) = delete;
     Display& operator=(Display const&) = delete;
@@ -20,6 +20,7 @@
 #define MIR_GRAPHICS_PLATFORM_IPC_PACKAGE_H_
 
 #include <vector>
+#include <string>
 #include <cinttypes>
 
 namespace mir
@@ -41,6 +42,10 @@ struct PlatformIPCPackage
     std::vector<int32_t> ipc_fds;
 
     ModuleProperties const* graphics_module;
+
+    /// Client platform module that understands this package, named without
+    /// its ".so" suffix. If empty, the client probes every module it has.
+    std::string client_module;
 };
 
 }
@@ -27,6 +27,16 @@ namespace mir
 namespace input
 {
 
+/// The points along the server input pipeline at which an event's latency is reported
+enum class InputPipelineStage
+{
+    converted,          /**< translated from the kernel event by the input platform */
+    seat_dispatched,    /**< handed on by the seat for dispatch */
+    filtered,           /**< passed through the event filter chain */
+    surface_dispatched, /**< delivered to the event sink of the target surface */
+    sent_to_client      /**< written to the client connection */
+};
+
 class InputReport
 {
 public:
@@ -41,6 +51,17 @@ public:
     virtual void opened_input_device(char const* device_name, char const* input_platform) = 0;
     virtual void failed_to_open_input_device(char const* device_name, char const* input_platform) = 0;
 
+    /**
+     * An input event has reached a stage of the input pipeline.
+     *
+     * \param [in] stage       The stage that has been reached
+     * \param [in] event_time  The kernel timestamp of the event (CLOCK_MONOTONIC, in ns);
+     *                         the report measures latency against it
+     *
+     * Reports that don't measure latency needn't override this.
+     */
+    virtual void event_reached_stage(InputPipelineStage /*stage*/, int64_t /*event_time*/) {}
+
 protected:
     InputReport() = default;
     InputReport(InputReport const&) = delete;
@@ -24,11 +24,32 @@
 #include "mir_toolkit/common.h"
 #include <glm/glm.hpp>
 
+#include <chrono>
+#include <memory>
+
 namespace mir
 {
 namespace renderer
 {
 
+/// Told as render() passes each stage of drawing a frame, so the frame time can be accounted for
+class FrameTimingObserver
+{
+public:
+    virtual ~FrameTimingObserver() = default;
+
+    virtual void textures_bound() = 0;
+    virtual void draw_submitted() = 0;
+
+    /// The GPU time taken by an earlier frame (the GPU's timings arrive late)
+    virtual void gpu_completed(std::chrono::nanoseconds gpu_time) = 0;
+
+protected:
+    FrameTimingObserver() = default;
+    FrameTimingObserver(FrameTimingObserver const&) = delete;
+    FrameTimingObserver& operator=(FrameTimingObserver const&) = delete;
+};
+
 class Renderer
 {
 public:
@@ -39,6 +60,9 @@ public:
     virtual void render(graphics::RenderableList const&) const = 0;
     virtual void suspend() = 0; // called when render() is skipped
 
+    /// Renderers that can't report their timing ignore the observer
+    virtual void set_timing_observer(std::shared_ptr<FrameTimingObserver> const& /*observer*/) {}
+
 protected:
     Renderer() = default;
     Renderer(const Renderer&) = delete;
@@ -19,6 +19,8 @@
 #ifndef MIR_COMPOSITOR_COMPOSITOR_H_
 #define MIR_COMPOSITOR_COMPOSITOR_H_
 
+#include "mir/graphics/display.h"
+
 namespace mir
 {
 namespace compositor
@@ -32,6 +34,27 @@ public:
     virtual void start() = 0;
     virtual void stop() = 0;
 
+    /**
+     * Applies conf to display, interrupting compositing as little as possible.
+     *
+     * The default stops compositing to every output while the display is
+     * configured, and (re)starts it afterwards, even if configuring fails.
+     */
+    virtual void configure_display(graphics::Display& display, graphics::DisplayConfiguration const& conf)
+    {
+        stop();
+        try
+        {
+            display.configure(conf);
+        }
+        catch (...)
+        {
+            start();
+            throw;
+        }
+        start();
+    }
+
 protected:
     Compositor() = default;
     Compositor(Compositor const&) = delete;
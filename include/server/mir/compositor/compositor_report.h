@@ -21,11 +21,22 @@
 
 #include "mir/graphics/renderable.h"
 
+#include <chrono>
+
 namespace mir
 {
 namespace compositor
 {
 
+/// The points a frame passes on its way to the display, in the order they're reached
+enum class FrameStage
+{
+    scene_snapshotted, /**< the renderables to draw have been picked out of the scene */
+    textures_bound,    /**< the renderables' buffers are bound as textures */
+    draw_submitted,    /**< the draw calls have all been issued to the GPU */
+    flip_completed     /**< the frame has been posted to the display */
+};
+
 class CompositorReport
 {
 public:
@@ -35,6 +46,22 @@ public:
     virtual void renderables_in_frame(SubCompositorId id, graphics::RenderableList const& renderables) = 0;
     virtual void rendered_frame(SubCompositorId id) = 0;
     virtual void finished_frame(SubCompositorId id) = 0;
+
+    /**
+     * The frame in progress on a display has reached a stage. Stages are
+     * reported between began_frame() and finished_frame(), except for
+     * flip_completed which follows finished_frame(). A bypassed frame only
+     * reaches scene_snapshotted and flip_completed.
+     */
+    virtual void frame_reached_stage(SubCompositorId /*id*/, FrameStage /*stage*/) {}
+
+    /**
+     * The time the GPU spent drawing a frame for a display. The GPU reports
+     * this asynchronously, so it refers to a frame already finished (usually
+     * the one before last). Only reported where the renderer can time the GPU.
+     */
+    virtual void rendered_on_gpu(SubCompositorId /*id*/, std::chrono::nanoseconds /*gpu_time*/) {}
+
     virtual void started() = 0;
     virtual void stopped() = 0;
     virtual void scheduled() = 0;
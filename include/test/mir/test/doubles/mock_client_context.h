@@ -46,6 +46,7 @@ struct MockClientContext : public client::ClientContext
     MOCK_METHOD4(allocate_buffer, void(geometry::Size, MirPixelFormat, MirBufferCallback, void*));
     MOCK_METHOD5(allocate_buffer, void(geometry::Size, uint32_t, uint32_t, MirBufferCallback, void*));
     MOCK_METHOD1(release_buffer, void(mir::client::MirBuffer*));
+    MOCK_METHOD0(client_module_hint, std::string());
 };
 
 }
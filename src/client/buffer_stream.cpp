@@ -33,6 +33,7 @@
 #include "connection_surface_map.h"
 
 #include "mir/log.h"
+#include "mir/time/steady_clock.h"
 #include "mir/client/client_platform.h"
 #include "mir/frontend/client_constants.h"
 #include "mir_toolkit/mir_native_buffer.h"
@@ -40,6 +41,7 @@
 #include <boost/throw_exception.hpp>
 #include <boost/exception/diagnostic_information.hpp>
 
+#include <algorithm>
 #include <stdexcept>
 
 namespace mcl = mir::client;
@@ -107,9 +109,8 @@ public:
         request.mutable_id()->set_value(stream_id);
         request.mutable_buffer()->set_buffer_id(buffer.rpc_id());
 
-        auto protobuf_void = std::make_shared<mp::Void>();
-        server.submit_buffer(&request, protobuf_void.get(),
-            google::protobuf::NewCallback(Requests::ignore_response, protobuf_void));
+        // The buffer comes back in a buffer event, so there's no result to wait for
+        server.submit_buffer(&request, nullptr, nullptr);
     }
 
     static void ignore_response(std::shared_ptr<mp::Void>)
@@ -134,6 +135,12 @@ mir::optional_value<int> parse_env_for_swap_interval()
         return {};
     }
 }
+
+void close_fds_of(mp::Buffer const& buffer)
+{
+    for (int i = 0; i < buffer.fd_size(); i++)
+        ::close(buffer.fd(i));
+}
 }
 
 namespace mir
@@ -149,8 +156,11 @@ struct BufferDepository
         std::shared_ptr<mcl::ServerBufferRequests> const& requests,
         std::weak_ptr<mcl::SurfaceMap> const& surface_map,
         geom::Size size, MirPixelFormat format, int usage,
-        unsigned int initial_nbuffers) :
-        vault(factory, mirbuffer_factory, requests, surface_map, size, format, usage, initial_nbuffers),
+        unsigned int initial_nbuffers,
+        unsigned int preallocated_nbuffers) :
+        vault(factory, mirbuffer_factory, requests, surface_map, size, format, usage,
+              initial_nbuffers, preallocated_nbuffers,
+              std::make_shared<mir::time::SteadyClock>()),
         current(nullptr),
         size_(size)
     {
@@ -304,10 +314,15 @@ mcl::BufferStream::BufferStream(
             for (int i = 0; i < protobuf_bs->buffer().fd_size(); i++)
                 ::close(protobuf_bs->buffer().fd(i));
         }
+        for (auto const& buffer : protobuf_bs->preallocated_buffer())
+            close_fds_of(buffer);
 
         BOOST_THROW_EXCEPTION(std::runtime_error("Can not create buffer stream: " + std::string(protobuf_bs->error())));
     }
 
+    // The server may have sent some buffers with the stream, sparing us the round trip
+    auto const preallocated = std::min<int>(protobuf_bs->preallocated_buffer_size(), nbuffers);
+    int adopted{0};
     try
     {
         buffer_depository = std::make_unique<BufferDepository>(
@@ -315,7 +330,16 @@ mcl::BufferStream::BufferStream(
             std::make_shared<Requests>(server, protobuf_bs->id().value(), client_platform),
             map,
             ideal_buffer_size, static_cast<MirPixelFormat>(protobuf_bs->pixel_format()), 
-            protobuf_bs->buffer_usage(), nbuffers);
+            protobuf_bs->buffer_usage(), nbuffers, preallocated);
+
+        for (; adopted != preallocated; adopted++)
+        {
+            auto const& protobuf_buffer = protobuf_bs->preallocated_buffer(adopted);
+            std::shared_ptr<mcl::MirBuffer> buffer = factory->generate_buffer(protobuf_buffer);
+            if (auto surface_map = map.lock())
+                surface_map->insert(protobuf_buffer.buffer_id(), buffer);
+            buffer->received();
+        }
 
         egl_native_window_ = client_platform->create_egl_native_window(this);
 
@@ -338,6 +362,11 @@ mcl::BufferStream::BufferStream(
         }
     }
 
+    // Whatever we failed to adopt, or didn't ask for, is of no use to us
+    for (auto i = adopted; i < protobuf_bs->preallocated_buffer_size(); i++)
+        close_fds_of(protobuf_bs->preallocated_buffer(i));
+    protobuf_bs->clear_preallocated_buffer();
+
     if (!valid())
         BOOST_THROW_EXCEPTION(std::runtime_error("Can not create buffer stream: " + std::string(protobuf_bs->error())));
     perf_report->name_surface(surface_name.c_str());
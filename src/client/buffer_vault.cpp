@@ -27,6 +27,7 @@
 #include "connection_surface_map.h"
 #include "buffer_factory.h"
 #include "buffer.h"
+#include "mir/time/clock.h"
 #include <algorithm>
 #include <boost/throw_exception.hpp>
 
@@ -45,6 +46,16 @@ enum class mcl::BufferVault::Owner
 
 namespace
 {
+/// Beyond what the swap interval asks for
+unsigned int const max_latency_buffers = 2;
+
+mir::time::Duration smoothed(mir::time::Duration average, mir::time::Duration sample)
+{
+    if (average == mir::time::Duration{0})
+        return sample;
+    return (average * 7 + sample) / 8;
+}
+
 void ignore_buffer(MirBuffer*, void*)
 {
 }
@@ -60,11 +71,14 @@ mcl::BufferVault::BufferVault(
     std::shared_ptr<AsyncBufferFactory> const& buffer_factory,
     std::shared_ptr<ServerBufferRequests> const& server_requests,
     std::weak_ptr<SurfaceMap> const& surface_map,
-    geom::Size size, MirPixelFormat format, int usage, unsigned int initial_nbuffers) :
+    geom::Size size, MirPixelFormat format, int usage, unsigned int initial_nbuffers,
+    unsigned int preallocated_nbuffers,
+    std::shared_ptr<time::Clock> const& clock) :
     platform_factory(platform_factory),
     buffer_factory(buffer_factory),
     server_requests(server_requests),
     surface_map(surface_map),
+    clock(clock),
     format(format),
     usage(usage),
     size(size),
@@ -74,7 +88,12 @@ mcl::BufferVault::BufferVault(
     initial_buffer_count(initial_nbuffers)
 {
     for (auto i = 0u; i < initial_buffer_count; i++)
-        alloc_buffer(size, format, usage);
+    {
+        if (i < preallocated_nbuffers)
+            expect_buffer(size, format, usage);
+        else
+            alloc_buffer(size, format, usage);
+    }
 }
 
 mcl::BufferVault::~BufferVault()
@@ -140,13 +159,18 @@ mcl::BufferVault::~BufferVault()
     }
 }
 
-void mcl::BufferVault::alloc_buffer(geom::Size size, MirPixelFormat format, int usage)
+void mcl::BufferVault::expect_buffer(geom::Size size, MirPixelFormat format, int usage)
 {
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
     buffer_factory->expect_buffer(platform_factory, nullptr, size, format, static_cast<MirBufferUsage>(usage),
         incoming_buffer, this);
 #pragma GCC diagnostic pop
+}
+
+void mcl::BufferVault::alloc_buffer(geom::Size size, MirPixelFormat format, int usage)
+{
+    expect_buffer(size, format, usage);
     server_requests->allocate_buffer(size, format, usage);
 }
 
@@ -222,7 +246,19 @@ mcl::NoTLSFuture<std::shared_ptr<mcl::MirBuffer>> mcl::BufferVault::withdraw()
     {
         it->second = Owner::ContentProducer;
         promise.set_value(checked_buffer_from_map(it->first));
+
+        // Allocate ahead of need when the server has been holding buffers longer
+        auto s = size;
+        bool allocate_buffer = (preallocations > 0 && current_buffer_count < needed_buffer_count);
+        if (allocate_buffer)
+        {
+            current_buffer_count++;
+            preallocations--;
+        }
         lk.unlock();
+
+        if (allocate_buffer)
+            alloc_buffer(s, format, usage);
     }
     else
     {
@@ -231,7 +267,11 @@ mcl::NoTLSFuture<std::shared_ptr<mcl::MirBuffer>> mcl::BufferVault::withdraw()
         auto s = size;
         bool allocate_buffer = (current_buffer_count <  needed_buffer_count);
         if (allocate_buffer)
+        {
             current_buffer_count++;
+            if (preallocations > 0)
+                preallocations--;
+        }
         lk.unlock();
 
         if (allocate_buffer)
@@ -262,6 +302,7 @@ MirWaitHandle* mcl::BufferVault::wire_transfer_outbound(
     if (it == buffers.end() || it->second != Owner::SelfWithContent)
         BOOST_THROW_EXCEPTION(std::logic_error("buffer cannot be transferred"));
     it->second = Owner::Server;
+    note_submission(lk, it->first);
     lk.unlock();
 
     buffer->submitted();
@@ -294,6 +335,7 @@ void mcl::BufferVault::wire_transfer_inbound(int buffer_id)
         return;
 
     last_received_id = buffer_id;
+    note_return(lk, buffer_id);
     auto buffer = checked_buffer_from_map(buffer_id);
     auto inbound_size = buffer->size();
     auto it = buffers.find(buffer_id);
@@ -339,6 +381,40 @@ void mcl::BufferVault::wire_transfer_inbound(int buffer_id)
     trigger_callback(std::move(lk));
 }
 
+void mcl::BufferVault::note_submission(std::unique_lock<std::mutex> const&, int id)
+{
+    auto const now = clock->now();
+    if (last_submission != time::Timestamp{})
+        frame_period = smoothed(frame_period, now - last_submission);
+    last_submission = now;
+    submission_times[id] = now;
+}
+
+void mcl::BufferVault::note_return(std::unique_lock<std::mutex> const&, int id)
+{
+    auto const submitted = submission_times.find(id);
+    if (submitted == submission_times.end())
+        return;
+
+    server_latency = smoothed(server_latency, clock->now() - submitted->second);
+    submission_times.erase(submitted);
+
+    if (interval != 0 || frame_period == time::Duration{0})
+        return;
+
+    // One to render into, those the server holds and one spare for jitter
+    auto const held = (server_latency + frame_period - time::Duration{1}) / frame_period;
+    auto const wanted = std::min<size_t>(
+        std::max<size_t>(held + 2, initial_buffer_count + 1),
+        initial_buffer_count + 1 + max_latency_buffers);
+
+    if (wanted > needed_buffer_count)
+        preallocations += wanted - needed_buffer_count;
+    // Only shrink on a clear drop, so as not to thrash
+    if (wanted > needed_buffer_count || wanted + 1 < needed_buffer_count)
+        needed_buffer_count = wanted;
+}
+
 void mcl::BufferVault::disconnected()
 {
     std::unique_lock<std::mutex> lk(mutex);
@@ -393,6 +469,7 @@ void mcl::BufferVault::set_interval(int i)
     else
     {
         needed_buffer_count = initial_buffer_count;
+        preallocations = 0;
         while (current_buffer_count > needed_buffer_count)
         {
             auto it = std::find_if(buffers.begin(), buffers.end(),
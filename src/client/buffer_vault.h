@@ -20,6 +20,7 @@
 #define MIR_CLIENT_BUFFER_VAULT_H_
 
 #include "mir/geometry/size.h"
+#include "mir/time/types.h"
 #include "mir_toolkit/common.h"
 #include "mir_toolkit/mir_native_buffer.h"
 #include "mir_wait_handle.h"
@@ -31,6 +32,7 @@
 namespace mir
 {
 namespace protobuf { class Buffer; }
+namespace time { class Clock; }
 namespace client
 {
 class ClientBuffer;
@@ -56,13 +58,19 @@ class ClientBufferFactory;
 class BufferVault
 {
 public:
+    /**
+     * \param preallocated_nbuffers how many of the initial buffers the server
+     *        has already allocated and is delivering without being asked
+     */
     BufferVault(
         std::shared_ptr<ClientBufferFactory> const&,
         std::shared_ptr<AsyncBufferFactory> const&,
         std::shared_ptr<ServerBufferRequests> const&,
         std::weak_ptr<SurfaceMap> const&,
         geometry::Size size, MirPixelFormat format, int usage,
-        unsigned int initial_nbuffers);
+        unsigned int initial_nbuffers,
+        unsigned int preallocated_nbuffers,
+        std::shared_ptr<time::Clock> const& clock);
     ~BufferVault();
 
     NoTLSFuture<std::shared_ptr<MirBuffer>> withdraw();
@@ -81,17 +89,21 @@ private:
     BufferMap::iterator available_buffer();
     void trigger_callback(std::unique_lock<std::mutex> lk);
 
+    void expect_buffer(geometry::Size size, MirPixelFormat format, int usage);
     void alloc_buffer(geometry::Size size, MirPixelFormat format, int usage);
     void free_buffer(int free_id);
     void realloc_buffer(int free_id, geometry::Size size, MirPixelFormat format, int usage);
     std::shared_ptr<MirBuffer> checked_buffer_from_map(int id);
     void set_size(std::unique_lock<std::mutex> const& lk, geometry::Size new_size);
+    void note_submission(std::unique_lock<std::mutex> const& lk, int id);
+    void note_return(std::unique_lock<std::mutex> const& lk, int id);
 
 
     std::shared_ptr<ClientBufferFactory> const platform_factory;
     std::shared_ptr<AsyncBufferFactory> const buffer_factory;
     std::shared_ptr<ServerBufferRequests> const server_requests;
     std::weak_ptr<SurfaceMap> const surface_map;
+    std::shared_ptr<time::Clock> const clock;
     MirPixelFormat const format;
     int const usage;
 
@@ -106,6 +118,16 @@ private:
     size_t const initial_buffer_count;
     int last_received_id = 0;
     int interval = 1;
+
+    // With interval 0 the server doesn't queue buffers, so how long it
+    // holds each compared to how often they arrive is how many buffers
+    // it takes to never wait for one
+    std::map<int, time::Timestamp> submission_times;
+    time::Timestamp last_submission;
+    time::Duration frame_period{0};
+    time::Duration server_latency{0};
+    size_t preallocations{0};
+
     MirWaitHandle swap_buffers_wait_handle;
     std::function<void()> deferred_cb;
 };
@@ -35,6 +35,7 @@
 #include "lifecycle_control.h"
 #include "mir/client/client_platform_factory.h"
 #include "probing_client_platform_factory.h"
+#include "platform_module_cache.h"
 #include "mir_event_distributor.h"
 #include "buffer_factory.h"
 
@@ -109,7 +110,9 @@ mcl::DefaultConnectionConfiguration::the_client_platform_factory()
                                          the_shared_library_prober_report(),
                                          libs,
                                          paths,
-                                         the_logger()
+                                         the_logger(),
+                                         std::make_shared<mcl::PlatformModuleCache>(
+                                             mcl::PlatformModuleCache::default_filename())
                                          );
         });
 }
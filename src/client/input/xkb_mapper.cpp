@@ -165,22 +165,36 @@ void mircv::XKBMapper::set_key_state(MirInputDeviceId id, std::vector<uint32_t>
 
     auto mapping_state = get_keymapping_state(id);
     if (mapping_state)
+    {
         mapping_state->set_key_state(key_state);
+        update_modifier();
+    }
 }
 
 void mircv::XKBMapper::update_modifier()
 {
     modifier_state = mir::optional_value<MirInputEventModifiers>{};
+    XkbModifiers xkb_modifiers{0, 0, 0, xkb_group};
     if (!device_mapping.empty())
     {
         MirInputEventModifiers new_modifier = 0;
         for (auto const& mapping_state : device_mapping)
         {
             new_modifier |= mapping_state.second->modifiers();
+
+            auto const device_xkb_modifiers = mapping_state.second->xkb_modifiers();
+            xkb_modifiers.depressed |= device_xkb_modifiers.depressed;
+            xkb_modifiers.latched |= device_xkb_modifiers.latched;
+            xkb_modifiers.locked |= device_xkb_modifiers.locked;
         }
 
         modifier_state = new_modifier;
     }
+
+    published_modifiers.store(
+        expand_modifiers(modifier_state.is_set() ? modifier_state.value() : 0),
+        std::memory_order_release);
+    published_xkb_modifiers.store(xkb_modifiers);
 }
 
 void mircv::XKBMapper::map_event(MirEvent& ev)
@@ -202,7 +216,11 @@ void mircv::XKBMapper::map_event(MirEvent& ev)
             {
                 auto compose_state = get_compose_state(device_id);
                 if (mapping_state->update_and_map(ev, compose_state))
+                {
+                    // The layout is that of the keyboard last typed on
+                    xkb_group = mapping_state->xkb_modifiers().group;
                     update_modifier();
+                }
             }
         }
         else if (modifier_state.is_set())
@@ -287,10 +305,7 @@ void mircv::XKBMapper::clear_keymap_for_device(MirInputDeviceId id)
 
 MirInputEventModifiers mircv::XKBMapper::modifiers() const
 {
-    std::lock_guard<std::mutex> lg(guard);
-    if (modifier_state.is_set())
-        return expand_modifiers(modifier_state.value());
-    return mir_input_event_modifier_none;
+    return published_modifiers.load(std::memory_order_acquire);
 }
 
 MirInputEventModifiers mircv::XKBMapper::device_modifiers(MirInputDeviceId id) const
@@ -303,6 +318,11 @@ MirInputEventModifiers mircv::XKBMapper::device_modifiers(MirInputDeviceId id) c
     return expand_modifiers(it->second->modifiers());
 }
 
+mi::XkbModifiers mircv::XKBMapper::xkb_modifiers() const
+{
+    return published_xkb_modifiers.load();
+}
+
 mircv::XKBMapper::XkbMappingState::XkbMappingState(std::shared_ptr<xkb_keymap> const& keymap)
     : keymap{keymap}, state{make_unique_state(this->keymap.get())}
 {
@@ -328,6 +348,8 @@ void mircv::XKBMapper::XkbMappingState::set_key_state(std::vector<uint32_t> cons
         else
             pressed_codes.insert(scan_code);
     }
+
+    update_xkb_modifiers();
 }
 
 bool mircv::XKBMapper::XkbMappingState::update_and_map(MirEvent& event, mircv::XKBMapper::ComposeState* compose_state)
@@ -335,6 +357,7 @@ bool mircv::XKBMapper::XkbMappingState::update_and_map(MirEvent& event, mircv::X
     auto& key_ev = *event.to_input()->to_keyboard();
     uint32_t xkb_scan_code = to_xkb_scan_code(key_ev.scan_code());
     auto old_state = modifier_state;
+    auto old_xkb_state = xkb_modifier_state;
     std::string key_text;
     xkb_keysym_t key_sym;
     key_sym = update_state(xkb_scan_code, key_ev.action(), compose_state, key_text);
@@ -345,7 +368,7 @@ bool mircv::XKBMapper::XkbMappingState::update_and_map(MirEvent& event, mircv::X
     // implement short cuts with keys that are only reachable via modifier keys
     key_ev.set_modifiers(expand_modifiers(modifier_state));
 
-    return old_state != modifier_state;
+    return old_state != modifier_state || old_xkb_state != xkb_modifier_state;
 }
 
 xkb_keysym_t mircv::XKBMapper::XkbMappingState::update_state(uint32_t scan_code, MirKeyboardAction action, mircv::XKBMapper::ComposeState* compose_state, std::string& text)
@@ -366,14 +389,16 @@ xkb_keysym_t mircv::XKBMapper::XkbMappingState::update_state(uint32_t scan_code,
 
     if (action == mir_keyboard_action_up)
     {
-        xkb_state_update_key(state.get(), scan_code, XKB_KEY_UP);
+        if (xkb_state_update_key(state.get(), scan_code, XKB_KEY_UP))
+            update_xkb_modifiers();
         // TODO get the modifier state from xkbcommon and apply it
         // for all other modifiers manually track them here:
         release_modifier(mod_change);
     }
     else if (action == mir_keyboard_action_down)
     {
-        xkb_state_update_key(state.get(), scan_code, XKB_KEY_DOWN);
+        if (xkb_state_update_key(state.get(), scan_code, XKB_KEY_DOWN))
+            update_xkb_modifiers();
         // TODO get the modifier state from xkbcommon and apply it
         // for all other modifiers manually track them here:
         press_modifier(mod_change);
@@ -387,6 +412,20 @@ MirInputEventModifiers mircv::XKBMapper::XkbMappingState::modifiers() const
     return modifier_state;
 }
 
+mi::XkbModifiers mircv::XKBMapper::XkbMappingState::xkb_modifiers() const
+{
+    return xkb_modifier_state;
+}
+
+void mircv::XKBMapper::XkbMappingState::update_xkb_modifiers()
+{
+    xkb_modifier_state = XkbModifiers{
+        xkb_state_serialize_mods(state.get(), XKB_STATE_MODS_DEPRESSED),
+        xkb_state_serialize_mods(state.get(), XKB_STATE_MODS_LATCHED),
+        xkb_state_serialize_mods(state.get(), XKB_STATE_MODS_LOCKED),
+        xkb_state_serialize_layout(state.get(), XKB_STATE_LAYOUT_EFFECTIVE)};
+}
+
 mircv::XKBMapper::ComposeState* mircv::XKBMapper::get_compose_state(MirInputDeviceId id)
 {
     auto dev_compose_state = device_composing.find(id);
@@ -108,6 +108,11 @@ size_t get_nbuffers_from_env()
     return 3u;
 }
 
+bool get_window_event_threads_from_env()
+{
+    return getenv("MIR_CLIENT_WINDOW_EVENT_THREADS") != nullptr;
+}
+
 struct OnScopeExit
 {
     ~OnScopeExit() { f(); }
@@ -305,6 +310,7 @@ MirConnection::MirConnection(std::string const& error_message) :
     server(nullptr),
     debug(nullptr),
     error_message(error_message),
+    dedicated_window_event_threads_{false},
     nbuffers(get_nbuffers_from_env())
 {
 }
@@ -334,6 +340,9 @@ MirConnection::MirConnection(
         error_handler{conf.the_error_handler()},
         event_handler_register(conf.the_event_handler_register()),
         pong_callback(google::protobuf::NewPermanentCallback(&google::protobuf::DoNothing)),
+        window_events{std::make_shared<md::MultiplexingDispatchable>()},
+        dedicated_window_event_threads_{get_window_event_threads_from_env()},
+        window_event_loop{new md::ThreadedDispatcher{"Window Events", window_events}},
         eventloop{new md::ThreadedDispatcher{"RPC Thread", std::dynamic_pointer_cast<md::Dispatchable>(channel)}},
         nbuffers(get_nbuffers_from_env())
 {
@@ -372,7 +381,10 @@ MirWaitHandle* MirConnection::create_surface(
     auto response = std::make_shared<mp::Surface>();
     auto c = std::make_shared<MirConnection::SurfaceCreationRequest>(callback, context, spec);
     c->wh->expect_result();
-    auto const message = serialize_spec(spec);
+    auto message = serialize_spec(spec);
+    // Let the server send the default stream's buffers with its reply
+    if (!spec.streams.is_set())
+        message.set_preallocate_buffers(nbuffers);
     {
         std::lock_guard<decltype(mutex)> lock(mutex);
         surface_requests.emplace_back(c);
@@ -664,6 +676,7 @@ MirWaitHandle* MirConnection::connect(
         std::lock_guard<decltype(mutex)> lock(mutex);
 
         connect_parameters->set_application_name(app_name);
+        connect_parameters->set_event_ring(true);
         connect_wait_handle.expect_result();
     }
 
@@ -834,6 +847,20 @@ void MirConnection::populate_graphics_module(MirModuleProperties& properties)
     }
 }
 
+std::string MirConnection::client_module_hint()
+{
+    // connect_result is write-once: once it's valid, we don't need to lock
+    // to use it.
+    if (connect_done &&
+        !connect_result->has_error() &&
+        connect_result->has_platform())
+    {
+        return connect_result->platform().client_module();
+    }
+
+    return {};
+}
+
 MirDisplayConfiguration* MirConnection::create_copy_of_display_config()
 {
     std::lock_guard<decltype(mutex)> lock(mutex);
@@ -86,6 +86,7 @@ class Logger;
 namespace dispatch
 {
 class ThreadedDispatcher;
+class MultiplexingDispatchable;
 }
 }
 
@@ -135,6 +136,7 @@ public:
 
     void populate(MirPlatformPackage& platform_package);
     void populate_graphics_module(MirModuleProperties& properties) override;
+    std::string client_module_hint() override;
     MirDisplayConfiguration* create_copy_of_display_config();
     std::unique_ptr<mir::protobuf::DisplayConfiguration> snapshot_display_configuration() const;
     void available_surface_formats(MirPixelFormat* formats,
@@ -208,6 +210,18 @@ public:
         return surface_map;
     }
 
+    /// Runs the event callbacks of windows, away from the thread reading the server socket
+    std::shared_ptr<mir::dispatch::MultiplexingDispatchable> const& window_event_dispatcher() const
+    {
+        return window_events;
+    }
+
+    /// Whether each window should run its event callbacks on a thread of its own instead
+    bool dedicated_window_event_threads() const
+    {
+        return dedicated_window_event_threads_;
+    }
+
     void allocate_buffer(
         mir::geometry::Size size, MirPixelFormat format,
         MirBufferCallback callback, void* context) override;
@@ -363,6 +377,10 @@ private:
 
     std::unique_ptr<google::protobuf::Closure> const pong_callback;
 
+    std::shared_ptr<mir::dispatch::MultiplexingDispatchable> const window_events;
+    bool const dedicated_window_event_threads_;
+    std::unique_ptr<mir::dispatch::ThreadedDispatcher> const window_event_loop;
+
     std::unique_ptr<mir::dispatch::ThreadedDispatcher> const eventloop;
     
 
@@ -27,6 +27,7 @@
 
 #include <boost/throw_exception.hpp>
 #include <algorithm>
+#include <stdexcept>
 
 namespace mcl = mir::client;
 namespace mp = mir::protobuf;
@@ -255,6 +256,20 @@ void MirScreencast::screencast_done(ScreencastRequest* request)
     std::unique_ptr<ScreencastRequest> request_holder;
     {
         std::unique_lock<decltype(mutex)> lk(mutex);
+
+        last_damage.clear();
+        if (request->response.damage_reported())
+        {
+            for (auto const& rect : request->response.damage())
+                last_damage.push_back(MirRectangle{rect.left(), rect.top(), rect.width(), rect.height()});
+        }
+        else if (status == mir_screencast_success)
+        {
+            // The server doesn't track damage, so all of it may have changed
+            auto const size = request->buffer->size();
+            last_damage.push_back(MirRectangle{0, 0, size.width.as_uint32_t(), size.height.as_uint32_t()});
+        }
+
         auto it = std::find_if(requests.begin(), requests.end(),
                                [&request](auto const& it)
                                { return it.get() == request; });
@@ -289,3 +304,17 @@ void MirScreencast::screencast_to_buffer(
         &(requests.back()->response),
         google::protobuf::NewCallback(this, &MirScreencast::screencast_done, requests.back().get()));
 }
+
+unsigned int MirScreencast::damage_count() const
+{
+    std::lock_guard<decltype(mutex)> lock(mutex);
+    return last_damage.size();
+}
+
+MirRectangle MirScreencast::damage(unsigned int index) const
+{
+    std::lock_guard<decltype(mutex)> lock(mutex);
+    if (index >= last_damage.size())
+        BOOST_THROW_EXCEPTION(std::out_of_range("Invalid screencast damage index"));
+    return last_damage[index];
+}
@@ -29,6 +29,7 @@
 #include <EGL/eglplatform.h>
 
 #include <memory>
+#include <vector>
 
 namespace mir
 {
@@ -92,6 +93,10 @@ public:
         MirScreencastBufferCallback available_callback,
         void* available_context);
 
+    /// The damage reported with the most recently completed capture to a buffer
+    unsigned int damage_count() const;
+    MirRectangle damage(unsigned int index) const;
+
 private:
     void screencast_created(
         MirScreencastCallback callback, void* context);
@@ -123,9 +128,10 @@ private:
         mir::client::MirBuffer* buffer;
         MirScreencastBufferCallback available_callback;
         void* available_context;
-        mir::protobuf::Void response;
+        mir::protobuf::ScreencastCapture response;
     };
     std::vector<std::unique_ptr<ScreencastRequest>> requests;
+    std::vector<MirRectangle> last_damage;
     void screencast_done(ScreencastRequest* request);
 };
 
@@ -168,3 +168,27 @@ catch (std::exception const& ex)
     MIR_LOG_UNCAUGHT_EXCEPTION(ex);
     return mir_screencast_error_failure;
 }
+
+unsigned int mir_screencast_get_damage_count(MirScreencast* screencast)
+try
+{
+    mir::require(screencast);
+    return screencast->damage_count();
+}
+catch (std::exception const& ex)
+{
+    MIR_LOG_UNCAUGHT_EXCEPTION(ex);
+    return 0;
+}
+
+MirRectangle mir_screencast_get_damage(MirScreencast* screencast, unsigned int index)
+try
+{
+    mir::require(screencast);
+    return screencast->damage(index);
+}
+catch (std::exception const& ex)
+{
+    MIR_LOG_UNCAUGHT_EXCEPTION(ex);
+    return MirRectangle{0, 0, 0, 0};
+}
@@ -29,6 +29,8 @@
 #include "mir/client/client_buffer.h"
 #include "mir/mir_buffer_stream.h"
 #include "mir/dispatch/threaded_dispatcher.h"
+#include "mir/dispatch/action_queue.h"
+#include "mir/events/event_builders.h"
 #include "mir/input/xkb_mapper.h"
 #include "mir/cookie/cookie.h"
 #include "mir_cookie.h"
@@ -51,6 +53,13 @@ namespace md = mir::dispatch;
 
 using mir::client::FrameClock;
 
+struct MirSurface::EventCallbackGuard
+{
+    // Held while a callback runs; recursive so that a callback may release its window
+    std::recursive_mutex mutex;
+    bool window_alive{true};
+};
+
 namespace
 {
 std::mutex handle_mutex;
@@ -124,6 +133,8 @@ MirSurface::MirSurface(
     surface{mcl::make_protobuf_object<mir::protobuf::Surface>()},
     connection_(conn),
     frame_clock(std::make_shared<FrameClock>()),
+    event_callback_guard(std::make_shared<EventCallbackGuard>()),
+    event_queue(std::make_shared<md::ActionQueue>()),
     creation_handle(handle)
 {
     surface->set_error(error);
@@ -155,6 +166,8 @@ MirSurface::MirSurface(
       keymapper(std::make_shared<mircv::XKBMapper>()),
       configure_result{mcl::make_protobuf_object<mir::protobuf::SurfaceSetting>()},
       frame_clock(std::make_shared<FrameClock>()),
+      event_callback_guard(std::make_shared<EventCallbackGuard>()),
+      event_queue(std::make_shared<md::ActionQueue>()),
       creation_handle(handle),
       size({surface_proto.width(), surface_proto.height()}),
       format(static_cast<MirPixelFormat>(surface_proto.pixel_format())),
@@ -194,6 +207,16 @@ MirSurface::MirSurface(
             spec.event_handler.value().context);
     }
 
+    if (connection_->dedicated_window_event_threads())
+    {
+        input_thread = std::make_shared<md::ThreadedDispatcher>("Window Events", event_queue);
+    }
+    else
+    {
+        event_dispatcher = connection_->window_event_dispatcher();
+        event_dispatcher->add_watch(event_queue);
+    }
+
     std::lock_guard<decltype(handle_mutex)> lock(handle_mutex);
     valid_surfaces.insert(this);
 
@@ -218,6 +241,15 @@ MirSurface::~MirSurface()
         valid_surfaces.erase(this);
     }
 
+    {
+        // Waits for any callback in progress; the ones still queued are dropped
+        std::lock_guard<decltype(event_callback_guard->mutex)> lock(event_callback_guard->mutex);
+        event_callback_guard->window_alive = false;
+    }
+
+    if (event_dispatcher)
+        event_dispatcher->remove_watch(event_queue);
+
     std::lock_guard<decltype(mutex)> lock(mutex);
 
     input_thread.reset();
@@ -466,7 +498,6 @@ void MirSurface::set_event_handler(MirWindowEventCallback callback,
 {
     std::lock_guard<decltype(mutex)> lock(mutex);
 
-    input_thread.reset();
     handle_event_callback = [](auto){};
 
     if (callback)
@@ -562,7 +593,15 @@ void MirSurface::handle_event(MirEvent& e)
     {
         auto callback = handle_event_callback;
         lock.unlock();
-        callback(&e);
+
+        std::shared_ptr<MirEvent const> const event{mir::events::clone_event(e)};
+        event_queue->enqueue(
+            [callback, event, guard = event_callback_guard]()
+            {
+                std::lock_guard<decltype(guard->mutex)> lock(guard->mutex);
+                if (guard->window_alive)
+                    callback(event.get());
+            });
     }
 }
 
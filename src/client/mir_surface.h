@@ -45,6 +45,8 @@ namespace mir
 namespace dispatch
 {
 class ThreadedDispatcher;
+class MultiplexingDispatchable;
+class ActionQueue;
 }
 namespace input
 {
@@ -270,6 +272,11 @@ private:
     std::function<void(MirEvent const*)> handle_event_callback;
     std::function<void(MirWindowEvent const*)> handle_drag_and_drop_start_callback = [](auto){};
 
+    // Event callbacks run from here, so that slow handlers don't hold up the server socket
+    struct EventCallbackGuard;
+    std::shared_ptr<EventCallbackGuard> const event_callback_guard;
+    std::shared_ptr<mir::dispatch::ActionQueue> const event_queue;
+    std::shared_ptr<mir::dispatch::MultiplexingDispatchable> event_dispatcher;
     std::shared_ptr<mir::dispatch::ThreadedDispatcher> input_thread;
 
     //a bit batty, but the creation handle has to exist for as long as the MirSurface does,
@@ -0,0 +1,155 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "platform_module_cache.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace mcl = mir::client;
+
+namespace
+{
+struct Entry
+{
+    std::string key;
+    std::string module;
+    std::string identity;
+};
+
+// Fields are separated by tabs and entries by newlines
+bool storable(std::string const& field)
+{
+    return field.find_first_of("\t\n") == std::string::npos;
+}
+
+std::string identity_of(std::string const& path)
+{
+    struct stat info;
+    if (stat(path.c_str(), &info) < 0)
+        return {};
+
+    std::ostringstream identity;
+    identity << info.st_dev << ' ' << info.st_ino << ' ' << info.st_size << ' '
+             << info.st_mtim.tv_sec << ' ' << info.st_mtim.tv_nsec;
+    return identity.str();
+}
+
+std::vector<Entry> read_entries(std::string const& filename)
+{
+    std::vector<Entry> entries;
+
+    std::ifstream in{filename};
+    std::string line;
+    while (std::getline(in, line))
+    {
+        auto const first = line.find('\t');
+        if (first == std::string::npos)
+            continue;
+        auto const second = line.find('\t', first + 1);
+        if (second == std::string::npos)
+            continue;
+
+        entries.push_back(
+            {line.substr(0, first), line.substr(first + 1, second - first - 1), line.substr(second + 1)});
+    }
+
+    return entries;
+}
+
+void create_parent_directories(std::string const& filename)
+{
+    for (auto slash = filename.find('/', 1); slash != std::string::npos; slash = filename.find('/', slash + 1))
+        mkdir(filename.substr(0, slash).c_str(), 0700);
+}
+}
+
+mcl::PlatformModuleCache::PlatformModuleCache(std::string const& filename) :
+    filename{filename}
+{
+}
+
+mir::optional_value<std::string> mcl::PlatformModuleCache::lookup(std::string const& key) const
+{
+    if (filename.empty())
+        return {};
+
+    for (auto const& entry : read_entries(filename))
+    {
+        if (entry.key == key)
+        {
+            if (entry.identity == identity_of(entry.module))
+                return entry.module;
+            return {};
+        }
+    }
+
+    return {};
+}
+
+void mcl::PlatformModuleCache::record(std::string const& key, std::string const& module)
+{
+    if (filename.empty() || !storable(key) || !storable(module))
+        return;
+
+    auto const identity = identity_of(module);
+    if (identity.empty())
+        return;
+
+    auto entries = read_entries(filename);
+    entries.erase(
+        std::remove_if(entries.begin(), entries.end(), [&key](Entry const& entry) { return entry.key == key; }),
+        entries.end());
+    entries.push_back({key, module, identity});
+
+    std::ostringstream contents;
+    for (auto const& entry : entries)
+        contents << entry.key << '\t' << entry.module << '\t' << entry.identity << '\n';
+    auto const data = contents.str();
+
+    // Replace the file atomically, so concurrent clients never read a partial cache
+    create_parent_directories(filename);
+    std::string temporary{filename + ".XXXXXX"};
+    int const fd = mkstemp(&temporary[0]);
+    if (fd < 0)
+        return;
+
+    bool const written = write(fd, data.data(), data.size()) == static_cast<ssize_t>(data.size());
+    close(fd);
+
+    if (!written || rename(temporary.c_str(), filename.c_str()) < 0)
+        unlink(temporary.c_str());
+}
+
+std::string mcl::PlatformModuleCache::default_filename()
+{
+    // The XDG base directory specification says to ignore relative paths
+    auto const xdg_cache_home = getenv("XDG_CACHE_HOME");
+    if (xdg_cache_home && xdg_cache_home[0] == '/')
+        return std::string{xdg_cache_home} + "/mir/client-platform-modules";
+
+    auto const home = getenv("HOME");
+    if (home && home[0] == '/')
+        return std::string{home} + "/.cache/mir/client-platform-modules";
+
+    return {};
+}
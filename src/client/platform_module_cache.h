@@ -0,0 +1,57 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_CLIENT_PLATFORM_MODULE_CACHE_H_
+#define MIR_CLIENT_PLATFORM_MODULE_CACHE_H_
+
+#include "mir/optional_value.h"
+
+#include <string>
+
+namespace mir
+{
+namespace client
+{
+/**
+ * Remembers, across client processes, which client platform module was
+ * chosen for a server platform, so that later clients load only that module.
+ *
+ * Each entry records the identity of the module file (device, inode, size
+ * and modification time). An entry whose file has since been replaced,
+ * upgraded or removed is ignored, so a stale cache costs a probe but never
+ * selects the wrong module.
+ */
+class PlatformModuleCache
+{
+public:
+    explicit PlatformModuleCache(std::string const& filename);
+
+    /// The module recorded for key, if its file hasn't changed since
+    optional_value<std::string> lookup(std::string const& key) const;
+
+    /// Best effort: a cache that can't be written only costs the next client a probe
+    void record(std::string const& key, std::string const& module);
+
+    /// $XDG_CACHE_HOME/mir/client-platform-modules, or empty if there's no cache directory
+    static std::string default_filename();
+
+private:
+    std::string const filename;
+};
+}
+}
+
+#endif /* MIR_CLIENT_PLATFORM_MODULE_CACHE_H_ */
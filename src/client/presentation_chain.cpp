@@ -28,7 +28,6 @@
 namespace mcl = mir::client;
 namespace geom = mir::geometry;
 namespace mp = mir::protobuf;
-namespace gp = google::protobuf;
 
 mcl::PresentationChain::PresentationChain(
     MirConnection* connection,
@@ -45,18 +44,6 @@ mcl::PresentationChain::PresentationChain(
 {
 }
 
-//note: the caller of the mir::client::rpc::DisplayServer interface
-//      has to provide the object for the server to fill when we get a
-//      response, but we can't pass ownership of the response object to
-//      the server given the current interface, nor do we know when the
-//      server has been destroyed, so we have to allow for responses
-//      to complete after the PresentationChain object has been deleted.
-//      (mcl::BufferStream has a similar situation)
-static void ignore_response(mp::Void* response)
-{
-    delete response;
-}
-
 void mcl::PresentationChain::submit_buffer(MirBuffer* buffer)
 {
     mp::BufferRequest request;
@@ -66,8 +53,7 @@ void mcl::PresentationChain::submit_buffer(MirBuffer* buffer)
         buffer->submitted();
     }
 
-    auto ignored = new mp::Void;
-    server.submit_buffer(&request, ignored, gp::NewCallback(ignore_response, ignored));
+    server.submit_buffer(&request, nullptr, nullptr);
 }
 
 int mcl::PresentationChain::rpc_id() const
@@ -1,23 +1,69 @@
 #include "probing_client_platform_factory.h"
+#include "platform_module_cache.h"
 #include "mir/client/client_platform.h"
+#include "mir/client/client_context.h"
 #include "mir/shared_library.h"
 #include "mir/shared_library_prober.h"
 #include "mir/shared_library_prober_report.h"
 
 #include <boost/exception/all.hpp>
+#include <algorithm>
+#include <sstream>
 #include <stdexcept>
 
 namespace mcl = mir::client;
 
+namespace
+{
+bool is_appropriate(mir::SharedLibrary const& module, mcl::ClientContext* context)
+{
+    try
+    {
+        auto probe = module.load_function<mcl::ClientPlatformProbe>("is_appropriate_module", CLIENT_PLATFORM_VERSION);
+        return probe(context);
+    }
+    catch (std::runtime_error const&)
+    {
+        // Assume we were handed a SharedLibrary that's not a client platform module of the correct vintage.
+        return false;
+    }
+}
+
+// A module chosen for one server platform and set of paths says nothing about any other
+std::string cache_key_for(mcl::ClientContext* context, std::vector<std::string> const& paths)
+{
+    MirModuleProperties server_module;
+    context->populate_graphics_module(server_module);
+
+    std::ostringstream key;
+    key << server_module.name << ' '
+        << server_module.major_version << '.' << server_module.minor_version << '.' << server_module.micro_version;
+    for (auto const& path : paths)
+        key << ' ' << path;
+    return key.str();
+}
+
+// Client platform modules are named <module>.so or <module>.so.<abi>
+bool is_file_of_module(std::string const& file, std::string const& module)
+{
+    auto const name = file.substr(file.rfind('/') + 1);
+    auto const prefix = module + ".so";
+    return name.compare(0, prefix.size(), prefix) == 0 &&
+           (name.size() == prefix.size() || name[prefix.size()] == '.');
+}
+}
+
 mcl::ProbingClientPlatformFactory::ProbingClientPlatformFactory(
     std::shared_ptr<mir::SharedLibraryProberReport> const& rep,
     StringList const& force_libs,
     StringList const& lib_paths,
-    std::shared_ptr<mir::logging::Logger> const& logger)
+    std::shared_ptr<mir::logging::Logger> const& logger,
+    std::shared_ptr<PlatformModuleCache> const& module_cache)
     : shared_library_prober_report{rep},
       platform_overrides{force_libs},
       platform_paths{lib_paths},
-      logger{logger}
+      logger{logger},
+      module_cache{module_cache}
 {
     if (platform_overrides.empty() && platform_paths.empty())
     {
@@ -30,27 +76,8 @@ std::shared_ptr<mcl::ClientPlatform>
 mcl::ProbingClientPlatformFactory::create_client_platform(mcl::ClientContext* context)
 {
     // Note we don't want to keep unused platform modules loaded any longer
-    // than it takes to choose the right one. So this list is local:
-    std::vector<std::shared_ptr<mir::SharedLibrary>> platform_modules;
-
-    auto const module_selector = [context, &platform_modules](std::shared_ptr<mir::SharedLibrary> const& module)
-    {
-        try
-        {
-            auto probe = module->load_function<ClientPlatformProbe>("is_appropriate_module", CLIENT_PLATFORM_VERSION);
-            if (probe(context))
-            {
-                platform_modules.push_back(module);
-                return Selection::quit;
-            }
-        }
-        catch (std::runtime_error const&)
-        {
-            // Assume we were handed a SharedLibrary that's not a client platform module of the correct vintage.
-        }
-
-        return Selection::persist;
-    };
+    // than it takes to choose the right one. So this is local:
+    std::shared_ptr<mir::SharedLibrary> platform_module;
 
     if (!platform_overrides.empty())
     {
@@ -60,19 +87,88 @@ mcl::ProbingClientPlatformFactory::create_client_platform(mcl::ClientContext* co
         // if you really wanted to.
 
         for (auto const& platform : platform_overrides)
-            module_selector(std::make_shared<mir::SharedLibrary>(platform));
+        {
+            auto const module = std::make_shared<mir::SharedLibrary>(platform);
+            if (is_appropriate(*module, context))
+            {
+                platform_module = module;
+                break;
+            }
+        }
     }
     else
     {
-        for (auto const& path : platform_paths)
-            select_libraries_for_path(path, module_selector, *shared_library_prober_report);
+        platform_module = probe_paths(context);
     }
 
-    for (auto& module : platform_modules)
+    if (platform_module)
     {
-        auto factory = module->load_function<CreateClientPlatform>("create_client_platform", CLIENT_PLATFORM_VERSION);
+        auto factory = platform_module->load_function<CreateClientPlatform>("create_client_platform", CLIENT_PLATFORM_VERSION);
         return factory(context, logger);
     }
 
     BOOST_THROW_EXCEPTION(std::runtime_error{"No appropriate client platform module found"});
 }
+
+std::shared_ptr<mir::SharedLibrary>
+mcl::ProbingClientPlatformFactory::probe_paths(mcl::ClientContext* context) const
+{
+    std::vector<std::string> files;
+    for (auto const& path : platform_paths)
+    {
+        auto const path_files = library_files_for_path(path, *shared_library_prober_report);
+        files.insert(files.end(), path_files.begin(), path_files.end());
+    }
+
+    // Loading a module costs several milliseconds, so try to load only the right one:
+    // first the one we chose for this server platform last time (if it's still one of
+    // ours: anyone who can write the cache mustn't be able to choose what we load)...
+    auto const key = cache_key_for(context, platform_paths);
+    if (module_cache)
+    {
+        auto const cached = module_cache->lookup(key);
+        if (cached && std::find(files.begin(), files.end(), cached.value()) != files.end())
+        {
+            if (auto const module = probe_file(context, cached.value()))
+                return module;
+        }
+    }
+
+    // ...then the one the server says it expects, and only then every module we have
+    auto const hint = context->client_module_hint();
+    if (!hint.empty())
+    {
+        std::stable_partition(files.begin(), files.end(),
+            [&hint](std::string const& file) { return is_file_of_module(file, hint); });
+    }
+
+    for (auto const& file : files)
+    {
+        if (auto const module = probe_file(context, file))
+        {
+            if (module_cache)
+                module_cache->record(key, file);
+            return module;
+        }
+    }
+
+    return nullptr;
+}
+
+std::shared_ptr<mir::SharedLibrary>
+mcl::ProbingClientPlatformFactory::probe_file(mcl::ClientContext* context, std::string const& file) const
+{
+    try
+    {
+        shared_library_prober_report->loading_library(file);
+        auto const module = std::make_shared<mir::SharedLibrary>(file);
+        if (is_appropriate(*module, context))
+            return module;
+    }
+    catch (std::runtime_error const& err)
+    {
+        shared_library_prober_report->loading_failed(file, err);
+    }
+
+    return nullptr;
+}
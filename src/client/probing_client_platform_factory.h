@@ -12,6 +12,8 @@ class SharedLibraryProberReport;
 
 namespace client
 {
+class PlatformModuleCache;
+
 class ProbingClientPlatformFactory : public ClientPlatformFactory
 {
 public:
@@ -20,15 +22,20 @@ public:
         std::shared_ptr<mir::SharedLibraryProberReport> const& rep,
         StringList const& force_libs,
         StringList const& lib_paths,
-        std::shared_ptr<mir::logging::Logger> const& logger);
+        std::shared_ptr<mir::logging::Logger> const& logger,
+        std::shared_ptr<PlatformModuleCache> const& module_cache);
 
     std::shared_ptr<ClientPlatform> create_client_platform(ClientContext *context) override;
 
 private:
+    std::shared_ptr<mir::SharedLibrary> probe_paths(ClientContext* context) const;
+    std::shared_ptr<mir::SharedLibrary> probe_file(ClientContext* context, std::string const& file) const;
+
     std::shared_ptr<mir::SharedLibraryProberReport> const shared_library_prober_report;
     StringList const platform_overrides;
     StringList const platform_paths;
     std::shared_ptr<mir::logging::Logger> const logger;
+    std::shared_ptr<PlatformModuleCache> const module_cache;
 };
 
 }
@@ -26,6 +26,7 @@
 #include "mir/protobuf/protocol_version.h"
 #include "mir/log.h"
 
+#include <algorithm>
 #include <sstream>
 
 namespace mclr = mir::client::rpc;
@@ -33,6 +34,9 @@ namespace mclrd = mir::client::rpc::detail;
 
 namespace
 {
+// Enough for the results of no_reply calls to arrive before being forgotten
+size_t const max_no_reply_calls = 256;
+
 int get_protocol_version()
 {
     auto protocol_version = mir::protobuf::current_protocol_version();
@@ -66,17 +70,31 @@ void mclrd::PendingCallCache::save_completion_details(
     pending_calls[invoke.id()] = PendingCall(response, complete);
 }
 
+void mclrd::PendingCallCache::save_no_reply(mir::protobuf::wire::Invocation const& invoke)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    if (no_reply_calls.size() == max_no_reply_calls)
+        no_reply_calls.pop_front();
+    no_reply_calls.push_back(invoke.id());
+}
+
 void mclrd::PendingCallCache::populate_message_for_result(
     mir::protobuf::wire::Result& result,
     std::function<void(google::protobuf::MessageLite*)> const& populator)
 {
     std::unique_lock<std::mutex> lock(mutex);
-    populator(pending_calls.at(result.id()).response);
+
+    // No response is waiting for the results of no_reply calls
+    auto const call = pending_calls.find(result.id());
+    if (call != pending_calls.end() && call->second.response)
+        populator(call->second.response);
 }
 
 void mclrd::PendingCallCache::complete_response(mir::protobuf::wire::Result& result)
 {
     PendingCall completion;
+    bool no_reply{false};
 
     {
         std::unique_lock<std::mutex> lock(mutex);
@@ -86,17 +104,47 @@ void mclrd::PendingCallCache::complete_response(mir::protobuf::wire::Result& res
             completion = std::move(call->second);
             pending_calls.erase(call);
         }
+        else
+        {
+            auto const no_reply_call = std::find(no_reply_calls.begin(), no_reply_calls.end(), result.id());
+            if (no_reply_call != no_reply_calls.end())
+            {
+                no_reply_calls.erase(no_reply_call);
+                no_reply = true;
+            }
+        }
         ++running_callbacks;
     }
 
-    if (!completion.complete)
+    if (completion.complete)
     {
-        rpc_report->orphaned_result(result);
+        rpc_report->complete_response(result);
+        completion.complete->Run();
     }
-    else
+    else if (no_reply)
     {
         rpc_report->complete_response(result);
-        completion.complete->Run();
+
+        // Nothing else will hear of the error, so log it
+        mir::protobuf::Void response;
+        if (response.ParseFromString(result.response()))
+        {
+            if (response.has_error())
+            {
+                mir::log(mir::logging::Severity::error, MIR_LOG_COMPONENT,
+                         "Call with no reply failed: %s", response.error().c_str());
+            }
+            else if (response.has_structured_error())
+            {
+                mir::log(mir::logging::Severity::error, MIR_LOG_COMPONENT,
+                         "Call with no reply failed: error %u in domain %u",
+                         response.structured_error().code(), response.structured_error().domain());
+            }
+        }
+    }
+    else
+    {
+        rpc_report->orphaned_result(result);
     }
 
     {
@@ -136,6 +184,46 @@ void mclrd::PendingCallCache::wait_till_complete() const
         pending_calls_shrank.wait(lock);
 }
 
+mclrd::EventSequencer::EventSequencer(std::function<void(std::string const& raw)> const& process) :
+    process{process}
+{
+}
+
+void mclrd::EventSequencer::deliver(uint64_t sequence, std::string const& raw)
+{
+    std::unique_lock<decltype(mutex)> lock{mutex};
+
+    waiting.emplace(sequence, raw);
+
+    // Whichever thread is already delivering will get to this event
+    if (delivering)
+        return;
+
+    delivering = true;
+
+    while (!waiting.empty() && waiting.begin()->first == next)
+    {
+        auto const event = std::move(waiting.begin()->second);
+        waiting.erase(waiting.begin());
+        ++next;
+
+        lock.unlock();
+        try
+        {
+            process(event);
+        }
+        catch (...)
+        {
+            lock.lock();
+            delivering = false;
+            throw;
+        }
+        lock.lock();
+    }
+
+    delivering = false;
+}
+
 mclr::MirBasicRpcChannel::MirBasicRpcChannel() :
     next_message_id(0),
     protocol_version{get_protocol_version()}
@@ -21,11 +21,13 @@
 
 #include <memory>
 #include <map>
+#include <deque>
 #include <mutex>
 #include <atomic>
 #include <vector>
 #include <condition_variable>
 #include <functional>
+#include <string>
 
 namespace google
 {
@@ -68,6 +70,9 @@ public:
         google::protobuf::MessageLite* response,
         google::protobuf::Closure* complete);
 
+    /// Remembers an invocation sent with no_reply. The server answers those
+    /// only on error (or, if it predates no_reply, always).
+    void save_no_reply(mir::protobuf::wire::Invocation const& invoke);
 
     void populate_message_for_result(
         mir::protobuf::wire::Result& result,
@@ -101,8 +106,32 @@ private:
     std::condition_variable mutable pending_calls_shrank;
     int running_callbacks = 0;
     std::map<int, PendingCall> pending_calls;
+    // Servers that know no_reply never answer most of these, so only the
+    // latest are kept
+    std::deque<uint32_t> no_reply_calls;
     std::shared_ptr<RpcReport> const rpc_report;
 };
+
+/**
+ * Puts events that arrive by different routes (the socket and the event ring)
+ * back into the order the server sent them.
+ */
+class EventSequencer
+{
+public:
+    EventSequencer(std::function<void(std::string const& raw)> const& process);
+
+    /// Processes the event once every event the server sent before it has been
+    void deliver(uint64_t sequence, std::string const& raw);
+
+private:
+    std::function<void(std::string const& raw)> const process;
+
+    std::mutex mutex;
+    uint64_t next{0};
+    bool delivering{false};
+    std::map<uint64_t, std::string> waiting;
+};
 }
 
 class MirBasicRpcChannel
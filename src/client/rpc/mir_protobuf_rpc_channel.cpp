@@ -35,6 +35,7 @@
 #include "mir/variable_length_array.h"
 #include "mir/events/event_builders.h"
 #include "mir/events/event_private.h"
+#include "mir/events/event_ring.h"
 #include "mir/events/surface_placement_event.h"
 
 #include "mir_protobuf.pb.h"  // For Buffer frig
@@ -78,6 +79,7 @@ mclr::MirProtobufRpcChannel::MirProtobufRpcChannel(
     ping_handler{ping_handler},
     error_handler{error_handler},
     event_sink(event_sink),
+    event_sequencer{[this](std::string const& raw) { process_or_report_raw_event(raw); }},
     disconnected(false),
     transport{std::move(transport)},
     delayed_processor{std::make_shared<md::ActionQueue>()},
@@ -144,6 +146,7 @@ void mclr::MirProtobufRpcChannel::receive_file_descriptors(google::protobuf::Mes
     mir::protobuf::Platform* platform = nullptr;
     mir::protobuf::SocketFD* socket_fd = nullptr;
     mir::protobuf::PlatformOperationMessage* platform_operation_message = nullptr;
+    mir::protobuf::EventRing* event_ring = nullptr;
 
     if (message_type == "mir.protobuf.Buffer")
     {
@@ -176,6 +179,8 @@ void mclr::MirProtobufRpcChannel::receive_file_descriptors(google::protobuf::Mes
         auto connection = static_cast<mir::protobuf::Connection*>(response);
         if (connection && connection->has_platform())
             platform = connection->mutable_platform();
+        if (connection && connection->has_event_ring())
+            event_ring = connection->mutable_event_ring();
     }
     else if (message_type == "mir.protobuf.SocketFD")
     {
@@ -189,9 +194,56 @@ void mclr::MirProtobufRpcChannel::receive_file_descriptors(google::protobuf::Mes
 
     receive_any_file_descriptors_for(surface);
     receive_any_file_descriptors_for(buffer);
+    if (surface && surface->has_buffer_stream())
+    {
+        for (auto& preallocated : *surface->mutable_buffer_stream()->mutable_preallocated_buffer())
+            receive_any_file_descriptors_for(&preallocated);
+    }
     receive_any_file_descriptors_for(platform);
+    receive_any_file_descriptors_for(event_ring);
     receive_any_file_descriptors_for(socket_fd);
     receive_any_file_descriptors_for(platform_operation_message);
+
+    if (event_ring)
+        use_event_ring(*event_ring);
+}
+
+void mclr::MirProtobufRpcChannel::use_event_ring(mp::EventRing const& ring_fds)
+{
+    std::vector<mir::Fd> fds;
+    for (auto const fd : ring_fds.fd())
+        fds.emplace_back(fd);
+
+    std::shared_ptr<mev::EventRing> ring;
+    try
+    {
+        if (fds.size() == 2)
+            ring = std::make_shared<mev::EventRing>(fds[0], fds[1]);
+    }
+    catch (std::exception const&)
+    {
+    }
+
+    if (!ring)
+    {
+        // The server won't use a ring we haven't mapped, so every event comes
+        // over the socket: don't hold them back waiting for missing numbers
+        event_ring_unusable = true;
+        return;
+    }
+
+    // Events in the ring don't need the socket, so don't contend for read_mutex
+    multiplexer.add_watch(
+        ring->wakeup_fd(),
+        [this, ring]()
+        {
+            ring->clear_wakeup();
+
+            std::string raw;
+            uint64_t sequence;
+            while (ring->pop(raw, sequence))
+                event_sequencer.deliver(sequence, raw);
+        });
 }
 
 void mclr::MirProtobufRpcChannel::call_method(
@@ -234,13 +286,20 @@ void mclr::MirProtobufRpcChannel::call_method(
             fds.emplace_back(mir::Fd{IntOwnedFd{fd}});
     }
 
-    auto const& invocation = invocation_for(method_name, parameters, fds.size());
+    auto invocation = invocation_for(method_name, parameters, fds.size());
+
+    // Nothing to complete, so the server needn't send a result
+    if (!complete)
+        invocation.set_no_reply(true);
 
     rpc_report->invocation_requested(invocation);
 
-    pending_calls.save_completion_details(invocation, response, complete);
+    if (complete)
+        pending_calls.save_completion_details(invocation, response, complete);
+    else
+        pending_calls.save_no_reply(invocation);
 
-    if (prioritise_next_request)
+    if (complete && prioritise_next_request)
     {
         id_to_wait_for = invocation.id();
         prioritise_next_request = false;
@@ -404,65 +463,80 @@ void mclr::MirProtobufRpcChannel::process_event_sequence(std::string const& even
         {
             // In future, events might be compressed where possible.
             // But that's a job for later...
-            try
-            {
-                auto e = MirEvent::deserialize(event.raw());
-                if (e)
-                {
-                    rpc_report->event_parsing_succeeded(*e);
+            if (event.has_sequence() && !event_ring_unusable)
+                event_sequencer.deliver(event.sequence(), event.raw());
+            else
+                process_or_report_raw_event(event.raw());
+        }
+    }
+}
 
-                    int window_id = 0;
-                    bool is_window_event = true;
+void mclr::MirProtobufRpcChannel::process_or_report_raw_event(std::string const& raw)
+{
+    try
+    {
+        process_raw_event(raw);
+    }
+    catch(...)
+    {
+        mp::Event event;
+        event.set_raw(raw);
+        rpc_report->event_parsing_failed(event);
+    }
+}
 
-                    switch (e->type())
-                    {
-                    case mir_event_type_window:
-                        window_id = e->to_surface()->id();
-                        break;
-                    case mir_event_type_resize:
-                        window_id = e->to_resize()->surface_id();
-                        break;
-                    case mir_event_type_orientation:
-                        window_id = e->to_orientation()->surface_id();
-                        break;
-                    case mir_event_type_close_window:
-                        window_id = e->to_close_window()->surface_id();
-                        break;
-                    case mir_event_type_keymap:
-                        input_report->received_event(*e);
-                        window_id = e->to_keymap()->surface_id();
-                        break;
-                    case mir_event_type_window_output:
-                        window_id = e->to_window_output()->surface_id();
-                        break;
-                    case mir_event_type_window_placement:
-                        window_id = e->to_window_placement()->id();
-                        break;
-                    case mir_event_type_input:
-                        input_report->received_event(*e);
-                        window_id = e->to_input()->window_id();
-                        break;
-                    case mir_event_type_input_device_state:
-                        input_report->received_event(*e);
-                        window_id = e->to_input_device_state()->window_id();
-                        break;
-                    default:
-                        is_window_event = false;
-                        event_sink->handle_event(*e);
-                    }
+void mclr::MirProtobufRpcChannel::process_raw_event(std::string const& raw)
+{
+    auto e = MirEvent::deserialize(raw);
+    if (e)
+    {
+        rpc_report->event_parsing_succeeded(*e);
 
-                    if (is_window_event)
-                        if (auto map = surface_map.lock())
-                            if (auto surf = map->surface(mf::SurfaceId(window_id)))
-                                surf->handle_event(*e);
+        int window_id = 0;
+        bool is_window_event = true;
 
-                }
-            }
-            catch(...)
-            {
-                rpc_report->event_parsing_failed(event);
-            }
+        switch (e->type())
+        {
+        case mir_event_type_window:
+            window_id = e->to_surface()->id();
+            break;
+        case mir_event_type_resize:
+            window_id = e->to_resize()->surface_id();
+            break;
+        case mir_event_type_orientation:
+            window_id = e->to_orientation()->surface_id();
+            break;
+        case mir_event_type_close_window:
+            window_id = e->to_close_window()->surface_id();
+            break;
+        case mir_event_type_keymap:
+            input_report->received_event(*e);
+            window_id = e->to_keymap()->surface_id();
+            break;
+        case mir_event_type_window_output:
+            window_id = e->to_window_output()->surface_id();
+            break;
+        case mir_event_type_window_placement:
+            window_id = e->to_window_placement()->id();
+            break;
+        case mir_event_type_input:
+            input_report->received_event(*e);
+            window_id = e->to_input()->window_id();
+            break;
+        case mir_event_type_input_device_state:
+            input_report->received_event(*e);
+            window_id = e->to_input_device_state()->window_id();
+            break;
+        default:
+            is_window_event = false;
+            event_sink->handle_event(*e);
         }
+
+        if (is_window_event)
+            if (auto map = surface_map.lock())
+                if (auto surf = map->surface(mf::SurfaceId(window_id)))
+                    surf->handle_event(*e);
+
     }
 }
 
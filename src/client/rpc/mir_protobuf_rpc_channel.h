@@ -35,6 +35,7 @@
 
 namespace mir
 {
+namespace protobuf { class EventRing; }
 
 namespace input
 {
@@ -131,6 +132,9 @@ private:
 
     void read_message();
     void process_event_sequence(std::string const& event);
+    void process_raw_event(std::string const& raw);
+    void process_or_report_raw_event(std::string const& raw);
+    void use_event_ring(mir::protobuf::EventRing const& ring_fds);
 
     void notify_disconnected();
 
@@ -142,6 +146,8 @@ private:
     std::shared_ptr<PingHandler> const ping_handler;
     std::shared_ptr<ErrorHandler> const error_handler;
     std::shared_ptr<EventSink> event_sink;
+    detail::EventSequencer event_sequencer;
+    std::atomic<bool> event_ring_unusable{false};
     std::atomic<bool> disconnected;
     std::mutex read_mutex;
     std::mutex write_mutex;
@@ -0,0 +1,246 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/events/event_ring.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <linux/memfd.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace mev = mir::events;
+
+static_assert(ATOMIC_INT_LOCK_FREE == 2, "EventRing needs address-free atomics to share them between processes");
+
+namespace
+{
+uint32_t const slot_count{256};
+size_t const slot_size{512};
+// Changes whenever the layout below does
+uint32_t const ring_magic{0x4d455203};
+}
+
+struct mev::detail::EventRingHeader
+{
+    uint32_t magic;
+    // Set by the consumer once it has mapped the ring; until then events go elsewhere
+    std::atomic<uint32_t> consumer_attached;
+    // Kept on separate cache lines so that the two sides don't contend
+    alignas(64) std::atomic<uint32_t> write_index;
+    alignas(64) std::atomic<uint32_t> read_index;
+};
+
+struct mev::detail::EventRingSlot
+{
+    uint64_t sequence;
+    uint32_t size;
+    char data[slot_size - sizeof(uint64_t) - sizeof(uint32_t)];
+};
+
+static_assert(sizeof(mev::detail::EventRingSlot) == slot_size, "EventRingSlot has unexpected padding");
+
+size_t const mev::EventRing::max_event_size{sizeof(detail::EventRingSlot::data)};
+
+namespace
+{
+size_t const header_size{(sizeof(mev::detail::EventRingHeader) + 63) & ~size_t{63}};
+size_t const ring_size{header_size + slot_count * slot_size};
+int const required_seals{F_SEAL_SHRINK | F_SEAL_GROW};
+
+mir::Fd create_shm()
+{
+    mir::Fd fd{static_cast<int>(syscall(SYS_memfd_create, "mir-event-ring", MFD_CLOEXEC | MFD_ALLOW_SEALING))};
+    if (fd < 0)
+    {
+        BOOST_THROW_EXCEPTION(
+            std::system_error(errno, std::system_category(), "Failed to create event ring memory"));
+    }
+    if (ftruncate(fd, ring_size) < 0)
+    {
+        BOOST_THROW_EXCEPTION(
+            std::system_error(errno, std::system_category(), "Failed to size event ring memory"));
+    }
+    // The fd is shared with a client: stop it resizing the memory under our mapping
+    if (fcntl(fd, F_ADD_SEALS, required_seals | F_SEAL_SEAL) < 0)
+    {
+        BOOST_THROW_EXCEPTION(
+            std::system_error(errno, std::system_category(), "Failed to seal event ring memory"));
+    }
+    return fd;
+}
+
+mir::Fd create_wakeup()
+{
+    mir::Fd fd{eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)};
+    if (fd < 0)
+    {
+        BOOST_THROW_EXCEPTION(
+            std::system_error(errno, std::system_category(), "Failed to create event ring wakeup"));
+    }
+    return fd;
+}
+
+void* map(mir::Fd const& shm)
+{
+    auto const mapping = mmap(nullptr, ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, shm, 0);
+    if (mapping == MAP_FAILED)
+    {
+        BOOST_THROW_EXCEPTION(
+            std::system_error(errno, std::system_category(), "Failed to map event ring"));
+    }
+    return mapping;
+}
+
+void* map_new(mir::Fd const& shm)
+{
+    auto const mapping = map(shm);
+    new (mapping) mev::detail::EventRingHeader{ring_magic, {0}, {0}, {0}};
+    return mapping;
+}
+
+void* map_existing(mir::Fd const& shm)
+{
+    struct stat info;
+    if ((fstat(shm, &info) < 0) || (static_cast<size_t>(info.st_size) != ring_size))
+        BOOST_THROW_EXCEPTION(std::runtime_error("Event ring has unexpected size"));
+
+    auto const seals = fcntl(shm, F_GET_SEALS);
+    if ((seals < 0) || ((seals & required_seals) != required_seals))
+        BOOST_THROW_EXCEPTION(std::runtime_error("Event ring memory can be resized"));
+
+    auto const mapping = map(shm);
+    if (static_cast<mev::detail::EventRingHeader*>(mapping)->magic != ring_magic)
+    {
+        munmap(mapping, ring_size);
+        BOOST_THROW_EXCEPTION(std::runtime_error("Event ring has unexpected layout"));
+    }
+    static_cast<mev::detail::EventRingHeader*>(mapping)->consumer_attached.store(1);
+    return mapping;
+}
+}
+
+mev::EventRing::EventRing() :
+    shm{create_shm()},
+    wakeup{create_wakeup()},
+    mapping{map_new(shm)},
+    header{static_cast<detail::EventRingHeader*>(mapping)},
+    slots{reinterpret_cast<detail::EventRingSlot*>(static_cast<char*>(mapping) + header_size)},
+    next_write{0}
+{
+}
+
+mev::EventRing::EventRing(Fd const& shm, Fd const& wakeup) :
+    shm{shm},
+    wakeup{wakeup},
+    mapping{map_existing(shm)},
+    header{static_cast<detail::EventRingHeader*>(mapping)},
+    slots{reinterpret_cast<detail::EventRingSlot*>(static_cast<char*>(mapping) + header_size)},
+    next_write{0}
+{
+}
+
+mev::EventRing::~EventRing() noexcept
+{
+    munmap(mapping, ring_size);
+}
+
+mir::Fd mev::EventRing::shm_fd() const
+{
+    return shm;
+}
+
+mir::Fd mev::EventRing::wakeup_fd() const
+{
+    return wakeup;
+}
+
+bool mev::EventRing::push(std::string const& event, uint64_t sequence)
+{
+    if (event.size() > max_event_size || !header->consumer_attached.load(std::memory_order_acquire))
+        return false;
+
+    // Unsigned arithmetic makes a read index from the future look full too
+    if (next_write - header->read_index.load(std::memory_order_acquire) >= slot_count)
+        return false;
+
+    auto& slot = slots[next_write % slot_count];
+    slot.sequence = sequence;
+    slot.size = event.size();
+    memcpy(slot.data, event.data(), event.size());
+
+    auto const written = next_write++;
+    header->write_index.store(next_write);
+
+    // The consumer only waits after reading everything before this event and
+    // finding nothing more. Together with the ordering in pop() this means we
+    // cannot both miss each other's update.
+    if (header->read_index.load() == written)
+    {
+        uint64_t const one{1};
+        if (write(wakeup, &one, sizeof one) < 0)
+        {
+            // EAGAIN means the counter is saturated, so the consumer is awake anyway
+        }
+    }
+
+    return true;
+}
+
+bool mev::EventRing::empty() const
+{
+    return header->read_index.load(std::memory_order_acquire) == next_write;
+}
+
+void mev::EventRing::clear_wakeup()
+{
+    uint64_t count;
+    if (read(wakeup, &count, sizeof count) < 0)
+    {
+        // EAGAIN means there was nothing to clear
+    }
+}
+
+bool mev::EventRing::pop(std::string& event)
+{
+    uint64_t sequence;
+    return pop(event, sequence);
+}
+
+bool mev::EventRing::pop(std::string& event, uint64_t& sequence)
+{
+    auto const read_index = header->read_index.load(std::memory_order_relaxed);
+    if (read_index == header->write_index.load())
+        return false;
+
+    auto const& slot = slots[read_index % slot_count];
+    sequence = slot.sequence;
+    event.assign(slot.data, std::min<size_t>(slot.size, max_event_size));
+
+    header->read_index.store(read_index + 1);
+    return true;
+}
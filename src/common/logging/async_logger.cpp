@@ -0,0 +1,338 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/logging/async_logger.h"
+#include "mir/logging/dumb_console_logger.h"
+#include "mir/thread_name.h"
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+namespace ml = mir::logging;
+
+namespace
+{
+struct Header
+{
+    std::uint32_t component_size;
+    std::uint32_t message_size;
+    ml::Severity severity;
+    timespec time;
+};
+
+std::atomic<std::uint64_t> next_logger_id{1};
+
+// The ring this thread logs to, for the logger with id logger_id
+struct ThreadRing
+{
+    std::uint64_t logger_id{0};
+    std::shared_ptr<void> ring;
+};
+
+thread_local ThreadRing thread_ring;
+
+void write_to_console(ml::Severity severity, std::string const& line, bool flush)
+{
+    auto const out = severity < ml::Severity::informational ? stderr : stdout;
+    fwrite(line.data(), 1, line.size(), out);
+
+    if (flush)
+    {
+        fflush(stdout);
+        fflush(stderr);
+    }
+}
+
+auto round_up_to_power_of_two(std::size_t size) -> std::size_t
+{
+    std::size_t result = 1;
+    while (result < size)
+        result <<= 1;
+    return result;
+}
+}
+
+// Single producer (the logging thread), single consumer (whoever holds write_mutex)
+class ml::AsyncLogger::Ring
+{
+public:
+    explicit Ring(std::size_t size) : buffer(round_up_to_power_of_two(size)), mask{buffer.size() - 1} {}
+
+    bool push(Header const& header, char const* component, char const* message)
+    {
+        auto const size = sizeof header + header.component_size + header.message_size;
+        auto const write_pos = head.load(std::memory_order_relaxed);
+
+        if (buffer.size() - (write_pos - tail.load(std::memory_order_acquire)) < size)
+            return false;
+
+        copy_in(write_pos, &header, sizeof header);
+        copy_in(write_pos + sizeof header, component, header.component_size);
+        copy_in(write_pos + sizeof header + header.component_size, message, header.message_size);
+
+        // seq_cst so that either the writer sees this or we see it is idle
+        head.store(write_pos + size, std::memory_order_seq_cst);
+        return true;
+    }
+
+    template<typename Receiver>
+    void pop_all(Receiver const& receive)
+    {
+        auto read_pos = tail.load(std::memory_order_relaxed);
+        auto const end = head.load(std::memory_order_acquire);
+
+        while (read_pos != end)
+        {
+            Header header;
+            copy_out(read_pos, &header, sizeof header);
+
+            std::string component(header.component_size, '\0');
+            copy_out(read_pos + sizeof header, &component[0], header.component_size);
+
+            std::string message(header.message_size, '\0');
+            copy_out(read_pos + sizeof header + header.component_size, &message[0], header.message_size);
+
+            read_pos += sizeof header + header.component_size + header.message_size;
+            receive(header, std::move(component), std::move(message));
+        }
+
+        tail.store(read_pos, std::memory_order_release);
+    }
+
+    bool empty() const
+    {
+        return head.load(std::memory_order_seq_cst) == tail.load(std::memory_order_acquire);
+    }
+
+private:
+    void copy_in(std::size_t pos, void const* data, std::size_t size)
+    {
+        auto const offset = pos & mask;
+        auto const first = std::min(size, buffer.size() - offset);
+        memcpy(buffer.data() + offset, data, first);
+        memcpy(buffer.data(), static_cast<char const*>(data) + first, size - first);
+    }
+
+    void copy_out(std::size_t pos, void* data, std::size_t size) const
+    {
+        auto const offset = pos & mask;
+        auto const first = std::min(size, buffer.size() - offset);
+        memcpy(data, buffer.data() + offset, first);
+        memcpy(static_cast<char*>(data) + first, buffer.data(), size - first);
+    }
+
+    std::vector<char> buffer;
+    std::size_t const mask;
+
+    // Positions only ever increase; they're reduced modulo the buffer size on use
+    std::atomic<std::size_t> head{0};
+    std::atomic<std::size_t> tail{0};
+};
+
+struct ml::AsyncLogger::Record
+{
+    timespec time;
+    Severity severity;
+    std::string component;
+    std::string message;
+};
+
+ml::AsyncLogger::AsyncLogger(std::size_t buffer_size, std::size_t max_threads) :
+    AsyncLogger{&write_to_console, buffer_size, max_threads}
+{
+}
+
+ml::AsyncLogger::AsyncLogger(Writer const& write, std::size_t buffer_size, std::size_t max_threads) :
+    write{write},
+    buffer_size{buffer_size},
+    max_threads{max_threads},
+    id{next_logger_id.fetch_add(1)},
+    writer{[this] { write_loop(); }}
+{
+}
+
+ml::AsyncLogger::~AsyncLogger()
+{
+    {
+        std::lock_guard<std::mutex> lock{write_mutex};
+        stopping = true;
+    }
+    wakeup.notify_one();
+    writer.join();
+}
+
+void ml::AsyncLogger::log(Severity severity, std::string const& message, std::string const& component)
+{
+    log(severity, message.data(), message.size(), component.data(), component.size());
+}
+
+void ml::AsyncLogger::log(char const* component, Severity severity, char const* format, ...)
+{
+    char message[4096];
+    va_list va;
+    va_start(va, format);
+    auto const size = vsnprintf(message, sizeof message, format, va);
+    va_end(va);
+
+    if (size >= 0)
+        log(severity, message, std::min<std::size_t>(size, sizeof message - 1), component, strlen(component));
+}
+
+void ml::AsyncLogger::log(
+    Severity severity, char const* message, std::size_t message_size, char const* component, std::size_t component_size)
+{
+    Header header{
+        static_cast<std::uint32_t>(component_size),
+        static_cast<std::uint32_t>(message_size),
+        severity,
+        {}};
+    clock_gettime(CLOCK_REALTIME, &header.time);
+
+    auto const ring = ring_for_this_thread();
+    if (!ring || !ring->push(header, component, message))
+        dropped_messages.fetch_add(1, std::memory_order_seq_cst);
+
+    if (severity <= Severity::error)
+    {
+        flush();
+        return;
+    }
+
+    // The writer only needs waking if it has found nothing to write. (The
+    // push, the drop count and writer_idle are all seq_cst, so either we see
+    // the writer is idle or it sees there is something to write.)
+    if (writer_idle.load(std::memory_order_seq_cst))
+    {
+        std::lock_guard<std::mutex> lock{write_mutex};
+        wakeup.notify_one();
+    }
+}
+
+void ml::AsyncLogger::flush()
+{
+    std::unique_lock<std::mutex> lock{write_mutex};
+    write_pending(lock);
+}
+
+auto ml::AsyncLogger::dropped() const -> std::uint64_t
+{
+    return dropped_messages.load(std::memory_order_seq_cst);
+}
+
+auto ml::AsyncLogger::ring_for_this_thread() -> Ring*
+{
+    if (thread_ring.logger_id == id)
+        return static_cast<Ring*>(thread_ring.ring.get());
+
+    std::lock_guard<std::mutex> lock{rings_mutex};
+
+    // Reclaim the buffers of threads that have exited (or moved to another logger)
+    rings.erase(
+        std::remove_if(rings.begin(), rings.end(),
+            [](std::shared_ptr<Ring> const& ring) { return ring.use_count() == 1 && ring->empty(); }),
+        rings.end());
+
+    if (rings.size() >= max_threads)
+        return nullptr;
+
+    auto const ring = std::make_shared<Ring>(buffer_size);
+    rings.push_back(ring);
+    thread_ring.logger_id = id;
+    thread_ring.ring = ring;
+    return ring.get();
+}
+
+bool ml::AsyncLogger::write_pending(std::unique_lock<std::mutex> const& /*lock*/)
+{
+    decltype(rings) current_rings;
+    {
+        std::lock_guard<std::mutex> lock{rings_mutex};
+        current_rings = rings;
+    }
+
+    std::vector<Record> records;
+    for (auto const& ring : current_rings)
+    {
+        ring->pop_all([&](Header const& header, std::string&& component, std::string&& message)
+            {
+                records.push_back({header.time, header.severity, std::move(component), std::move(message)});
+            });
+    }
+
+    auto const dropped_now = dropped();
+    if (dropped_now != reported_dropped)
+    {
+        timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        records.push_back({
+            now,
+            Severity::warning,
+            "logging",
+            std::to_string(dropped_now - reported_dropped) + " messages dropped: log buffer full"});
+        reported_dropped = dropped_now;
+    }
+
+    // Each thread's messages are in order, but they need merging with the others'
+    std::stable_sort(records.begin(), records.end(),
+        [](Record const& lhs, Record const& rhs)
+        {
+            return lhs.time.tv_sec < rhs.time.tv_sec ||
+                (lhs.time.tv_sec == rhs.time.tv_sec && lhs.time.tv_nsec < rhs.time.tv_nsec);
+        });
+
+    for (auto i = records.begin(); i != records.end(); ++i)
+        write(i->severity, format_log_line(i->severity, i->message, i->component, i->time), i + 1 == records.end());
+
+    return !records.empty();
+}
+
+void ml::AsyncLogger::write_loop()
+{
+    mir::set_thread_name("Mir/Logging");
+
+    std::unique_lock<std::mutex> lock{write_mutex};
+
+    while (!stopping)
+    {
+        if (write_pending(lock))
+        {
+            // Let a burst of messages accumulate rather than waking for each
+            wakeup.wait_for(lock, std::chrono::milliseconds{10});
+            continue;
+        }
+
+        writer_idle.store(true, std::memory_order_seq_cst);
+
+        if (!pending() && !stopping)
+            wakeup.wait(lock);
+
+        writer_idle.store(false, std::memory_order_seq_cst);
+    }
+
+    write_pending(lock);
+}
+
+bool ml::AsyncLogger::pending()
+{
+    if (dropped() != reported_dropped)
+        return true;
+
+    std::lock_guard<std::mutex> lock{rings_mutex};
+    return std::any_of(rings.begin(), rings.end(), [](std::shared_ptr<Ring> const& ring) { return !ring->empty(); });
+}
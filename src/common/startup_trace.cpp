@@ -0,0 +1,160 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/startup_trace.h"
+#include "mir/log.h"
+
+#include <boost/core/demangle.hpp>
+
+#include <algorithm>
+#include <mutex>
+#include <thread>
+
+using namespace std::chrono;
+
+struct mir::StartupTrace::Recording
+{
+    steady_clock::time_point const start{steady_clock::now()};
+
+    std::mutex mutable mutex;
+    std::vector<std::thread::id> threads;
+    std::vector<Step> steps;
+
+    void add(Step step)
+    {
+        auto const this_thread = std::this_thread::get_id();
+
+        std::lock_guard<decltype(mutex)> lock{mutex};
+
+        auto thread = std::find(begin(threads), end(threads), this_thread);
+        if (thread == end(threads))
+            thread = threads.insert(thread, this_thread);
+
+        step.thread = thread - begin(threads);
+        steps.push_back(std::move(step));
+    }
+
+    // The recording steps are added to
+    static std::mutex current_mutex;
+    static std::weak_ptr<Recording> current;
+
+    static auto current_recording() -> std::shared_ptr<Recording>
+    {
+        std::lock_guard<decltype(current_mutex)> lock{current_mutex};
+        return current.lock();
+    }
+};
+
+std::mutex mir::StartupTrace::Recording::current_mutex;
+std::weak_ptr<mir::StartupTrace::Recording> mir::StartupTrace::Recording::current;
+
+namespace
+{
+thread_local mir::StartupTrace::Scope* innermost{nullptr};
+
+auto in_ms(nanoseconds interval) -> double
+{
+    return duration_cast<duration<double, std::milli>>(interval).count();
+}
+}
+
+mir::StartupTrace::StartupTrace() :
+    recording{std::make_shared<Recording>()}
+{
+    std::lock_guard<decltype(Recording::current_mutex)> lock{Recording::current_mutex};
+    Recording::current = recording;
+}
+
+mir::StartupTrace::~StartupTrace()
+{
+    std::lock_guard<decltype(Recording::current_mutex)> lock{Recording::current_mutex};
+    if (Recording::current.lock() == recording)
+        Recording::current.reset();
+}
+
+auto mir::StartupTrace::steps() const -> std::vector<Step>
+{
+    std::vector<Step> result;
+    {
+        std::lock_guard<decltype(recording->mutex)> lock{recording->mutex};
+        result = recording->steps;
+    }
+
+    // Steps are recorded as they finish, so those within a step come before it
+    std::stable_sort(begin(result), end(result), [](Step const& a, Step const& b) { return a.start < b.start; });
+    return result;
+}
+
+void mir::StartupTrace::log() const
+{
+    auto const completed = steps();
+
+    mir::log(logging::Severity::informational, "startup",
+        "%zu steps taken in %.3fms (start, duration, exclusive of nested steps, thread):",
+        completed.size(), in_ms(steady_clock::now() - recording->start));
+
+    for (auto const& step : completed)
+    {
+        mir::log(logging::Severity::informational, "startup",
+            "%9.3fms %9.3fms %9.3fms [%u] %*s%s",
+            in_ms(step.start), in_ms(step.duration), in_ms(step.exclusive), step.thread,
+            2 * step.depth, "", step.name.c_str());
+    }
+}
+
+mir::StartupTrace::Scope::Scope(char const* name) :
+    Scope{name, nullptr}
+{
+}
+
+mir::StartupTrace::Scope::Scope(std::type_info const& type) :
+    Scope{nullptr, &type}
+{
+}
+
+mir::StartupTrace::Scope::Scope(char const* name, std::type_info const* type) :
+    recording{Recording::current_recording()},
+    name{name},
+    type{type},
+    parent{recording && innermost && innermost->recording == recording ? innermost : nullptr},
+    depth{parent ? parent->depth + 1 : 0},
+    start{recording ? steady_clock::now() : steady_clock::time_point{}}
+{
+    if (recording)
+        innermost = this;
+}
+
+mir::StartupTrace::Scope::~Scope()
+{
+    if (!recording)
+        return;
+
+    auto const elapsed = duration_cast<nanoseconds>(steady_clock::now() - start);
+
+    if (innermost == this)
+        innermost = parent;
+
+    if (parent)
+        parent->nested += elapsed;
+
+    recording->add(Step{
+        type ? boost::core::demangle(type->name()) : name,
+        0,
+        depth,
+        duration_cast<nanoseconds>(start - recording->start),
+        elapsed,
+        elapsed - nested});
+}
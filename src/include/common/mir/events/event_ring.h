@@ -0,0 +1,100 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_EVENTS_EVENT_RING_H_
+#define MIR_EVENTS_EVENT_RING_H_
+
+#include "mir/fd.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace mir
+{
+namespace events
+{
+namespace detail
+{
+struct EventRingHeader;
+struct EventRingSlot;
+}
+
+/**
+ * A single producer, single consumer queue of serialized events, held in
+ * memory shared between the server and one client.
+ *
+ * The server pushes, the client pops. The consumer is woken through an
+ * eventfd, which is only written when the consumer may have found the ring
+ * empty, so a busy client drains many events per wakeup.
+ *
+ * Nothing is pushed until the consumer has mapped the ring, so a consumer
+ * that fails to map it doesn't lose events.
+ *
+ * The producer never trusts anything the consumer can write: its own write
+ * position is kept out of shared memory, and a corrupt read position only
+ * makes the ring look full.
+ */
+class EventRing
+{
+public:
+    /// Largest serialized event that fits in a slot
+    static size_t const max_event_size;
+
+    /// Creates an empty ring in new anonymous shared memory
+    EventRing();
+    /// Maps a ring created by the other end of the connection, and lets it push events
+    EventRing(Fd const& shm, Fd const& wakeup);
+    ~EventRing() noexcept;
+
+    Fd shm_fd() const;
+    /// Readable whenever there may be events to pop
+    Fd wakeup_fd() const;
+
+    /**
+     * Queues an event, waking the consumer if needed.
+     *
+     * \param sequence passed to the consumer with the event, so that it can
+     *                 order it among events delivered some other way
+     * \returns false if the event is too large, the ring is full or no
+     *          consumer has mapped it yet; the event must then be delivered
+     *          some other way
+     */
+    bool push(std::string const& event, uint64_t sequence = 0);
+    /// Whether the consumer has taken every event pushed so far
+    bool empty() const;
+
+    /// Resets the wakeup; call before draining the ring with pop()
+    void clear_wakeup();
+    /// Takes the oldest event, if any
+    bool pop(std::string& event);
+    bool pop(std::string& event, uint64_t& sequence);
+
+private:
+    EventRing(EventRing const&) = delete;
+    EventRing& operator=(EventRing const&) = delete;
+
+    Fd const shm;
+    Fd const wakeup;
+    void* const mapping;
+    detail::EventRingHeader* const header;
+    detail::EventRingSlot* const slots;
+    uint32_t next_write;
+};
+}
+}
+
+#endif /* MIR_EVENTS_EVENT_RING_H_ */
@@ -34,6 +34,29 @@ namespace input
 {
 class Keymap;
 
+/**
+ * The modifier and layout state of the keyboards in the form Wayland's
+ * wl_keyboard.modifiers event (and xkb_state_update_mask()) expects it.
+ */
+struct XkbModifiers
+{
+    uint32_t depressed;
+    uint32_t latched;
+    uint32_t locked;
+    uint32_t group;
+};
+
+inline bool operator==(XkbModifiers const& lhs, XkbModifiers const& rhs)
+{
+    return lhs.depressed == rhs.depressed && lhs.latched == rhs.latched &&
+        lhs.locked == rhs.locked && lhs.group == rhs.group;
+}
+
+inline bool operator!=(XkbModifiers const& lhs, XkbModifiers const& rhs)
+{
+    return !(lhs == rhs);
+}
+
 /**
  * The key mapping interface KeyMapper allows configuring a key map for each device individually or a single
  * key map shared by all devices.
@@ -87,9 +110,22 @@ public:
      * masks in input events with the modifier mask evaluated by this Keymapper.
      */
     virtual void map_event(MirEvent& event) = 0;
+
+    /**
+     * The modifiers of all devices, as of the last mapped event.
+     *
+     * Safe to call from any thread; doesn't wait for events being mapped.
+     */
     virtual MirInputEventModifiers modifiers() const = 0;
     virtual MirInputEventModifiers device_modifiers(MirInputDeviceId id) const = 0;
 
+    /**
+     * The XKB modifier state of all devices, as of the last mapped event.
+     *
+     * Safe to call from any thread; doesn't wait for events being mapped.
+     */
+    virtual XkbModifiers xkb_modifiers() const = 0;
+
 protected:
     KeyMapper(KeyMapper const&) = delete;
     KeyMapper& operator=(KeyMapper const&) = delete;
@@ -23,9 +23,11 @@
 
 #include "mir/input/key_mapper.h"
 #include "mir/optional_value.h"
+#include "mir/seqlock.h"
 
 #include <xkbcommon/xkbcommon.h>
 #include <xkbcommon/xkbcommon-compose.h>
+#include <atomic>
 #include <mutex>
 #include <unordered_map>
 #include <unordered_set>
@@ -64,6 +66,7 @@ public:
     void map_event(MirEvent& event) override;
     MirInputEventModifiers modifiers() const override;
     MirInputEventModifiers device_modifiers(MirInputDeviceId di) const override;
+    XkbModifiers xkb_modifiers() const override;
 
 protected:
     XKBMapper(XKBMapper const&) = delete;
@@ -95,13 +98,16 @@ private:
         bool update_and_map(MirEvent& event, ComposeState* compose_state);
         xkb_keysym_t update_state(uint32_t scan_code, MirKeyboardAction direction, ComposeState* compose_state, std::string& text);
         MirInputEventModifiers modifiers() const;
+        XkbModifiers xkb_modifiers() const;
     private:
         void press_modifier(MirInputEventModifiers mod);
         void release_modifier(MirInputEventModifiers mod);
+        void update_xkb_modifiers();
 
         std::shared_ptr<xkb_keymap> const keymap;
         XKBStatePtr state;
         MirInputEventModifiers modifier_state{0};
+        XkbModifiers xkb_modifier_state{0, 0, 0, 0};
     };
 
     XkbMappingState* get_keymapping_state(MirInputDeviceId id);
@@ -112,6 +118,12 @@ private:
     XKBComposeTablePtr compose_table;
 
     mir::optional_value<MirInputEventModifiers> modifier_state;
+    uint32_t xkb_group{0};
+
+    // Snapshots of the modifier state, published by update_modifier() for
+    // readers that don't take the guard
+    std::atomic<MirInputEventModifiers> published_modifiers{mir_input_event_modifier_none};
+    Seqlock<XkbModifiers> published_xkb_modifiers{XkbModifiers{0, 0, 0, 0}};
     std::unordered_map<MirInputDeviceId, std::unique_ptr<XkbMappingState>> device_mapping;
     std::unordered_map<MirInputDeviceId, std::unique_ptr<ComposeState>> device_composing;
 };
@@ -0,0 +1,98 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_LOGGING_ASYNC_LOGGER_H_
+#define MIR_LOGGING_ASYNC_LOGGER_H_
+
+#include "mir/logging/logger.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mir
+{
+namespace logging
+{
+/**
+ * Logs in the same format as DumbConsoleLogger, but without making the
+ * logging thread wait for formatting or console I/O.
+ *
+ * Each logging thread copies its messages into a ring buffer of its own,
+ * without locking. A background thread writes them out in batches, merging
+ * each batch by timestamp.
+ * Memory is bounded by buffer_size * max_threads: a message that doesn't fit
+ * is dropped and counted, and the count is logged.
+ *
+ * Errors and critical messages are written before log() returns, as they
+ * are often the last thing logged before the process aborts.
+ */
+class AsyncLogger : public Logger
+{
+public:
+    /// Receives each formatted line (including the trailing newline); flush is
+    /// true for the last line of each batch
+    using Writer = std::function<void(Severity severity, std::string const& line, bool flush)>;
+
+    AsyncLogger(std::size_t buffer_size, std::size_t max_threads);
+    AsyncLogger(Writer const& write, std::size_t buffer_size, std::size_t max_threads);
+    ~AsyncLogger();
+
+    void log(Severity severity, std::string const& message, std::string const& component) override;
+    void log(char const* component, Severity severity, char const* format, ...) override
+        __attribute__ ((format (printf, 4, 5)));
+
+    /// Writes everything already logged before returning
+    void flush();
+
+    /// The number of messages dropped because a buffer was full
+    auto dropped() const -> std::uint64_t;
+
+private:
+    class Ring;
+    struct Record;
+
+    void log(Severity severity, char const* message, std::size_t message_size, char const* component, std::size_t component_size);
+    auto ring_for_this_thread() -> Ring*;
+    bool write_pending(std::unique_lock<std::mutex> const& lock);
+    bool pending();
+    void write_loop();
+
+    Writer const write;
+    std::size_t const buffer_size;
+    std::size_t const max_threads;
+    std::uint64_t const id;
+
+    std::atomic<std::uint64_t> dropped_messages{0};
+    std::uint64_t reported_dropped{0};
+
+    std::mutex rings_mutex;
+    std::vector<std::shared_ptr<Ring>> rings;
+
+    std::mutex write_mutex;
+    std::condition_variable wakeup;
+    std::atomic<bool> writer_idle{false};
+    bool stopping{false};
+    std::thread writer;
+};
+}
+}
+
+#endif // MIR_LOGGING_ASYNC_LOGGER_H_
@@ -21,6 +21,8 @@
 
 #include "mir/logging/logger.h"
 
+#include <ctime>
+
 namespace mir
 {
 namespace logging
@@ -32,6 +34,10 @@ public:
 protected:
     void log(Severity severity, const std::string& message, const std::string& component) override;
 };
+
+/// A line as DumbConsoleLogger writes it: "[time] <SEVERITY> component: message\n"
+auto format_log_line(Severity severity, std::string const& message, std::string const& component, timespec const& time)
+-> std::string;
 }
 }
 
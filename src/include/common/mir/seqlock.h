@@ -0,0 +1,96 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_SEQLOCK_H_
+#define MIR_SEQLOCK_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace mir
+{
+/** A small value published by one writer and read by any number of threads
+ * without locking.
+ * Readers never block the writer: a read that overlaps a store is retried.
+ * Stores must be serialized by the caller.
+ */
+template<typename T>
+class Seqlock
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Seqlock values are copied bytewise");
+
+public:
+    explicit Seqlock(T const& initial = T{})
+    {
+        write_words(initial);
+    }
+
+    void store(T const& value)
+    {
+        auto const seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        write_words(value);
+
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    T load() const
+    {
+        std::array<uint32_t, word_count> copy;
+        unsigned before, after;
+
+        do
+        {
+            before = sequence.load(std::memory_order_acquire);
+
+            for (size_t i = 0; i != word_count; ++i)
+                copy[i] = words[i].load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = sequence.load(std::memory_order_relaxed);
+        }
+        while ((before & 1) || before != after);
+
+        T value;
+        std::memcpy(&value, copy.data(), sizeof value);
+        return value;
+    }
+
+private:
+    static size_t const word_count = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+    // The value is held in atomic words so that a read racing a store is
+    // merely discarded rather than undefined behaviour
+    void write_words(T const& value)
+    {
+        std::array<uint32_t, word_count> copy{};
+        std::memcpy(copy.data(), &value, sizeof value);
+
+        for (size_t i = 0; i != word_count; ++i)
+            words[i].store(copy[i], std::memory_order_relaxed);
+    }
+
+    std::atomic<unsigned> sequence{0};
+    std::array<std::atomic<uint32_t>, word_count> words;
+};
+}
+
+#endif /* MIR_SEQLOCK_H_ */
@@ -31,6 +31,9 @@ class SharedLibrary;
 
 std::vector<std::shared_ptr<SharedLibrary>> libraries_for_path(std::string const& path, SharedLibraryProberReport& report);
 
+// The library files in path, in the order the functions here load them, without loading any
+std::vector<std::string> library_files_for_path(std::string const& path, SharedLibraryProberReport& report);
+
 // The selector can tell select_libraries_for_path() to persist or quit after each library
 enum class Selection { persist, quit };
 
@@ -0,0 +1,86 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_GRAPHICS_PIXEL_CONVERSION_H_
+#define MIR_GRAPHICS_PIXEL_CONVERSION_H_
+
+#include <cstddef>
+
+namespace mir
+{
+namespace graphics
+{
+
+/*!
+ * \name Pixel conversion
+ *
+ * Conversions between the pixel layouts of MirPixelFormat. Each is
+ * implemented with the widest vector instructions the CPU supports (SSE2 or
+ * AVX2 on x86, NEON on ARM), selected on first use, and falls back to plain
+ * C++ otherwise.
+ *
+ * Formats are named as MirPixelFormat names them: 32 bit formats by the
+ * channel order of a native endian word, from the most significant byte
+ * (so abgr_8888 is laid out R, G, B, A in memory on little endian machines),
+ * 24 bit formats by their byte order in memory.
+ * \{
+ */
+
+/// Swaps the red and blue channels, converting abgr_8888 to argb_8888 and
+/// back. \a src and \a dst may be the same buffer.
+void swap_red_blue_8888(void const* src, void* dst, size_t pixel_count);
+
+/// Expands 24 bit pixels to 32 bit ones with opaque alpha: bgr_888 to
+/// argb_8888 or, with \a swap_red_blue, to abgr_8888.
+/// \a src and \a dst must not overlap.
+void expand_888_to_8888(void const* src, void* dst, size_t pixel_count, bool swap_red_blue);
+
+/// The inverse of expand_888_to_8888, dropping the alpha channel.
+/// \a src and \a dst must not overlap.
+void pack_8888_to_888(void const* src, void* dst, size_t pixel_count, bool swap_red_blue);
+
+/// Expands rgb_565 pixels to opaque argb_8888.
+/// \a src and \a dst must not overlap.
+void expand_565_to_8888(void const* src, void* dst, size_t pixel_count);
+
+/// Multiplies the colour channels of 8888 pixels by their alpha (which must be
+/// the most significant byte). \a src and \a dst may be the same buffer.
+void premultiply_alpha_8888(void const* src, void* dst, size_t pixel_count);
+
+/// Copies \a height lines of \a line_size bytes, turning the image upside down
+void copy_flipped(
+    void const* src, size_t src_stride,
+    void* dst, size_t dst_stride,
+    size_t line_size, size_t height);
+
+/// Turns an image of 8888 pixels upside down in place, optionally swapping its
+/// red and blue channels in the same pass
+void flip_in_place_8888(void* pixels, size_t stride, size_t width, size_t height, bool swap_red_blue);
+
+/*!
+ * \}
+ */
+
+namespace detail
+{
+/// premultiply_alpha_8888() without vector instructions, which every kernel has to match
+void premultiply_alpha_8888_scalar(void const* src, void* dst, size_t pixel_count);
+}
+
+}
+}
+
+#endif /* MIR_GRAPHICS_PIXEL_CONVERSION_H_ */
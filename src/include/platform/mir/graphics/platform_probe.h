@@ -19,6 +19,7 @@
 #ifndef MIR_GRAPHICS_PLATFORM_PROBE_H_
 #define MIR_GRAPHICS_PLATFORM_PROBE_H_
 
+#include <string>
 #include <vector>
 #include <memory>
 #include "mir/shared_library.h"
@@ -26,14 +27,31 @@
 
 namespace mir
 {
+class SharedLibraryProberReport;
+
 namespace graphics
 {
 class Platform;
+class PlatformProbeCache;
 
 std::shared_ptr<SharedLibrary> module_for_device(
          std::vector<std::shared_ptr<SharedLibrary>> const& modules,
          options::ProgramOption const& options);
 
+/**
+ * Chooses the module for the device from those in path, as above, and
+ * records the choice in cache.
+ *
+ * While the hardware and module files are as they were when a choice was
+ * recorded, only the chosen module is loaded and probed. The others are
+ * loaded and probed only if it now probes worse than it did.
+ */
+std::shared_ptr<SharedLibrary> module_for_device(
+         std::string const& path,
+         PlatformProbeCache& cache,
+         options::ProgramOption const& options,
+         SharedLibraryProberReport& report);
+
 }
 }
 
@@ -0,0 +1,69 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_GRAPHICS_PLATFORM_PROBE_CACHE_H_
+#define MIR_GRAPHICS_PLATFORM_PROBE_CACHE_H_
+
+#include "mir/graphics/platform.h"
+#include "mir/optional_value.h"
+
+#include <string>
+#include <vector>
+
+namespace mir
+{
+namespace graphics
+{
+/**
+ * Remembers, across server starts, which graphics platform module was chosen
+ * and how well it probed, so that the next start can probe just that module.
+ *
+ * The choice is recorded against a fingerprint of the hardware and modules
+ * (see platform_fingerprint()); once either changes, the choice is ignored.
+ */
+class PlatformProbeCache
+{
+public:
+    struct Choice
+    {
+        std::string module;
+        PlatformPriority priority;
+    };
+
+    explicit PlatformProbeCache(std::string const& filename);
+
+    /// The choice recorded for fingerprint, if there is one
+    optional_value<Choice> lookup(std::string const& fingerprint) const;
+
+    /// Best effort: a cache that can't be written only costs the next start a full probe
+    void record(std::string const& fingerprint, Choice const& choice);
+
+    /// $XDG_CACHE_HOME/mir/graphics-platform, or empty if there's no cache directory
+    static std::string default_filename();
+
+private:
+    std::string const filename;
+};
+
+/**
+ * Identifies the graphics hardware (the DRM devices udev knows of) and the
+ * module files (their paths, sizes and modification times).
+ */
+std::string platform_fingerprint(std::vector<std::string> const& module_files);
+}
+}
+
+#endif /* MIR_GRAPHICS_PLATFORM_PROBE_CACHE_H_ */
@@ -53,6 +53,13 @@ extern char const* const fatal_except_opt;
 extern char const* const debug_opt;
 extern char const* const composite_delay_opt;
 extern char const* const enable_key_repeat_opt;
+extern char const* const touch_resampling_opt;
+extern char const* const touch_resampling_latency_opt;
+extern char const* const record_input_opt;
+extern char const* const async_logging_opt;
+extern char const* const metrics_socket_opt;
+extern char const* const startup_report_opt;
+extern char const* const parallel_startup_opt;
 
 extern char const* const name_opt;
 extern char const* const offscreen_opt;
@@ -62,10 +69,12 @@ extern char const* const enable_key_repeat_opt;
 extern char const* const off_opt_value;
 extern char const* const log_opt_value;
 extern char const* const lttng_opt_value;
+extern char const* const metrics_opt_value;
 
 extern char const* const platform_graphics_lib;
 extern char const* const platform_input_lib;
 extern char const* const platform_path;
+extern char const* const platform_probe_cache_opt;
 
 class Configuration
 {
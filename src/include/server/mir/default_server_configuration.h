@@ -88,6 +88,7 @@ namespace detail { class FrontendShell; }
 namespace time
 {
 class Clock;
+class AlarmFactory;
 }
 namespace scene
 {
@@ -136,6 +137,7 @@ class InputDeviceHub;
 class DefaultInputDeviceHub;
 class CompositeEventFilter;
 class EventFilterChainDispatcher;
+class TouchResamplingDispatcher;
 class CursorListener;
 class TouchVisualizer;
 class CursorImages;
@@ -158,6 +160,7 @@ namespace report
 {
 class ReportFactory;
 class Reports;
+namespace metrics { class Registry; }
 }
 
 namespace renderer
@@ -318,6 +321,7 @@ public:
     virtual std::shared_ptr<input::CompositeEventFilter> the_composite_event_filter();
 
     virtual std::shared_ptr<input::EventFilterChainDispatcher> the_event_filter_chain_dispatcher();
+    virtual std::shared_ptr<input::TouchResamplingDispatcher> the_touch_resampling_dispatcher();
 
     virtual std::shared_ptr<shell::InputTargeter> the_input_targeter();
     virtual std::shared_ptr<input::Scene>  the_input_scene();
@@ -337,9 +341,13 @@ public:
      * configurable interfaces for modifying logging
      *  @{ */
     virtual std::shared_ptr<logging::Logger> the_logger();
+
+    /// The registry "metrics" reports record to (served on the metrics socket)
+    std::shared_ptr<report::metrics::Registry> the_metrics_registry();
     /** @} */
 
     virtual std::shared_ptr<time::Clock> the_clock();
+    virtual std::shared_ptr<time::AlarmFactory> the_alarm_factory();
     virtual std::shared_ptr<ServerActionQueue> the_server_action_queue();
     virtual std::shared_ptr<SharedLibraryProberReport>  the_shared_library_prober_report();
 
@@ -381,6 +389,7 @@ protected:
 
     CachedPtr<input::InputReport> input_report;
     CachedPtr<input::EventFilterChainDispatcher> event_filter_chain_dispatcher;
+    CachedPtr<input::TouchResamplingDispatcher> touch_resampling_dispatcher;
     CachedPtr<input::CompositeEventFilter> composite_event_filter;
     CachedPtr<input::InputManager>    input_manager;
     CachedPtr<input::SurfaceInputDispatcher>    surface_input_dispatcher;
@@ -426,6 +435,7 @@ protected:
     CachedPtr<graphics::DisplayReport> display_report;
     CachedPtr<time::Clock> clock;
     CachedPtr<MainLoop> main_loop;
+    CachedPtr<time::AlarmFactory> alarm_factory;
     CachedPtr<ServerStatusListener> server_status_listener;
     CachedPtr<graphics::DisplayConfigurationPolicy> display_configuration_policy;
     CachedPtr<graphics::nested::MirClientHostConnection> host_connection;
@@ -454,6 +464,7 @@ private:
         seat_observer_multiplexer;
     CachedPtr<ObserverMultiplexer<frontend::SessionMediatorObserver>>
         session_mediator_observer_multiplexer;
+    CachedPtr<report::metrics::Registry> metrics_registry;
     std::shared_ptr<report::Reports> const reports;
 
     virtual std::string the_socket_file() const;
@@ -46,6 +46,8 @@ public:
     const ::std::string& method_name() const;
     const ::std::string& parameters() const;
     google::protobuf::uint32 id() const;
+    /// The client won't wait for a result, so one is only worth sending on error
+    bool no_reply() const;
 private:
     mir::protobuf::wire::Invocation const& invocation;
 };
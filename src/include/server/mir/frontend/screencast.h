@@ -21,6 +21,7 @@
 
 #include "mir/int_wrapper.h"
 #include "mir/graphics/display_configuration.h"
+#include "mir/geometry/rectangles.h"
 
 #include <memory>
 
@@ -46,7 +47,13 @@ public:
         MirMirrorMode mirror_mode) = 0;
     virtual void destroy_session(ScreencastSessionId id) = 0;
     virtual std::shared_ptr<graphics::Buffer> capture(ScreencastSessionId id) = 0;
-    virtual void capture(ScreencastSessionId id, std::shared_ptr<graphics::Buffer> const& buffer) = 0;
+    /**
+     * Captures into a client supplied buffer.
+     *
+     * \returns the areas of the buffer that changed since the previous
+     *          capture of the session (everything for the first capture)
+     */
+    virtual geometry::Rectangles capture(ScreencastSessionId id, std::shared_ptr<graphics::Buffer> const& buffer) = 0;
 
 protected:
     Screencast() = default;
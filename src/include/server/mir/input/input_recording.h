@@ -0,0 +1,149 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_INPUT_INPUT_RECORDING_H_
+#define MIR_INPUT_INPUT_RECORDING_H_
+
+#include "mir/input/device_capability.h"
+#include "mir/events/contact_state.h"
+#include "mir_toolkit/event.h"
+
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mir
+{
+namespace input
+{
+
+/**
+ * Receives the content of an input recording: the devices as they come and
+ * go, and the events they emit, in the form the input platforms hand them to
+ * the EventBuilder.
+ */
+class InputRecordHandler
+{
+public:
+    using Timestamp = std::chrono::nanoseconds;
+
+    virtual ~InputRecordHandler() = default;
+
+    virtual void device_added(
+        MirInputDeviceId id,
+        DeviceCapabilities capabilities,
+        std::string const& name,
+        std::string const& unique_id) = 0;
+    virtual void device_removed(MirInputDeviceId id) = 0;
+
+    virtual void key_event(MirInputDeviceId id, Timestamp timestamp, MirKeyboardAction action, int scan_code) = 0;
+    virtual void pointer_event(
+        MirInputDeviceId id,
+        Timestamp timestamp,
+        MirPointerAction action,
+        MirPointerButtons buttons,
+        float hscroll,
+        float vscroll,
+        float relative_x,
+        float relative_y) = 0;
+    virtual void touch_event(
+        MirInputDeviceId id,
+        Timestamp timestamp,
+        std::vector<events::ContactState> const& contacts) = 0;
+
+protected:
+    InputRecordHandler() = default;
+    InputRecordHandler(InputRecordHandler const&) = delete;
+    InputRecordHandler& operator=(InputRecordHandler const&) = delete;
+};
+
+/**
+ * Writes an input recording to a file.
+ *
+ * The file starts with an eight byte magic and a format version and is then
+ * a sequence of records, each a one byte record type followed by fixed size
+ * fields in host byte order (strings are length prefixed). Recordings are
+ * meant to be replayed on the machine, or at least the architecture, they
+ * were made on.
+ */
+class InputRecordWriter : public InputRecordHandler
+{
+public:
+    explicit InputRecordWriter(std::string const& path);
+    ~InputRecordWriter();
+
+    void device_added(
+        MirInputDeviceId id,
+        DeviceCapabilities capabilities,
+        std::string const& name,
+        std::string const& unique_id) override;
+    void device_removed(MirInputDeviceId id) override;
+
+    void key_event(MirInputDeviceId id, Timestamp timestamp, MirKeyboardAction action, int scan_code) override;
+    void pointer_event(
+        MirInputDeviceId id,
+        Timestamp timestamp,
+        MirPointerAction action,
+        MirPointerButtons buttons,
+        float hscroll,
+        float vscroll,
+        float relative_x,
+        float relative_y) override;
+    void touch_event(
+        MirInputDeviceId id,
+        Timestamp timestamp,
+        std::vector<events::ContactState> const& contacts) override;
+
+    /// Records an input event as received from an input device
+    void record(MirEvent const& event);
+
+private:
+    template<typename T>
+    void put(T const& value);
+    void put(std::string const& value);
+
+    std::mutex mutex;
+    std::ofstream out;
+};
+
+/// Reads back a recording made by InputRecordWriter
+class InputRecordReader
+{
+public:
+    explicit InputRecordReader(std::string const& path);
+
+    /**
+     * Passes the next record to \a handler.
+     *
+     * \return false at the end of the recording
+     * \throws std::runtime_error if the recording is malformed
+     */
+    bool read_next(InputRecordHandler& handler);
+
+private:
+    template<typename T>
+    T get();
+    std::string get_string();
+
+    std::ifstream in;
+};
+
+}
+}
+
+#endif /* MIR_INPUT_INPUT_RECORDING_H_ */
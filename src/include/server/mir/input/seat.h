@@ -22,6 +22,7 @@
 
 #include "mir/geometry/rectangle.h"
 #include "mir/geometry/rectangles.h"
+#include "mir/input/key_mapper.h"
 #include "mir_toolkit/event.h"
 
 #include <memory>
@@ -44,6 +45,8 @@ public:
     virtual void remove_device(Device const& device) = 0;
     virtual void dispatch_event(std::shared_ptr<MirEvent> const& event) = 0;
     virtual EventUPtr create_device_state() = 0;
+    /// The seat's keyboard modifiers, readable from any thread without waiting on input dispatch
+    virtual XkbModifiers xkb_modifiers() const = 0;
 
     virtual void set_key_state(Device const& dev, std::vector<uint32_t> const& scan_codes) = 0;
     virtual void set_pointer_state(Device const& dev, MirPointerButtons buttons) = 0;
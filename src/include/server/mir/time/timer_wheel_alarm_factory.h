@@ -0,0 +1,68 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_TIME_TIMER_WHEEL_ALARM_FACTORY_H_
+#define MIR_TIME_TIMER_WHEEL_ALARM_FACTORY_H_
+
+#include "mir/time/alarm_factory.h"
+
+#include <chrono>
+#include <memory>
+
+namespace mir
+{
+namespace graphics
+{
+class EventHandlerRegister;
+}
+namespace time
+{
+class Clock;
+
+/**
+ * An AlarmFactory whose alarms share a single hierarchical timer wheel.
+ *
+ * Scheduling, rescheduling and cancelling an alarm are O(1) and all pending
+ * alarms are driven by one timerfd registered with \a event_handler_register,
+ * so the cost of an alarm no longer depends on the number of alarms pending.
+ *
+ * Alarms fire with a granularity of \a resolution; they never fire early.
+ * Cancelling or destroying an alarm doesn't wait for a callback that is
+ * already running on another thread.
+ */
+class TimerWheelAlarmFactory : public AlarmFactory
+{
+public:
+    TimerWheelAlarmFactory(
+        std::shared_ptr<graphics::EventHandlerRegister> const& event_handler_register,
+        std::shared_ptr<Clock> const& clock,
+        std::chrono::milliseconds resolution = std::chrono::milliseconds{1});
+    ~TimerWheelAlarmFactory();
+
+    std::unique_ptr<Alarm> create_alarm(std::function<void()> const& callback) override;
+    std::unique_ptr<Alarm> create_alarm(std::unique_ptr<LockableCallback> callback) override;
+
+    class Wheel;
+
+private:
+    std::shared_ptr<graphics::EventHandlerRegister> const event_handler_register;
+    std::shared_ptr<Wheel> const wheel;
+};
+
+}
+}
+
+#endif // MIR_TIME_TIMER_WHEEL_ALARM_FACTORY_H_
@@ -18,6 +18,8 @@
 
 #include "basic_window_manager.h"
 #include "display_configuration_listeners.h"
+#include "window_management_trace.h"
+#include "window_self.h"
 
 #include "miral/window_manager_tools.h"
 
@@ -39,6 +41,15 @@ using namespace mir::geometry;
 namespace
 {
 int const title_bar_height = 12;
+
+// WindowManagementTrace wraps the policy, so ask it for the one it wraps
+auto pointer_motion_policy_of(miral::WindowManagementPolicy* policy) -> miral::PointerMotionPolicy*
+{
+    if (auto const trace = dynamic_cast<miral::WindowManagementTrace*>(policy))
+        return trace->pointer_motion_policy();
+
+    return dynamic_cast<miral::PointerMotionPolicy*>(policy);
+}
 }
 
 struct miral::BasicWindowManager::Locker
@@ -48,14 +59,48 @@ struct miral::BasicWindowManager::Locker
     ~Locker()
     {
         policy->advise_end();
+        self->publish_layout();
     }
 
     std::lock_guard<std::mutex> const lock;
+    BasicWindowManager* const self;
     WindowManagementPolicy* const policy;
 };
 
+class miral::BasicWindowManager::LayoutSnapshot : public WindowLayoutSnapshot
+{
+public:
+    explicit LayoutSnapshot(Window const& active) :
+        active{active}
+    {
+    }
+
+    auto active_window() const -> Window override
+    {
+        return active;
+    }
+
+    auto window_at(Point point) const -> Window override
+    {
+        for (auto window = windows.rbegin(); window != windows.rend(); ++window)
+        {
+            if (window->first.contains(point))
+                return window->second;
+        }
+
+        return {};
+    }
+
+    // The visible windows and where they were, bottom first
+    std::vector<std::pair<Rectangle, Window>> windows;
+
+private:
+    Window const active;
+};
+
 miral::BasicWindowManager::Locker::Locker(BasicWindowManager* self) :
     lock{self->mutex},
+    self{self},
     policy{self->policy.get()}
 {
     policy->advise_begin();
@@ -79,10 +124,12 @@ miral::BasicWindowManager::BasicWindowManager(
     display_layout(display_layout),
     persistent_surface_store{persistent_surface_store},
     policy(build(WindowManagerTools{this})),
+    pointer_motion_policy{pointer_motion_policy_of(policy.get())},
     display_config_monitor{std::make_shared<DisplayConfigurationListeners>()}
 {
     display_config_monitor->add_listener(this);
     display_configuration_observers.register_interest(display_config_monitor);
+    publish_layout();
 }
 
 miral::BasicWindowManager::~BasicWindowManager()
@@ -120,7 +167,12 @@ auto miral::BasicWindowManager::add_surface(
     spec.update(parameters);
     auto const surface_id = build(session, parameters);
     Window const window{session, session->surface(surface_id)};
-    auto& window_info = this->window_info.emplace(window, WindowInfo{window, spec}).first->second;
+    auto const slot = this->window_info.emplace(window, spec);
+    window.self->slot = slot;
+    window_slots[window] = slot;
+    stacking.push_back(window);
+    auto& window_info = *this->window_info.find(slot);
+    layout_changed = true;
 
     if (spec.parent().is_set() && spec.parent().value().lock())
         window_info.parent(info_for(spec.parent().value()).window());
@@ -295,7 +347,11 @@ void miral::BasicWindowManager::erase(miral::WindowInfo const& info)
     for (auto& child : info.children())
         info_for(child).parent({});
 
-    window_info.erase(info.window());
+    auto const window = info.window();
+    window_info.erase(window.self->slot);
+    window_slots.erase(window);
+    stacking.erase(std::remove(begin(stacking), end(stacking), window), end(stacking));
+    layout_changed = true;
 }
 
 #pragma GCC diagnostic push
@@ -327,12 +383,26 @@ bool miral::BasicWindowManager::handle_touch_event(MirTouchEvent const* event)
 
 bool miral::BasicWindowManager::handle_pointer_event(MirPointerEvent const* event)
 {
+    Point const position{
+        mir_pointer_event_axis_value(event, mir_pointer_axis_x),
+        mir_pointer_event_axis_value(event, mir_pointer_axis_y)};
+
+    // Most pointer events are motion over windows: if the policy can tell us it
+    // isn't interested, there's no need to wait for other window management
+    if (pointer_motion_policy &&
+        mir_pointer_event_action(event) == mir_pointer_action_motion &&
+        mir_pointer_event_buttons(event) == 0)
+    {
+        cursor = position;
+
+        if (!pointer_motion_policy->pointer_motion_needs_handling(event, *std::atomic_load(&layout)))
+            return false;
+    }
+
     Locker lock{this};
     update_event_timestamp(event);
 
-    cursor = {
-        mir_pointer_event_axis_value(event, mir_pointer_axis_x),
-        mir_pointer_event_axis_value(event, mir_pointer_axis_y)};
+    cursor = position;
 
     return policy->handle_pointer_event(event);
 }
@@ -362,7 +432,7 @@ void miral::BasicWindowManager::handle_request_move(
     std::shared_ptr<mir::scene::Surface> const& surface,
     uint64_t timestamp)
 {
-    std::lock_guard<decltype(mutex)> lock(mutex);
+    Locker lock{this};
     if (timestamp >= last_input_event_timestamp && last_input_event)
     {
         policy->handle_request_move(info_for(surface), mir_event_get_input_event(last_input_event));
@@ -375,7 +445,7 @@ void miral::BasicWindowManager::handle_request_resize(
     uint64_t timestamp,
     MirResizeEdge edge)
 {
-    std::lock_guard<decltype(mutex)> lock(mutex);
+    Locker lock{this};
     if (timestamp >= last_input_event_timestamp && last_input_event)
     {
         policy->handle_request_resize(info_for(surface), mir_event_get_input_event(last_input_event), edge);
@@ -480,12 +550,19 @@ auto miral::BasicWindowManager::info_for(std::weak_ptr<scene::Session> const& se
 auto miral::BasicWindowManager::info_for(std::weak_ptr<scene::Surface> const& surface) const
 -> WindowInfo&
 {
-    return const_cast<WindowInfo&>(window_info.at(surface));
+    return *window_info.find(window_slots.at(surface));
 }
 
 auto miral::BasicWindowManager::info_for(Window const& window) const
 -> WindowInfo&
 {
+    if (window.self)
+    {
+        if (auto const info = window_info.find(window.self->slot))
+            return *info;
+    }
+
+    // A Window constructed elsewhere for a surface we manage doesn't know its slot
     return info_for(std::weak_ptr<mir::scene::Surface>(window));
 }
 
@@ -673,6 +750,29 @@ void miral::BasicWindowManager::focus_prev_within_application()
     }
 }
 
+void miral::BasicWindowManager::publish_layout()
+{
+    // Only a PointerMotionPolicy looks at the snapshot
+    if (!pointer_motion_policy)
+        return;
+
+    auto const active = active_window();
+    auto const current = std::atomic_load(&layout);
+
+    if (!layout_changed && current && current->active_window() == active)
+        return;
+
+    auto const snapshot = std::make_shared<LayoutSnapshot>(active);
+    for (auto const& window : stacking)
+    {
+        if (info_for(window).is_visible())
+            snapshot->windows.emplace_back(Rectangle{window.top_left(), window.size()}, window);
+    }
+
+    std::atomic_store(&layout, std::shared_ptr<LayoutSnapshot const>{snapshot});
+    layout_changed = false;
+}
+
 auto miral::BasicWindowManager::window_at(geometry::Point cursor) const
 -> Window
 {
@@ -752,6 +852,11 @@ void miral::BasicWindowManager::raise_tree(Window const& root)
 
     policy->advise_raise(windows);
     focus_controller->raise({begin(windows), end(windows)});
+
+    // Like the scene, keep the raised windows in the order they were
+    std::stable_partition(begin(stacking), end(stacking), [&](Window const& window)
+        { return std::find(begin(windows), end(windows), window) == end(windows); });
+    layout_changed = true;
 }
 
 void miral::BasicWindowManager::start_drag_and_drop(WindowInfo& window_info, std::vector<uint8_t> const& handle)
@@ -781,6 +886,7 @@ void miral::BasicWindowManager::move_tree(miral::WindowInfo& root, mir::geometry
 
     policy->advise_move_to(root, top_left);
     root.window().move_to(top_left);
+    layout_changed = true;
 
     for (auto const& child: root.children())
     {
@@ -979,6 +1085,7 @@ void miral::BasicWindowManager::place_and_size(WindowInfo& root, Point const& ne
     {
         policy->advise_resize(root, new_size);
         root.window().resize(new_size);
+        layout_changed = true;
     }
 
     move_tree(root, new_pos - root.window().top_left());
@@ -1135,6 +1242,7 @@ void miral::BasicWindowManager::set_state(miral::WindowInfo& window_info, MirWin
                             window_info.state() == mir_window_state_minimized;
 
     policy->advise_state_change(window_info, value);
+    layout_changed = true;
 
     switch (value)
     {
@@ -22,11 +22,13 @@
 #include "window_manager_tools_implementation.h"
 
 #include "miral/window_management_policy.h"
+#include "miral/pointer_motion_policy.h"
 #include "miral/window_info.h"
 #include "active_outputs.h"
 #include "miral/application.h"
 #include "miral/application_info.h"
 #include "mru_window_list.h"
+#include "slot_map.h"
 
 #include <mir/geometry/rectangles.h>
 #include <mir/observer_registrar.h>
@@ -37,6 +39,7 @@
 #include <boost/bimap.hpp>
 #include <boost/bimap/multiset_of.hpp>
 
+#include <atomic>
 #include <map>
 #include <mutex>
 
@@ -197,7 +200,7 @@ public:
     void invoke_under_lock(std::function<void()> const& callback) override;
 
 private:
-    using SurfaceInfoMap = std::map<std::weak_ptr<mir::scene::Surface>, WindowInfo, std::owner_less<std::weak_ptr<mir::scene::Surface>>>;
+    using SurfaceSlotMap = std::map<std::weak_ptr<mir::scene::Surface>, SlotHandle, std::owner_less<std::weak_ptr<mir::scene::Surface>>>;
     using SessionInfoMap = std::map<std::weak_ptr<mir::scene::Session>, ApplicationInfo, std::owner_less<std::weak_ptr<mir::scene::Session>>>;
 
     mir::shell::FocusController* const focus_controller;
@@ -214,12 +217,15 @@ private:
     std::shared_ptr<DeadWorkspaces> const dead_workspaces{std::make_shared<DeadWorkspaces>()};
 
     std::unique_ptr<WindowManagementPolicy> const policy;
+    PointerMotionPolicy* const pointer_motion_policy;
 
     std::mutex mutex;
     SessionInfoMap app_info;
-    SurfaceInfoMap window_info;
+    SlotMap<WindowInfo> window_info;
+    SurfaceSlotMap window_slots; // For lookup from a surface: a Window knows its slot
+    std::vector<Window> stacking; // As the windows were raised, bottom first
     mir::geometry::Rectangles outputs;
-    mir::geometry::Point cursor;
+    std::atomic<mir::geometry::Point> cursor{mir::geometry::Point{}};
     uint64_t last_input_event_timestamp{0};
     MirEvent const* last_input_event{nullptr};
     miral::MRUWindowList mru_active_windows;
@@ -237,6 +243,12 @@ private:
 
     struct Locker;
 
+    // Published (under mutex) for pointer_motion_policy to read without it
+    class LayoutSnapshot;
+    std::shared_ptr<LayoutSnapshot const> layout;
+    bool layout_changed{true};
+    void publish_layout();
+
     void update_event_timestamp(MirKeyboardEvent const* kev);
     void update_event_timestamp(MirPointerEvent const* pev);
     void update_event_timestamp(MirTouchEvent const* tev);
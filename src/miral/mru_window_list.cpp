@@ -41,13 +41,25 @@ bool visible(miral::Window const& window)
 
 void miral::MRUWindowList::push(Window const& window)
 {
-    windows.erase(remove(begin(windows), end(windows), window), end(windows));
-    windows.push_back(window);
+    auto const i = index.find(window);
+    if (i != index.end())
+    {
+        windows.splice(windows.end(), windows, i->second);
+    }
+    else
+    {
+        index.emplace(window, windows.insert(windows.end(), window));
+    }
 }
 
 void miral::MRUWindowList::erase(Window const& window)
 {
-    windows.erase(remove(begin(windows), end(windows), window), end(windows));
+    auto const i = index.find(window);
+    if (i != index.end())
+    {
+        windows.erase(i->second);
+        index.erase(i);
+    }
 }
 
 auto miral::MRUWindowList::top() const -> Window
@@ -58,8 +70,21 @@ auto miral::MRUWindowList::top() const -> Window
 
 void miral::MRUWindowList::enumerate(Enumerator const& enumerator) const
 {
-    for (auto i = windows.rbegin(); i != windows.rend(); ++i)
-        if (visible(*i))
-            if (!enumerator(const_cast<Window&>(*i)))
+    if (windows.empty())
+        return;
+
+    // Step past each window before handing it out, as the enumerator may move it
+    auto next = std::prev(windows.end());
+    for (auto more = true; more;)
+    {
+        auto const current = next;
+        if (current == windows.begin())
+            more = false;
+        else
+            --next;
+
+        if (visible(*current))
+            if (!enumerator(const_cast<Window&>(*current)))
                 break;
+    }
 }
@@ -22,7 +22,8 @@
 #include <miral/window.h>
 
 #include <functional>
-#include <vector>
+#include <list>
+#include <map>
 
 namespace miral
 {
@@ -36,10 +37,13 @@ public:
 
     using Enumerator = std::function<bool(Window& window)>;
 
+    /// The enumerator may push() or erase() the window it is given
     void enumerate(Enumerator const& enumerator) const;
 
 private:
-    std::vector<Window> windows;
+    // Least recently used first, with an index so push() and erase() don't search
+    std::list<Window> windows;
+    std::map<Window, std::list<Window>::iterator> index;
 };
 }
 
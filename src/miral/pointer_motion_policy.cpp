@@ -0,0 +1,23 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "miral/pointer_motion_policy.h"
+
+miral::WindowLayoutSnapshot::WindowLayoutSnapshot() = default;
+miral::WindowLayoutSnapshot::~WindowLayoutSnapshot() = default;
+
+miral::PointerMotionPolicy::PointerMotionPolicy() = default;
+miral::PointerMotionPolicy::~PointerMotionPolicy() = default;
@@ -29,6 +29,7 @@ namespace msh = mir::shell;
 namespace
 {
 char const* const trace_option = "window-management-trace";
+char const* const trace_file_option = "window-management-trace-file";
 }
 
 miral::SetWindowManagementPolicy::SetWindowManagementPolicy(WindowManagementPolicyBuilder const& builder) :
@@ -41,6 +42,8 @@ miral::SetWindowManagementPolicy::~SetWindowManagementPolicy() = default;
 void miral::SetWindowManagementPolicy::operator()(mir::Server& server) const
 {
     server.add_configuration_option(trace_option, "log trace message", mir::OptionType::null);
+    server.add_configuration_option(trace_file_option,
+        "record a binary trace in the file given (decode with miral-wm-trace-decode)", mir::OptionType::string);
 
     server.override_the_window_manager_builder([this, &server](msh::FocusController* focus_controller)
         -> std::shared_ptr<msh::WindowManager>
@@ -49,11 +52,17 @@ void miral::SetWindowManagementPolicy::operator()(mir::Server& server) const
 
             auto const persistent_surface_store = server.the_persistent_surface_store();
 
-            if (server.get_options()->is_set(trace_option))
+            if (server.get_options()->is_set(trace_option) || server.get_options()->is_set(trace_file_option))
             {
-                auto trace_builder = [this](WindowManagerTools const& tools) -> std::unique_ptr<miral::WindowManagementPolicy>
+                auto const trace_file = server.get_options()->is_set(trace_file_option) ?
+                    server.get_options()->get<std::string>(trace_file_option) : std::string{};
+
+                auto trace_builder = [this, trace_file](WindowManagerTools const& tools) -> std::unique_ptr<miral::WindowManagementPolicy>
                     {
-                        return std::make_unique<WindowManagementTrace>(tools, builder);
+                        if (trace_file.empty())
+                            return std::make_unique<WindowManagementTrace>(tools, builder);
+                        else
+                            return std::make_unique<WindowManagementTrace>(tools, builder, trace_file);
                     };
 
                 return std::make_shared<BasicWindowManager>(
@@ -0,0 +1,118 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIRAL_SLOT_MAP_H
+#define MIRAL_SLOT_MAP_H
+
+#include <boost/optional.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace miral
+{
+/// Identifies a value in a SlotMap. Once the value is erased the handle is
+/// stale, even if the slot is reused. A default constructed handle is never valid.
+struct SlotHandle
+{
+    std::uint32_t index{0};
+    std::uint32_t generation{0};
+};
+
+/**
+ * Values held in numbered slots, found from a SlotHandle without any search.
+ *
+ * Slots are reused, but each reuse has a new generation so old handles don't
+ * find the new value. Values never move, so references remain valid until
+ * the value is erased.
+ */
+template<typename Value>
+class SlotMap
+{
+public:
+    template<typename... Args>
+    auto emplace(Args&&... args) -> SlotHandle
+    {
+        std::uint32_t index;
+        if (free_slots.empty())
+        {
+            index = slots.size();
+            slots.emplace_back();
+        }
+        else
+        {
+            index = free_slots.back();
+            free_slots.pop_back();
+        }
+
+        auto& slot = slots[index];
+        slot.value.emplace(std::forward<Args>(args)...);
+        ++live;
+        return {index, slot.generation};
+    }
+
+    void erase(SlotHandle handle)
+    {
+        if (find(handle))
+        {
+            auto& slot = slots[handle.index];
+            slot.value = boost::none;
+            ++slot.generation;
+            free_slots.push_back(handle.index);
+            --live;
+        }
+    }
+
+    /// The value for handle, or nullptr if it has been erased
+    auto find(SlotHandle handle) const -> Value*
+    {
+        if (handle.index >= slots.size())
+            return nullptr;
+
+        auto& slot = slots[handle.index];
+        if (slot.generation != handle.generation || !slot.value)
+            return nullptr;
+
+        return const_cast<Value*>(&*slot.value);
+    }
+
+    auto size() const -> std::size_t { return live; }
+
+    template<typename Functor>
+    void for_each(Functor const& functor) const
+    {
+        for (auto& slot : slots)
+        {
+            if (slot.value)
+                functor(const_cast<Value&>(*slot.value));
+        }
+    }
+
+private:
+    struct Slot
+    {
+        std::uint32_t generation{1};
+        boost::optional<Value> value;
+    };
+
+    std::deque<Slot> slots;
+    std::vector<std::uint32_t> free_slots;
+    std::size_t live{0};
+};
+}
+
+#endif //MIRAL_SLOT_MAP_H
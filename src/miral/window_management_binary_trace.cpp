@@ -0,0 +1,656 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "window_management_binary_trace.h"
+
+#include <mir/event_printer.h>
+#include <mir/geometry/displacement.h>
+#include <mir/geometry/rectangle.h>
+
+#include <boost/throw_exception.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <istream>
+#include <map>
+#include <ostream>
+#include <stdexcept>
+#include <system_error>
+
+namespace mbt = miral::binary_trace;
+namespace geom = mir::geometry;
+using namespace std::chrono;
+
+namespace
+{
+struct FileHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t record_size;
+};
+
+FileHeader const file_header{{'M', 'i', 'r', 'A', 'L', 'W', 'M', 'T'}, 1, sizeof(mbt::Record)};
+
+auto round_up_to_power_of_two(std::size_t size) -> std::size_t
+{
+    std::size_t result = 1;
+    while (result < size)
+        result *= 2;
+    return result;
+}
+}
+
+mbt::RingBuffer::RingBuffer(std::size_t capacity) :
+    mask{round_up_to_power_of_two(capacity) - 1},
+    slots{new Slot[mask + 1]}
+{
+    for (std::size_t i = 0; i <= mask; ++i)
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+// Each slot's sequence says what it is ready for: to be written at position "sequence", or
+// to be read at position "sequence - 1". Writers claim positions by advancing head, so
+// they never wait for one another or for the reader.
+auto mbt::RingBuffer::push(Record const& record) -> bool
+{
+    return push(&record, 1);
+}
+
+auto mbt::RingBuffer::push(Record const* records, std::size_t count) -> bool
+{
+    if (count > mask + 1)
+    {
+        dropped_count.fetch_add(count, std::memory_order_relaxed);
+        return false;
+    }
+
+    auto position = head.load(std::memory_order_relaxed);
+
+    for (;;)
+    {
+        auto const sequence = slots[position & mask].sequence.load(std::memory_order_acquire);
+        auto const difference = static_cast<std::int64_t>(sequence - position);
+
+        if (difference == 0)
+        {
+            // The reader frees slots in order, so if the last slot we need is free so are the others
+            auto const last = position + count - 1;
+            if (static_cast<std::int64_t>(slots[last & mask].sequence.load(std::memory_order_acquire) - last) < 0)
+            {
+                dropped_count.fetch_add(count, std::memory_order_relaxed);
+                return false;
+            }
+
+            if (head.compare_exchange_weak(position, position + count, std::memory_order_relaxed))
+            {
+                for (std::size_t i = 0; i != count; ++i)
+                {
+                    auto& slot = slots[(position + i) & mask];
+                    slot.record = records[i];
+                    slot.sequence.store(position + i + 1, std::memory_order_release);
+                }
+                return true;
+            }
+        }
+        else if (difference < 0)
+        {
+            dropped_count.fetch_add(count, std::memory_order_relaxed);
+            return false;
+        }
+        else
+        {
+            position = head.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+auto mbt::RingBuffer::pop(Record& record) -> bool
+{
+    auto& slot = slots[tail & mask];
+
+    if (slot.sequence.load(std::memory_order_acquire) != tail + 1)
+        return false;
+
+    record = slot.record;
+    slot.sequence.store(tail + mask + 1, std::memory_order_release);
+    ++tail;
+    return true;
+}
+
+auto mbt::RingBuffer::dropped() const -> std::uint64_t
+{
+    return dropped_count.load(std::memory_order_relaxed);
+}
+
+mbt::Writer::Writer(std::string const& filename, std::size_t capacity) :
+    start{steady_clock::now()},
+    buffer{capacity},
+    file{std::fopen(filename.c_str(), "w")}
+{
+    if (!file)
+    {
+        BOOST_THROW_EXCEPTION((std::system_error{
+            errno, std::system_category(), "Failed to open window management trace file: " + filename}));
+    }
+
+    std::fwrite(&file_header, sizeof file_header, 1, file);
+
+    thread = std::thread{[this]
+        {
+            std::unique_lock<decltype(mutex)> lock{mutex};
+
+            while (!stopping)
+            {
+                wakeup.wait_for(lock, milliseconds{100});
+                drain();
+            }
+        }};
+}
+
+mbt::Writer::~Writer()
+{
+    {
+        std::lock_guard<decltype(mutex)> lock{mutex};
+        stopping = true;
+    }
+    wakeup.notify_one();
+    thread.join();
+
+    drain();
+    std::fclose(file);
+}
+
+void mbt::Writer::write(Record record)
+{
+    record.time = duration_cast<nanoseconds>(steady_clock::now() - start).count();
+    buffer.push(record);
+}
+
+void mbt::Writer::write(Call call, std::uint64_t subject, char const* text)
+{
+    Record records[max_text_records];
+    auto const time = duration_cast<nanoseconds>(steady_clock::now() - start).count();
+
+    auto length = std::min<std::size_t>(std::strlen(text), max_text_records * Record::max_text);
+    std::size_t count = 0;
+
+    do
+    {
+        auto& record = records[count];
+        record = Record{};
+        record.time = time;
+        record.call = call;
+        record.subject = subject;
+
+        auto const chunk = std::min<std::size_t>(length, Record::max_text);
+        std::memcpy(record.text, text, chunk);
+        text += chunk;
+        length -= chunk;
+        record.flags = (count ? Record::continued_text : 0) | (length ? Record::more_text : 0);
+        ++count;
+    }
+    while (length);
+
+    buffer.push(records, count);
+}
+
+// Only called from the writer thread (or once it has stopped)
+void mbt::Writer::drain()
+{
+    Record records[64];
+    std::size_t count = 0;
+
+    while (buffer.pop(records[count]))
+    {
+        if (++count == sizeof records/sizeof records[0])
+        {
+            std::fwrite(records, sizeof records[0], count, file);
+            count = 0;
+        }
+    }
+
+    auto const dropped = buffer.dropped();
+    if (dropped != dropped_written)
+    {
+        auto& record = records[count++];
+        record = Record{};
+        record.time = duration_cast<nanoseconds>(steady_clock::now() - start).count();
+        record.call = Call::dropped;
+        record.count = dropped - dropped_written;
+        dropped_written = dropped;
+    }
+
+    std::fwrite(records, sizeof records[0], count, file);
+    std::fflush(file);
+}
+
+namespace
+{
+// What identifies the subject and object of a record
+enum class Id { none, window, application, workspace };
+
+// What is in the values of a record (following the window info, if there is one)
+enum class Values { none, state, point, size, displacement, rectangle, edge, keyboard, pointer, touch };
+
+struct Layout
+{
+    char const* name;
+    Id subject;
+    char const* subject_label;
+    bool window_info;           // The subject is shown with its type, state, position and size
+    Values values;
+    char const* values_label;
+    Id object;
+    char const* object_label;   // "->" shows the object as the result
+    char const* count_label;
+};
+
+auto layout_of(mbt::Call call) -> Layout
+{
+    using mbt::Call;
+
+    auto const none = Id::none;
+    auto const window = Id::window;
+    auto const application = Id::application;
+    auto const workspace = Id::workspace;
+
+    switch (call)
+    {
+    case Call::count_applications:
+        return {"count_applications", none, nullptr, false, Values::none, nullptr, none, nullptr, "->"};
+    case Call::for_each_application:
+        return {"for_each_application", none, nullptr, false, Values::none, nullptr, none, nullptr, nullptr};
+    case Call::find_application:
+        return {"find_application", none, nullptr, false, Values::none, nullptr, application, "->", nullptr};
+    case Call::info_for_application:
+        return {"info_for", none, nullptr, false, Values::none, nullptr, application, "->", nullptr};
+    case Call::info_for_window:
+        return {"info_for", none, nullptr, false, Values::none, nullptr, window, "->", nullptr};
+    case Call::ask_client_to_close:
+        return {"ask_client_to_close", window, "window", false, Values::none, nullptr, none, nullptr, nullptr};
+    case Call::force_close:
+        return {"force_close", window, "window", false, Values::none, nullptr, none, nullptr, nullptr};
+    case Call::active_window:
+        return {"active_window", none, nullptr, false, Values::none, nullptr, window, "->", nullptr};
+    case Call::select_active_window:
+        return {"select_active_window", window, "hint", false, Values::none, nullptr, window, "->", nullptr};
+    case Call::window_at:
+        return {"window_at", none, nullptr, false, Values::point, "cursor", window, "->", nullptr};
+    case Call::active_output:
+        return {"active_output", none, nullptr, false, Values::rectangle, "->", none, nullptr, nullptr};
+    case Call::info_for_window_id:
+        return {"info_for_window_id", none, nullptr, false, Values::none, nullptr, window, "->", nullptr};
+    case Call::id_for_window:
+        return {"id_for_window", window, "window", false, Values::none, nullptr, none, nullptr, nullptr};
+    case Call::place_and_size_for_state:
+        return {"place_and_size_for_state", window, "window_info", true, Values::none, nullptr, none, nullptr, nullptr};
+    case Call::drag_active_window:
+        return {"drag_active_window", none, nullptr, false, Values::displacement, "movement", none, nullptr, nullptr};
+    case Call::drag_window:
+        return {"drag_window", window, "window", false, Values::displacement, "movement", none, nullptr, nullptr};
+    case Call::focus_next_application:
+        return {"focus_next_application", none, nullptr, false, Values::none, nullptr, none, nullptr, nullptr};
+    case Call::focus_next_within_application:
+        return {"focus_next_within_application", none, nullptr, false, Values::none, nullptr, none, nullptr, nullptr};
+    case Call::focus_prev_within_application:
+        return {"focus_prev_within_application", none, nullptr, false, Values::none, nullptr, none, nullptr, nullptr};
+    case Call::raise_tree:
+        return {"raise_tree", window, "root", false, Values::none, nullptr, none, nullptr, nullptr};
+    case Call::start_drag_and_drop:
+        return {"start_drag_and_drop", window, "window_info", true, Values::none, nullptr, none, nullptr, nullptr};
+    case Call::end_drag_and_drop:
+        return {"end_drag_and_drop", none, nullptr, false, Values::none, nullptr, none, nullptr, nullptr};
+    case Call::modify_window:
+        return {"modify_window", window, "window_info", true, Values::none, nullptr, none, nullptr, nullptr};
+    case Call::invoke_under_lock:
+        return {"invoke_under_lock", none, nullptr, false, Values::none, nullptr, none, nullptr, nullptr};
+    case Call::create_workspace:
+        return {"create_workspace", none, nullptr, false, Values::none, nullptr, workspace, "->", nullptr};
+    case Call::add_tree_to_workspace:
+        return {"add_tree_to_workspace", window, "window", false, Values::none, nullptr, workspace, "workspace", nullptr};
+    case Call::remove_tree_from_workspace:
+        return {"remove_tree_from_workspace", window, "window", false, Values::none, nullptr, workspace, "workspace", nullptr};
+    case Call::move_workspace_content_to_workspace:
+        return {"move_workspace_content_to_workspace",
+                workspace, "to_workspace", false, Values::none, nullptr, workspace, "from_workspace", nullptr};
+    case Call::for_each_workspace_containing:
+        return {"for_each_workspace_containing", window, "window", false, Values::none, nullptr, none, nullptr, nullptr};
+    case Call::for_each_window_in_workspace:
+        return {"for_each_window_in_workspace", workspace, "workspace", false, Values::none, nullptr, none, nullptr, nullptr};
+    case Call::place_new_window:
+        return {"place_new_window", application, "app_info", false, Values::rectangle, "->", none, nullptr, nullptr};
+    case Call::handle_window_ready:
+        return {"handle_window_ready", window, "window_info", true, Values::none, nullptr, none, nullptr, nullptr};
+    case Call::handle_modify_window:
+        return {"handle_modify_window", window, "window_info", true, Values::none, nullptr, none, nullptr, nullptr};
+    case Call::handle_raise_window:
+        return {"handle_raise_window", window, "window_info", true, Values::none, nullptr, none, nullptr, nullptr};
+    case Call::handle_keyboard_event:
+        return {"handle_keyboard_event", none, nullptr, false, Values::keyboard, "event", none, nullptr, nullptr};
+    case Call::handle_touch_event:
+        return {"handle_touch_event", none, nullptr, false, Values::touch, "event", none, nullptr, "points"};
+    case Call::handle_pointer_event:
+        return {"handle_pointer_event", none, nullptr, false, Values::pointer, "event", none, nullptr, nullptr};
+    case Call::confirm_inherited_move:
+        return {"confirm_inherited_move", window, "window_info", true, Values::displacement, "movement", none, nullptr, nullptr};
+    case Call::advise_new_app:
+        return {"advise_new_app", application, "application", false, Values::none, nullptr, none, nullptr, nullptr};
+    case Call::advise_delete_app:
+        return {"advise_delete_app", application, "application", false, Values::none, nullptr, none, nullptr, nullptr};
+    case Call::advise_new_window:
+        return {"advise_new_window", window, "window_info", true, Values::none, nullptr, none, nullptr, nullptr};
+    case Call::advise_focus_lost:
+        return {"advise_focus_lost", window, "window_info", true, Values::none, nullptr, none, nullptr, nullptr};
+    case Call::advise_focus_gained:
+        return {"advise_focus_gained", window, "window_info", true, Values::none, nullptr, none, nullptr, nullptr};
+    case Call::advise_state_change:
+        return {"advise_state_change", window, "window_info", true, Values::state, "state", none, nullptr, nullptr};
+    case Call::advise_move_to:
+        return {"advise_move_to", window, "window_info", true, Values::point, "top_left", none, nullptr, nullptr};
+    case Call::advise_resize:
+        return {"advise_resize", window, "window_info", true, Values::size, "new_size", none, nullptr, nullptr};
+    case Call::advise_delete_window:
+        return {"advise_delete_window", window, "window_info", true, Values::none, nullptr, none, nullptr, nullptr};
+    case Call::advise_raise:
+        return {"advise_raise", window, "windows", false, Values::none, nullptr, none, nullptr, "count"};
+    case Call::handle_request_drag_and_drop:
+        return {"handle_request_drag_and_drop", window, "window_info", true, Values::none, nullptr, none, nullptr, nullptr};
+    case Call::handle_request_move:
+        return {"handle_request_move", window, "window_info", true, Values::none, nullptr, none, nullptr, nullptr};
+    case Call::handle_request_resize:
+        return {"handle_request_resize", window, "window_info", true, Values::edge, "edge", none, nullptr, nullptr};
+    case Call::advise_adding_to_workspace:
+        return {"advise_adding_to_workspace", workspace, "workspace", false, Values::none, nullptr, none, nullptr, "windows"};
+    case Call::advise_removing_from_workspace:
+        return {"advise_removing_from_workspace", workspace, "workspace", false, Values::none, nullptr, none, nullptr, "windows"};
+    case Call::confirm_placement_on_display:
+        return {"confirm_placement_on_display", window, "window_info", true, Values::none, nullptr, none, nullptr, nullptr};
+
+    case Call::window_name:
+    case Call::application_name:
+    case Call::exception:
+    case Call::end_of_batch:
+    case Call::dropped:
+        break;
+    }
+
+    return {nullptr, none, nullptr, false, Values::none, nullptr, none, nullptr, nullptr};
+}
+
+auto real(std::int32_t value) -> float
+{
+    float result;
+    std::memcpy(&result, &value, sizeof result);
+    return result;
+}
+
+class Decoder
+{
+public:
+    explicit Decoder(std::ostream& out) : out{out} {}
+
+    void decode(mbt::Record const& record)
+    {
+        if (is_text(record.call))
+        {
+            // Drop text that has lost its start (or whose end never came)
+            if (!continues_text(record))
+            {
+                text.clear();
+                if (record.flags & mbt::Record::continued_text)
+                {
+                    text_pending = false;
+                    return;
+                }
+            }
+
+            text.append(record.text, strnlen(record.text, sizeof record.text));
+            text_pending = record.flags & mbt::Record::more_text;
+            if (text_pending)
+            {
+                pending_call = record.call;
+                pending_subject = record.subject;
+                return;
+            }
+        }
+        else if (text_pending)
+        {
+            text.clear();
+            text_pending = false;
+        }
+
+        switch (record.call)
+        {
+        case mbt::Call::window_name:
+        case mbt::Call::application_name:
+            names[record.subject] = text;
+            break;
+
+        case mbt::Call::exception:
+            timestamp(record) << text << '\n';
+            break;
+
+        case mbt::Call::end_of_batch:
+            timestamp(record) << "====\n";
+            break;
+
+        case mbt::Call::dropped:
+            timestamp(record) << "(" << record.count << " records dropped)\n";
+            break;
+
+        default:
+            call(record);
+            out << '\n';
+        }
+
+        text.clear();
+    }
+
+private:
+    std::ostream& out;
+    std::map<std::uint64_t, std::string> names;
+    std::string text;
+    bool text_pending{false};
+    mbt::Call pending_call;
+    std::uint64_t pending_subject;
+
+    auto continues_text(mbt::Record const& record) const -> bool
+    {
+        return text_pending &&
+               (record.flags & mbt::Record::continued_text) &&
+               record.call == pending_call &&
+               record.subject == pending_subject;
+    }
+
+    static auto is_text(mbt::Call call) -> bool
+    {
+        return call == mbt::Call::window_name ||
+               call == mbt::Call::application_name ||
+               call == mbt::Call::exception;
+    }
+
+    auto timestamp(mbt::Record const& record) -> std::ostream&
+    {
+        return out << '[' << std::fixed << std::setprecision(6) << std::setw(13) << record.time/1e9 << "] ";
+    }
+
+    void id(Id kind, std::uint64_t value)
+    {
+        if (kind == Id::workspace)
+        {
+            out << "0x" << std::hex << value << std::dec;
+        }
+        else if (!value)
+        {
+            out << "(null)";
+        }
+        else
+        {
+            auto const name = names.find(value);
+            if (name != names.end())
+                out << name->second;
+            else
+                out << "#" << std::hex << value << std::dec;
+        }
+    }
+
+    void call(mbt::Record const& record)
+    {
+        using mir::operator<<;
+
+        auto const layout = layout_of(record.call);
+
+        if (!layout.name)
+        {
+            timestamp(record) << "(unknown record " << static_cast<unsigned>(record.call) << ")";
+            return;
+        }
+
+        timestamp(record) << layout.name;
+
+        auto value = record.args.value;
+
+        if (layout.subject_label)
+        {
+            out << ' ' << layout.subject_label << '=';
+
+            if (layout.window_info)
+            {
+                out << "{name=";
+                id(layout.subject, record.subject);
+                out << ", type=" << static_cast<MirWindowType>(value[0])
+                    << ", state=" << static_cast<MirWindowState>(value[1])
+                    << ", top_left=" << geom::Point{value[2], value[3]}
+                    << ", size=" << geom::Size{value[4], value[5]} << '}';
+                value += 6;
+            }
+            else
+            {
+                id(layout.subject, record.subject);
+            }
+        }
+
+        if (layout.values_label)
+        {
+            if (std::strcmp(layout.values_label, "->"))
+                out << ' ' << layout.values_label << '=';
+            else
+                out << " -> ";
+
+            switch (layout.values)
+            {
+            case Values::none:
+                break;
+
+            case Values::state:
+                out << static_cast<MirWindowState>(value[0]);
+                break;
+
+            case Values::point:
+                out << geom::Point{value[0], value[1]};
+                break;
+
+            case Values::size:
+                out << geom::Size{value[0], value[1]};
+                break;
+
+            case Values::displacement:
+                out << geom::Displacement{value[0], value[1]};
+                break;
+
+            case Values::rectangle:
+                out << geom::Rectangle{{value[0], value[1]}, {value[2], value[3]}};
+                break;
+
+            case Values::edge:
+                out << "0x" << std::hex << value[0] << std::dec;
+                break;
+
+            case Values::keyboard:
+                out << "{from=" << value[0]
+                    << ", action=" << static_cast<MirKeyboardAction>(value[1])
+                    << ", code=" << value[2]
+                    << ", scan=" << value[3]
+                    << ", modifiers=" << std::hex << value[4] << std::dec << '}';
+                break;
+
+            case Values::pointer:
+                out << "{from=" << value[0]
+                    << ", action=" << static_cast<MirPointerAction>(value[1])
+                    << ", button_state=" << value[2]
+                    << ", x=" << std::defaultfloat << real(value[3])
+                    << ", y=" << real(value[4])
+                    << ", modifiers=" << std::hex << value[5] << std::dec << '}';
+                break;
+
+            case Values::touch:
+                out << "{from=" << value[0]
+                    << ", action=" << static_cast<MirTouchAction>(value[1])
+                    << ", x=" << std::defaultfloat << real(value[2])
+                    << ", y=" << real(value[3])
+                    << ", modifiers=" << std::hex << value[4] << std::dec << '}';
+                break;
+            }
+        }
+
+        if (layout.object_label)
+        {
+            if (std::strcmp(layout.object_label, "->"))
+                out << ' ' << layout.object_label << '=';
+            else
+                out << " -> ";
+
+            id(layout.object, record.args.object);
+        }
+
+        if (layout.count_label)
+        {
+            if (std::strcmp(layout.count_label, "->"))
+                out << ' ' << layout.count_label << '=';
+            else
+                out << " -> ";
+
+            out << record.count;
+        }
+    }
+};
+}
+
+void mbt::decode(std::istream& in, std::ostream& out)
+{
+    FileHeader header;
+
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof header) ||
+        std::memcmp(header.magic, file_header.magic, sizeof header.magic) != 0)
+    {
+        BOOST_THROW_EXCEPTION(std::runtime_error{"Not a window management trace"});
+    }
+
+    if (header.version != file_header.version || header.record_size != file_header.record_size)
+    {
+        BOOST_THROW_EXCEPTION(std::runtime_error{
+            "Unsupported window management trace version: " + std::to_string(header.version)});
+    }
+
+    Decoder decoder{out};
+    Record record;
+
+    while (in.read(reinterpret_cast<char*>(&record), sizeof record))
+        decoder.decode(record);
+}
@@ -0,0 +1,211 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIRAL_WINDOW_MANAGEMENT_BINARY_TRACE_H
+#define MIRAL_WINDOW_MANAGEMENT_BINARY_TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace miral
+{
+/// A trace of window management that records fixed size records in a file, instead of logging text.
+/// Recording a call neither allocates nor takes a lock, so has little effect on timing.
+namespace binary_trace
+{
+enum class Call : std::uint16_t
+{
+    count_applications,
+    for_each_application,
+    find_application,
+    info_for_application,
+    info_for_window,
+    ask_client_to_close,
+    force_close,
+    active_window,
+    select_active_window,
+    window_at,
+    active_output,
+    info_for_window_id,
+    id_for_window,
+    place_and_size_for_state,
+    drag_active_window,
+    drag_window,
+    focus_next_application,
+    focus_next_within_application,
+    focus_prev_within_application,
+    raise_tree,
+    start_drag_and_drop,
+    end_drag_and_drop,
+    modify_window,
+    invoke_under_lock,
+    create_workspace,
+    add_tree_to_workspace,
+    remove_tree_from_workspace,
+    move_workspace_content_to_workspace,
+    for_each_workspace_containing,
+    for_each_window_in_workspace,
+    place_new_window,
+    handle_window_ready,
+    handle_modify_window,
+    handle_raise_window,
+    handle_keyboard_event,
+    handle_touch_event,
+    handle_pointer_event,
+    confirm_inherited_move,
+    advise_new_app,
+    advise_delete_app,
+    advise_new_window,
+    advise_focus_lost,
+    advise_focus_gained,
+    advise_state_change,
+    advise_move_to,
+    advise_resize,
+    advise_delete_window,
+    advise_raise,
+    handle_request_drag_and_drop,
+    handle_request_move,
+    handle_request_resize,
+    advise_adding_to_workspace,
+    advise_removing_from_workspace,
+    confirm_placement_on_display,
+
+    // Records that aren't calls
+    window_name,        ///< The text is the name of the subject window
+    application_name,   ///< The text is the name of the subject application
+    exception,          ///< The text is the function that threw and what was thrown
+    end_of_batch,       ///< The calls of one batch (between advise_begin() and advise_end()) are done
+    dropped,            ///< The count of records dropped because the buffer was full
+};
+
+/// What one call is recorded as.
+/// Windows, applications and workspaces are identified by their address. Their names are
+/// recorded separately (when they first appear or are changed), so each call is a single record.
+struct Record
+{
+    static unsigned constexpr max_values = 8;
+    static unsigned constexpr max_text = 40;
+
+    /// Set when the text continues in the next record
+    static std::uint16_t constexpr more_text = 1;
+
+    /// Set when the text continues that of the previous record
+    static std::uint16_t constexpr continued_text = 2;
+
+    struct Arguments
+    {
+        std::uint64_t object;   ///< Another window, application or workspace: often the result
+        std::int32_t value[max_values];
+    };
+
+    std::uint64_t time;         ///< Nanoseconds since the trace started
+    Call call;
+    std::uint16_t flags;
+    std::uint32_t count;
+    std::uint64_t subject;      ///< The window, application or workspace the call is about
+
+    union
+    {
+        Arguments args;
+        char text[max_text];
+    };
+};
+
+static_assert(sizeof(Record) == 64, "Records are meant to be a cache line");
+
+/// A bounded buffer that any number of threads can add records to without locking, and one
+/// thread takes them from. Records added while it is full are dropped (and counted).
+class RingBuffer
+{
+public:
+    /// capacity is rounded up to a power of two
+    explicit RingBuffer(std::size_t capacity);
+
+    auto push(Record const& record) -> bool;
+
+    /// Adds the records next to one another, or (if they don't all fit) drops them all
+    auto push(Record const* records, std::size_t count) -> bool;
+    auto pop(Record& record) -> bool;
+
+    auto dropped() const -> std::uint64_t;
+
+private:
+    struct Slot
+    {
+        std::atomic<std::uint64_t> sequence;
+        Record record;
+    };
+
+    std::size_t const mask;
+    std::unique_ptr<Slot[]> const slots;
+    std::atomic<std::uint64_t> head{0};
+    std::uint64_t tail{0};
+    std::atomic<std::uint64_t> dropped_count{0};
+};
+
+/// Records into a RingBuffer and, on a thread of its own, writes them to a file
+class Writer
+{
+public:
+    static std::size_t constexpr default_capacity = 4096;
+
+    /// Text that doesn't fit in this many records is truncated
+    static std::size_t constexpr max_text_records = 8;
+
+    explicit Writer(std::string const& filename, std::size_t capacity = default_capacity);
+
+    /// Writes out everything recorded before returning
+    ~Writer();
+
+    /// Records the call (and sets the time of the record)
+    void write(Record record);
+
+    /// Records the text, split over as many records as it needs (up to max_text_records).
+    /// The records are added together, so other threads' records never come between them.
+    void write(Call call, std::uint64_t subject, char const* text);
+
+private:
+    Writer(Writer const&) = delete;
+    Writer& operator=(Writer const&) = delete;
+
+    void drain();
+
+    std::chrono::steady_clock::time_point const start;
+    RingBuffer buffer;
+    std::FILE* const file;
+    std::uint64_t dropped_written{0};
+
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    bool stopping{false};
+    std::thread thread;
+};
+
+/// Writes the human readable form of the trace read from in to out.
+/// \throws std::runtime_error if in isn't a trace
+void decode(std::istream& in, std::ostream& out);
+}
+}
+
+#endif //MIRAL_WINDOW_MANAGEMENT_BINARY_TRACE_H
@@ -35,6 +35,7 @@ namespace
 char const* const wm_option = "window-manager";
 char const* const wm_system_compositor = "system-compositor";
 char const* const trace_option = "window-management-trace";
+char const* const trace_file_option = "window-management-trace-file";
 }
 
 void miral::WindowManagerOptions::operator()(mir::Server& server) const
@@ -48,6 +49,8 @@ void miral::WindowManagerOptions::operator()(mir::Server& server) const
 
     server.add_configuration_option(wm_option, description, policies.begin()->name);
     server.add_configuration_option(trace_option, "log trace message", mir::OptionType::null);
+    server.add_configuration_option(trace_file_option,
+        "record a binary trace in the file given (decode with miral-wm-trace-decode)", mir::OptionType::string);
 
     server.override_the_window_manager_builder([this, &server](msh::FocusController* focus_controller)
         -> std::shared_ptr<msh::WindowManager>
@@ -62,11 +65,17 @@ void miral::WindowManagerOptions::operator()(mir::Server& server) const
             {
                 if (selection == option.name)
                 {
-                    if (server.get_options()->is_set(trace_option))
+                    if (server.get_options()->is_set(trace_option) || server.get_options()->is_set(trace_file_option))
                     {
-                        auto trace_builder = [&option](WindowManagerTools const& tools) -> std::unique_ptr<miral::WindowManagementPolicy>
+                        auto const trace_file = server.get_options()->is_set(trace_file_option) ?
+                            server.get_options()->get<std::string>(trace_file_option) : std::string{};
+
+                        auto trace_builder = [&option, trace_file](WindowManagerTools const& tools) -> std::unique_ptr<miral::WindowManagementPolicy>
                             {
-                                return std::make_unique<WindowManagementTrace>(tools, option.build);
+                                if (trace_file.empty())
+                                    return std::make_unique<WindowManagementTrace>(tools, option.build);
+                                else
+                                    return std::make_unique<WindowManagementTrace>(tools, option.build, trace_file);
                             };
 
                         return std::make_shared<BasicWindowManager>(
@@ -26,6 +26,8 @@
 #include <mir/scene/surface.h>
 #include <mir/event_printer.h>
 
+#include <cstdio>
+#include <cstring>
 #include <iomanip>
 #include <sstream>
 
@@ -38,9 +40,16 @@ using mir::operator<<;
 #define MIRAL_TRACE_EXCEPTION \
 catch (std::exception const& x)\
 {\
-    std::stringstream out;\
-    mir::report_exception(out);\
-    mir::log_warning("%s throws %s", __func__, out.str().c_str());\
+    if (binary)\
+    {\
+        trace_exception(*binary, __func__, x);\
+    }\
+    else\
+    {\
+        std::stringstream out;\
+        mir::report_exception(out);\
+        mir::log_warning("%s throws %s", __func__, out.str().c_str());\
+    }\
     throw;\
 }
 
@@ -330,6 +339,130 @@ auto dump_of(mir::geometry::Size const size) -> std::string
     out << size;
     return out.str();
 }
+
+namespace mbt = miral::binary_trace;
+
+template<typename Type>
+auto id_of(std::shared_ptr<Type> const& object) -> std::uint64_t
+{
+    return reinterpret_cast<std::uintptr_t>(object.get());
+}
+
+auto id_of(miral::Window const& window) -> std::uint64_t
+{
+    return id_of(std::shared_ptr<mir::scene::Surface>(window));
+}
+
+// Builds the record of a call, for the binary trace
+struct Entry
+{
+    explicit Entry(mbt::Call call) : record{} { record.call = call; }
+
+    auto subject(std::uint64_t id) -> Entry& { record.subject = id; return *this; }
+    auto object(std::uint64_t id) -> Entry& { record.args.object = id; return *this; }
+    auto count(std::size_t count) -> Entry& { record.count = count; return *this; }
+
+    auto value(std::int32_t value) -> Entry&
+    {
+        if (values != mbt::Record::max_values)
+            record.args.value[values++] = value;
+        return *this;
+    }
+
+    auto real(float value) -> Entry&
+    {
+        std::int32_t bits;
+        std::memcpy(&bits, &value, sizeof bits);
+        return this->value(bits);
+    }
+
+    auto point(mir::geometry::Point point) -> Entry&
+    {
+        return value(point.x.as_int()).value(point.y.as_int());
+    }
+
+    auto size(mir::geometry::Size size) -> Entry&
+    {
+        return value(size.width.as_int()).value(size.height.as_int());
+    }
+
+    auto displacement(mir::geometry::Displacement displacement) -> Entry&
+    {
+        return value(displacement.dx.as_int()).value(displacement.dy.as_int());
+    }
+
+    auto window_info(miral::WindowInfo const& info) -> Entry&
+    {
+        return subject(id_of(info.window()))
+            .value(info.type())
+            .value(info.state())
+            .point(info.window().top_left())
+            .size(info.window().size());
+    }
+
+    operator mbt::Record const&() const { return record; }
+
+    mbt::Record record;
+    unsigned values{0};
+};
+
+auto entry_for(MirKeyboardEvent const* event) -> Entry
+{
+    Entry entry{mbt::Call::handle_keyboard_event};
+    entry.value(mir_input_event_get_device_id(mir_keyboard_event_input_event(event)))
+        .value(mir_keyboard_event_action(event))
+        .value(mir_keyboard_event_key_code(event))
+        .value(mir_keyboard_event_scan_code(event))
+        .value(mir_keyboard_event_modifiers(event));
+    return entry;
+}
+
+auto entry_for(MirTouchEvent const* event) -> Entry
+{
+    Entry entry{mbt::Call::handle_touch_event};
+    entry.count(mir_touch_event_point_count(event))
+        .value(mir_input_event_get_device_id(mir_touch_event_input_event(event)));
+
+    // Only the first touch fits in a record
+    if (mir_touch_event_point_count(event) > 0)
+    {
+        entry.value(mir_touch_event_action(event, 0))
+            .real(mir_touch_event_axis_value(event, 0, mir_touch_axis_x))
+            .real(mir_touch_event_axis_value(event, 0, mir_touch_axis_y));
+    }
+    else
+    {
+        entry.value(0).real(0).real(0);
+    }
+
+    entry.value(mir_touch_event_modifiers(event));
+    return entry;
+}
+
+auto entry_for(MirPointerEvent const* event) -> Entry
+{
+    unsigned int button_state = 0;
+
+    for (auto const a : {mir_pointer_button_primary, mir_pointer_button_secondary, mir_pointer_button_tertiary,
+                         mir_pointer_button_back, mir_pointer_button_forward})
+        button_state |= mir_pointer_event_button_state(event, a) ? a : 0;
+
+    Entry entry{mbt::Call::handle_pointer_event};
+    entry.value(mir_input_event_get_device_id(mir_pointer_event_input_event(event)))
+        .value(mir_pointer_event_action(event))
+        .value(button_state)
+        .real(mir_pointer_event_axis_value(event, mir_pointer_axis_x))
+        .real(mir_pointer_event_axis_value(event, mir_pointer_axis_y))
+        .value(mir_pointer_event_modifiers(event));
+    return entry;
+}
+
+void trace_exception(mbt::Writer& binary, char const* function, std::exception const& exception)
+{
+    char text[256];
+    std::snprintf(text, sizeof text, "%s throws %s", function, exception.what());
+    binary.write(mbt::Call::exception, 0, text);
+}
 }
 
 miral::WindowManagementTrace::WindowManagementTrace(
@@ -340,11 +473,29 @@ miral::WindowManagementTrace::WindowManagementTrace(
 {
 }
 
+miral::WindowManagementTrace::WindowManagementTrace(
+    WindowManagerTools const& wrapped,
+    WindowManagementPolicyBuilder const& builder,
+    std::string const& binary_trace_file) :
+    wrapped{wrapped},
+    binary{std::make_unique<binary_trace::Writer>(binary_trace_file)},
+    policy(builder(WindowManagerTools{this}))
+{
+}
+
+miral::WindowManagementTrace::~WindowManagementTrace() = default;
+
+auto miral::WindowManagementTrace::pointer_motion_policy() const -> PointerMotionPolicy*
+{
+    return dynamic_cast<PointerMotionPolicy*>(policy.get());
+}
+
 auto miral::WindowManagementTrace::count_applications() const -> unsigned int
 try {
     log_input();
     auto const result = wrapped.count_applications();
-    mir::log_info("%s -> %d", __func__, result);
+    if (binary) binary->write(Entry{mbt::Call::count_applications}.count(result));
+    else mir::log_info("%s -> %d", __func__, result);
     trace_count++;
     return result;
 }
@@ -353,7 +504,8 @@ MIRAL_TRACE_EXCEPTION
 void miral::WindowManagementTrace::for_each_application(std::function<void(miral::ApplicationInfo&)> const& functor)
 try {
     log_input();
-    mir::log_info("%s", __func__);
+    if (binary) binary->write(Entry{mbt::Call::for_each_application});
+    else mir::log_info("%s", __func__);
     trace_count++;
     wrapped.for_each_application(functor);
 }
@@ -364,7 +516,8 @@ auto miral::WindowManagementTrace::find_application(std::function<bool(Applicati
 try {
     log_input();
     auto result = wrapped.find_application(predicate);
-    mir::log_info("%s -> %s", __func__, dump_of(result).c_str());
+    if (binary) binary->write(Entry{mbt::Call::find_application}.object(id_of(result)));
+    else mir::log_info("%s -> %s", __func__, dump_of(result).c_str());
     trace_count++;
     return result;
 }
@@ -374,7 +527,8 @@ auto miral::WindowManagementTrace::info_for(std::weak_ptr<mir::scene::Session> c
 try {
     log_input();
     auto& result = wrapped.info_for(session);
-    mir::log_info("%s -> %s", __func__, result.application()->name().c_str());
+    if (binary) binary->write(Entry{mbt::Call::info_for_application}.object(id_of(result.application())));
+    else mir::log_info("%s -> %s", __func__, result.application()->name().c_str());
     trace_count++;
     return result;
 }
@@ -384,7 +538,8 @@ auto miral::WindowManagementTrace::info_for(std::weak_ptr<mir::scene::Surface> c
 try {
     log_input();
     auto& result = wrapped.info_for(surface);
-    mir::log_info("%s -> %s", __func__, result.name().c_str());
+    if (binary) binary->write(Entry{mbt::Call::info_for_window}.object(id_of(result.window())));
+    else mir::log_info("%s -> %s", __func__, result.name().c_str());
     trace_count++;
     return result;
 }
@@ -394,7 +549,8 @@ auto miral::WindowManagementTrace::info_for(Window const& window) const -> Windo
 try {
     log_input();
     auto& result = wrapped.info_for(window);
-    mir::log_info("%s -> %s", __func__, result.name().c_str());
+    if (binary) binary->write(Entry{mbt::Call::info_for_window}.object(id_of(result.window())));
+    else mir::log_info("%s -> %s", __func__, result.name().c_str());
     trace_count++;
     return result;
 }
@@ -403,7 +559,8 @@ MIRAL_TRACE_EXCEPTION
 void miral::WindowManagementTrace::ask_client_to_close(miral::Window const& window)
 try {
     log_input();
-    mir::log_info("%s -> %s", __func__, dump_of(window).c_str());
+    if (binary) binary->write(Entry{mbt::Call::ask_client_to_close}.subject(id_of(window)));
+    else mir::log_info("%s -> %s", __func__, dump_of(window).c_str());
     trace_count++;
     wrapped.ask_client_to_close(window);
 }
@@ -412,7 +569,8 @@ MIRAL_TRACE_EXCEPTION
 void miral::WindowManagementTrace::force_close(miral::Window const& window)
 try {
     log_input();
-    mir::log_info("%s -> %s", __func__, dump_of(window).c_str());
+    if (binary) binary->write(Entry{mbt::Call::force_close}.subject(id_of(window)));
+    else mir::log_info("%s -> %s", __func__, dump_of(window).c_str());
     trace_count++;
     wrapped.force_close(window);
 }
@@ -422,7 +580,8 @@ auto miral::WindowManagementTrace::active_window() const -> Window
 try {
     log_input();
     auto result = wrapped.active_window();
-    mir::log_info("%s -> %s", __func__, dump_of(result).c_str());
+    if (binary) binary->write(Entry{mbt::Call::active_window}.object(id_of(result)));
+    else mir::log_info("%s -> %s", __func__, dump_of(result).c_str());
     trace_count++;
     return result;
 }
@@ -432,7 +591,8 @@ auto miral::WindowManagementTrace::select_active_window(Window const& hint) -> W
 try {
     log_input();
     auto result = wrapped.select_active_window(hint);
-    mir::log_info("%s hint=%s -> %s", __func__, dump_of(hint).c_str(), dump_of(result).c_str());
+    if (binary) binary->write(Entry{mbt::Call::select_active_window}.subject(id_of(hint)).object(id_of(result)));
+    else mir::log_info("%s hint=%s -> %s", __func__, dump_of(hint).c_str(), dump_of(result).c_str());
     trace_count++;
     return result;
 }
@@ -442,9 +602,16 @@ auto miral::WindowManagementTrace::window_at(mir::geometry::Point cursor) const
 try {
     log_input();
     auto result = wrapped.window_at(cursor);
-    std::stringstream out;
-    out << cursor << " -> " << dump_of(result);
-    mir::log_info("%s cursor=%s", __func__, out.str().c_str());
+    if (binary)
+    {
+        binary->write(Entry{mbt::Call::window_at}.point(cursor).object(id_of(result)));
+    }
+    else
+    {
+        std::stringstream out;
+        out << cursor << " -> " << dump_of(result);
+        mir::log_info("%s cursor=%s", __func__, out.str().c_str());
+    }
     trace_count++;
     return result;
 }
@@ -454,9 +621,16 @@ auto miral::WindowManagementTrace::active_output() -> mir::geometry::Rectangle c
 try {
     log_input();
     auto result = wrapped.active_output();
-    std::stringstream out;
-    out << result;
-    mir::log_info("%s -> ", __func__, out.str().c_str());
+    if (binary)
+    {
+        binary->write(Entry{mbt::Call::active_output}.point(result.top_left).size(result.size));
+    }
+    else
+    {
+        std::stringstream out;
+        out << result;
+        mir::log_info("%s -> ", __func__, out.str().c_str());
+    }
     trace_count++;
     return result;
 }
@@ -466,7 +640,8 @@ auto miral::WindowManagementTrace::info_for_window_id(std::string const& id) con
 try {
     log_input();
     auto& result = wrapped.info_for_window_id(id);
-    mir::log_info("%s id=%s -> %s", __func__, id.c_str(), dump_of(result).c_str());
+    if (binary) binary->write(Entry{mbt::Call::info_for_window_id}.object(id_of(result.window())));
+    else mir::log_info("%s id=%s -> %s", __func__, id.c_str(), dump_of(result).c_str());
     trace_count++;
     return result;
 }
@@ -476,7 +651,8 @@ auto miral::WindowManagementTrace::id_for_window(Window const& window) const ->
 try {
     log_input();
     auto result = wrapped.id_for_window(window);
-    mir::log_info("%s window=%s -> %s", __func__, dump_of(window).c_str(), result.c_str());
+    if (binary) binary->write(Entry{mbt::Call::id_for_window}.subject(id_of(window)));
+    else mir::log_info("%s window=%s -> %s", __func__, dump_of(window).c_str(), result.c_str());
     trace_count++;
     return result;
 }
@@ -486,7 +662,8 @@ void miral::WindowManagementTrace::place_and_size_for_state(
     WindowSpecification& modifications, WindowInfo const& window_info) const
 try {
     log_input();
-    mir::log_info("%s modifications=%s window_info=%s", __func__, dump_of(modifications).c_str(), dump_of(window_info).c_str());
+    if (binary) binary->write(Entry{mbt::Call::place_and_size_for_state}.window_info(window_info));
+    else mir::log_info("%s modifications=%s window_info=%s", __func__, dump_of(modifications).c_str(), dump_of(window_info).c_str());
     wrapped.place_and_size_for_state(modifications, window_info);
 }
 MIRAL_TRACE_EXCEPTION
@@ -494,9 +671,16 @@ MIRAL_TRACE_EXCEPTION
 void miral::WindowManagementTrace::drag_active_window(mir::geometry::Displacement movement)
 try {
     log_input();
-    std::stringstream out;
-    out << movement;
-    mir::log_info("%s movement=%s", __func__, out.str().c_str());
+    if (binary)
+    {
+        binary->write(Entry{mbt::Call::drag_active_window}.displacement(movement));
+    }
+    else
+    {
+        std::stringstream out;
+        out << movement;
+        mir::log_info("%s movement=%s", __func__, out.str().c_str());
+    }
     trace_count++;
     wrapped.drag_active_window(movement);
 }
@@ -505,9 +689,16 @@ MIRAL_TRACE_EXCEPTION
 void miral::WindowManagementTrace::drag_window(Window const& window, mir::geometry::Displacement& movement)
 try {
     log_input();
-    std::stringstream out;
-    out << movement;
-    mir::log_info("%s window=%s -> %s", __func__, dump_of(window).c_str(), out.str().c_str());
+    if (binary)
+    {
+        binary->write(Entry{mbt::Call::drag_window}.subject(id_of(window)).displacement(movement));
+    }
+    else
+    {
+        std::stringstream out;
+        out << movement;
+        mir::log_info("%s window=%s -> %s", __func__, dump_of(window).c_str(), out.str().c_str());
+    }
     trace_count++;
     wrapped.drag_window(window, movement);
 }
@@ -516,7 +707,8 @@ MIRAL_TRACE_EXCEPTION
 void miral::WindowManagementTrace::focus_next_application()
 try {
     log_input();
-    mir::log_info("%s", __func__);
+    if (binary) binary->write(Entry{mbt::Call::focus_next_application});
+    else mir::log_info("%s", __func__);
     trace_count++;
     wrapped.focus_next_application();
 }
@@ -525,7 +717,8 @@ MIRAL_TRACE_EXCEPTION
 void miral::WindowManagementTrace::focus_next_within_application()
 try {
     log_input();
-    mir::log_info("%s", __func__);
+    if (binary) binary->write(Entry{mbt::Call::focus_next_within_application});
+    else mir::log_info("%s", __func__);
     trace_count++;
     wrapped.focus_next_within_application();
 }
@@ -534,7 +727,8 @@ MIRAL_TRACE_EXCEPTION
 void miral::WindowManagementTrace::focus_prev_within_application()
 try {
     log_input();
-    mir::log_info("%s", __func__);
+    if (binary) binary->write(Entry{mbt::Call::focus_prev_within_application});
+    else mir::log_info("%s", __func__);
     trace_count++;
     wrapped.focus_prev_within_application();
 }
@@ -543,7 +737,8 @@ MIRAL_TRACE_EXCEPTION
 void miral::WindowManagementTrace::raise_tree(miral::Window const& root)
 try {
     log_input();
-    mir::log_info("%s root=%s", __func__, dump_of(root).c_str());
+    if (binary) binary->write(Entry{mbt::Call::raise_tree}.subject(id_of(root)));
+    else mir::log_info("%s root=%s", __func__, dump_of(root).c_str());
     trace_count++;
     wrapped.raise_tree(root);
 }
@@ -552,7 +747,8 @@ MIRAL_TRACE_EXCEPTION
 void miral::WindowManagementTrace::start_drag_and_drop(miral::WindowInfo& window_info, std::vector<uint8_t> const& handle)
 try {
     log_input();
-    mir::log_info("%s window_info=%s", __func__, dump_of(window_info).c_str());
+    if (binary) binary->write(Entry{mbt::Call::start_drag_and_drop}.window_info(window_info));
+    else mir::log_info("%s window_info=%s", __func__, dump_of(window_info).c_str());
     trace_count++;
     wrapped.start_drag_and_drop(window_info, handle);
 }
@@ -561,7 +757,8 @@ MIRAL_TRACE_EXCEPTION
 void miral::WindowManagementTrace::end_drag_and_drop()
 try {
     log_input();
-    mir::log_info("%s window_info=%s", __func__);
+    if (binary) binary->write(Entry{mbt::Call::end_drag_and_drop});
+    else mir::log_info("%s window_info=%s", __func__);
     trace_count++;
     wrapped.end_drag_and_drop();
 }
@@ -571,8 +768,17 @@ void miral::WindowManagementTrace::modify_window(
     miral::WindowInfo& window_info, miral::WindowSpecification const& modifications)
 try {
     log_input();
-    mir::log_info("%s window_info=%s, modifications=%s",
-                  __func__, dump_of(window_info).c_str(), dump_of(modifications).c_str());
+    if (binary)
+    {
+        binary->write(Entry{mbt::Call::modify_window}.window_info(window_info));
+        if (modifications.name().is_set())
+            binary->write(mbt::Call::window_name, id_of(window_info.window()), modifications.name().value().c_str());
+    }
+    else
+    {
+        mir::log_info("%s window_info=%s, modifications=%s",
+                      __func__, dump_of(window_info).c_str(), dump_of(modifications).c_str());
+    }
     trace_count++;
     wrapped.modify_window(window_info, modifications);
 }
@@ -580,22 +786,31 @@ MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::invoke_under_lock(std::function<void()> const& callback)
 try {
-    mir::log_info("%s", __func__);
+    if (binary) binary->write(Entry{mbt::Call::invoke_under_lock});
+    else mir::log_info("%s", __func__);
     wrapped.invoke_under_lock(callback);
 }
 MIRAL_TRACE_EXCEPTION
 
 auto miral::WindowManagementTrace::create_workspace() -> std::shared_ptr<Workspace>
 try {
-    mir::log_info("%s", __func__);
-    return wrapped.create_workspace();
+    if (!binary)
+        mir::log_info("%s", __func__);
+
+    auto result = wrapped.create_workspace();
+
+    if (binary)
+        binary->write(Entry{mbt::Call::create_workspace}.object(id_of(result)));
+
+    return result;
 }
 MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::add_tree_to_workspace(
     miral::Window const& window, std::shared_ptr<miral::Workspace> const& workspace)
 try {
-    mir::log_info("%s window=%s, workspace =%p", __func__, dump_of(window).c_str(), workspace.get());
+    if (binary) binary->write(Entry{mbt::Call::add_tree_to_workspace}.subject(id_of(window)).object(id_of(workspace)));
+    else mir::log_info("%s window=%s, workspace =%p", __func__, dump_of(window).c_str(), workspace.get());
     wrapped.add_tree_to_workspace(window, workspace);
 }
 MIRAL_TRACE_EXCEPTION
@@ -603,7 +818,8 @@ MIRAL_TRACE_EXCEPTION
 void miral::WindowManagementTrace::remove_tree_from_workspace(
     miral::Window const& window, std::shared_ptr<miral::Workspace> const& workspace)
 try {
-    mir::log_info("%s window=%s, workspace =%p", __func__, dump_of(window).c_str(), workspace.get());
+    if (binary) binary->write(Entry{mbt::Call::remove_tree_from_workspace}.subject(id_of(window)).object(id_of(workspace)));
+    else mir::log_info("%s window=%s, workspace =%p", __func__, dump_of(window).c_str(), workspace.get());
     wrapped.remove_tree_from_workspace(window, workspace);
 }
 MIRAL_TRACE_EXCEPTION
@@ -611,7 +827,16 @@ MIRAL_TRACE_EXCEPTION
 void miral::WindowManagementTrace::move_workspace_content_to_workspace(
     std::shared_ptr<Workspace> const& to_workspace, std::shared_ptr<Workspace> const& from_workspace)
 try {
-    mir::log_info("%s to_workspace=%p, from_workspace=%p", __func__, to_workspace.get(), from_workspace.get());
+    if (binary)
+    {
+        binary->write(Entry{mbt::Call::move_workspace_content_to_workspace}
+            .subject(id_of(to_workspace))
+            .object(id_of(from_workspace)));
+    }
+    else
+    {
+        mir::log_info("%s to_workspace=%p, from_workspace=%p", __func__, to_workspace.get(), from_workspace.get());
+    }
     wrapped.move_workspace_content_to_workspace(to_workspace, from_workspace);
 }
 MIRAL_TRACE_EXCEPTION
@@ -619,7 +844,8 @@ MIRAL_TRACE_EXCEPTION
 void miral::WindowManagementTrace::for_each_workspace_containing(
     miral::Window const& window, std::function<void(std::shared_ptr<miral::Workspace> const&)> const& callback)
 try {
-    mir::log_info("%s window=%s", __func__, dump_of(window).c_str());
+    if (binary) binary->write(Entry{mbt::Call::for_each_workspace_containing}.subject(id_of(window)));
+    else mir::log_info("%s window=%s", __func__, dump_of(window).c_str());
     wrapped.for_each_workspace_containing(window, callback);
 }
 MIRAL_TRACE_EXCEPTION
@@ -627,7 +853,8 @@ MIRAL_TRACE_EXCEPTION
 void miral::WindowManagementTrace::for_each_window_in_workspace(
     std::shared_ptr<miral::Workspace> const& workspace, std::function<void(miral::Window const&)> const& callback)
 try {
-    mir::log_info("%s workspace =%p", __func__, workspace.get());
+    if (binary) binary->write(Entry{mbt::Call::for_each_window_in_workspace}.subject(id_of(workspace)));
+    else mir::log_info("%s workspace =%p", __func__, workspace.get());
     wrapped.for_each_window_in_workspace(workspace, callback);
 }
 MIRAL_TRACE_EXCEPTION
@@ -637,15 +864,27 @@ auto miral::WindowManagementTrace::place_new_window(
     WindowSpecification const& requested_specification) -> WindowSpecification
 try {
     auto const result = policy->place_new_window(app_info, requested_specification);
-    mir::log_info("%s app_info=%s, requested_specification=%s -> %s",
-              __func__, dump_of(app_info).c_str(), dump_of(requested_specification).c_str(), dump_of(result).c_str());
+    if (binary)
+    {
+        Entry entry{mbt::Call::place_new_window};
+        entry.subject(id_of(app_info.application()));
+        entry.point(result.top_left().is_set() ? result.top_left().value() : mir::geometry::Point{});
+        entry.size(result.size().is_set() ? result.size().value() : mir::geometry::Size{});
+        binary->write(entry);
+    }
+    else
+    {
+        mir::log_info("%s app_info=%s, requested_specification=%s -> %s",
+                  __func__, dump_of(app_info).c_str(), dump_of(requested_specification).c_str(), dump_of(result).c_str());
+    }
     return result;
 }
 MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::handle_window_ready(miral::WindowInfo& window_info)
 try {
-    mir::log_info("%s window_info=%s", __func__, dump_of(window_info).c_str());
+    if (binary) binary->write(Entry{mbt::Call::handle_window_ready}.window_info(window_info));
+    else mir::log_info("%s window_info=%s", __func__, dump_of(window_info).c_str());
     policy->handle_window_ready(window_info);
 }
 MIRAL_TRACE_EXCEPTION
@@ -653,26 +892,45 @@ MIRAL_TRACE_EXCEPTION
 void miral::WindowManagementTrace::handle_modify_window(
     miral::WindowInfo& window_info, miral::WindowSpecification const& modifications)
 try {
-    mir::log_info("%s window_info=%s, modifications=%s",
-                  __func__, dump_of(window_info).c_str(), dump_of(modifications).c_str());
+    if (binary)
+    {
+        binary->write(Entry{mbt::Call::handle_modify_window}.window_info(window_info));
+    }
+    else
+    {
+        mir::log_info("%s window_info=%s, modifications=%s",
+                      __func__, dump_of(window_info).c_str(), dump_of(modifications).c_str());
+    }
     policy->handle_modify_window(window_info, modifications);
 }
 MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::handle_raise_window(miral::WindowInfo& window_info)
 try {
-    mir::log_info("%s window_info=%s", __func__, dump_of(window_info).c_str());
+    if (binary) binary->write(Entry{mbt::Call::handle_raise_window}.window_info(window_info));
+    else mir::log_info("%s window_info=%s", __func__, dump_of(window_info).c_str());
     policy->handle_raise_window(window_info);
 }
 MIRAL_TRACE_EXCEPTION
 
 bool miral::WindowManagementTrace::handle_keyboard_event(MirKeyboardEvent const* event)
 try {
-    log_input = [event, this]
-        {
-            mir::log_info("handle_keyboard_event event=%s", dump_of(event).c_str());
-            log_input = []{};
-        };
+    if (binary)
+    {
+        log_input = [event, this]
+            {
+                binary->write(entry_for(event));
+                log_input = []{};
+            };
+    }
+    else
+    {
+        log_input = [event, this]
+            {
+                mir::log_info("handle_keyboard_event event=%s", dump_of(event).c_str());
+                log_input = []{};
+            };
+    }
 
     return policy->handle_keyboard_event(event);
 }
@@ -680,11 +938,22 @@ MIRAL_TRACE_EXCEPTION
 
 bool miral::WindowManagementTrace::handle_touch_event(MirTouchEvent const* event)
 try {
-    log_input = [event, this]
-        {
-            mir::log_info("handle_touch_event event=%s", dump_of(event).c_str());
-            log_input = []{};
-        };
+    if (binary)
+    {
+        log_input = [event, this]
+            {
+                binary->write(entry_for(event));
+                log_input = []{};
+            };
+    }
+    else
+    {
+        log_input = [event, this]
+            {
+                mir::log_info("handle_touch_event event=%s", dump_of(event).c_str());
+                log_input = []{};
+            };
+    }
 
     return policy->handle_touch_event(event);
 }
@@ -692,11 +961,22 @@ MIRAL_TRACE_EXCEPTION
 
 bool miral::WindowManagementTrace::handle_pointer_event(MirPointerEvent const* event)
 try {
-    log_input = [event, this]
-        {
-            mir::log_info("handle_pointer_event event=%s", dump_of(event).c_str());
-            log_input = []{};
-        };
+    if (binary)
+    {
+        log_input = [event, this]
+            {
+                binary->write(entry_for(event));
+                log_input = []{};
+            };
+    }
+    else
+    {
+        log_input = [event, this]
+            {
+                mir::log_info("handle_pointer_event event=%s", dump_of(event).c_str());
+                log_input = []{};
+            };
+    }
 
     return policy->handle_pointer_event(event);
 }
@@ -705,9 +985,16 @@ MIRAL_TRACE_EXCEPTION
 auto miral::WindowManagementTrace::confirm_inherited_move(WindowInfo const& window_info, Displacement movement)
 -> Rectangle
 try {
-    std::stringstream out;
-    out << movement;
-    mir::log_info("%s window_info=%s, movement=%s", __func__, dump_of(window_info).c_str(), out.str().c_str());
+    if (binary)
+    {
+        binary->write(Entry{mbt::Call::confirm_inherited_move}.window_info(window_info).displacement(movement));
+    }
+    else
+    {
+        std::stringstream out;
+        out << movement;
+        mir::log_info("%s window_info=%s, movement=%s", __func__, dump_of(window_info).c_str(), out.str().c_str());
+    }
 
     return policy->confirm_inherited_move(window_info, movement);
 }
@@ -724,91 +1011,129 @@ MIRAL_TRACE_EXCEPTION
 void miral::WindowManagementTrace::advise_end()
 try {
     if (trace_count.load() > 0)
-        mir::log_info("====");
+    {
+        if (binary) binary->write(Entry{mbt::Call::end_of_batch});
+        else mir::log_info("====");
+    }
     policy->advise_end();
 }
 MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::advise_new_app(miral::ApplicationInfo& application)
 try {
-    mir::log_info("%s application=%s", __func__, dump_of(application).c_str());
+    if (binary)
+    {
+        auto const id = id_of(application.application());
+        binary->write(mbt::Call::application_name, id, dump_of(application.application()).c_str());
+        binary->write(Entry{mbt::Call::advise_new_app}.subject(id));
+    }
+    else
+    {
+        mir::log_info("%s application=%s", __func__, dump_of(application).c_str());
+    }
     policy->advise_new_app(application);
 }
 MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::advise_delete_app(miral::ApplicationInfo const& application)
 try {
-    mir::log_info("%s application=%s", __func__, dump_of(application).c_str());
+    if (binary) binary->write(Entry{mbt::Call::advise_delete_app}.subject(id_of(application.application())));
+    else mir::log_info("%s application=%s", __func__, dump_of(application).c_str());
     policy->advise_delete_app(application);
 }
 MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::advise_new_window(miral::WindowInfo const& window_info)
 try {
-    mir::log_info("%s window_info=%s", __func__, dump_of(window_info).c_str());
+    if (binary)
+    {
+        binary->write(mbt::Call::window_name, id_of(window_info.window()), window_info.name().c_str());
+        binary->write(Entry{mbt::Call::advise_new_window}.window_info(window_info));
+    }
+    else
+    {
+        mir::log_info("%s window_info=%s", __func__, dump_of(window_info).c_str());
+    }
     policy->advise_new_window(window_info);
 }
 MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::advise_focus_lost(miral::WindowInfo const& window_info)
 try {
-    mir::log_info("%s window_info=%s", __func__, dump_of(window_info).c_str());
+    if (binary) binary->write(Entry{mbt::Call::advise_focus_lost}.window_info(window_info));
+    else mir::log_info("%s window_info=%s", __func__, dump_of(window_info).c_str());
     policy->advise_focus_lost(window_info);
 }
 MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::advise_focus_gained(miral::WindowInfo const& window_info)
 try {
-    mir::log_info("%s window_info=%s", __func__, dump_of(window_info).c_str());
+    if (binary) binary->write(Entry{mbt::Call::advise_focus_gained}.window_info(window_info));
+    else mir::log_info("%s window_info=%s", __func__, dump_of(window_info).c_str());
     policy->advise_focus_gained(window_info);
 }
 MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::advise_state_change(miral::WindowInfo const& window_info, MirWindowState state)
 try {
-    mir::log_info("%s window_info=%s, state=%s", __func__, dump_of(window_info).c_str(), dump_of(state).c_str());
+    if (binary) binary->write(Entry{mbt::Call::advise_state_change}.window_info(window_info).value(state));
+    else mir::log_info("%s window_info=%s, state=%s", __func__, dump_of(window_info).c_str(), dump_of(state).c_str());
     policy->advise_state_change(window_info, state);
 }
 MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::advise_move_to(miral::WindowInfo const& window_info, mir::geometry::Point top_left)
 try {
-    mir::log_info("%s window_info=%s, top_left=%s", __func__, dump_of(window_info).c_str(), dump_of(top_left).c_str());
+    if (binary) binary->write(Entry{mbt::Call::advise_move_to}.window_info(window_info).point(top_left));
+    else mir::log_info("%s window_info=%s, top_left=%s", __func__, dump_of(window_info).c_str(), dump_of(top_left).c_str());
     policy->advise_move_to(window_info, top_left);
 }
 MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::advise_resize(miral::WindowInfo const& window_info, mir::geometry::Size const& new_size)
 try {
-    mir::log_info("%s window_info=%s, new_size=%s", __func__, dump_of(window_info).c_str(), dump_of(new_size).c_str());
+    if (binary) binary->write(Entry{mbt::Call::advise_resize}.window_info(window_info).size(new_size));
+    else mir::log_info("%s window_info=%s, new_size=%s", __func__, dump_of(window_info).c_str(), dump_of(new_size).c_str());
     policy->advise_resize(window_info, new_size);
 }
 MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::advise_delete_window(miral::WindowInfo const& window_info)
 try {
-    mir::log_info("%s window_info=%s", __func__, dump_of(window_info).c_str());
+    if (binary) binary->write(Entry{mbt::Call::advise_delete_window}.window_info(window_info));
+    else mir::log_info("%s window_info=%s", __func__, dump_of(window_info).c_str());
     policy->advise_delete_window(window_info);
 }
 MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::advise_raise(std::vector<miral::Window> const& windows)
 try {
-    mir::log_info("%s window_info=%s", __func__, dump_of(windows).c_str());
+    if (binary)
+    {
+        binary->write(Entry{mbt::Call::advise_raise}
+            .subject(windows.empty() ? 0 : id_of(windows.front()))
+            .count(windows.size()));
+    }
+    else
+    {
+        mir::log_info("%s window_info=%s", __func__, dump_of(windows).c_str());
+    }
     policy->advise_raise(windows);
 }
 MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::handle_request_drag_and_drop(miral::WindowInfo& window_info)
 try {
-    mir::log_info("%s window_info=%s", __func__, dump_of(window_info).c_str());
+    if (binary) binary->write(Entry{mbt::Call::handle_request_drag_and_drop}.window_info(window_info));
+    else mir::log_info("%s window_info=%s", __func__, dump_of(window_info).c_str());
     policy->handle_request_drag_and_drop(window_info);
 }
 MIRAL_TRACE_EXCEPTION
 
 void miral::WindowManagementTrace::handle_request_move(miral::WindowInfo& window_info, MirInputEvent const* input_event)
 try {
-    mir::log_info("%s window_info=%s", __func__, dump_of(window_info).c_str());
+    if (binary) binary->write(Entry{mbt::Call::handle_request_move}.window_info(window_info));
+    else mir::log_info("%s window_info=%s", __func__, dump_of(window_info).c_str());
     policy->handle_request_move(window_info, input_event);
 }
 MIRAL_TRACE_EXCEPTION
@@ -816,7 +1141,8 @@ MIRAL_TRACE_EXCEPTION
 void miral::WindowManagementTrace::handle_request_resize(
     miral::WindowInfo& window_info, MirInputEvent const* input_event, MirResizeEdge edge)
 try {
-    mir::log_info("%s window_info=%s, edge=0x%1x", __func__, dump_of(window_info).c_str(), edge);
+    if (binary) binary->write(Entry{mbt::Call::handle_request_resize}.window_info(window_info).value(edge));
+    else mir::log_info("%s window_info=%s, edge=0x%1x", __func__, dump_of(window_info).c_str(), edge);
     policy->handle_request_resize(window_info, input_event, edge);
 }
 MIRAL_TRACE_EXCEPTION
@@ -824,7 +1150,8 @@ MIRAL_TRACE_EXCEPTION
 void miral::WindowManagementTrace::advise_adding_to_workspace(
     std::shared_ptr<miral::Workspace> const& workspace, std::vector<miral::Window> const& windows)
 try {
-    mir::log_info("%s workspace=%p, windows=%s", __func__, workspace.get(), dump_of(windows).c_str());
+    if (binary) binary->write(Entry{mbt::Call::advise_adding_to_workspace}.subject(id_of(workspace)).count(windows.size()));
+    else mir::log_info("%s workspace=%p, windows=%s", __func__, workspace.get(), dump_of(windows).c_str());
     policy->advise_adding_to_workspace(workspace, windows);
 }
 MIRAL_TRACE_EXCEPTION
@@ -832,7 +1159,8 @@ MIRAL_TRACE_EXCEPTION
 void miral::WindowManagementTrace::advise_removing_from_workspace(
     std::shared_ptr<miral::Workspace> const& workspace, std::vector<miral::Window> const& windows)
 try {
-    mir::log_info("%s workspace=%p, windows=%s", __func__, workspace.get(), dump_of(windows).c_str());
+    if (binary) binary->write(Entry{mbt::Call::advise_removing_from_workspace}.subject(id_of(workspace)).count(windows.size()));
+    else mir::log_info("%s workspace=%p, windows=%s", __func__, workspace.get(), dump_of(windows).c_str());
     policy->advise_removing_from_workspace(workspace, windows);
 }
 MIRAL_TRACE_EXCEPTION
@@ -843,7 +1171,8 @@ auto miral::WindowManagementTrace::confirm_placement_on_display(
     MirWindowState new_state,
     Rectangle const& new_placement) -> Rectangle
 try {
-    mir::log_info("%s window_info=%s", __func__, dump_of(window_info).c_str());
+    if (binary) binary->write(Entry{mbt::Call::confirm_placement_on_display}.window_info(window_info));
+    else mir::log_info("%s window_info=%s", __func__, dump_of(window_info).c_str());
     return policy->confirm_placement_on_display(window_info, new_state, new_placement);
 }
 MIRAL_TRACE_EXCEPTION
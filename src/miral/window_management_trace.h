@@ -20,9 +20,11 @@
 #define MIRAL_WINDOW_MANAGEMENT_TRACE_H
 
 #include "window_manager_tools_implementation.h"
+#include "window_management_binary_trace.h"
 
 #include "miral/window_manager_tools.h"
 #include "miral/window_management_options.h"
+#include "miral/pointer_motion_policy.h"
 #include "miral/window_management_policy.h"
 
 #include <atomic>
@@ -35,6 +37,18 @@ class WindowManagementTrace : public WindowManagementPolicy,
 public:
     WindowManagementTrace(WindowManagerTools const& wrapped, WindowManagementPolicyBuilder const& builder);
 
+    /// Records the trace in binary_trace_file, instead of logging it
+    WindowManagementTrace(
+        WindowManagerTools const& wrapped,
+        WindowManagementPolicyBuilder const& builder,
+        std::string const& binary_trace_file);
+
+    ~WindowManagementTrace();
+
+    /// The wrapped policy, if it is also a PointerMotionPolicy.
+    /// (Screening pointer motion isn't traced: it happens without the window management lock.)
+    auto pointer_motion_policy() const -> PointerMotionPolicy*;
+
 private:
     virtual auto count_applications() const -> unsigned int override;
 
@@ -155,6 +169,7 @@ public:
 
 private:
     WindowManagerTools wrapped;
+    std::unique_ptr<binary_trace::Writer> const binary;
     std::unique_ptr<miral::WindowManagementPolicy> const policy;
     std::atomic<unsigned> mutable trace_count;
     std::function<void()> log_input;
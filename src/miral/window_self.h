@@ -0,0 +1,34 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIRAL_WINDOW_SELF_H
+#define MIRAL_WINDOW_SELF_H
+
+#include "miral/window.h"
+#include "slot_map.h"
+
+struct miral::Window::Self
+{
+    Self(std::shared_ptr<mir::scene::Session> const& session, std::shared_ptr<mir::scene::Surface> const& surface);
+
+    std::weak_ptr<mir::scene::Session> const session;
+    std::weak_ptr<mir::scene::Surface> const surface;
+
+    /// Where BasicWindowManager keeps the WindowInfo (shared by all copies of the Window)
+    SlotHandle slot;
+};
+
+#endif //MIRAL_WINDOW_SELF_H
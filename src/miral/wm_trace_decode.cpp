@@ -0,0 +1,46 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "window_management_binary_trace.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+// Writes the trace recorded with --window-management-trace-file as text
+auto main(int argc, char* argv[]) -> int
+try
+{
+    if (argc != 2 || !std::strcmp(argv[1], "--help"))
+    {
+        std::cout << "Usage: " << argv[0] << " <trace file>\n";
+        return argc == 2 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    std::ifstream in{argv[1], std::ios::binary};
+
+    if (!in)
+        throw std::runtime_error(std::string{"Failed to open "} + argv[1]);
+
+    miral::binary_trace::decode(in, std::cout);
+    return EXIT_SUCCESS;
+}
+catch (std::exception const& x)
+{
+    std::cerr << "ERROR: " << x.what() << '\n';
+    return EXIT_FAILURE;
+}
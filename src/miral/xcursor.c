@@ -25,6 +25,10 @@
 #include <stdlib.h>
 #include <string.h>
 #include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 /*
  * From libXcursor/include/X11/extensions/Xcursor.h
@@ -599,6 +603,95 @@ XcursorFileLoadImages (FILE *file, int size)
     return XcursorXcFileLoadImages (&f, size);
 }
 
+/*
+ * Decoding reads the pixels four bytes at a time, so read from a mapping
+ * of the file rather than through stdio
+ */
+
+typedef struct _XcursorMappedFile {
+    const unsigned char	*data;
+    long		size;
+    long		position;
+} XcursorMappedFile;
+
+static int
+_XcursorMappedFileRead (XcursorFile *file, unsigned char *buf, int len)
+{
+    XcursorMappedFile	*f = file->closure;
+    long		available = f->size - f->position;
+
+    if (len > available)
+	len = available;
+    memcpy (buf, f->data + f->position, len);
+    f->position += len;
+    return len;
+}
+
+static int
+_XcursorMappedFileWrite (XcursorFile *file, unsigned char *buf, int len)
+{
+    (void)file; (void)buf; (void)len;
+    return 0;
+}
+
+static int
+_XcursorMappedFileSeek (XcursorFile *file, long offset, int whence)
+{
+    XcursorMappedFile	*f = file->closure;
+    long		position;
+
+    switch (whence)
+    {
+    case SEEK_SET: position = offset; break;
+    case SEEK_CUR: position = f->position + offset; break;
+    case SEEK_END: position = f->size + offset; break;
+    default: return EOF;
+    }
+    if (position < 0 || position > f->size)
+	return EOF;
+    f->position = position;
+    return 0;
+}
+
+static XcursorImages *
+XcursorFilenameLoadImages (const char *filename, int size)
+{
+    int			fd;
+    struct stat		st;
+    void		*data;
+    XcursorMappedFile	mapped;
+    XcursorFile		f;
+    XcursorImages	*images;
+
+    if (!filename)
+        return NULL;
+
+    fd = open (filename, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+	return NULL;
+    if (fstat (fd, &st) < 0 || !S_ISREG (st.st_mode) || st.st_size == 0)
+    {
+	close (fd);
+	return NULL;
+    }
+    data = mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close (fd);
+    if (data == MAP_FAILED)
+	return NULL;
+
+    mapped.data = data;
+    mapped.size = st.st_size;
+    mapped.position = 0;
+    f.closure = &mapped;
+    f.read = _XcursorMappedFileRead;
+    f.write = _XcursorMappedFileWrite;
+    f.seek = _XcursorMappedFileSeek;
+
+    images = XcursorXcFileLoadImages (&f, size);
+    munmap (data, st.st_size);
+    return images;
+}
+
 /*
  * From libXcursor/src/library.c
  */
@@ -614,14 +707,11 @@ XcursorFileLoadImages (FILE *file, int size)
 static const char *
 XcursorLibraryPath (void)
 {
-    static const char	*path;
+    /* Not cached: cursors are loaded as needed, and getenv() may not return the same pointer each time */
+    const char	*path = getenv ("XCURSOR_PATH");
 
     if (!path)
-    {
-	path = getenv ("XCURSOR_PATH");
-	if (!path)
-	    path = XCURSORPATH;
-    }
+	path = XCURSORPATH;
     return path;
 }
 
@@ -897,3 +987,88 @@ xcursor_load_theme(const char *theme, int size,
 	if (inherits)
 		free(inherits);
 }
+
+/* Guard against themes that (indirectly) inherit from themselves, and
+ * against inheritance that fans out to very many themes */
+#define XCURSOR_MAX_INHERIT_DEPTH 16
+#define XCURSOR_MAX_THEMES_SEARCHED 64
+
+static XcursorImages *
+load_cursor_from_theme(const char *theme, const char *name, int size,
+		       int depth, int *themes_left)
+{
+	char *full, *dir;
+	char *inherits = NULL;
+	const char *path, *i;
+	XcursorImages *images = NULL;
+
+	if (*themes_left <= 0)
+		return NULL;
+	--*themes_left;
+
+	for (path = XcursorLibraryPath();
+	     path && !images;
+	     path = _XcursorNextPath(path)) {
+		dir = _XcursorBuildThemeDir(path, theme);
+		if (!dir)
+			continue;
+
+		full = _XcursorBuildFullname(dir, "cursors", name);
+		if (full) {
+			images = XcursorFilenameLoadImages(full, size);
+			free(full);
+		}
+
+		if (!images && !inherits) {
+			full = _XcursorBuildFullname(dir, "", "index.theme");
+			if (full) {
+				inherits = _XcursorThemeInherits(full);
+				free(full);
+			}
+		}
+
+		free(dir);
+	}
+
+	if (depth < XCURSOR_MAX_INHERIT_DEPTH)
+		for (i = inherits; i && !images; i = _XcursorNextPath(i))
+			images = load_cursor_from_theme(i, name, size, depth + 1,
+							themes_left);
+
+	if (inherits)
+		free(inherits);
+
+	return images;
+}
+
+/** Load a single cursor of a theme
+ *
+ * This function loads the images of the named cursor at the size
+ * closest to that requested, from the first of the theme and the
+ * themes it inherits from that has the cursor. Only that cursor's
+ * file is read. The caller is expected to destroy the result with
+ * XcursorImagesDestroy().
+ *
+ * \param theme The name of the theme the cursor should come from
+ * \param name The name of the cursor (a file name: it may not contain '/')
+ * \param size The desired size of the cursor images
+ * \return The images of the cursor, or NULL if none could be loaded
+ */
+XcursorImages *
+xcursor_load_cursor(const char *theme, const char *name, int size)
+{
+	XcursorImages *images;
+	int themes_left = XCURSOR_MAX_THEMES_SEARCHED;
+
+	if (!theme)
+		theme = "default";
+
+	if (!name || !*name || name[0] == '.' || strchr(name, '/'))
+		return NULL;
+
+	images = load_cursor_from_theme(theme, name, size, 0, &themes_left);
+	if (images)
+		XcursorImagesSetName(images, name);
+
+	return images;
+}
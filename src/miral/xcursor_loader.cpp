@@ -140,28 +140,21 @@ xcursor_name_for_mir_cursor(std::string const& mir_cursor_name)
         return mir_cursor_name;
     }
 }
-}
-
-miral::XCursorLoader::XCursorLoader()
-{
-    load_cursor_theme("default");
-}
 
-miral::XCursorLoader::XCursorLoader(std::string const& theme)
-{
-    load_cursor_theme(theme);
-}
+// Enough for every cursor a shell uses, at a couple of sizes
+size_t const max_loaded_images{64};
 
-// Each XcursorImages represents images for the different sizes of a given symbolic cursor.
-void miral::XCursorLoader::load_appropriately_sized_image(_XcursorImages *images)
+auto read_image(std::string const& theme, std::string const& xcursor_name, geom::Size const& size)
+    -> std::shared_ptr<mg::CursorImage>
 {
-    // We would rather take this lock in load_cursor_theme but the Xcursor lib style
-    // makes it difficult to use our standard 'pass the lg around to _locked members' pattern
-    std::lock_guard<std::mutex> lg(guard);
+    // Cursors are named by their square dimension...called the nominal size in XCursor terminology, so we just look up by width.
+    // Later we verify the actual size.
+    auto const images = xcursor_load_cursor(theme.c_str(), xcursor_name.c_str(), size.width.as_int());
+    if (!images)
+        return nullptr;
 
-    // We have to save all the images as XCursor expects us to free them.
-    // This contains the actual image data though, so we need to ensure they stay alive
-    // with the lifetime of the mg::CursorImage instance which refers to them.
+    // XcursorImages holds the image data, so it needs to stay alive with the mg::CursorImage referring to it.
+    // It holds the images for each frame of an animated cursor, the first of which we use.
     auto saved_xcursor_library_resource = std::shared_ptr<_XcursorImages>(images, [](_XcursorImages *images)
         {
             XcursorImagesDestroy(images);
@@ -170,46 +163,75 @@ void miral::XCursorLoader::load_appropriately_sized_image(_XcursorImages *images
     for (int i = 0; i < images->nimage; i++)
     {
         _XcursorImage *candidate = images->images[i];
-        if (candidate->width == mi::default_cursor_size.width.as_uint32_t() &&
-            candidate->height == mi::default_cursor_size.height.as_uint32_t())
+        if (candidate->width == size.width.as_uint32_t() &&
+            candidate->height == size.height.as_uint32_t())
         {
-            loaded_images[std::string(images->name)] = std::make_shared<XCursorImage>(candidate, saved_xcursor_library_resource);
-            return;
+            return std::make_shared<XCursorImage>(candidate, saved_xcursor_library_resource);
         }
     }
 
-    loaded_images[std::string(images->name)] = std::make_shared<XCursorImage>(images->images[0], saved_xcursor_library_resource);
+    return std::make_shared<XCursorImage>(images->images[0], saved_xcursor_library_resource);
+}
 }
 
-void miral::XCursorLoader::load_cursor_theme(std::string const& theme_name)
+miral::XCursorLoader::XCursorLoader() :
+    XCursorLoader{"default"}
+{
+}
+
+miral::XCursorLoader::XCursorLoader(std::string const& theme) :
+    theme{theme}
 {
-    // Cursors are named by their square dimension...called the nominal size in XCursor terminology, so we just look up by width.
-    // Later we verify the actual size.
-    xcursor_load_theme(theme_name.c_str(), mi::default_cursor_size.width.as_uint32_t(),
-        [](XcursorImages* images, void *this_ptr)  -> void
-        {
-            // Can't use lambda capture as this lambda is thunked to a C function ptr
-            auto p = static_cast<miral::XCursorLoader*>(this_ptr);
-            p->load_appropriately_sized_image(images);
-        }, this);
 }
 
 std::shared_ptr<mg::CursorImage> miral::XCursorLoader::image(
     std::string const& cursor_name,
-    geom::Size const& /*size*/)
+    geom::Size const& size)
 {
     auto xcursor_name = xcursor_name_for_mir_cursor(cursor_name);
 
-    std::lock_guard<std::mutex> lg(guard);
-
-    auto it = loaded_images.find(xcursor_name);
-    if (it != loaded_images.end())
-        return it->second;
+    if (auto const image = load(xcursor_name, size))
+        return image;
 
     // Fall back
-    it = loaded_images.find("arrow");
-    if (it != loaded_images.end())
-        return it->second;
+    return load("arrow", size);
+}
+
+auto miral::XCursorLoader::load(
+    std::string const& xcursor_name,
+    geom::Size const& size) -> std::shared_ptr<mg::CursorImage>
+{
+    Key const key{xcursor_name, size.width.as_int(), size.height.as_int()};
+
+    {
+        std::lock_guard<std::mutex> lock{guard};
+
+        auto const loaded = loaded_images.find(key);
+        if (loaded != loaded_images.end())
+        {
+            recently_used.splice(recently_used.begin(), recently_used, loaded->second.use);
+            return loaded->second.image;
+        }
+    }
+
+    // Searching the theme reads the filesystem, so don't hold up lookups of cursors already loaded
+    auto const image = read_image(theme, xcursor_name, size);
+
+    std::lock_guard<std::mutex> lock{guard};
+
+    // If another thread loaded it meanwhile, keep to the one image
+    auto const loaded = loaded_images.find(key);
+    if (loaded != loaded_images.end())
+        return loaded->second.image;
+
+    recently_used.push_front(key);
+    loaded_images[key] = Loaded{image, recently_used.begin()};
+
+    if (loaded_images.size() > max_loaded_images)
+    {
+        loaded_images.erase(recently_used.back());
+        recently_used.pop_back();
+    }
 
-    return nullptr;
+    return image;
 }
@@ -22,16 +22,12 @@
 
 #include "mir/input/cursor_images.h"
 
+#include <list>
 #include <memory>
 #include <string>
 #include <map>
 #include <mutex>
-
-// Unfortunately this library does not compile as C++ so we can not namespace it.
-extern "C"
-{
-struct _XcursorImages;
-}
+#include <tuple>
 
 namespace mir { namespace graphics { class CursorImage; } }
 
@@ -53,12 +49,24 @@ protected:
     XCursorLoader& operator=(XCursorLoader const&) = delete;
 
 private:
-    std::mutex guard;
+    std::string const theme;
+
+    // Each cursor is read from the theme when first asked for, at the size asked for.
+    // Those the theme lacks are remembered too, as nullptr. Only the most recently
+    // used are kept, as clients can ask for any number of names.
+    using Key = std::tuple<std::string, int, int>;
+    struct Loaded
+    {
+        std::shared_ptr<mir::graphics::CursorImage> image;
+        std::list<Key>::iterator use;
+    };
 
-    std::map<std::string, std::shared_ptr<mir::graphics::CursorImage>> loaded_images;
+    std::mutex guard;
+    std::map<Key, Loaded> loaded_images;
+    std::list<Key> recently_used;
 
-    void load_cursor_theme(std::string const& theme_name);
-    void load_appropriately_sized_image(_XcursorImages *images);
+    auto load(std::string const& xcursor_name, mir::geometry::Size const& size)
+        -> std::shared_ptr<mir::graphics::CursorImage>;
 };
 }
 
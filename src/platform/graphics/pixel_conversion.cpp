@@ -0,0 +1,478 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/graphics/pixel_conversion.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MIR_PIXEL_CONVERSION_X86
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define MIR_PIXEL_CONVERSION_NEON
+#endif
+
+namespace mg = mir::graphics;
+
+namespace
+{
+/*
+ * Every kernel converts as many whole vectors as it can and hands the
+ * remaining pixels to the scalar version, so all of them produce exactly
+ * the same results.
+ */
+
+// Exact, rounded x / 255 for x in [0, 255 * 255]
+inline uint32_t div255(uint32_t x)
+{
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+inline uint32_t load_u32(uint8_t const* p)
+{
+    uint32_t value;
+    std::memcpy(&value, p, sizeof value);
+    return value;
+}
+
+inline void store_u32(uint8_t* p, uint32_t value)
+{
+    std::memcpy(p, &value, sizeof value);
+}
+
+void swap_red_blue_scalar(uint8_t const* src, uint8_t* dst, size_t count)
+{
+    for (size_t i = 0; i != count; ++i)
+    {
+        auto const p = load_u32(src + 4*i);
+        store_u32(dst + 4*i,
+            ((p << 16) & 0x00ff0000) | /* Move R to new position */
+            ((p) & 0xff00ff00) |       /* G and A remain at the same position */
+            ((p >> 16) & 0x000000ff)); /* Move B to new position */
+    }
+}
+
+void expand_888_scalar(uint8_t const* src, uint8_t* dst, size_t count, bool swap_red_blue)
+{
+    for (size_t i = 0; i != count; ++i, src += 3, dst += 4)
+    {
+        dst[0] = swap_red_blue ? src[2] : src[0];
+        dst[1] = src[1];
+        dst[2] = swap_red_blue ? src[0] : src[2];
+        dst[3] = 0xff;
+    }
+}
+
+void pack_8888_scalar(uint8_t const* src, uint8_t* dst, size_t count, bool swap_red_blue)
+{
+    for (size_t i = 0; i != count; ++i, src += 4, dst += 3)
+    {
+        dst[0] = swap_red_blue ? src[2] : src[0];
+        dst[1] = src[1];
+        dst[2] = swap_red_blue ? src[0] : src[2];
+    }
+}
+
+void expand_565_scalar(uint8_t const* src, uint8_t* dst, size_t count)
+{
+    for (size_t i = 0; i != count; ++i)
+    {
+        uint16_t p;
+        std::memcpy(&p, src + 2*i, sizeof p);
+
+        uint32_t const r = (p >> 11) & 0x1f;
+        uint32_t const g = (p >> 5) & 0x3f;
+        uint32_t const b = p & 0x1f;
+
+        store_u32(dst + 4*i,
+            0xff000000 |
+            ((r << 3 | r >> 2) << 16) |
+            ((g << 2 | g >> 4) << 8) |
+            (b << 3 | b >> 2));
+    }
+}
+
+void premultiply_scalar(uint8_t const* src, uint8_t* dst, size_t count)
+{
+    for (size_t i = 0; i != count; ++i)
+    {
+        auto const p = load_u32(src + 4*i);
+        auto const a = p >> 24;
+
+        store_u32(dst + 4*i,
+            (a << 24) |
+            (div255(((p >> 16) & 0xff) * a) << 16) |
+            (div255(((p >> 8) & 0xff) * a) << 8) |
+            div255((p & 0xff) * a));
+    }
+}
+
+#ifdef MIR_PIXEL_CONVERSION_X86
+#ifdef __SSE2__
+void swap_red_blue_sse2(uint8_t const* src, uint8_t* dst, size_t count)
+{
+    auto const ga_mask = _mm_set1_epi32(0xff00ff00);
+    auto const r_mask = _mm_set1_epi32(0x00ff0000);
+    auto const b_mask = _mm_set1_epi32(0x000000ff);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        auto const p = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + 4*i));
+        auto const swapped = _mm_or_si128(
+            _mm_and_si128(p, ga_mask),
+            _mm_or_si128(
+                _mm_and_si128(_mm_slli_epi32(p, 16), r_mask),
+                _mm_and_si128(_mm_srli_epi32(p, 16), b_mask)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4*i), swapped);
+    }
+
+    swap_red_blue_scalar(src + 4*i, dst + 4*i, count - i);
+}
+
+void expand_565_sse2(uint8_t const* src, uint8_t* dst, size_t count)
+{
+    auto const mask5 = _mm_set1_epi16(0x1f);
+    auto const mask6 = _mm_set1_epi16(0x3f);
+    auto const opaque = _mm_set1_epi16(static_cast<short>(0xff00));
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        auto const p = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + 2*i));
+
+        auto const r5 = _mm_srli_epi16(p, 11);
+        auto const g6 = _mm_and_si128(_mm_srli_epi16(p, 5), mask6);
+        auto const b5 = _mm_and_si128(p, mask5);
+
+        auto const r8 = _mm_or_si128(_mm_slli_epi16(r5, 3), _mm_srli_epi16(r5, 2));
+        auto const g8 = _mm_or_si128(_mm_slli_epi16(g6, 2), _mm_srli_epi16(g6, 4));
+        auto const b8 = _mm_or_si128(_mm_slli_epi16(b5, 3), _mm_srli_epi16(b5, 2));
+
+        // Pair up (B, G) and (R, A) bytes, then interleave them into words
+        auto const bg = _mm_or_si128(b8, _mm_slli_epi16(g8, 8));
+        auto const ra = _mm_or_si128(r8, opaque);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4*i), _mm_unpacklo_epi16(bg, ra));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4*i + 16), _mm_unpackhi_epi16(bg, ra));
+    }
+
+    expand_565_scalar(src + 2*i, dst + 4*i, count - i);
+}
+
+inline __m128i premultiply_two_sse2(__m128i pixels, __m128i alpha_lane, __m128i round)
+{
+    // Multiply each channel by its pixel's alpha, and alpha by 255 to keep it
+    auto alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    alpha = _mm_or_si128(_mm_andnot_si128(alpha_lane, alpha), _mm_and_si128(alpha_lane, _mm_set1_epi16(0xff)));
+
+    auto t = _mm_add_epi16(_mm_mullo_epi16(pixels, alpha), round);
+    return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+void premultiply_sse2(uint8_t const* src, uint8_t* dst, size_t count)
+{
+    auto const zero = _mm_setzero_si128();
+    auto const alpha_lane = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+    auto const round = _mm_set1_epi16(128);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        auto const p = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + 4*i));
+
+        auto const lo = premultiply_two_sse2(_mm_unpacklo_epi8(p, zero), alpha_lane, round);
+        auto const hi = premultiply_two_sse2(_mm_unpackhi_epi8(p, zero), alpha_lane, round);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4*i), _mm_packus_epi16(lo, hi));
+    }
+
+    premultiply_scalar(src + 4*i, dst + 4*i, count - i);
+}
+#endif
+
+__attribute__((target("avx2")))
+void swap_red_blue_avx2(uint8_t const* src, uint8_t* dst, size_t count)
+{
+    auto const shuffle = _mm256_setr_epi8(
+        2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+        2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        auto const p = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + 4*i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 4*i), _mm256_shuffle_epi8(p, shuffle));
+    }
+
+    swap_red_blue_scalar(src + 4*i, dst + 4*i, count - i);
+}
+
+__attribute__((target("avx2")))
+void expand_888_avx2(uint8_t const* src, uint8_t* dst, size_t count, bool swap_red_blue)
+{
+    // Each 128 bit lane takes four pixels from a 16 byte load
+    auto const shuffle = swap_red_blue ?
+        _mm256_setr_epi8(
+            2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1,
+            2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1) :
+        _mm256_setr_epi8(
+            0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+            0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    auto const opaque = _mm256_set1_epi32(0xff000000);
+
+    size_t i = 0;
+    // The second load reads four bytes beyond the eight pixels converted
+    for (; i + 10 <= count; i += 8)
+    {
+        auto const lo = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + 3*i));
+        auto const hi = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + 3*i + 12));
+        auto const p = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i*>(dst + 4*i),
+            _mm256_or_si256(_mm256_shuffle_epi8(p, shuffle), opaque));
+    }
+
+    expand_888_scalar(src + 3*i, dst + 4*i, count - i, swap_red_blue);
+}
+
+bool cpu_has_avx2()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+#endif
+
+#ifdef MIR_PIXEL_CONVERSION_NEON
+void swap_red_blue_neon(uint8_t const* src, uint8_t* dst, size_t count)
+{
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        auto p = vld4q_u8(src + 4*i);
+        auto const red = p.val[0];
+        p.val[0] = p.val[2];
+        p.val[2] = red;
+        vst4q_u8(dst + 4*i, p);
+    }
+
+    swap_red_blue_scalar(src + 4*i, dst + 4*i, count - i);
+}
+
+void expand_888_neon(uint8_t const* src, uint8_t* dst, size_t count, bool swap_red_blue)
+{
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        auto const p = vld3q_u8(src + 3*i);
+        uint8x16x4_t q;
+        q.val[0] = swap_red_blue ? p.val[2] : p.val[0];
+        q.val[1] = p.val[1];
+        q.val[2] = swap_red_blue ? p.val[0] : p.val[2];
+        q.val[3] = vdupq_n_u8(0xff);
+        vst4q_u8(dst + 4*i, q);
+    }
+
+    expand_888_scalar(src + 3*i, dst + 4*i, count - i, swap_red_blue);
+}
+
+void pack_8888_neon(uint8_t const* src, uint8_t* dst, size_t count, bool swap_red_blue)
+{
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        auto const p = vld4q_u8(src + 4*i);
+        uint8x16x3_t q;
+        q.val[0] = swap_red_blue ? p.val[2] : p.val[0];
+        q.val[1] = p.val[1];
+        q.val[2] = swap_red_blue ? p.val[0] : p.val[2];
+        vst3q_u8(dst + 3*i, q);
+    }
+
+    pack_8888_scalar(src + 4*i, dst + 3*i, count - i, swap_red_blue);
+}
+
+void expand_565_neon(uint8_t const* src, uint8_t* dst, size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        uint16_t lanes[8];
+        std::memcpy(lanes, src + 2*i, sizeof lanes);
+        auto const p = vld1q_u16(lanes);
+
+        auto const r5 = vshrq_n_u16(p, 11);
+        auto const g6 = vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x3f));
+        auto const b5 = vandq_u16(p, vdupq_n_u16(0x1f));
+
+        uint8x8x4_t q;
+        q.val[0] = vmovn_u16(vorrq_u16(vshlq_n_u16(b5, 3), vshrq_n_u16(b5, 2)));
+        q.val[1] = vmovn_u16(vorrq_u16(vshlq_n_u16(g6, 2), vshrq_n_u16(g6, 4)));
+        q.val[2] = vmovn_u16(vorrq_u16(vshlq_n_u16(r5, 3), vshrq_n_u16(r5, 2)));
+        q.val[3] = vdup_n_u8(0xff);
+        vst4_u8(dst + 4*i, q);
+    }
+
+    expand_565_scalar(src + 2*i, dst + 4*i, count - i);
+}
+
+inline uint8x8_t div255_neon(uint16x8_t x)
+{
+    return vraddhn_u16(x, vrshrq_n_u16(x, 8));
+}
+
+void premultiply_neon(uint8_t const* src, uint8_t* dst, size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        auto p = vld4_u8(src + 4*i);
+        auto const alpha = p.val[3];
+        for (int channel = 0; channel != 3; ++channel)
+            p.val[channel] = div255_neon(vmull_u8(p.val[channel], alpha));
+        vst4_u8(dst + 4*i, p);
+    }
+
+    premultiply_scalar(src + 4*i, dst + 4*i, count - i);
+}
+#endif
+
+struct Kernels
+{
+    Kernels()
+    {
+#ifdef MIR_PIXEL_CONVERSION_X86
+#ifdef __SSE2__
+        swap_red_blue = &swap_red_blue_sse2;
+        expand_565 = &expand_565_sse2;
+        premultiply = &premultiply_sse2;
+#endif
+        if (cpu_has_avx2())
+        {
+            swap_red_blue = &swap_red_blue_avx2;
+            expand_888 = &expand_888_avx2;
+        }
+#endif
+#ifdef MIR_PIXEL_CONVERSION_NEON
+        swap_red_blue = &swap_red_blue_neon;
+        expand_888 = &expand_888_neon;
+        pack_8888 = &pack_8888_neon;
+        expand_565 = &expand_565_neon;
+        premultiply = &premultiply_neon;
+#endif
+    }
+
+    void (*swap_red_blue)(uint8_t const*, uint8_t*, size_t) = &swap_red_blue_scalar;
+    void (*expand_888)(uint8_t const*, uint8_t*, size_t, bool) = &expand_888_scalar;
+    void (*pack_8888)(uint8_t const*, uint8_t*, size_t, bool) = &pack_8888_scalar;
+    void (*expand_565)(uint8_t const*, uint8_t*, size_t) = &expand_565_scalar;
+    void (*premultiply)(uint8_t const*, uint8_t*, size_t) = &premultiply_scalar;
+};
+
+Kernels const& kernels()
+{
+    static Kernels const instance;
+    return instance;
+}
+
+inline uint8_t const* bytes(void const* p)
+{
+    return static_cast<uint8_t const*>(p);
+}
+
+inline uint8_t* bytes(void* p)
+{
+    return static_cast<uint8_t*>(p);
+}
+}
+
+void mg::swap_red_blue_8888(void const* src, void* dst, size_t pixel_count)
+{
+    kernels().swap_red_blue(bytes(src), bytes(dst), pixel_count);
+}
+
+void mg::expand_888_to_8888(void const* src, void* dst, size_t pixel_count, bool swap_red_blue)
+{
+    kernels().expand_888(bytes(src), bytes(dst), pixel_count, swap_red_blue);
+}
+
+void mg::pack_8888_to_888(void const* src, void* dst, size_t pixel_count, bool swap_red_blue)
+{
+    kernels().pack_8888(bytes(src), bytes(dst), pixel_count, swap_red_blue);
+}
+
+void mg::expand_565_to_8888(void const* src, void* dst, size_t pixel_count)
+{
+    kernels().expand_565(bytes(src), bytes(dst), pixel_count);
+}
+
+void mg::premultiply_alpha_8888(void const* src, void* dst, size_t pixel_count)
+{
+    kernels().premultiply(bytes(src), bytes(dst), pixel_count);
+}
+
+void mg::detail::premultiply_alpha_8888_scalar(void const* src, void* dst, size_t pixel_count)
+{
+    premultiply_scalar(bytes(src), bytes(dst), pixel_count);
+}
+
+void mg::copy_flipped(
+    void const* src, size_t src_stride,
+    void* dst, size_t dst_stride,
+    size_t line_size, size_t height)
+{
+    for (size_t i = 0; i != height; ++i)
+        std::memcpy(bytes(dst) + i * dst_stride, bytes(src) + (height - i - 1) * src_stride, line_size);
+}
+
+void mg::flip_in_place_8888(void* pixels, size_t stride, size_t width, size_t height, bool swap_red_blue)
+{
+    auto const line_size = width * 4;
+    auto const copy_line =
+        [&](uint8_t const* from, uint8_t* to)
+        {
+            if (swap_red_blue)
+                kernels().swap_red_blue(from, to, width);
+            else if (from != to)
+                std::memcpy(to, from, line_size);
+        };
+
+    std::vector<uint8_t> tmp(line_size);
+
+    for (size_t i = 0; i < height / 2; i++)
+    {
+        auto const top = bytes(pixels) + i * stride;
+        auto const bottom = bytes(pixels) + (height - i - 1) * stride;
+
+        std::memcpy(tmp.data(), top, line_size);
+        copy_line(bottom, top);
+        copy_line(tmp.data(), bottom);
+    }
+
+    /* Process middle line if there is one */
+    if (height % 2 == 1)
+    {
+        auto const middle = bytes(pixels) + (height / 2) * stride;
+        copy_line(middle, middle);
+    }
+}
@@ -19,19 +19,35 @@
 #include "mir/log.h"
 #include "mir/graphics/platform.h"
 #include "mir/graphics/platform_probe.h"
+#include "mir/graphics/platform_probe_cache.h"
+#include "mir/shared_library_prober.h"
+#include "mir/shared_library_prober_report.h"
 
 #include <boost/throw_exception.hpp>
 
-std::shared_ptr<mir::SharedLibrary>
-mir::graphics::module_for_device(std::vector<std::shared_ptr<SharedLibrary>> const& modules, mir::options::ProgramOption const& options)
+#include <algorithm>
+
+namespace mg = mir::graphics;
+
+namespace
+{
+struct Candidate
+{
+    std::shared_ptr<mir::SharedLibrary> module;
+    mg::PlatformPriority priority;
+};
+
+Candidate best_module_for_device(
+    std::vector<std::shared_ptr<mir::SharedLibrary>> const& modules,
+    mir::options::ProgramOption const& options)
 {
-    mir::graphics::PlatformPriority best_priority_so_far = mir::graphics::unsupported;
+    mg::PlatformPriority best_priority_so_far = mg::unsupported;
     std::shared_ptr<mir::SharedLibrary> best_module_so_far;
     for (auto& module : modules)
     {
         try
         {
-            auto probe = module->load_function<PlatformProbe>(
+            auto probe = module->load_function<mg::PlatformProbe>(
                  "probe_graphics_platform",
                  MIR_SERVER_GRAPHICS_PLATFORM_VERSION);
 
@@ -42,7 +58,7 @@ mir::graphics::module_for_device(std::vector<std::shared_ptr<SharedLibrary>> con
                 best_module_so_far = module;
             }
 
-            auto describe = module->load_function<DescribeModule>(
+            auto describe = module->load_function<mg::DescribeModule>(
                 "describe_graphics_module",
                 MIR_SERVER_GRAPHICS_PLATFORM_VERSION);
             auto desc = describe();
@@ -56,9 +72,94 @@ mir::graphics::module_for_device(std::vector<std::shared_ptr<SharedLibrary>> con
         {
         }
     }
-    if (best_priority_so_far > mir::graphics::unsupported)
+    return {best_module_so_far, best_priority_so_far};
+}
+
+auto probe(mir::SharedLibrary const& module, mir::options::ProgramOption const& options) -> mg::PlatformPriority
+{
+    try
+    {
+        return module.load_function<mg::PlatformProbe>(
+            "probe_graphics_platform",
+            MIR_SERVER_GRAPHICS_PLATFORM_VERSION)(options);
+    }
+    catch (std::runtime_error const&)
+    {
+        return mg::unsupported;
+    }
+}
+}
+
+std::shared_ptr<mir::SharedLibrary>
+mir::graphics::module_for_device(std::vector<std::shared_ptr<SharedLibrary>> const& modules, mir::options::ProgramOption const& options)
+{
+    auto const best = best_module_for_device(modules, options);
+    if (best.priority > mir::graphics::unsupported)
+    {
+        return best.module;
+    }
+    BOOST_THROW_EXCEPTION((std::runtime_error{"Failed to find platform for current system"}));
+}
+
+std::shared_ptr<mir::SharedLibrary>
+mir::graphics::module_for_device(
+    std::string const& path,
+    PlatformProbeCache& cache,
+    options::ProgramOption const& options,
+    SharedLibraryProberReport& report)
+{
+    auto const files = library_files_for_path(path, report);
+    if (files.empty())
+        BOOST_THROW_EXCEPTION((std::runtime_error{"Failed to find any platform plugins in: " + path}));
+
+    auto const fingerprint = platform_fingerprint(files);
+
+    // Trust the last choice only while it probes as well as it did: if it does
+    // worse (e.g. it can no longer become DRM master) another module may do better.
+    // The cache is just a file, so never load a module that isn't on the path.
+    auto const choice = cache.lookup(fingerprint);
+    if (choice && std::find(files.begin(), files.end(), choice.value().module) != files.end())
+    {
+        try
+        {
+            report.loading_library(choice.value().module);
+            auto const module = std::make_shared<SharedLibrary>(choice.value().module);
+
+            if (probe(*module, options) >= choice.value().priority)
+            {
+                mir::log_info("Using graphics driver chosen previously for this hardware: %s",
+                              choice.value().module.c_str());
+                return module;
+            }
+        }
+        catch (std::runtime_error const& error)
+        {
+            report.loading_failed(choice.value().module, error);
+        }
+    }
+
+    std::vector<std::shared_ptr<SharedLibrary>> modules;
+    std::vector<std::string> module_files;
+    for (auto const& file : files)
+    {
+        try
+        {
+            report.loading_library(file);
+            modules.push_back(std::make_shared<SharedLibrary>(file));
+            module_files.push_back(file);
+        }
+        catch (std::runtime_error const& error)
+        {
+            report.loading_failed(file, error);
+        }
+    }
+
+    auto const best = best_module_for_device(modules, options);
+    if (best.priority > mir::graphics::unsupported)
     {
-        return best_module_so_far;
+        auto const index = std::find(modules.begin(), modules.end(), best.module) - modules.begin();
+        cache.record(fingerprint, {module_files[index], best.priority});
+        return best.module;
     }
     BOOST_THROW_EXCEPTION((std::runtime_error{"Failed to find platform for current system"}));
 }
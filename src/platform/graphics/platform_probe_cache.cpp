@@ -0,0 +1,174 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/graphics/platform_probe_cache.h"
+#include "mir/udev/wrapper.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace mg = mir::graphics;
+
+namespace
+{
+// Fields are separated by tabs
+bool storable(std::string const& field)
+{
+    return field.find_first_of("\t\n") == std::string::npos;
+}
+
+void create_parent_directories(std::string const& filename)
+{
+    for (auto slash = filename.find('/', 1); slash != std::string::npos; slash = filename.find('/', slash + 1))
+        mkdir(filename.substr(0, slash).c_str(), 0700);
+}
+
+// FNV-1a: the fingerprint only needs to change when its input does
+class Hash
+{
+public:
+    void add(std::string const& text)
+    {
+        for (auto const c : text)
+        {
+            value ^= static_cast<unsigned char>(c);
+            value *= 0x100000001b3;
+        }
+        // Keep "ab","c" distinct from "a","bc"
+        value ^= 0xff;
+        value *= 0x100000001b3;
+    }
+
+    std::string str() const
+    {
+        std::ostringstream result;
+        result << std::hex << std::setw(16) << std::setfill('0') << value;
+        return result.str();
+    }
+
+private:
+    std::uint64_t value{0xcbf29ce484222325};
+};
+}
+
+mg::PlatformProbeCache::PlatformProbeCache(std::string const& filename) :
+    filename{filename}
+{
+}
+
+mir::optional_value<mg::PlatformProbeCache::Choice> mg::PlatformProbeCache::lookup(
+    std::string const& fingerprint) const
+{
+    if (filename.empty())
+        return {};
+
+    std::ifstream in{filename};
+    std::string recorded_fingerprint;
+    std::string module;
+    std::uint32_t priority;
+
+    if (std::getline(in, recorded_fingerprint, '\t') &&
+        std::getline(in, module, '\t') &&
+        in >> priority &&
+        recorded_fingerprint == fingerprint)
+    {
+        return Choice{module, static_cast<PlatformPriority>(priority)};
+    }
+
+    return {};
+}
+
+void mg::PlatformProbeCache::record(std::string const& fingerprint, Choice const& choice)
+{
+    if (filename.empty() || !storable(fingerprint) || !storable(choice.module))
+        return;
+
+    std::ostringstream contents;
+    contents << fingerprint << '\t' << choice.module << '\t' << static_cast<std::uint32_t>(choice.priority) << '\n';
+    auto const data = contents.str();
+
+    // Replace the file atomically, so a server starting meanwhile never reads a partial record
+    create_parent_directories(filename);
+    std::string temporary{filename + ".XXXXXX"};
+    int const fd = mkstemp(&temporary[0]);
+    if (fd < 0)
+        return;
+
+    bool const written = write(fd, data.data(), data.size()) == static_cast<ssize_t>(data.size());
+    close(fd);
+
+    if (!written || rename(temporary.c_str(), filename.c_str()) < 0)
+        unlink(temporary.c_str());
+}
+
+std::string mg::PlatformProbeCache::default_filename()
+{
+    // The XDG base directory specification says to ignore relative paths
+    auto const xdg_cache_home = getenv("XDG_CACHE_HOME");
+    if (xdg_cache_home && xdg_cache_home[0] == '/')
+        return std::string{xdg_cache_home} + "/mir/graphics-platform";
+
+    auto const home = getenv("HOME");
+    if (home && home[0] == '/')
+        return std::string{home} + "/.cache/mir/graphics-platform";
+
+    return {};
+}
+
+std::string mg::platform_fingerprint(std::vector<std::string> const& module_files)
+{
+    Hash hash;
+
+    for (auto const& file : module_files)
+    {
+        hash.add(file);
+
+        struct stat info;
+        if (stat(file.c_str(), &info) == 0)
+        {
+            std::ostringstream identity;
+            identity << info.st_size << ' ' << info.st_mtim.tv_sec << ' ' << info.st_mtim.tv_nsec;
+            hash.add(identity.str());
+        }
+    }
+
+    try
+    {
+        auto const udev = std::make_shared<mir::udev::Context>();
+        mir::udev::Enumerator drm_devices{udev};
+        drm_devices.match_subsystem("drm");
+        drm_devices.scan_devices();
+
+        for (auto const& device : drm_devices)
+        {
+            hash.add(device.devpath());
+            hash.add(std::to_string(device.devnum()));
+        }
+    }
+    catch (std::runtime_error const&)
+    {
+        // Without udev we can't tell one GPU from another, but the modules still probe
+        // the hardware before being used, so a stale choice costs a full probe and no more
+    }
+
+    return hash.str();
+}
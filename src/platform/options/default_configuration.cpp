@@ -55,14 +55,23 @@ char const* const mo::fatal_except_opt            = "on-fatal-error-except";
 char const* const mo::debug_opt                   = "debug";
 char const* const mo::composite_delay_opt         = "composite-delay";
 char const* const mo::enable_key_repeat_opt       = "enable-key-repeat";
+char const* const mo::touch_resampling_opt        = "touch-resampling";
+char const* const mo::touch_resampling_latency_opt = "touch-resampling-latency";
+char const* const mo::record_input_opt            = "record-input";
+char const* const mo::async_logging_opt           = "async-logging";
+char const* const mo::metrics_socket_opt          = "metrics-socket";
+char const* const mo::startup_report_opt          = "startup-report";
+char const* const mo::parallel_startup_opt        = "parallel-startup";
 
 char const* const mo::off_opt_value = "off";
 char const* const mo::log_opt_value = "log";
 char const* const mo::lttng_opt_value = "lttng";
+char const* const mo::metrics_opt_value = "metrics";
 
 char const* const mo::platform_graphics_lib = "platform-graphics-lib";
 char const* const mo::platform_input_lib = "platform-input-lib";
 char const* const mo::platform_path = "platform-path";
+char const* const mo::platform_probe_cache_opt = "platform-probe-cache";
 
 namespace
 {
@@ -155,26 +164,33 @@ mo::DefaultConfiguration::DefaultConfiguration(
             "Library to use for platform input support (default: input-stub.so)")
         (platform_path, po::value<std::string>()->default_value(MIR_SERVER_PLATFORM_PATH),
             "Directory to look for platform libraries (default: " MIR_SERVER_PLATFORM_PATH ")")
+        (platform_probe_cache_opt, po::value<std::string>(),
+            "File recording the graphics platform chosen for this hardware, so that later "
+            "starts needn't probe every platform; empty to disable "
+            "[string:default=$XDG_CACHE_HOME/mir/graphics-platform]")
         (enable_input_opt, po::value<bool>()->default_value(enable_input_default),
             "Enable input.")
         (compositor_report_opt, po::value<std::string>()->default_value(off_opt_value),
-            "Compositor reporting [{log,lttng,off}]")
+            "Compositor reporting [{log,lttng,metrics,off}]")
         (connector_report_opt, po::value<std::string>()->default_value(off_opt_value),
             "How to handle the Connector report. [{log,lttng,off}]")
         (display_report_opt, po::value<std::string>()->default_value(off_opt_value),
             "How to handle the Display report. [{log,lttng,off}]")
         (input_report_opt, po::value<std::string>()->default_value(off_opt_value),
-            "How to handle to Input report. [{log,lttng,off}]")
+            "How to handle to Input report. [{log,lttng,metrics,off}]")
         (legacy_input_report_opt, po::value<std::string>()->default_value(off_opt_value),
             "How to handle the Legacy Input report. [{log,off}]")
         (seat_report_opt, po::value<std::string>()->default_value(off_opt_value),
             "How to handle to Seat report. [{log,off}]")
         (session_mediator_report_opt, po::value<std::string>()->default_value(off_opt_value),
-            "How to handle the SessionMediator report. [{log,lttng,off}]")
+            "How to handle the SessionMediator report. [{log,lttng,metrics,off}]")
         (msg_processor_report_opt, po::value<std::string>()->default_value(off_opt_value),
-            "How to handle the MessageProcessor report. [{log,lttng,off}]")
+            "How to handle the MessageProcessor report. [{log,lttng,metrics,off}]")
         (scene_report_opt, po::value<std::string>()->default_value(off_opt_value),
-            "How to handle the scene report. [{log,lttng,off}]")
+            "How to handle the scene report. [{log,lttng,metrics,off}]")
+        (metrics_socket_opt, po::value<std::string>(),
+            "Socket filename to read \"metrics\" reports from, in OpenMetrics text format "
+            "[string:default=<socket filename>_metrics]")
         (shared_library_prober_report_opt, po::value<std::string>()->default_value(log_opt_value),
             "How to handle the SharedLibraryProber report. [{log,lttng,off}]")
         (shell_report_opt, po::value<std::string>()->default_value(off_opt_value),
@@ -198,6 +214,19 @@ mo::DefaultConfiguration::DefaultConfiguration(
             "Cursor (mouse pointer) to use [{auto,software}]")
         (enable_key_repeat_opt, po::value<bool>()->default_value(true),
              "Enable server generated key repeat")
+        (touch_resampling_opt, po::value<bool>()->default_value(false),
+             "Resample touch motion to one event per composited frame")
+        (touch_resampling_latency_opt, po::value<int>()->default_value(5),
+             "How far before each frame, in milliseconds, touch motion is resampled to")
+        (async_logging_opt, po::value<bool>()->default_value(false),
+             "Format and write log messages on a background thread")
+        (startup_report_opt, po::value<std::string>()->default_value(off_opt_value),
+             "How to report the time taken by each step of starting the server. [{log,off}]")
+        (parallel_startup_opt, po::value<bool>()->default_value(false),
+             "Start input, the Wayland socket and cursor images on threads of their own while "
+             "the display starts (needs platforms that allow this)")
+        (record_input_opt, po::value<std::string>(),
+             "Record input device events to the given file for replay by mir_input_replay_benchmark")
         (fatal_except_opt, "On \"fatal error\" conditions [e.g. drivers behaving "
             "in unexpected ways] throw an exception (instead of a core dump)")
         (debug_opt, "Enable extra development debugging. "
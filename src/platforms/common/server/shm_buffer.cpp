@@ -18,6 +18,7 @@
  */
 
 #include "mir/graphics/gl_format.h"
+#include "mir/graphics/pixel_conversion.h"
 #include "mir/shm_file.h"
 #include "shm_buffer.h"
 #include "buffer_texture_binder.h"
@@ -87,7 +88,8 @@ bool mg::get_gl_pixel_format(MirPixelFormat mir_format,
 bool mgc::ShmBuffer::supports(MirPixelFormat mir_format)
 {
     GLenum gl_format, gl_type;
-    return mg::get_gl_pixel_format(mir_format, gl_format, gl_type);
+    return mg::get_gl_pixel_format(mir_format, gl_format, gl_type) ||
+           mir_format == mir_pixel_format_bgr_888;
 }
 
 mgc::ShmBuffer::ShmBuffer(
@@ -140,6 +142,17 @@ void mgc::ShmBuffer::gl_bind_to_texture()
                      size_.width.as_int(), size_.height.as_int(),
                      0, format, type, pixels);
     }
+    else if (pixel_format_ == mir_pixel_format_bgr_888)
+    {
+        /* GLES has no BGR format: upload as RGBA */
+        auto const pixel_count = size_.width.as_uint32_t() * size_.height.as_uint32_t();
+        conversion_buffer.resize(pixel_count * 4);
+        mg::expand_888_to_8888(pixels, conversion_buffer.data(), pixel_count, true);
+
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA,
+                     size_.width.as_int(), size_.height.as_int(),
+                     0, GL_RGBA, GL_UNSIGNED_BYTE, conversion_buffer.data());
+    }
 }
 
 std::shared_ptr<MirBufferPackage> mgc::ShmBuffer::to_mir_buffer_package() const
@@ -197,5 +210,12 @@ void mir::graphics::common::ShmBuffer::commit()
     {
         glReadPixels(0, 0, size_.width.as_int(), size_.height.as_int(), format, type, pixels);
     }
+    else if (pixel_format_ == mir_pixel_format_bgr_888)
+    {
+        auto const pixel_count = size_.width.as_uint32_t() * size_.height.as_uint32_t();
+        conversion_buffer.resize(pixel_count * 4);
+        glReadPixels(0, 0, size_.width.as_int(), size_.height.as_int(),
+                     GL_RGBA, GL_UNSIGNED_BYTE, conversion_buffer.data());
+        mg::pack_8888_to_888(conversion_buffer.data(), pixels, pixel_count, true);
+    }
 }
-
@@ -29,6 +29,8 @@
 #include "mir_toolkit/mir_native_buffer.h"
 #include "mir/renderer/sw/pixel_source.h"
 
+#include <vector>
+
 namespace mir
 {
 class ShmFile;
@@ -81,6 +83,7 @@ private:
     MirPixelFormat const pixel_format_;
     geometry::Stride const stride_;
     void* const pixels;
+    std::vector<unsigned char> conversion_buffer;
 };
 
 }
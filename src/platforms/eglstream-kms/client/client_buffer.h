@@ -26,6 +26,7 @@
 #include "native_buffer.h"
 
 #include <memory>
+#include <mutex>
 
 namespace mir
 {
@@ -58,6 +59,10 @@ private:
     std::shared_ptr<graphics::eglstream::NativeBuffer> const creation_package;
     geometry::Rectangle const rect;
     MirPixelFormat const buffer_pf;
+
+    /// Mapped on first use and kept until the buffer is destroyed
+    std::mutex mapping_mutex;
+    std::shared_ptr<MemoryRegion> mapping;
 };
 
 }
@@ -68,6 +68,7 @@ public:
     ::libinput_device_group* group();
     void add_device_of_group(LibInputDevicePtr ptr);
 private:
+    void handle_input(EventUPtr&& event);
     EventUPtr convert_event(libinput_event_keyboard* keyboard);
     EventUPtr convert_button_event(libinput_event_pointer* pointer);
     EventUPtr convert_motion_event(libinput_event_pointer* pointer);
@@ -142,18 +142,26 @@ mclm::ClientBuffer::~ClientBuffer() noexcept
 {
     // TODO (@raof): Error reporting? It should not be possible for this to fail; if it does,
     //               something's seriously wrong.
+    mapping.reset();
     buffer_file_ops->close(creation_package->fd[0]);
 }
 
 std::shared_ptr<mcl::MemoryRegion> mclm::ClientBuffer::secure_for_cpu_write()
 {
-    int const buffer_fd = creation_package->fd[0];
+    std::lock_guard<decltype(mapping_mutex)> lock{mapping_mutex};
 
-    return std::make_shared<ShmMemoryRegion>(buffer_file_ops,
-                                             buffer_fd,
-                                             size(),
-                                             stride(),
-                                             pixel_format());
+    if (!mapping)
+    {
+        int const buffer_fd = creation_package->fd[0];
+
+        mapping = std::make_shared<ShmMemoryRegion>(buffer_file_ops,
+                                                    buffer_fd,
+                                                    size(),
+                                                    stride(),
+                                                    pixel_format());
+    }
+
+    return mapping;
 }
 
 geom::Size mclm::ClientBuffer::size() const
@@ -27,6 +27,7 @@
 
 #include <vector>
 #include <memory>
+#include <mutex>
 
 namespace mir
 {
@@ -67,6 +68,11 @@ private:
     geometry::Rectangle const rect;
     MirPixelFormat const buffer_pf;
     std::vector<EGLint> egl_image_attrs;
+
+    /// Mapped on first use and kept until the buffer is destroyed, as
+    /// software clients map the same buffers every frame
+    std::mutex mapping_mutex;
+    std::shared_ptr<MemoryRegion> mapping;
 };
 
 }
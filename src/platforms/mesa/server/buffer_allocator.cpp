@@ -306,7 +306,8 @@ std::vector<MirPixelFormat> mgm::BufferAllocator::supported_pixel_formats()
      * the usage type (e.g. scanout). In the future it's also expected to
      * depend on the GPU model in use at runtime.
      *   To be precise, ShmBuffer now supports OpenGL compositing of all
-     * but one MirPixelFormat (bgr_888). But GBM only supports [AX]RGB.
+     * MirPixelFormats (bgr_888 by converting it on upload). But GBM only
+     * supports [AX]RGB.
      * So since we don't yet have an adequate API in place to query what the
      * intended usage will be, we need to be conservative and report the
      * intersection of ShmBuffer and GBM's pixel format support. That is
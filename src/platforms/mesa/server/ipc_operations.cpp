@@ -55,6 +55,7 @@ struct MesaPlatformIPCPackage : public mg::PlatformIPCPackage
         mg::PlatformIPCPackage(&description)
     {
         ipc_fds.push_back(drm_auth_fd);
+        client_module = "mesa";
     }
 
     ~MesaPlatformIPCPackage()
@@ -28,6 +28,8 @@
 
 #include <boost/exception/errinfo_errno.hpp>
 
+#include <algorithm>
+#include <cstring>
 #include <stdexcept>
 #include <vector>
 
@@ -40,6 +42,9 @@ namespace
 const uint64_t fallback_cursor_size = 64;
 char const* const mir_drm_cursor_64x64 = "MIR_DRM_CURSOR_64x64";
 
+// Enough for the cursors a shell switches between (arrow, caret, hand, resizing...)
+std::size_t const max_cached_images = 8;
+
 // Transforms a relative position within the display bounds described by \a rect which is rotated with \a orientation
 geom::Displacement transform(geom::Rectangle const& rect, geom::Displacement const& vector, MirOrientation orientation)
 {
@@ -162,7 +167,7 @@ mgm::Cursor::Cursor(
                 [this, &kms_conf](auto const& output)
                 {
                     // I'm not sure why g++ needs the explicit "this->" but it does - alan_g
-                    this->buffer_for_output(*kms_conf.get_output_for(output.id));
+                    this->create_buffer_for_output(*kms_conf.get_output_for(output.id));
                 });
         });
 
@@ -192,8 +197,11 @@ void mgm::Cursor::write_buffer_data_locked(
 
 void mgm::Cursor::pad_and_write_image_data_locked(
     std::lock_guard<std::mutex> const& lg,
+    Image const& image,
     GBMBOWrapper& buffer)
 {
+    auto const& size = image.size;
+
     auto const orientation = buffer.orientation();
     bool const sideways = orientation == mir_orientation_left || orientation == mir_orientation_right;
 
@@ -212,7 +220,7 @@ void mgm::Cursor::pad_and_write_image_data_locked(
     size_t rhs_padding = buffer_stride - 4*image_width;
 
     auto const filler = 0; // 0x3f; is useful to make buffer visible for debugging
-    uint8_t const* src = argb8888.data();
+    uint8_t const* src = image.argb8888.data();
     uint8_t* dest = &padded[0];
 
     switch (orientation)
@@ -290,19 +298,16 @@ void mgm::Cursor::show(CursorImage const& cursor_image)
 {
     std::lock_guard<std::mutex> lg(guard);
 
-    size = cursor_image.size();
-
-    argb8888.resize(size.width.as_uint32_t() * size.height.as_uint32_t() * 4);
-    memcpy(argb8888.data(), cursor_image.as_argb_8888(), argb8888.size());
+    select_image_locked(lg, cursor_image);
 
-    hotspot = cursor_image.hotspot();
+    for_each_used_output([&](KMSOutput& output, geom::Rectangle const& output_rect, MirOrientation orientation)
     {
-        auto locked_buffers = buffers.lock();
-        for (auto& pair : *locked_buffers)
+        if (output_rect.contains(current_position))
         {
-            pad_and_write_image_data_locked(lg, pair.second);
+            bool written{false};
+            buffer_for_output_locked(lg, output, orientation, written);
         }
-    }
+    });
 
     // Writing the data could throw an exception so lets
     // hold off on setting visible until after we have succeeded.
@@ -310,6 +315,39 @@ void mgm::Cursor::show(CursorImage const& cursor_image)
     place_cursor_at_locked(lg, current_position, ForceState);
 }
 
+void mgm::Cursor::select_image_locked(std::lock_guard<std::mutex> const&, CursorImage const& cursor_image)
+{
+    auto const size = cursor_image.size();
+    auto const hotspot = cursor_image.hotspot();
+    auto const data = static_cast<uint8_t const*>(cursor_image.as_argb_8888());
+    auto const data_size = size.width.as_uint32_t() * size.height.as_uint32_t() * 4;
+
+    // Images are told apart by content: a CursorImage's address says nothing about what it holds
+    auto const cached = std::find_if(begin(images), end(images), [&](Image const& image)
+        {
+            return image.size == size &&
+                   image.hotspot == hotspot &&
+                   memcmp(image.argb8888.data(), data, data_size) == 0;
+        });
+
+    if (cached != end(images))
+    {
+        std::rotate(cached, cached + 1, end(images));
+        return;
+    }
+
+    if (images.size() == max_cached_images)
+        images.erase(begin(images));
+
+    images.push_back(Image{next_image_id++, size, hotspot, {data, data + data_size}});
+}
+
+auto mgm::Cursor::current_image_locked(std::lock_guard<std::mutex> const&) const -> Image const&
+{
+    static Image const no_image{0, {}, {}, {}};
+    return images.empty() ? no_image : images.back();
+}
+
 void mgm::Cursor::move_to(geometry::Point position)
 {
     place_cursor_at(position, UpdateState);
@@ -380,6 +418,7 @@ void mgm::Cursor::place_cursor_at_locked(
     if (!visible)
         return;
 
+    auto const& image = current_image_locked(lg);
     bool set_on_all_outputs = true;
 
     for_each_used_output([&](KMSOutput& output, geom::Rectangle const& output_rect, MirOrientation orientation)
@@ -387,21 +426,18 @@ void mgm::Cursor::place_cursor_at_locked(
         if (output_rect.contains(position))
         {
             auto dp = transform(output_rect, position - output_rect.top_left, orientation);
-            auto hs = transform(geom::Rectangle{{0,0}, size}, hotspot, orientation);
+            auto hs = transform(geom::Rectangle{{0,0}, image.size}, image.hotspot, orientation);
 
             // It's a little strange that we implement hotspot this way as there is
             // drmModeSetCursor2 with hotspot support. However it appears to not actually
             // work on radeon and intel. There also seems to be precedent in weston for
             // implementing hotspot in this fashion.
             output.move_cursor(geom::Point{} + dp - hs);
-            auto& buffer = buffer_for_output(output);
 
-            auto const changed_orientation = buffer.change_orientation(orientation);
+            bool changed_buffer{false};
+            auto& buffer = buffer_for_output_locked(lg, output, orientation, changed_buffer);
 
-            if (changed_orientation)
-                pad_and_write_image_data_locked(lg, buffer);
-
-            if (force_state || !output.has_cursor() || changed_orientation)
+            if (force_state || !output.has_cursor() || changed_buffer)
             {
                 if (!output.set_cursor(buffer) || !output.has_cursor())
                     set_on_all_outputs = false;
@@ -419,26 +455,85 @@ void mgm::Cursor::place_cursor_at_locked(
     last_set_failed = !set_on_all_outputs;
 }
 
-mgm::Cursor::GBMBOWrapper& mgm::Cursor::buffer_for_output(KMSOutput const& output)
+mgm::Cursor::GBMBOWrapper& mgm::Cursor::buffer_for_output_locked(
+    std::lock_guard<std::mutex> const& lg,
+    KMSOutput const& output,
+    MirOrientation orientation,
+    bool& written)
+{
+    auto const& image = current_image_locked(lg);
+    auto const drm_fd = output.drm_fd();
+
+    auto locked_buffers = buffers.lock();
+
+    auto const is_cached = [this](uint64_t id)
+        {
+            return std::any_of(begin(images), end(images), [id](Image const& cached) { return cached.id == id; });
+        };
+
+    Buffer* stale{nullptr};
+    Buffer* least_recently_used{nullptr};
+    std::size_t buffers_for_device{0};
+
+    for (auto& buffer : *locked_buffers)
+    {
+        if (buffer.drm_fd != drm_fd)
+            continue;
+
+        if (buffer.image == image.id && buffer.bo.orientation() == orientation)
+        {
+            buffer.last_used = ++buffer_uses;
+            return buffer.bo;
+        }
+
+        ++buffers_for_device;
+
+        if (!stale && !is_cached(buffer.image))
+            stale = &buffer;
+
+        if (!least_recently_used || buffer.last_used < least_recently_used->last_used)
+            least_recently_used = &buffer;
+    }
+
+    // Reuse a buffer whose image is no longer needed, or when there are enough for
+    // this device, the one that has gone unused the longest
+    auto& chosen =
+        stale ? *stale :
+        buffers_for_device >= max_cached_images ? *least_recently_used :
+        add_buffer(*locked_buffers, drm_fd);
+
+    chosen.image = 0;
+    chosen.bo.change_orientation(orientation);
+    pad_and_write_image_data_locked(lg, image, chosen.bo);
+
+    chosen.image = image.id;
+    chosen.last_used = ++buffer_uses;
+    written = true;
+
+    return chosen.bo;
+}
+
+void mgm::Cursor::create_buffer_for_output(KMSOutput const& output)
 {
     auto locked_buffers = buffers.lock();
 
-    auto buffer_it = std::find_if(
+    auto const has_buffer = std::any_of(
         locked_buffers->begin(),
         locked_buffers->end(),
         [&output](auto const& candidate)
             {
-                return candidate.first == output.drm_fd();
+                return candidate.drm_fd == output.drm_fd();
             });
 
-    if (buffer_it != locked_buffers->end())
-    {
-        return buffer_it->second;
-    }
+    if (!has_buffer)
+        add_buffer(*locked_buffers, output.drm_fd());
+}
 
-    locked_buffers->push_back(std::make_pair(output.drm_fd(), GBMBOWrapper(output.drm_fd(), mir_orientation_normal)));
+auto mgm::Cursor::add_buffer(std::vector<Buffer>& locked_buffers, int drm_fd) -> Buffer&
+{
+    locked_buffers.push_back(Buffer{drm_fd, 0, 0, GBMBOWrapper(drm_fd, mir_orientation_normal)});
 
-    GBMBOWrapper& bo = locked_buffers->back().second;
+    GBMBOWrapper& bo = locked_buffers.back().bo;
     if (gbm_bo_get_width(bo) < min_buffer_width)
     {
         min_buffer_width = gbm_bo_get_width(bo);
@@ -448,5 +543,5 @@ mgm::Cursor::GBMBOWrapper& mgm::Cursor::buffer_for_output(KMSOutput const& outpu
         min_buffer_height = gbm_bo_get_height(bo);
     }
 
-    return bo;
+    return locked_buffers.back();
 }
@@ -86,6 +86,7 @@ public:
 private:
     enum ForceCursorState { UpdateState, ForceState };
     struct GBMBOWrapper;
+    struct Image;
     void for_each_used_output(std::function<void(KMSOutput&, geometry::Rectangle const&, MirOrientation orientation)> const& f);
     void place_cursor_at(geometry::Point position, ForceCursorState force_state);
     void place_cursor_at_locked(std::lock_guard<std::mutex> const&, geometry::Point position, ForceCursorState force_state);
@@ -96,18 +97,39 @@ private:
         size_t count);
     void pad_and_write_image_data_locked(
         std::lock_guard<std::mutex> const&,
+        Image const& image,
         GBMBOWrapper& buffer);
     void clear(std::lock_guard<std::mutex> const&);
 
-    GBMBOWrapper& buffer_for_output(KMSOutput const& output);
+    void select_image_locked(std::lock_guard<std::mutex> const&, CursorImage const& cursor_image);
+    auto current_image_locked(std::lock_guard<std::mutex> const&) const -> Image const&;
+
+    /// The buffer holding the current image for output, padded and rotated to orientation.
+    /// Sets written if the image had to be written to it.
+    GBMBOWrapper& buffer_for_output_locked(
+        std::lock_guard<std::mutex> const&,
+        KMSOutput const& output,
+        MirOrientation orientation,
+        bool& written);
+    void create_buffer_for_output(KMSOutput const& output);
     
     std::mutex guard;
 
     KMSOutputContainer& output_container;
     geometry::Point current_position;
-    geometry::Displacement hotspot;
-    geometry::Size size;
-    std::vector<uint8_t> argb8888;
+
+    struct Image
+    {
+        uint64_t id;    ///< 0 for no image
+        geometry::Size size;
+        geometry::Displacement hotspot;
+        std::vector<uint8_t> argb8888;
+    };
+
+    // The images most recently shown, the current one last. Changing back to one of
+    // these needs no more than a buffer it was written to earlier to be set.
+    std::vector<Image> images;
+    uint64_t next_image_id{1};
 
     bool visible;
     bool last_set_failed;
@@ -130,7 +152,18 @@ private:
         GBMBOWrapper(GBMBOWrapper const&) = delete;
         GBMBOWrapper& operator=(GBMBOWrapper const&) = delete;
     };
-    Mutex<std::vector<std::pair<int, GBMBOWrapper>>> buffers;
+
+    struct Buffer
+    {
+        int drm_fd;
+        uint64_t image;         ///< The id of the image written to bo
+        uint64_t last_used;
+        GBMBOWrapper bo;
+    };
+    Mutex<std::vector<Buffer>> buffers;
+    uint64_t buffer_uses{0};
+
+    auto add_buffer(std::vector<Buffer>& locked_buffers, int drm_fd) -> Buffer&;
 
     uint32_t min_buffer_width;
     uint32_t min_buffer_height;
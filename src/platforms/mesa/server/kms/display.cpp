@@ -46,6 +46,7 @@
 #include <stdexcept>
 #include <algorithm>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace mgm = mir::graphics::mesa;
 namespace mg = mir::graphics;
@@ -60,6 +61,22 @@ int errno_from_exception(std::exception const& e)
     return (errno_ptr != nullptr) ? *errno_ptr : -1;
 }
 
+std::vector<mg::DisplayConfigurationOutput> outputs_of(mg::OverlappingOutputGroup const& group)
+{
+    std::vector<mg::DisplayConfigurationOutput> outputs;
+    group.for_each_output(
+        [&outputs](mg::DisplayConfigurationOutput const& output) { outputs.push_back(output); });
+    return outputs;
+}
+
+std::vector<std::vector<mg::DisplayConfigurationOutput>> output_groups_of(mg::DisplayConfiguration const& conf)
+{
+    std::vector<std::vector<mg::DisplayConfigurationOutput>> groups;
+    mg::OverlappingOutputGrouping{conf}.for_each_group(
+        [&groups](mg::OverlappingOutputGroup const& group) { groups.push_back(outputs_of(group)); });
+    return groups;
+}
+
 class GBMGLContext : public mir::renderer::gl::Context
 {
 public:
@@ -417,6 +434,26 @@ std::unique_ptr<mir::renderer::gl::Context> mgm::Display::create_gl_context()
     return std::make_unique<GBMGLContext>(*gbm, *gl_config, shared_egl.context());
 }
 
+void mgm::Display::for_each_display_sync_group_invalidated_by(
+    mg::DisplayConfiguration const& conf,
+    std::function<void(graphics::DisplaySyncGroup&)> const& f)
+{
+    auto const& new_kms_conf = dynamic_cast<RealKMSDisplayConfiguration const&>(conf);
+
+    std::lock_guard<std::mutex> lg{configuration_mutex};
+
+    if (compatible(current_display_configuration, new_kms_conf))
+        return;
+
+    /* configure_locked() keeps the DisplayBuffers of groups it finds unchanged */
+    auto const new_groups = output_groups_of(new_kms_conf);
+    for (size_t i = 0; i != display_buffers.size(); ++i)
+    {
+        if (std::find(new_groups.begin(), new_groups.end(), display_buffer_outputs[i]) == new_groups.end())
+            f(*display_buffers[i]);
+    }
+}
+
 bool mgm::Display::apply_if_configuration_preserves_display_buffers(
     mg::DisplayConfiguration const& conf)
 {
@@ -482,24 +519,48 @@ void mgm::Display::configure_locked(
         (&kms_conf != &current_display_configuration) &&
         compatible(kms_conf, current_display_configuration)};
     std::vector<std::unique_ptr<DisplayBuffer>> display_buffers_new;
+    std::vector<std::vector<DisplayConfigurationOutput>> display_buffer_outputs_new;
 
     if (!comp)
     {
         /*
-         * Notice for a little while here we will have duplicate
-         * DisplayBuffers attached to each output, and the display_buffers_new
-         * will take over the outputs before the old display_buffers are
-         * destroyed. So to avoid page flipping confusion in-between, make
-         * sure we wait for all pending page flips to finish before the
-         * display_buffers_new are created and take control of the outputs.
+         * A group of outputs that is exactly the same in the new configuration
+         * keeps its DisplayBuffers: its outputs are neither reset nor modeset,
+         * and compositing to it can carry on undisturbed.
          */
-        for (auto& db : display_buffers)
-            db->wait_for_page_flip();
+        auto const new_groups = output_groups_of(kms_conf);
+        std::unordered_set<DisplayConfigurationOutputId> preserved_outputs;
 
-        /* Reset the state of all outputs */
+        for (size_t i = 0; i != display_buffers.size(); ++i)
+        {
+            auto const& outputs = display_buffer_outputs[i];
+
+            if (std::find(new_groups.begin(), new_groups.end(), outputs) != new_groups.end())
+            {
+                for (auto const& output : outputs)
+                    preserved_outputs.insert(output.id);
+            }
+            else
+            {
+                /*
+                 * Notice for a little while here we will have duplicate
+                 * DisplayBuffers attached to each output, and the display_buffers_new
+                 * will take over the outputs before the old display_buffers are
+                 * destroyed. So to avoid page flipping confusion in-between, make
+                 * sure we wait for all pending page flips to finish before the
+                 * display_buffers_new are created and take control of the outputs.
+                 */
+                display_buffers[i]->wait_for_page_flip();
+            }
+        }
+
+        /* Reset the state of all other outputs */
         kms_conf.for_each_output(
             [&](DisplayConfigurationOutput const& conf_output)
             {
+                if (preserved_outputs.count(conf_output.id))
+                    return;
+
                 auto kms_output = current_display_configuration.get_output_for(conf_output.id);
                 kms_output->clear_cursor();
                 kms_output->reset();
@@ -513,6 +574,25 @@ void mgm::Display::configure_locked(
     grouping.for_each_group(
         [&](OverlappingOutputGroup const& group)
         {
+            auto const outputs = outputs_of(group);
+
+            if (!comp)
+            {
+                auto const kept = display_buffers_new.size();
+
+                for (size_t i = 0; i != display_buffers.size(); ++i)
+                {
+                    if (display_buffers[i] && display_buffer_outputs[i] == outputs)
+                    {
+                        display_buffers_new.push_back(std::move(display_buffers[i]));
+                        display_buffer_outputs_new.push_back(outputs);
+                    }
+                }
+
+                if (display_buffers_new.size() != kept)
+                    return;
+            }
+
             auto bounding_rect = group.bounding_rectangle();
             // Each vector<KMSOutput> is a single GPU memory domain
             std::vector<std::vector<std::shared_ptr<KMSOutput>>> kms_output_groups;
@@ -542,6 +622,7 @@ void mgm::Display::configure_locked(
 
             if (comp)
             {
+                display_buffer_outputs[group_idx] = outputs;
                 display_buffers[group_idx++]->set_transformation(transformation,
                                                                  bounding_rect);
             }
@@ -586,12 +667,16 @@ void mgm::Display::configure_locked(
                         transformation);
 
                     display_buffers_new.push_back(std::move(db));
+                    display_buffer_outputs_new.push_back(outputs);
                 }
             }
         });
 
     if (!comp)
+    {
         display_buffers = std::move(display_buffers_new);
+        display_buffer_outputs = std::move(display_buffer_outputs_new);
+    }
 
     /* Store applied configuration */
     current_display_configuration = kms_conf;
@@ -35,15 +35,170 @@
 #include <glm/gtc/type_ptr.hpp>
 #include <EGL/egl.h>
 
+#include MIR_SERVER_GLEXT_H
+
 #include <boost/throw_exception.hpp>
+#include <array>
 #include <stdexcept>
 #include <cmath>
+#include <cstring>
 
 namespace mg = mir::graphics;
 namespace mgl = mir::gl;
 namespace mrg = mir::renderer::gl;
 namespace geom = mir::geometry;
 
+namespace
+{
+/* Timer query names, common to GL_EXT_disjoint_timer_query and GL_ARB_timer_query */
+GLenum const time_elapsed{0x88BF};              // GL_TIME_ELAPSED
+GLenum const query_result{0x8866};              // GL_QUERY_RESULT
+GLenum const query_result_available{0x8867};    // GL_QUERY_RESULT_AVAILABLE
+GLenum const gpu_disjoint{0x8FBB};              // GL_GPU_DISJOINT_EXT
+
+bool has_extension(char const* name)
+{
+    auto const extensions = reinterpret_cast<char const*>(glGetString(GL_EXTENSIONS));
+    if (!extensions)
+        return false;
+
+    auto const length = strlen(name);
+    for (auto found = strstr(extensions, name); found; found = strstr(found + length, name))
+    {
+        if ((found == extensions || found[-1] == ' ') && (found[length] == '\0' || found[length] == ' '))
+            return true;
+    }
+
+    return false;
+}
+
+template<typename Function>
+void resolve(Function& function, std::string const& name)
+{
+    function = reinterpret_cast<Function>(eglGetProcAddress(name.c_str()));
+}
+}
+
+/*
+ * Times the GPU's work on each frame with timer queries. A result is only
+ * available once the GPU has caught up, which is usually a frame or two
+ * later, so a few queries are kept in flight and polled (never waited on).
+ */
+class mrg::Renderer::GpuTimer
+{
+public:
+    GpuTimer()
+    {
+        // GLES has the EXT extension; desktop GL has the ARB one, whose entry points have no suffix
+        std::string suffix;
+        if (has_extension("GL_EXT_disjoint_timer_query"))
+        {
+            suffix = "EXT";
+            can_be_disjoint = true;
+        }
+        else if (!has_extension("GL_ARB_timer_query"))
+        {
+            return;
+        }
+
+        resolve(glGenQueries, "glGenQueries" + suffix);
+        resolve(glDeleteQueries, "glDeleteQueries" + suffix);
+        resolve(glBeginQuery, "glBeginQuery" + suffix);
+        resolve(glEndQuery, "glEndQuery" + suffix);
+        resolve(glGetQueryObjectuiv, "glGetQueryObjectuiv" + suffix);
+        resolve(glGetQueryObjectui64v, "glGetQueryObjectui64v" + suffix);
+
+        supported = glGenQueries && glDeleteQueries && glBeginQuery && glEndQuery &&
+                    glGetQueryObjectuiv && glGetQueryObjectui64v;
+
+        if (supported)
+            glGenQueries(queries.size(), queries.data());
+    }
+
+    ~GpuTimer()
+    {
+        if (supported)
+            glDeleteQueries(queries.size(), queries.data());
+    }
+
+    // Passes the GPU time of each frame that has completed to receive()
+    template<typename Receiver>
+    void begin_frame(Receiver const& receive)
+    {
+        if (!supported)
+            return;
+
+        collect(receive);
+
+        // If the GPU is this far behind, this frame just goes untimed
+        if (in_flight == queries.size())
+            return;
+
+        glBeginQuery(time_elapsed, queries[(oldest + in_flight) % queries.size()]);
+        timing = true;
+    }
+
+    void end_frame()
+    {
+        if (!timing)
+            return;
+
+        glEndQuery(time_elapsed);
+        timing = false;
+        ++in_flight;
+    }
+
+private:
+    template<typename Receiver>
+    void collect(Receiver const& receive)
+    {
+        if (can_be_disjoint)
+        {
+            // Something (e.g. a GPU frequency change) has made the results in flight meaningless
+            GLint disjoint{GL_FALSE};
+            glGetIntegerv(gpu_disjoint, &disjoint);
+            if (disjoint)
+            {
+                oldest = (oldest + in_flight) % queries.size();
+                in_flight = 0;
+                return;
+            }
+        }
+
+        while (in_flight)
+        {
+            auto const query = queries[oldest];
+
+            GLuint available{GL_FALSE};
+            glGetQueryObjectuiv(query, query_result_available, &available);
+            if (!available)
+                break;
+
+            GLuint64 elapsed{0};
+            glGetQueryObjectui64v(query, query_result, &elapsed);
+            oldest = (oldest + 1) % queries.size();
+            --in_flight;
+
+            receive(std::chrono::nanoseconds{elapsed});
+        }
+    }
+
+    void (GL_APIENTRYP glGenQueries)(GLsizei n, GLuint* ids){nullptr};
+    void (GL_APIENTRYP glDeleteQueries)(GLsizei n, GLuint const* ids){nullptr};
+    void (GL_APIENTRYP glBeginQuery)(GLenum target, GLuint id){nullptr};
+    void (GL_APIENTRYP glEndQuery)(GLenum target){nullptr};
+    void (GL_APIENTRYP glGetQueryObjectuiv)(GLuint id, GLenum pname, GLuint* params){nullptr};
+    void (GL_APIENTRYP glGetQueryObjectui64v)(GLuint id, GLenum pname, GLuint64* params){nullptr};
+
+    bool supported{false};
+    bool can_be_disjoint{false};
+    bool timing{false};
+
+    std::array<GLuint, 4> queries;
+    std::size_t oldest{0};
+    std::size_t in_flight{0};
+};
+
 mrg::CurrentRenderTarget::CurrentRenderTarget(mg::DisplayBuffer* display_buffer)
     : render_target{
         dynamic_cast<renderer::gl::RenderTarget*>(display_buffer->native_display_buffer())}
@@ -137,6 +292,7 @@ mrg::Renderer::Renderer(graphics::DisplayBuffer& display_buffer)
       default_program(family.add_program(vshader, default_fshader)),
       alpha_program(family.add_program(vshader, alpha_fshader)),
       texture_cache(mgl::DefaultProgramFactory().create_texture_cache()),
+      gpu_timer(std::make_unique<GpuTimer>()),
       display_transform(1)
 {
     eglBindAPI(MIR_SERVER_EGL_OPENGL_API);
@@ -205,14 +361,42 @@ void mrg::Renderer::render(mg::RenderableList const& renderables) const
 {
     render_target.bind();
 
+    gpu_timer->begin_frame([this](std::chrono::nanoseconds gpu_time)
+        {
+            if (timing_observer)
+                timing_observer->gpu_completed(gpu_time);
+        });
+
     glClearColor(clear_color[0], clear_color[1], clear_color[2], clear_color[3]);
     glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
     glClear(GL_COLOR_BUFFER_BIT);
 
+    // Binding all the textures up front keeps the cost of uploading client
+    // buffers apart from the cost of drawing (draw() then finds them cached)
+    for (auto const& r : renderables)
+    {
+        try
+        {
+            texture_cache->load(*r);
+        }
+        catch (std::exception const&)
+        {
+            // draw() tries again, and reports the failure
+        }
+    }
+
+    if (timing_observer)
+        timing_observer->textures_bound();
+
     ++frameno;
     for (auto const& r : renderables)
         draw(*r, r->alpha() < 1.0f ? alpha_program : default_program);
 
+    gpu_timer->end_frame();
+
+    if (timing_observer)
+        timing_observer->draw_submitted();
+
     render_target.swap_buffers();
 
     // Deleting unused textures only requires the GL context. This clean-up
@@ -430,3 +614,8 @@ void mrg::Renderer::suspend()
     texture_cache->invalidate();
 }
 
+void mrg::Renderer::set_timing_observer(std::shared_ptr<FrameTimingObserver> const& observer)
+{
+    timing_observer = observer;
+}
+
@@ -29,6 +29,7 @@
 #include "mir/renderer/gl/render_target.h"
 
 #include MIR_SERVER_GL_H
+#include <memory>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -70,6 +71,8 @@ public:
     // This is called _without_ a GL context:
     void suspend() override;
 
+    void set_timing_observer(std::shared_ptr<FrameTimingObserver> const& observer) override;
+
 private:
     mutable CurrentRenderTarget render_target;
 
@@ -126,6 +129,11 @@ private:
     void update_gl_viewport();
 
     std::unique_ptr<mir::gl::TextureCache> const texture_cache;
+
+    class GpuTimer;
+    std::unique_ptr<GpuTimer> const gpu_timer;
+    std::shared_ptr<FrameTimingObserver> timing_observer;
+
     geometry::Rectangle viewport;
     glm::mat4 screen_to_gl_coords;
     glm::mat4 display_transform;
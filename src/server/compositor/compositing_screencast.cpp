@@ -18,6 +18,7 @@
 
 #include "compositing_screencast.h"
 #include "screencast_display_buffer.h"
+#include "screencast_damage.h"
 #include "queueing_schedule.h"
 #include "mir/graphics/buffer.h"
 #include "mir/graphics/buffer_properties.h"
@@ -29,13 +30,17 @@
 #include "mir/graphics/transformation.h"
 #include "mir/compositor/display_buffer_compositor.h"
 #include "mir/geometry/rectangles.h"
+#include "mir/scene/legacy_scene_change_notification.h"
 #include "mir/raii.h"
 
 #include <boost/throw_exception.hpp>
 
+#include <algorithm>
+
 namespace mc = mir::compositor;
 namespace mf = mir::frontend;
 namespace mg = mir::graphics;
+namespace ms = mir::scene;
 namespace geom = mir::geometry;
 
 namespace
@@ -64,6 +69,13 @@ std::unique_ptr<mg::VirtualOutput> make_virtual_output(mg::Display& display, geo
     }
     return nullptr;
 }
+
+std::shared_ptr<ms::Observer> make_damage_observer(std::shared_ptr<mc::ScreencastDamage> const& damage)
+{
+    return std::make_shared<ms::LegacySceneChangeNotification>(
+        [damage] { damage->add_everything(); },
+        [damage](int, geom::Rectangle const& area) { damage->add(area); });
+}
 }
 
 class mc::detail::ScreencastSessionContext
@@ -81,6 +93,8 @@ public:
       display_buffer{std::make_unique<ScreencastDisplayBuffer>(capture_region, capture_size, mirror_mode, free_queue, ready_queue, display)},
       display_buffer_compositor{db_compositor_factory.create_compositor_for(*display_buffer)},
       virtual_output{make_virtual_output(display, capture_region)},
+      damage{std::make_shared<ScreencastDamage>(capture_region)},
+      damage_observer{make_damage_observer(damage)},
       queue_size(capture_size),
       mirror_mode(mirror_mode)
     {
@@ -88,11 +102,13 @@ public:
             free_queue.schedule(buffer);
 
         scene->register_compositor(this);
+        scene->add_observer(damage_observer);
         if (virtual_output)
             virtual_output->enable();
     }
     ~ScreencastSessionContext()
     {
+        scene->remove_observer(damage_observer);
         scene->unregister_compositor(this);
     }
 
@@ -113,9 +129,16 @@ public:
         return last_captured_buffer;
     }
 
-    void capture(std::shared_ptr<mg::Buffer> const& buffer)
+    geom::Rectangles capture(std::shared_ptr<mg::Buffer> const& buffer)
     {
         std::lock_guard<decltype(mutex)> lk(mutex);
+
+        auto const generation = damage->generation();
+        auto const changes = damage->take(buffer->size(), mirror_mode);
+
+        if (holds_generation(buffer, generation))
+            return changes;
+
         if (buffer->size() != display_buffer->renderbuffer_size())
             display_buffer->set_renderbuffer_size(buffer->size());
        
@@ -144,9 +167,36 @@ public:
 
         display_buffer->set_transformation(mg::transformation(mirror_mode));
         display_buffer->commit();
+
+        remember_generation(buffer, generation);
+        return changes;
     }
 
 private:
+    bool holds_generation(std::shared_ptr<mg::Buffer> const& buffer, uint64_t generation) const
+    {
+        for (auto const& rendered : rendered_generations)
+        {
+            if (rendered.first.lock() == buffer)
+                return rendered.second == generation;
+        }
+        return false;
+    }
+
+    void remember_generation(std::shared_ptr<mg::Buffer> const& buffer, uint64_t generation)
+    {
+        rendered_generations.erase(
+            std::remove_if(rendered_generations.begin(), rendered_generations.end(),
+                [&buffer](auto const& rendered)
+                {
+                    auto const rendered_buffer = rendered.first.lock();
+                    return !rendered_buffer || rendered_buffer == buffer;
+                }),
+            rendered_generations.end());
+
+        rendered_generations.emplace_back(buffer, generation);
+    }
+
     std::mutex mutex;
     std::shared_ptr<Scene> const scene;
     QueueingSchedule free_queue;
@@ -155,6 +205,11 @@ private:
 
     std::unique_ptr<compositor::DisplayBufferCompositor> display_buffer_compositor;
     std::unique_ptr<graphics::VirtualOutput> virtual_output;
+    std::shared_ptr<ScreencastDamage> const damage;
+    std::shared_ptr<ms::Observer> const damage_observer;
+    /// The scene generation last composited into each client buffer, so
+    /// capturing again while nothing has changed can skip compositing
+    std::vector<std::pair<std::weak_ptr<mg::Buffer>, uint64_t>> rendered_generations;
     std::shared_ptr<mg::Buffer> last_captured_buffer;
     geom::Size queue_size;
     MirMirrorMode mirror_mode;
@@ -247,8 +302,8 @@ mc::CompositingScreencast::create_session_context(
         scene, *display, *db_compositor_factory, buffers, rect, size, mirror_mode);
 }
 
-void mc::CompositingScreencast::capture(
+geom::Rectangles mc::CompositingScreencast::capture(
     mf::ScreencastSessionId id, std::shared_ptr<mg::Buffer> const& b)
 {
-    session(id)->capture(b);
+    return session(id)->capture(b);
 }
@@ -21,6 +21,8 @@
 #include "mir/shell/shell.h"
 #include "buffer_stream_factory.h"
 #include "default_display_buffer_compositor_factory.h"
+#include "frame_notifying_compositor_factory.h"
+#include "../input/touch_resampling_dispatcher.h"
 #include "multi_threaded_compositor.h"
 #include "gl/renderer_factory.h"
 #include "compositing_screencast.h"
@@ -51,8 +53,19 @@ mir::DefaultServerConfiguration::the_display_buffer_compositor_factory()
     return display_buffer_compositor_factory(
         [this]()
         {
-            return wrap_display_buffer_compositor_factory(std::make_shared<mc::DefaultDisplayBufferCompositorFactory>(
-                the_renderer_factory(), the_compositor_report()));
+            std::shared_ptr<mc::DisplayBufferCompositorFactory> factory =
+                std::make_shared<mc::DefaultDisplayBufferCompositorFactory>(
+                    the_renderer_factory(), the_compositor_report());
+
+            // Touch resampling follows the compositor's frames
+            if (the_options()->get<bool>(options::touch_resampling_opt))
+            {
+                auto const resampler = the_touch_resampling_dispatcher();
+                factory = std::make_shared<mc::FrameNotifyingCompositorFactory>(
+                    factory, [resampler] { resampler->frame_started(); });
+            }
+
+            return wrap_display_buffer_compositor_factory(factory);
         });
 }
 
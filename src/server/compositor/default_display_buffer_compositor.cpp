@@ -34,6 +34,41 @@
 namespace mc = mir::compositor;
 namespace mg = mir::graphics;
 
+namespace
+{
+// Reports the renderer's progress through a frame as the stages of the display's frame
+class ReportingTimingObserver : public mir::renderer::FrameTimingObserver
+{
+public:
+    ReportingTimingObserver(
+        std::shared_ptr<mc::CompositorReport> const& report,
+        mc::CompositorReport::SubCompositorId id) :
+        report{report},
+        id{id}
+    {
+    }
+
+    void textures_bound() override
+    {
+        report->frame_reached_stage(id, mc::FrameStage::textures_bound);
+    }
+
+    void draw_submitted() override
+    {
+        report->frame_reached_stage(id, mc::FrameStage::draw_submitted);
+    }
+
+    void gpu_completed(std::chrono::nanoseconds gpu_time) override
+    {
+        report->rendered_on_gpu(id, gpu_time);
+    }
+
+private:
+    std::shared_ptr<mc::CompositorReport> const report;
+    mc::CompositorReport::SubCompositorId const id;
+};
+}
+
 mc::DefaultDisplayBufferCompositor::DefaultDisplayBufferCompositor(
     mg::DisplayBuffer& display_buffer,
     std::shared_ptr<mir::renderer::Renderer> const& renderer,
@@ -42,6 +77,7 @@ mc::DefaultDisplayBufferCompositor::DefaultDisplayBufferCompositor(
     renderer(renderer),
     report(report)
 {
+    renderer->set_timing_observer(std::make_shared<ReportingTimingObserver>(report, this));
 }
 
 void mc::DefaultDisplayBufferCompositor::composite(mc::SceneElementSequence&& scene_elements)
@@ -62,6 +98,8 @@ void mc::DefaultDisplayBufferCompositor::composite(mc::SceneElementSequence&& sc
         renderable_list.push_back(element->renderable());
     }
 
+    report->frame_reached_stage(this, mc::FrameStage::scene_snapshotted);
+
     /*
      * Note: Buffer lifetimes are ensured by the two objects holding
      *       references to them; scene_elements and renderable_list.
@@ -0,0 +1,61 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "frame_notifying_compositor_factory.h"
+#include "mir/compositor/display_buffer_compositor.h"
+
+namespace mc = mir::compositor;
+namespace mg = mir::graphics;
+
+namespace
+{
+class FrameNotifyingCompositor : public mc::DisplayBufferCompositor
+{
+public:
+    FrameNotifyingCompositor(
+        std::unique_ptr<mc::DisplayBufferCompositor> wrapped,
+        std::function<void()> const& frame_started)
+        : wrapped{std::move(wrapped)},
+          frame_started{frame_started}
+    {
+    }
+
+    void composite(mc::SceneElementSequence&& scene_sequence) override
+    {
+        frame_started();
+        wrapped->composite(std::move(scene_sequence));
+    }
+
+private:
+    std::unique_ptr<mc::DisplayBufferCompositor> const wrapped;
+    std::function<void()> const frame_started;
+};
+}
+
+mc::FrameNotifyingCompositorFactory::FrameNotifyingCompositorFactory(
+    std::shared_ptr<DisplayBufferCompositorFactory> const& wrapped,
+    std::function<void()> const& frame_started)
+    : wrapped{wrapped},
+      frame_started{frame_started}
+{
+}
+
+std::unique_ptr<mc::DisplayBufferCompositor>
+mc::FrameNotifyingCompositorFactory::create_compositor_for(mg::DisplayBuffer& display_buffer)
+{
+    return std::make_unique<FrameNotifyingCompositor>(
+        wrapped->create_compositor_for(display_buffer), frame_started);
+}
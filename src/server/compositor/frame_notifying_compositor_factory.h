@@ -0,0 +1,48 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_COMPOSITOR_FRAME_NOTIFYING_COMPOSITOR_FACTORY_H_
+#define MIR_COMPOSITOR_FRAME_NOTIFYING_COMPOSITOR_FACTORY_H_
+
+#include "mir/compositor/display_buffer_compositor_factory.h"
+
+#include <functional>
+
+namespace mir
+{
+namespace compositor
+{
+
+/// Wraps the compositors created by another factory to call \a frame_started
+/// (on the compositor thread) each time one of them starts a frame
+class FrameNotifyingCompositorFactory : public DisplayBufferCompositorFactory
+{
+public:
+    FrameNotifyingCompositorFactory(
+        std::shared_ptr<DisplayBufferCompositorFactory> const& wrapped,
+        std::function<void()> const& frame_started);
+
+    std::unique_ptr<DisplayBufferCompositor> create_compositor_for(graphics::DisplayBuffer& display_buffer) override;
+
+private:
+    std::shared_ptr<DisplayBufferCompositorFactory> const wrapped;
+    std::function<void()> const frame_started;
+};
+
+}
+}
+
+#endif /* MIR_COMPOSITOR_FRAME_NOTIFYING_COMPOSITOR_FACTORY_H_ */
@@ -35,6 +35,7 @@
 #include <thread>
 #include <chrono>
 #include <condition_variable>
+#include <algorithm>
 #include <boost/throw_exception.hpp>
 
 using namespace std::literals::chrono_literals;
@@ -142,6 +143,12 @@ public:
                     }
                     group.post();
 
+                    for (auto& tuple : compositors)
+                    {
+                        auto const comp_id = std::get<1>(tuple).get();
+                        report->frame_reached_stage(comp_id, FrameStage::flip_completed);
+                    }
+
                     /*
                      * "Predictive bypass" optimization: If the last frame was
                      * bypassed/overlayed or you simply have a fast GPU, it is
@@ -222,6 +229,11 @@ public:
         run_cv.notify_one();
     }
 
+    bool composites_to(mg::DisplaySyncGroup const& display_sync_group) const
+    {
+        return &group == &display_sync_group;
+    }
+
     void wait_until_started()
     {
         if (started_future.wait_for(10s) != std::future_status::ready)
@@ -286,6 +298,7 @@ mc::MultiThreadedCompositor::~MultiThreadedCompositor()
 void mc::MultiThreadedCompositor::schedule_compositing(int num)
 {
     report->scheduled();
+    std::lock_guard<std::mutex> lock{functors_mutex};
     for (auto& f : thread_functors)
         f->schedule_compositing(num);
 }
@@ -293,6 +306,7 @@ void mc::MultiThreadedCompositor::schedule_compositing(int num)
 void mc::MultiThreadedCompositor::schedule_compositing(int num, geometry::Rectangle const& damage) const
 {
     report->scheduled();
+    std::lock_guard<std::mutex> lock{functors_mutex};
     for (auto& f : thread_functors)
         f->schedule_compositing(num, damage);
 }
@@ -361,23 +375,66 @@ void mc::MultiThreadedCompositor::stop()
     state = CompositorState::stopped;
 }
 
+void mc::MultiThreadedCompositor::configure_display(mg::Display& display, mg::DisplayConfiguration const& conf)
+{
+    // We can only carry on compositing to the outputs of our own display
+    if (state != CompositorState::started || &display != this->display.get())
+    {
+        Compositor::configure_display(display, conf);
+        return;
+    }
+
+    std::unordered_set<mg::DisplaySyncGroup*> invalidated;
+    display.for_each_display_sync_group_invalidated_by(
+        conf,
+        [&invalidated](mg::DisplaySyncGroup& group) { invalidated.insert(&group); });
+
+    destroy_compositing_threads_for(invalidated);
+
+    /* Whether or not it succeeds, composite to every output group the display then has */
+    try
+    {
+        display.configure(conf);
+    }
+    catch (...)
+    {
+        create_compositing_threads();
+        throw;
+    }
+
+    create_compositing_threads();
+    schedule_compositing(1);
+}
+
 void mc::MultiThreadedCompositor::create_compositing_threads()
 {
-    /* Start the display buffer compositing threads */
+    auto const first_new = thread_functors.size();
+
+    /* Start compositing threads for the display buffers we aren't compositing to already */
     display->for_each_display_sync_group([this](mg::DisplaySyncGroup& group)
     {
+        auto const composited = std::any_of(
+            thread_functors.begin(), thread_functors.end(),
+            [&group](auto const& functor) { return functor->composites_to(group); });
+
+        if (composited)
+            return;
+
         auto thread_functor = std::make_unique<mc::CompositingFunctor>(
             display_buffer_compositor_factory, group, scene, display_listener,
             fixed_composite_delay, report);
 
-        futures.push_back(thread_pool.run(std::ref(*thread_functor), &group));
+        auto future = thread_pool.run(std::ref(*thread_functor), &group);
+
+        std::lock_guard<std::mutex> lock{functors_mutex};
+        futures.push_back(std::move(future));
         thread_functors.push_back(std::move(thread_functor));
     });
 
     thread_pool.shrink();
 
-    for (auto& functor : thread_functors)
-        functor->wait_until_started();
+    for (auto i = first_new; i != thread_functors.size(); ++i)
+        thread_functors[i]->wait_until_started();
 }
 
 void mc::MultiThreadedCompositor::destroy_compositing_threads()
@@ -388,6 +445,43 @@ void mc::MultiThreadedCompositor::destroy_compositing_threads()
     for (auto& f : futures)
         f.wait();
 
+    std::lock_guard<std::mutex> lock{functors_mutex};
     thread_functors.clear();
     futures.clear();
 }
+
+void mc::MultiThreadedCompositor::destroy_compositing_threads_for(
+    std::unordered_set<mg::DisplaySyncGroup*> const& groups)
+{
+    std::vector<std::unique_ptr<CompositingFunctor>> stopping_functors;
+    std::vector<std::future<void>> stopping_futures;
+
+    {
+        std::lock_guard<std::mutex> lock{functors_mutex};
+
+        for (size_t i = 0; i != thread_functors.size();)
+        {
+            auto const stopping = std::any_of(
+                groups.begin(), groups.end(),
+                [&](mg::DisplaySyncGroup* group) { return thread_functors[i]->composites_to(*group); });
+
+            if (stopping)
+            {
+                stopping_functors.push_back(std::move(thread_functors[i]));
+                stopping_futures.push_back(std::move(futures[i]));
+                thread_functors.erase(thread_functors.begin() + i);
+                futures.erase(futures.begin() + i);
+            }
+            else
+            {
+                ++i;
+            }
+        }
+    }
+
+    for (auto& f : stopping_functors)
+        f->stop();
+
+    for (auto& f : stopping_futures)
+        f.wait();
+}
@@ -28,6 +28,7 @@
 #include <future>
 #include <chrono>
 #include <atomic>
+#include <unordered_set>
 
 namespace mir
 {
@@ -35,6 +36,7 @@ namespace geometry { struct Rectangle; }
 namespace graphics
 {
 class Display;
+class DisplaySyncGroup;
 }
 namespace scene
 {
@@ -73,10 +75,12 @@ public:
 
     void start();
     void stop();
+    void configure_display(graphics::Display& display, graphics::DisplayConfiguration const& conf) override;
 
 private:
     void create_compositing_threads();
     void destroy_compositing_threads();
+    void destroy_compositing_threads_for(std::unordered_set<graphics::DisplaySyncGroup*> const& groups);
 
     std::shared_ptr<graphics::Display> const display;
     std::shared_ptr<Scene> const scene;
@@ -84,6 +88,8 @@ private:
     std::shared_ptr<DisplayListener> const display_listener;
     std::shared_ptr<CompositorReport> const report;
 
+    // Guards thread_functors and futures, which change while running when the display is reconfigured
+    mutable std::mutex functors_mutex;
     std::vector<std::unique_ptr<CompositingFunctor>> thread_functors;
     std::vector<std::future<void>> futures;
 
@@ -0,0 +1,128 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "screencast_damage.h"
+
+#include <algorithm>
+
+namespace mc = mir::compositor;
+namespace geom = mir::geometry;
+
+namespace
+{
+geom::Rectangle bounding_rectangle(std::vector<geom::Rectangle> const& rects)
+{
+    geom::Rectangles all;
+    for (auto const& rect : rects)
+        all.add(rect);
+    return all.bounding_rectangle();
+}
+
+/// Scales a span of the capture region to the buffer, rounding outwards
+void scale(int start, int length, int region_length, int buffer_length, int& scaled_start, int& scaled_length)
+{
+    auto const scaled_end = (static_cast<int64_t>(start + length) * buffer_length + region_length - 1) / region_length;
+    scaled_start = static_cast<int64_t>(start) * buffer_length / region_length;
+    scaled_length = std::min<int64_t>(scaled_end, buffer_length) - scaled_start;
+}
+}
+
+mc::ScreencastDamage::ScreencastDamage(geom::Rectangle const& capture_region)
+    : capture_region{capture_region},
+      everything{true},
+      generation_{0}
+{
+}
+
+void mc::ScreencastDamage::add(geom::Rectangle const& rect)
+{
+    auto const clipped = rect.intersection_with(capture_region);
+    if (clipped.size.width.as_int() == 0 || clipped.size.height.as_int() == 0)
+        return;
+
+    std::lock_guard<decltype(mutex)> lock{mutex};
+
+    ++generation_;
+
+    if (everything)
+        return;
+
+    // Surfaces tend to post the same area frame after frame
+    for (auto const& existing : damage)
+    {
+        if (existing.contains(clipped))
+            return;
+    }
+
+    damage.push_back(clipped);
+
+    if (damage.size() > max_rectangles)
+        damage = {bounding_rectangle(damage)};
+}
+
+void mc::ScreencastDamage::add_everything()
+{
+    std::lock_guard<decltype(mutex)> lock{mutex};
+
+    ++generation_;
+    everything = true;
+    damage.clear();
+}
+
+uint64_t mc::ScreencastDamage::generation() const
+{
+    std::lock_guard<decltype(mutex)> lock{mutex};
+    return generation_;
+}
+
+geom::Rectangles mc::ScreencastDamage::take(geom::Size const& buffer_size, MirMirrorMode mirror_mode)
+{
+    std::vector<geom::Rectangle> taken;
+    bool taken_everything;
+    {
+        std::lock_guard<decltype(mutex)> lock{mutex};
+        taken_everything = everything;
+        taken.swap(damage);
+        everything = false;
+    }
+
+    if (taken_everything)
+        return {{{0, 0}, buffer_size}};
+
+    auto const region_width = capture_region.size.width.as_int();
+    auto const region_height = capture_region.size.height.as_int();
+    auto const buffer_width = buffer_size.width.as_int();
+    auto const buffer_height = buffer_size.height.as_int();
+
+    geom::Rectangles result;
+    for (auto const& rect : taken)
+    {
+        int x, y, width, height;
+        scale((rect.left() - capture_region.left()).as_int(), rect.size.width.as_int(),
+              region_width, buffer_width, x, width);
+        scale((rect.top() - capture_region.top()).as_int(), rect.size.height.as_int(),
+              region_height, buffer_height, y, height);
+
+        if (mirror_mode == mir_mirror_mode_horizontal)
+            x = buffer_width - x - width;
+        if (mirror_mode == mir_mirror_mode_vertical)
+            y = buffer_height - y - height;
+
+        result.add({{x, y}, {width, height}});
+    }
+
+    return result;
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_COMPOSITOR_SCREENCAST_DAMAGE_H_
+#define MIR_COMPOSITOR_SCREENCAST_DAMAGE_H_
+
+#include "mir/geometry/rectangle.h"
+#include "mir/geometry/rectangles.h"
+#include "mir_toolkit/common.h"
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace mir
+{
+namespace compositor
+{
+/**
+ * Collects the scene damage that falls in a screencast's capture region
+ * between captures.
+ *
+ * Damage may be added from any thread.
+ */
+class ScreencastDamage
+{
+public:
+    /// Too many rectangles cost encoders more than they save, so beyond
+    /// this the damage is merged into its bounding rectangle
+    static size_t const max_rectangles = 16;
+
+    explicit ScreencastDamage(geometry::Rectangle const& capture_region);
+
+    /// Adds damage in scene coordinates
+    void add(geometry::Rectangle const& damage);
+    /// Marks the whole capture region as damaged
+    void add_everything();
+
+    /// Counts changes to the capture region; a capture that saw the same
+    /// value has the current content
+    uint64_t generation() const;
+
+    /**
+     * Returns the damage since the last call, in the coordinates of a buffer
+     * of \a buffer_size showing the capture region mirrored by \a mirror_mode
+     * (with the first row at the top), and resets it.
+     */
+    geometry::Rectangles take(geometry::Size const& buffer_size, MirMirrorMode mirror_mode);
+
+private:
+    geometry::Rectangle const capture_region;
+
+    std::mutex mutable mutex;
+    bool everything;
+    std::vector<geometry::Rectangle> damage;
+    uint64_t generation_;
+};
+}
+}
+
+#endif /* MIR_COMPOSITOR_SCREENCAST_DAMAGE_H_ */
@@ -89,6 +89,12 @@ std::shared_ptr<mg::Buffer> mc::Stream::lock_compositor_buffer(void const* id)
     return arbiter->compositor_acquire(id);
 }
 
+std::shared_ptr<mg::Buffer> mc::Stream::lock_snapshot_buffer()
+{
+    std::lock_guard<decltype(mutex)> lk(mutex);
+    return arbiter->snapshot_acquire();
+}
+
 geom::Size mc::Stream::stream_size()
 {
     std::lock_guard<decltype(mutex)> lk(mutex);
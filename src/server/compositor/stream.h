@@ -49,6 +49,7 @@ public:
         std::function<void(geometry::Size const&)> const& callback) override;
     std::shared_ptr<graphics::Buffer>
         lock_compositor_buffer(void const* user_id) override;
+    std::shared_ptr<graphics::Buffer> lock_snapshot_buffer() override;
     geometry::Size stream_size() override;
     void resize(geometry::Size const& size) override;
     void allow_framedropping(bool) override;
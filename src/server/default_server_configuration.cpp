@@ -26,6 +26,7 @@
 #include "mir/default_configuration.h"
 #include "mir/cookie/authority.h"
 
+#include "mir/logging/async_logger.h"
 #include "mir/logging/dumb_console_logger.h"
 #include "mir/options/program_option.h"
 #include "mir/frontend/session_credentials.h"
@@ -37,6 +38,7 @@
 #include "mir/input/vt_filter.h"
 #include "mir/input/input_manager.h"
 #include "mir/time/steady_clock.h"
+#include "mir/time/timer_wheel_alarm_factory.h"
 #include "mir/geometry/rectangles.h"
 #include "mir/default_configuration.h"
 #include "mir/scene/null_prompt_session_listener.h"
@@ -172,6 +174,15 @@ std::shared_ptr<mir::MainLoop> mir::DefaultServerConfiguration::the_main_loop()
         });
 }
 
+std::shared_ptr<mir::time::AlarmFactory> mir::DefaultServerConfiguration::the_alarm_factory()
+{
+    return alarm_factory(
+        [this]()
+        {
+            return std::make_shared<mir::time::TimerWheelAlarmFactory>(the_main_loop(), the_clock());
+        });
+}
+
 std::shared_ptr<mir::ServerActionQueue> mir::DefaultServerConfiguration::the_server_action_queue()
 {
     return the_main_loop();
@@ -225,8 +236,14 @@ auto mir::DefaultServerConfiguration::the_logger()
     -> std::shared_ptr<ml::Logger>
 {
     return logger(
-        []() -> std::shared_ptr<ml::Logger>
+        [this]() -> std::shared_ptr<ml::Logger>
         {
+            if (the_options()->get<bool>(options::async_logging_opt))
+            {
+                // 64KiB per logging thread holds a few hundred typical messages
+                return std::make_shared<ml::AsyncLogger>(64*1024, 64);
+            }
+
             return std::make_shared<ml::DumbConsoleLogger>();
         });
 }
@@ -31,6 +31,7 @@
 #include "mir/input/input_manager.h"
 #include "mir/input/input_dispatcher.h"
 #include "mir/log.h"
+#include "mir/startup_trace.h"
 #include "mir/unwind_helpers.h"
 
 #include <stdexcept>
@@ -201,12 +202,18 @@ void mir::DisplayServer::run()
 
     auto const& server = *p.load();
 
-    server.compositor->start();
-    server.input_manager->start();
-    server.input_dispatcher->start();
-    server.prompt_connector->start();
-    server.connector->start();
-    server.wayland_connector->start();
+    auto const start = [](char const* name, auto& subsystem)
+        {
+            StartupTrace::Scope const step{name};
+            subsystem.start();
+        };
+
+    start("compositor start", *server.compositor);
+    start("input manager start", *server.input_manager);
+    start("input dispatcher start", *server.input_dispatcher);
+    start("prompt connector start", *server.prompt_connector);
+    start("connector start", *server.connector);
+    start("wayland connector start", *server.wayland_connector);
 
     server.server_status_listener->started();
 
@@ -18,6 +18,7 @@
 
 #include "event_sender.h"
 #include "mir/events/event.h"
+#include "mir/events/event_ring.h"
 #include "mir/frontend/client_constants.h"
 #include "mir/graphics/display_configuration.h"
 #include "mir/variable_length_array.h"
@@ -27,6 +28,7 @@
 #include "mir/input/mir_pointer_config.h"
 #include "mir/input/mir_touchpad_config.h"
 #include "mir/input/mir_keyboard_config.h"
+#include "mir/input/input_report.h"
 #include "message_sender.h"
 #include "protobuf_buffer_packer.h"
 
@@ -44,21 +46,71 @@ namespace mi = mir::input;
 
 mfd::EventSender::EventSender(
     std::shared_ptr<MessageSender> const& socket_sender,
-    std::shared_ptr<mg::PlatformIpcOperations> const& buffer_packer) :
+    std::shared_ptr<mg::PlatformIpcOperations> const& buffer_packer,
+    std::shared_ptr<mi::InputReport> const& input_report) :
+    EventSender(socket_sender, buffer_packer, input_report, nullptr)
+{
+}
+
+mfd::EventSender::EventSender(
+    std::shared_ptr<MessageSender> const& socket_sender,
+    std::shared_ptr<mg::PlatformIpcOperations> const& buffer_packer,
+    std::shared_ptr<mi::InputReport> const& input_report,
+    std::shared_ptr<mev::EventRing> const& event_ring) :
     sender(socket_sender),
-    buffer_packer(buffer_packer)
+    buffer_packer(buffer_packer),
+    input_report(input_report),
+    event_ring(event_ring)
 {
 }
 
 void mfd::EventSender::handle_event(MirEvent const& e)
 {
-    // In future we might send multiple events, or insert them into messages
-    // containing other responses, but for now we send them individually.
-    mp::EventSequence seq;
-    mp::Event *ev = seq.add_event();
-    ev->set_raw(MirEvent::serialize(&e));
+    auto const is_input = mir_event_get_type(&e) == mir_event_type_input;
+    auto const event_time = is_input ? mir_input_event_get_event_time(mir_event_get_input_event(&e)) : 0;
 
-    send_event_sequence(seq, {});
+    if (is_input)
+        input_report->event_reached_stage(mi::InputPipelineStage::surface_dispatched, event_time);
+
+    auto const raw = MirEvent::serialize(&e);
+
+    if (event_ring)
+    {
+        send_sequenced(raw);
+    }
+    else
+    {
+        // In future we might send multiple events, or insert them into messages
+        // containing other responses, but for now we send them individually.
+        mp::EventSequence seq;
+        mp::Event *ev = seq.add_event();
+        ev->set_raw(raw);
+
+        send_event_sequence(seq, {});
+    }
+
+    if (is_input)
+        input_report->event_reached_stage(mi::InputPipelineStage::sent_to_client, event_time);
+}
+
+void mfd::EventSender::send_sequenced(std::string const& event)
+{
+    // Numbering and sending under one lock means the numbers are in the order sent
+    std::lock_guard<decltype(ring_mutex)> lock{ring_mutex};
+
+    auto const sequence = next_sequence++;
+
+    // The client puts events back in sequence, so one too large for the ring,
+    // or arriving while it is full, can take the socket without overtaking
+    if (!event_ring->push(event, sequence))
+    {
+        mp::EventSequence seq;
+        mp::Event *ev = seq.add_event();
+        ev->set_raw(event);
+        ev->set_sequence(sequence);
+
+        send_event_sequence(seq, {});
+    }
 }
 
 void mfd::EventSender::handle_display_config_change(
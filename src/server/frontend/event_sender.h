@@ -22,10 +22,14 @@
 #include "mir/frontend/event_sink.h"
 #include "mir/frontend/fd_sets.h"
 #include <memory>
+#include <mutex>
+#include <string>
 
 namespace mir
 {
+namespace events { class EventRing; }
 namespace graphics { class PlatformIpcOperations; }
+namespace input { class InputReport; }
 namespace protobuf
 {
 class EventSequence;
@@ -42,7 +46,14 @@ class EventSender : public  mir::frontend::EventSink
 public:
     explicit EventSender(
         std::shared_ptr<MessageSender> const& socket_sender,
-        std::shared_ptr<graphics::PlatformIpcOperations> const& buffer_packer);
+        std::shared_ptr<graphics::PlatformIpcOperations> const& buffer_packer,
+        std::shared_ptr<input::InputReport> const& input_report);
+    /// Events are delivered through \a event_ring, unless they don't fit in it
+    EventSender(
+        std::shared_ptr<MessageSender> const& socket_sender,
+        std::shared_ptr<graphics::PlatformIpcOperations> const& buffer_packer,
+        std::shared_ptr<input::InputReport> const& input_report,
+        std::shared_ptr<events::EventRing> const& event_ring);
     void handle_event(MirEvent const& e) override;
     void handle_lifecycle_event(MirLifecycleState state) override;
     void handle_display_config_change(graphics::DisplayConfiguration const& config) override;
@@ -57,9 +68,15 @@ public:
 private:
     void send_event_sequence(protobuf::EventSequence&, FdSets const&);
     void send_buffer(protobuf::EventSequence&, graphics::Buffer&, graphics::BufferIpcMsgType);
+    void send_sequenced(std::string const& event);
 
     std::shared_ptr<MessageSender> const sender;
     std::shared_ptr<graphics::PlatformIpcOperations> const buffer_packer;
+    std::shared_ptr<input::InputReport> const input_report;
+
+    std::shared_ptr<events::EventRing> const event_ring;
+    std::mutex ring_mutex;
+    uint64_t next_sequence{0};
 };
 
 }
@@ -23,6 +23,7 @@
 
 namespace mir
 {
+namespace events { class EventRing; }
 namespace frontend
 {
 class EventSink;
@@ -39,6 +40,20 @@ public:
 
     virtual std::unique_ptr<EventSink>
         create_sink(std::shared_ptr<MessageSender> const& sender) = 0;
+
+    /**
+     * Creates a sink that delivers input events through \a ring where it can.
+     *
+     * \returns nullptr if this factory's sinks cannot use a ring, in which
+     *          case all events stay on \a sender
+     */
+    virtual std::unique_ptr<EventSink>
+        create_sink_with_ring(
+            std::shared_ptr<MessageSender> const& /*sender*/,
+            std::shared_ptr<events::EventRing> const& /*ring*/)
+    {
+        return nullptr;
+    }
 };
 
 }
@@ -37,11 +37,13 @@ mf::ProtobufConnectionCreator::ProtobufConnectionCreator(
     std::shared_ptr<ProtobufIpcFactory> const& ipc_factory,
     std::shared_ptr<SessionAuthorizer> const& session_authorizer,
     std::shared_ptr<mir::graphics::PlatformIpcOperations> const& operations,
-    std::shared_ptr<MessageProcessorReport> const& report)
+    std::shared_ptr<MessageProcessorReport> const& report,
+    std::shared_ptr<mir::input::InputReport> const& input_report)
 :   ipc_factory(ipc_factory),
     session_authorizer(session_authorizer),
     operations(operations),
     report(report),
+    input_report(input_report),
     next_session_id(0),
     connections(std::make_shared<mfd::Connections<mfd::SocketConnection>>())
 {
@@ -62,18 +64,30 @@ namespace
 class ProtobufEventFactory : public mf::EventSinkFactory
 {
 public:
-    ProtobufEventFactory(std::shared_ptr<mir::graphics::PlatformIpcOperations> const& operations)
-        : ops{operations}
+    ProtobufEventFactory(
+        std::shared_ptr<mir::graphics::PlatformIpcOperations> const& operations,
+        std::shared_ptr<mir::input::InputReport> const& input_report)
+        : ops{operations},
+          input_report{input_report}
     {
     }
 
     std::unique_ptr<mf::EventSink>
     create_sink(std::shared_ptr<mf::MessageSender> const& messenger)
     {
-        return std::make_unique<mf::detail::EventSender>(messenger, ops);
+        return std::make_unique<mf::detail::EventSender>(messenger, ops, input_report);
     };
+
+    std::unique_ptr<mf::EventSink>
+    create_sink_with_ring(
+        std::shared_ptr<mf::MessageSender> const& messenger,
+        std::shared_ptr<mir::events::EventRing> const& ring) override
+    {
+        return std::make_unique<mf::detail::EventSender>(messenger, ops, input_report, ring);
+    }
 private:
     std::shared_ptr<mir::graphics::PlatformIpcOperations> const ops;
+    std::shared_ptr<mir::input::InputReport> const input_report;
 };
 }
 
@@ -95,7 +109,7 @@ void mf::ProtobufConnectionCreator::create_connection_for(
             message_sender,
             ipc_factory->make_ipc_server(
                 creds,
-                std::make_shared<ProtobufEventFactory>(operations),
+                std::make_shared<ProtobufEventFactory>(operations, input_report),
                 messenger,
                 connection_context),
             report);
@@ -104,13 +104,17 @@ void invoke(
         ResponseType* response,
         ::google::protobuf::Closure* done),
     unsigned int invocation_id,
-    RequestType* request)
+    RequestType* request,
+    bool no_reply = false)
 {
     auto const result_message = std::make_shared<ResponseType>();
 
     std::weak_ptr<ProtobufMessageProcessor> weak_mp = mp;
-    auto const response_callback = [weak_mp, invocation_id, result_message]
+    auto const response_callback = [weak_mp, invocation_id, result_message, no_reply]
     {
+        if (no_reply && !result_message->has_error() && !result_message->has_structured_error())
+            return;
+
         auto message_processor = weak_mp.lock();
         if (message_processor)
         {
@@ -182,6 +186,11 @@ google::protobuf::uint32 mfd::Invocation::id() const
     return invocation.id();
 }
 
+bool mfd::Invocation::no_reply() const
+{
+    return invocation.no_reply();
+}
+
 void mfd::ProtobufMessageProcessor::client_pid(int pid)
 {
     display_server->client_pid(pid);
@@ -213,7 +222,8 @@ bool mfd::ProtobufMessageProcessor::dispatch(
             request.mutable_buffer()->clear_fd();
             for (auto& fd : side_channel_fds)
                 request.mutable_buffer()->add_fd(fd);
-            invoke(shared_from_this(), display_server.get(), &DisplayServer::submit_buffer, invocation.id(), &request);
+            invoke(shared_from_this(), display_server.get(), &DisplayServer::submit_buffer,
+                   invocation.id(), &request, invocation.no_reply());
         }
         else if ("allocate_buffers" == invocation.method_name())
         {
@@ -391,19 +401,30 @@ void mfd::ProtobufMessageProcessor::send_response(::google::protobuf::uint32 id,
 
 void mfd::ProtobufMessageProcessor::send_response(::google::protobuf::uint32 id, mir::protobuf::Connection* response)
 {
+    // The client reads the platform fds before those of the event ring
+    FdSets fd_sets;
     if (response->has_platform())
-        sender->send_response(id, response, {extract_fds_from(response->mutable_platform())});
-    else
-        sender->send_response(id, response, {});
+        fd_sets.push_back(extract_fds_from(response->mutable_platform()));
+    if (response->has_event_ring())
+        fd_sets.push_back(extract_fds_from(response->mutable_event_ring()));
+
+    sender->send_response(id, response, fd_sets);
 }
 
 void mfd::ProtobufMessageProcessor::send_response(::google::protobuf::uint32 id, mir::protobuf::Surface* response)
 {
-    if (response->has_buffer_stream() && response->buffer_stream().has_buffer()) 
-        sender->send_response(id, response,
-            {extract_fds_from(response), extract_fds_from(response->mutable_buffer_stream()->mutable_buffer())});
-    else
-        sender->send_response(id, response, {extract_fds_from(response)});
+    // The client reads the surface fds, then the stream's buffer, then each preallocated buffer
+    FdSets fd_sets{extract_fds_from(response)};
+    if (response->has_buffer_stream())
+    {
+        auto const buffer_stream = response->mutable_buffer_stream();
+        if (buffer_stream->has_buffer())
+            fd_sets.push_back(extract_fds_from(buffer_stream->mutable_buffer()));
+        for (auto& buffer : *buffer_stream->mutable_preallocated_buffer())
+            fd_sets.push_back(extract_fds_from(&buffer));
+    }
+
+    sender->send_response(id, response, fd_sets);
 }
 
 void mfd::ProtobufMessageProcessor::send_response(::google::protobuf::uint32 id, mir::protobuf::BufferStream* response)
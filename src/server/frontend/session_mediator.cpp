@@ -57,9 +57,11 @@
 #include "mir/input/device.h"
 #include "mir/scene/prompt_session_creation_parameters.h"
 #include "mir/fd.h"
+#include "mir/events/event_ring.h"
 #include "mir/cookie/authority.h"
 #include "mir/module_properties.h"
 #include "mir/graphics/graphic_buffer_allocator.h"
+#include "mir/graphics/buffer_properties.h"
 #include "mir/executor.h"
 
 #include "mir/geometry/rectangles.h"
@@ -77,6 +79,7 @@
 #include <thread>
 #include <functional>
 #include <cstring>
+#include <algorithm>
 
 namespace ms = mir::scene;
 namespace msh = mir::shell;
@@ -160,6 +163,26 @@ void mf::SessionMediator::connect(
 {
     observer->session_connect_called(request->application_name());
 
+    if (request->event_ring())
+    {
+        try
+        {
+            auto const ring = std::make_shared<mir::events::EventRing>();
+            if (auto sink = sink_factory->create_sink_with_ring(message_sender, ring))
+            {
+                event_sink = std::move(sink);
+
+                auto const ring_fds = response->mutable_event_ring();
+                ring_fds->add_fd(ring->shm_fd());
+                ring_fds->add_fd(ring->wakeup_fd());
+            }
+        }
+        catch (std::exception const&)
+        {
+            // The client gets all its events over the socket instead
+        }
+    }
+
     auto const session = shell->open_session(client_pid_, request->application_name(), event_sink);
     weak_session = session;
     connection_context.handle_client_connect(session);
@@ -184,6 +207,9 @@ void mf::SessionMediator::connect(
         module->set_file(graphics_module->file);
     }
 
+    if (!ipc_package->client_module.empty())
+        platform->set_client_module(ipc_package->client_module);
+
     auto display_config = display_changer->base_configuration();
     auto protobuf_config = response->mutable_display_configuration();
     mfd::pack_protobuf_display_configuration(*protobuf_config, *display_config);
@@ -227,6 +253,9 @@ extract_input_shape_from(T const& params)
     }
     return shapes;
 }
+
+// Enough for the client to start drawing without waiting on allocate_buffers()
+int const max_preallocated_buffers{3};
 }
 
 void mf::SessionMediator::create_surface(
@@ -374,6 +403,18 @@ void mf::SessionMediator::create_surface(
         response->mutable_buffer_stream()->set_pixel_format(legacy_stream->pixel_format());
         response->mutable_buffer_stream()->set_buffer_usage(request->buffer_usage());
         legacy_default_stream_map[surf_id] = buffer_stream_id;
+
+        if (request->has_preallocate_buffers())
+        {
+            preallocate_buffers(
+                buffer_stream_id,
+                mg::BufferProperties{
+                    client_size,
+                    legacy_stream->pixel_format(),
+                    static_cast<mg::BufferUsage>(request->buffer_usage())},
+                std::min(request->preallocate_buffers(), max_preallocated_buffers),
+                *response);
+        }
     }
     done->Run();
     // ...then uncork the message sender, sending all buffered surface events.
@@ -552,6 +593,43 @@ void mf::SessionMediator::allocate_buffers(
     done->Run();
 }
  
+void mf::SessionMediator::preallocate_buffers(
+    BufferStreamId stream_id,
+    graphics::BufferProperties const& properties,
+    int count,
+    mir::protobuf::Surface& response)
+{
+    for (auto i = 0; i < count; i++)
+    {
+        std::shared_ptr<mg::Buffer> buffer;
+        try
+        {
+            if (properties.usage == mg::BufferUsage::software)
+                buffer = allocator->alloc_software_buffer(properties.size, properties.format);
+            else
+                buffer = allocator->alloc_buffer(properties);
+        }
+        catch (std::exception const&)
+        {
+            // The client allocates whatever we didn't send in the usual way
+            return;
+        }
+
+        stream_associated_buffers.insert(std::make_pair(stream_id, buffer->id()));
+        buffer_cache.insert(std::make_pair(buffer->id(), buffer));
+
+        auto const protobuf_buffer = response.mutable_buffer_stream()->add_preallocated_buffer();
+        protobuf_buffer->set_buffer_id(buffer->id().as_value());
+
+        mfd::ProtobufBufferPacker packer{protobuf_buffer};
+        ipc_operations->pack_buffer(packer, *buffer, mg::BufferIpcMsgType::full_msg);
+
+        // Keyed on the response so that they are released once it has been sent
+        for (auto const& fd : packer.fds())
+            resource_cache->save_fd(&response, fd);
+    }
+}
+
 void mf::SessionMediator::release_buffers(
     mir::protobuf::BufferRelease const* request,
     mir::protobuf::Void*,
@@ -979,13 +1057,24 @@ void mf::SessionMediator::screencast_buffer(
 
 void mf::SessionMediator::screencast_to_buffer(
     mir::protobuf::ScreencastRequest const* request,
-    mir::protobuf::Void*,
+    mir::protobuf::ScreencastCapture* response,
     google::protobuf::Closure* done)
 {
     auto session = weak_session.lock();
     ScreencastSessionId const screencast_session_id{request->id().value()};
     auto buffer = buffer_cache.at(mg::BufferID{request->buffer_id()});
-    screencast->capture(screencast_session_id, buffer);
+    auto const damage = screencast->capture(screencast_session_id, buffer);
+
+    for (auto const& rect : damage)
+    {
+        auto const protobuf_rect = response->add_damage();
+        protobuf_rect->set_left(rect.top_left.x.as_int());
+        protobuf_rect->set_top(rect.top_left.y.as_int());
+        protobuf_rect->set_width(rect.size.width.as_uint32_t());
+        protobuf_rect->set_height(rect.size.height.as_uint32_t());
+    }
+    response->set_damage_reported(true);
+
     done->Run();
 }
 
@@ -49,6 +49,7 @@ class Authority;
 namespace graphics
 {
 class Buffer;
+struct BufferProperties;
 class DisplayConfiguration;
 class GraphicBufferAllocator;
 }
@@ -198,7 +199,7 @@ public:
         google::protobuf::Closure* done) override;
     void screencast_to_buffer(
         mir::protobuf::ScreencastRequest const* request,
-        mir::protobuf::Void* response,
+        mir::protobuf::ScreencastCapture* response,
         google::protobuf::Closure* done) override;
     void release_screencast(
         mir::protobuf::ScreencastId const* request,
@@ -276,6 +277,13 @@ private:
                               graphics::Buffer* graphics_buffer,
                               graphics::BufferIpcMsgType msg_type);
 
+    /// Allocates up to count buffers for a new surface's stream, sending them with the response
+    void preallocate_buffers(
+        BufferStreamId stream_id,
+        graphics::BufferProperties const& properties,
+        int count,
+        mir::protobuf::Surface& response);
+
     std::shared_ptr<graphics::DisplayConfiguration> unpack_and_sanitize_display_configuration(
         protobuf::DisplayConfiguration const*);
 
@@ -293,7 +301,8 @@ private:
     std::shared_ptr<frontend::DisplayChanger> const display_changer;
     std::shared_ptr<SessionMediatorObserver> const observer;
     std::shared_ptr<EventSinkFactory> const sink_factory;
-    std::shared_ptr<EventSink> const event_sink;
+    /// Replaced at connect() if the client accepts input through an event ring
+    std::shared_ptr<EventSink> event_sink;
     std::shared_ptr<MessageSender> const message_sender;
     std::shared_ptr<MessageResourceCache> const resource_cache;
     std::shared_ptr<Screencast> const screencast;
@@ -39,14 +39,14 @@ mf::WlKeyboard::WlKeyboard(
     mir::input::Keymap const& initial_keymap,
     std::function<void(WlKeyboard*)> const& on_destroy,
     std::function<std::vector<uint32_t>()> const& acquire_current_keyboard_state,
+    std::function<mir::input::XkbModifiers()> const& acquire_current_modifiers,
     std::shared_ptr<mir::Executor> const& executor)
     : Keyboard(client, parent, id),
-        keymap{nullptr, &xkb_keymap_unref},
-        state{nullptr, &xkb_state_unref},
         context{xkb_context_new(XKB_CONTEXT_NO_FLAGS), &xkb_context_unref},
         executor{executor},
         on_destroy{on_destroy},
         acquire_current_keyboard_state{acquire_current_keyboard_state},
+        acquire_current_modifiers{acquire_current_modifiers},
         destroyed{std::make_shared<bool>(false)}
 {
     // TODO: We should really grab the keymap for the focused surface when
@@ -84,16 +84,10 @@ void mf::WlKeyboard::handle_event(MirInputEvent const* event, wl_resource* /*tar
             auto const serial = wl_display_next_serial(wl_client_get_display(client));
             auto const event = mir_event_get_input_event(ev);
             auto const key_event = mir_input_event_get_keyboard_event(event);
-            auto const scancode = mir_keyboard_event_scan_code(key_event);
-            /*
-                * HACK! Maintain our own XKB state, so we can serialise it for
-                * wl_keyboard_send_modifiers
-                */
 
             switch (mir_keyboard_event_action(key_event))
             {
                 case mir_keyboard_action_up:
-                    xkb_state_update_key(state.get(), scancode + 8, XKB_KEY_UP);
                     wl_keyboard_send_key(resource,
                         serial,
                         mir_input_event_get_event_time(event) / 1000,
@@ -101,7 +95,6 @@ void mf::WlKeyboard::handle_event(MirInputEvent const* event, wl_resource* /*tar
                         WL_KEYBOARD_KEY_STATE_RELEASED);
                     break;
                 case mir_keyboard_action_down:
-                    xkb_state_update_key(state.get(), scancode + 8, XKB_KEY_DOWN);
                     wl_keyboard_send_key(resource,
                         serial,
                         mir_input_event_get_event_time(event) / 1000,
@@ -111,6 +104,8 @@ void mf::WlKeyboard::handle_event(MirInputEvent const* event, wl_resource* /*tar
                 default:
                     break;
             }
+            // The seat has mapped this event before it reached us, so its
+            // modifiers are at least as recent as the key we just sent
             update_modifier_state();
         }));
 }
@@ -156,16 +151,12 @@ void mf::WlKeyboard::handle_event(MirWindowEvent const* event, wl_resource* targ
                         keyboard_state.data(),
                         keyboard_state.size() * sizeof(decltype(keyboard_state)::value_type));
 
-                    // Rebuild xkb state
-                    state = decltype(state)(xkb_state_new(keymap.get()), &xkb_state_unref);
-                    for (auto scancode : keyboard_state)
-                    {
-                        xkb_state_update_key(state.get(), scancode + 8, XKB_KEY_DOWN);
-                    }
-                    update_modifier_state();
-
                     wl_keyboard_send_enter(resource, serial, target, &key_state);
                     wl_array_release(&key_state);
+
+                    // The client needs the modifiers after each enter, changed or not
+                    modifiers = acquire_current_modifiers();
+                    send_modifiers();
                 }
                 else
                 {
@@ -190,16 +181,6 @@ void mf::WlKeyboard::handle_event(MirKeymapEvent const* event, wl_resource* /*ta
         WL_KEYBOARD_KEYMAP_FORMAT_XKB_V1,
         shm_buffer.fd(),
         length);
-
-    keymap = decltype(keymap)(xkb_keymap_new_from_buffer(
-        context.get(),
-        buffer,
-        length,
-        XKB_KEYMAP_FORMAT_TEXT_V1,
-        XKB_KEYMAP_COMPILE_NO_FLAGS),
-        &xkb_keymap_unref);
-
-    state = decltype(state)(xkb_state_new(keymap.get()), &xkb_state_unref);
 }
 
 void mf::WlKeyboard::set_keymap(mir::input::Keymap const& new_keymap)
@@ -211,16 +192,13 @@ void mf::WlKeyboard::set_keymap(mir::input::Keymap const& new_keymap)
         new_keymap.variant.c_str(),
         new_keymap.options.c_str()
     };
-    keymap = decltype(keymap){
+    std::unique_ptr<xkb_keymap, void (*)(xkb_keymap *)> const keymap{
         xkb_keymap_new_from_names(
             context.get(),
             &names,
             XKB_KEYMAP_COMPILE_NO_FLAGS),
         &xkb_keymap_unref};
 
-    // TODO: We might need to copy across the existing depressed keys?
-    state = decltype(state)(xkb_state_new(keymap.get()), &xkb_state_unref);
-
     std::unique_ptr<char, void(*)(void*)> buffer{xkb_keymap_get_as_string(keymap.get(), XKB_KEYMAP_FORMAT_TEXT_V1), free};
     auto length = strlen(buffer.get());
 
@@ -239,39 +217,26 @@ void mf::WlKeyboard::update_modifier_state()
     // TODO?
     // assert_on_wayland_event_loop()
 
-    auto new_depressed_mods = xkb_state_serialize_mods(
-        state.get(),
-        XKB_STATE_MODS_DEPRESSED);
-    auto new_latched_mods = xkb_state_serialize_mods(
-        state.get(),
-        XKB_STATE_MODS_LATCHED);
-    auto new_locked_mods = xkb_state_serialize_mods(
-        state.get(),
-        XKB_STATE_MODS_LOCKED);
-    auto new_group = xkb_state_serialize_layout(
-        state.get(),
-        XKB_STATE_LAYOUT_EFFECTIVE);
-
-    if ((new_depressed_mods != mods_depressed) ||
-        (new_latched_mods != mods_latched) ||
-        (new_locked_mods != mods_locked) ||
-        (new_group != group))
+    auto const new_modifiers = acquire_current_modifiers();
+
+    if (new_modifiers != modifiers)
     {
-        mods_depressed = new_depressed_mods;
-        mods_latched = new_latched_mods;
-        mods_locked = new_locked_mods;
-        group = new_group;
-
-        wl_keyboard_send_modifiers(
-            resource,
-            wl_display_get_serial(wl_client_get_display(client)),
-            mods_depressed,
-            mods_latched,
-            mods_locked,
-            group);
+        modifiers = new_modifiers;
+        send_modifiers();
     }
 }
 
+void mf::WlKeyboard::send_modifiers()
+{
+    wl_keyboard_send_modifiers(
+        resource,
+        wl_display_get_serial(wl_client_get_display(client)),
+        modifiers.depressed,
+        modifiers.latched,
+        modifiers.locked,
+        modifiers.group);
+}
+
 void mf::WlKeyboard::release()
 {
     wl_resource_destroy(resource);
@@ -20,12 +20,11 @@
 #define MIR_FRONTEND_WL_KEYBOARD_H
 
 #include "generated/wayland_wrapper.h"
+#include "mir/input/key_mapper.h"
 
 #include <vector>
 
 // from <xkbcommon/xkbcommon.h>
-struct xkb_keymap;
-struct xkb_state;
 struct xkb_context;
 
 // from "mir_toolkit/events/event.h"
@@ -57,6 +56,7 @@ public:
         mir::input::Keymap const& initial_keymap,
         std::function<void(WlKeyboard*)> const& on_destroy,
         std::function<std::vector<uint32_t>()> const& acquire_current_keyboard_state,
+        std::function<mir::input::XkbModifiers()> const& acquire_current_modifiers,
         std::shared_ptr<mir::Executor> const& executor);
 
     ~WlKeyboard();
@@ -68,20 +68,18 @@ public:
 
 private:
     void update_modifier_state();
+    void send_modifiers();
 
-    std::unique_ptr<xkb_keymap, void (*)(xkb_keymap *)> keymap;
-    std::unique_ptr<xkb_state, void (*)(xkb_state *)> state;
     std::unique_ptr<xkb_context, void (*)(xkb_context *)> const context;
 
     std::shared_ptr<mir::Executor> const executor;
     std::function<void(WlKeyboard*)> on_destroy;
     std::function<std::vector<uint32_t>()> const acquire_current_keyboard_state;
+    std::function<mir::input::XkbModifiers()> const acquire_current_modifiers;
     std::shared_ptr<bool> const destroyed;
 
-    uint32_t mods_depressed{0};
-    uint32_t mods_latched{0};
-    uint32_t mods_locked{0};
-    uint32_t group{0};
+    // The modifiers last sent to the client
+    mir::input::XkbModifiers modifiers{0, 0, 0, 0};
 
     void release() override;
 };
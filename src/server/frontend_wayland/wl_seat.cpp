@@ -291,6 +291,10 @@ void mf::WlSeat::get_keyboard(wl_client* client, wl_resource* resource, uint32_t
 
                 return std::vector<uint32_t>{pressed_keys.begin(), pressed_keys.end()};
             },
+            [this]()
+            {
+                return seat->xkb_modifiers();
+            },
             executor});
 }
 
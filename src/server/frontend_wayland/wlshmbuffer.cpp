@@ -21,6 +21,7 @@
 #include "wlshmbuffer.h"
 
 #include <mir/log.h>
+#include <mir/graphics/pixel_conversion.h>
 
 #include <wayland-server-protocol.h>
 
@@ -30,6 +31,7 @@
 #include <boost/throw_exception.hpp>
 
 #include <cstring>
+#include <vector>
 
 namespace
 {
@@ -214,6 +216,28 @@ void mf::WlShmBuffer::gl_bind_to_texture()
                              0, format, type, pixels);
             });
     }
+    else if (format_ == mir_pixel_format_bgr_888)
+    {
+        /* GLES has no BGR format: upload as RGBA */
+        read(
+            [this](unsigned char const *pixels)
+            {
+                auto const size = this->size();
+                auto const width = size.width.as_uint32_t();
+                auto const height = size.height.as_uint32_t();
+
+                std::vector<unsigned char> rgba(width * height * 4);
+                for (uint32_t line = 0; line != height; ++line)
+                {
+                    mg::expand_888_to_8888(
+                        pixels + line * stride_.as_uint32_t(), &rgba[line * width * 4], width, true);
+                }
+
+                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA,
+                             size.width.as_int(), size.height.as_int(),
+                             0, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+            });
+    }
 }
 
 void mf::WlShmBuffer::bind()
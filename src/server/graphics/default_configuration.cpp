@@ -33,10 +33,11 @@
 #include "mir/graphics/platform.h"
 #include "mir/graphics/cursor.h"
 #include "mir/graphics/platform_probe.h"
+#include "mir/graphics/platform_probe_cache.h"
 #include "display_configuration_observer_multiplexer.h"
 
 #include "mir/shared_library.h"
-#include "mir/shared_library_prober.h"
+#include "mir/shared_library_prober_report.h"
 #include "mir/abnormal_exit.h"
 #include "mir/emergency_cleanup.h"
 #include "mir/log.h"
@@ -103,13 +104,15 @@ std::shared_ptr<mg::Platform> mir::DefaultServerConfiguration::the_graphics_plat
                 else
                 {
                     auto const& path = the_options()->get<std::string>(options::platform_path);
-                    auto platforms = mir::libraries_for_path(path, *the_shared_library_prober_report());
-                    if (platforms.empty())
-                    {
-                        auto msg = "Failed to find any platform plugins in: " + path;
-                        throw std::runtime_error(msg.c_str());
-                    }
-                    platform_library = mir::graphics::module_for_device(platforms, dynamic_cast<mir::options::ProgramOption&>(*the_options()));
+                    mg::PlatformProbeCache cache{
+                        the_options()->is_set(options::platform_probe_cache_opt) ?
+                            the_options()->get<std::string>(options::platform_probe_cache_opt) :
+                            mg::PlatformProbeCache::default_filename()};
+                    platform_library = mir::graphics::module_for_device(
+                        path,
+                        cache,
+                        dynamic_cast<mir::options::ProgramOption&>(*the_options()),
+                        *the_shared_library_prober_report());
                 }
                 auto create_host_platform = platform_library->load_function<mg::CreateHostPlatform>(
                     "create_host_platform",
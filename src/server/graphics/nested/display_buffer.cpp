@@ -27,6 +27,7 @@
 #include "mir/graphics/egl_error.h"
 #include "buffer.h"
 
+#include <algorithm>
 #include <sstream>
 #include <boost/throw_exception.hpp>
 #include <stdexcept>
@@ -68,7 +69,6 @@ mgn::detail::DisplayBuffer::DisplayBuffer(
     host_stream{create_host_stream(*host_connection, best_output)},
     host_surface{create_host_surface(*host_connection, host_stream, best_output)},
     host_connection{host_connection},
-    host_chain{nullptr},
     egl_config{egl_display.choose_windowed_config(best_output.current_format)},
     egl_context{egl_display, eglCreateContext(egl_display, egl_config, egl_display.egl_context(), nested_egl_context_attribs)},
     area{best_output.extents()},
@@ -105,9 +105,12 @@ void mgn::detail::DisplayBuffer::swap_buffers()
         spec->add_stream(*host_stream, geom::Displacement{0,0}, area.size);
         content = BackingContent::stream;
         host_surface->apply_spec(*spec);
-        //if the host_chain is not released, a buffer of the passthrough surface might get caught
-        //up in the host server, resulting a drop in nbuffers available to the client
-        host_chain = nullptr;
+        //if the host_chains are not released, a buffer of the passthrough surfaces might get caught
+        //up in the host server, resulting a drop in nbuffers available to the clients
+        for (auto const& chain : host_chains)
+            release_submissions_to(*chain.second.chain);
+        host_chains.clear();
+        chain_layout.clear();
     }
 }
 
@@ -115,6 +118,15 @@ void mgn::detail::DisplayBuffer::bind()
 {
 }
 
+bool mgn::detail::DisplayBuffer::can_pass_through(Renderable const& renderable) const
+{
+    return (renderable.alpha() == 1.0f) &&
+           (!renderable.shaped()) &&
+           (renderable.transformation() == identity) &&
+           area.contains(renderable.screen_position()) &&
+           dynamic_cast<mgn::NativeBuffer*>(renderable.buffer()->native_buffer_handle().get());
+}
+
 bool mgn::detail::DisplayBuffer::overlay(RenderableList const& list)
 {
     if ((passthrough_option == mgn::PassthroughOption::disabled) ||
@@ -124,53 +136,112 @@ bool mgn::detail::DisplayBuffer::overlay(RenderableList const& list)
         return false;
     }
 
-    auto const topmost = list.back();
-
-    if ((topmost->screen_position() != area) ||
-        (topmost->alpha() != 1.0f) ||
-        (topmost->shaped()) ||
-        (topmost->transformation() != identity))
+    // Nothing below the topmost renderable that fills the output can be seen, and
+    // everything from there up must be something the host can show by itself
+    auto const fills_output = [this](std::shared_ptr<Renderable> const& renderable)
+        { return renderable->screen_position() == area; };
+    auto const bottom = std::find_if(list.rbegin(), list.rend(), fills_output);
+    if (bottom == list.rend())
     {
         //could not represent scene with subsurfaces
         return false;
     }
 
-    auto passthrough_buffer = topmost->buffer();
-    auto native = dynamic_cast<mgn::NativeBuffer*>(passthrough_buffer->native_buffer_handle().get());
-    if (!native)
-        return false;
+    RenderableList const layers(std::prev(bottom.base()), list.end());
+    for (auto const& layer : layers)
+    {
+        if (!can_pass_through(*layer))
+        {
+            //could not represent scene with subsurfaces
+            return false;
+        }
+    }
 
-    if (!host_chain)
-        host_chain = host_connection->create_chain();
+    // A renderable keeps its chain when the scene is restacked: otherwise a buffer
+    // the host still holds could be submitted again on another chain
+    for (auto chain = host_chains.begin(); chain != host_chains.end();)
+    {
+        auto const id = chain->first;
+        auto const shown = std::any_of(layers.begin(), layers.end(),
+            [id](std::shared_ptr<Renderable> const& layer) { return layer->id() == id; });
 
+        if (shown)
+        {
+            ++chain;
+        }
+        else
+        {
+            release_submissions_to(*chain->second.chain);
+            chain = host_chains.erase(chain);
+        }
+    }
+
+    std::vector<PassthroughChain*> chains;
+    for (auto const& layer : layers)
+    {
+        auto& chain = host_chains[layer->id()];
+        if (!chain.chain)
+            chain.chain = host_connection->create_chain();
+        chains.push_back(&chain);
+    }
+
+    std::vector<mgn::NativeBuffer*> natives;
+    for (auto const& layer : layers)
+        natives.push_back(dynamic_cast<mgn::NativeBuffer*>(layer->buffer()->native_buffer_handle().get()));
+
+    std::vector<bool> needs_submission(layers.size(), true);
     {
         std::unique_lock<std::mutex> lk(mutex);
-        SubmissionInfo submission_info{native->client_handle(), host_chain->handle()};
-        auto submitted = submitted_buffers.find(submission_info);
-        if ((submission_info != last_submitted) && (submitted != submitted_buffers.end()))
-            BOOST_THROW_EXCEPTION(std::logic_error("cannot resubmit buffer that has not been returned by host server"));
-        if ((submission_info == last_submitted) && (submitted != submitted_buffers.end()))
-            return true;
-
-        if (topmost->swap_interval() == 0)
-            host_chain->set_submission_mode(mgn::SubmissionMode::dropping);
-        else
-            host_chain->set_submission_mode(mgn::SubmissionMode::queueing);
 
-        submitted_buffers[submission_info] = passthrough_buffer;
-        last_submitted = submission_info;
+        for (auto i = 0u; i != layers.size(); ++i)
+        {
+            SubmissionInfo submission_info{natives[i]->client_handle(), chains[i]->chain->handle()};
+            auto submitted = submitted_buffers.find(submission_info);
+            if ((submission_info != chains[i]->last_submitted) && (submitted != submitted_buffers.end()))
+                BOOST_THROW_EXCEPTION(std::logic_error("cannot resubmit buffer that has not been returned by host server"));
+            if ((submission_info == chains[i]->last_submitted) && (submitted != submitted_buffers.end()))
+                needs_submission[i] = false;
+        }
+
+        for (auto i = 0u; i != layers.size(); ++i)
+        {
+            if (!needs_submission[i])
+                continue;
+
+            SubmissionInfo const submission_info{natives[i]->client_handle(), chains[i]->chain->handle()};
+            submitted_buffers[submission_info] = layers[i]->buffer();
+            chains[i]->last_submitted = submission_info;
+        }
     }
 
-    native->on_ownership_notification(
-        std::bind(&mgn::detail::DisplayBuffer::release_buffer, this,
-        native->client_handle(), host_chain->handle()));
-    host_chain->submit_buffer(*native);
+    std::vector<std::pair<Renderable::ID, geom::Rectangle>> layout;
+    for (auto i = 0u; i != layers.size(); ++i)
+    {
+        auto const position = layers[i]->screen_position();
+        layout.push_back({layers[i]->id(), {geom::Point{} + (position.top_left - area.top_left), position.size}});
+
+        if (!needs_submission[i])
+            continue;
+
+        auto& host_chain = *chains[i]->chain;
+        if (layers[i]->swap_interval() == 0)
+            host_chain.set_submission_mode(mgn::SubmissionMode::dropping);
+        else
+            host_chain.set_submission_mode(mgn::SubmissionMode::queueing);
 
-    if (content != BackingContent::chain)
+        natives[i]->on_ownership_notification(
+            std::bind(&mgn::detail::DisplayBuffer::release_buffer, this,
+            natives[i]->client_handle(), host_chain.handle()));
+        host_chain.submit_buffer(*natives[i]);
+    }
+
+    if ((content != BackingContent::chain) || (layout != chain_layout))
     {
         auto spec = host_connection->create_surface_spec();
-        spec->add_chain(*host_chain, geom::Displacement{0,0}, area.size);
+        for (auto i = 0u; i != layout.size(); ++i)
+            spec->add_chain(*chains[i]->chain, layout[i].second.top_left - geom::Point{}, layout[i].second.size);
         content = BackingContent::chain;
+        chain_layout = std::move(layout);
         host_surface->apply_spec(*spec);
     }
     return true;
@@ -184,6 +255,34 @@ void mgn::detail::DisplayBuffer::release_buffer(MirBuffer* b, MirPresentationCha
         submitted_buffers.erase(buf);
 }
 
+void mgn::detail::DisplayBuffer::release_submissions_to(HostChain& chain)
+{
+    // Forget what was submitted to a chain we're dropping, and stop those
+    // buffers telling us when the host is done with them
+    std::vector<std::shared_ptr<graphics::Buffer>> released;
+    {
+        std::unique_lock<std::mutex> lk(mutex);
+        for (auto buf = submitted_buffers.begin(); buf != submitted_buffers.end();)
+        {
+            if (std::get<1>(buf->first) == chain.handle())
+            {
+                released.push_back(buf->second);
+                buf = submitted_buffers.erase(buf);
+            }
+            else
+            {
+                ++buf;
+            }
+        }
+    }
+
+    for (auto const& b : released)
+    {
+        auto n = dynamic_cast<mgn::NativeBuffer*>(b->native_buffer_handle().get());
+        n->on_ownership_notification([]{});
+    }
+}
+
 glm::mat2 mgn::detail::DisplayBuffer::transformation() const
 {
     return glm::mat2(1);
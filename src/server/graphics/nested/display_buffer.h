@@ -27,6 +27,7 @@
 #include "host_chain.h"
 
 #include <map>
+#include <vector>
 #include <glm/glm.hpp>
 #include <EGL/egl.h>
 
@@ -73,7 +74,16 @@ private:
     std::shared_ptr<HostStream> const host_stream;
     std::shared_ptr<HostSurface> const host_surface;
     std::shared_ptr<HostConnection> const host_connection;
-    std::unique_ptr<HostChain> host_chain;
+    typedef std::tuple<MirBuffer*, MirPresentationChain*> SubmissionInfo;
+    struct PassthroughChain
+    {
+        std::unique_ptr<HostChain> chain;
+        SubmissionInfo last_submitted;
+    };
+    /// One per passed through renderable, so a buffer stays on the chain it was submitted to
+    std::map<Renderable::ID, PassthroughChain> host_chains;
+    /// Where the host surface shows each renderable's chain, relative to the output, bottom first
+    std::vector<std::pair<Renderable::ID, geometry::Rectangle>> chain_layout;
     EGLConfig const egl_config;
     EGLContextStore const egl_context;
     geometry::Rectangle const area;
@@ -91,11 +101,12 @@ private:
     glm::mat4 const identity;
 
     std::mutex mutex;
-    typedef std::tuple<MirBuffer*, MirPresentationChain*> SubmissionInfo;
     std::map<SubmissionInfo, std::shared_ptr<graphics::Buffer>> submitted_buffers;
-    SubmissionInfo last_submitted { nullptr, nullptr };
+
+    bool can_pass_through(Renderable const& renderable) const;
 
     void release_buffer(MirBuffer* b, MirPresentationChain* c);
+    void release_submissions_to(HostChain& chain);
 };
 }
 }
@@ -20,6 +20,7 @@
 #include "mir/graphics/cursor_image.h"
 #include "mir/graphics/graphic_buffer_allocator.h"
 #include "mir/graphics/pixel_format_utils.h"
+#include "mir/graphics/pixel_conversion.h"
 #include "mir/graphics/renderable.h"
 #include "mir/graphics/buffer_properties.h"
 #include "mir/input/scene.h"
@@ -189,12 +190,23 @@ mg::SoftwareCursor::create_renderable_for(CursorImage const& cursor_image, geom:
         allocator->alloc_buffer({cursor_image.size(), format, mg::BufferUsage::software}),
         position + hotspot - cursor_image.hotspot());
 
-    // TODO: The buffer pixel format may not be argb_8888, leading to
-    // incorrect cursor colors. We need to transform the data to match
-    // the buffer pixel format.
     auto pixel_source = dynamic_cast<mrs::PixelSource*>(new_renderable->buffer()->native_buffer_base());
     if (pixel_source)
-        pixel_source->write(static_cast<unsigned char const*>(cursor_image.as_argb_8888()), pixels_size);
+    {
+        auto const argb_pixels = static_cast<unsigned char const*>(cursor_image.as_argb_8888());
+
+        // The buffer may have been allocated with red and blue swapped
+        if (format == mir_pixel_format_abgr_8888)
+        {
+            std::vector<unsigned char> pixels(pixels_size);
+            mg::swap_red_blue_8888(argb_pixels, pixels.data(), pixels_size / 4);
+            pixel_source->write(pixels.data(), pixels_size);
+        }
+        else
+        {
+            pixel_source->write(argb_pixels, pixels_size);
+        }
+    }
     else
         BOOST_THROW_EXCEPTION(std::logic_error("could not write to buffer for software cursor"));
     return new_renderable;
@@ -20,6 +20,8 @@
 
 #include "key_repeat_dispatcher.h"
 #include "event_filter_chain_dispatcher.h"
+#include "reporting_input_dispatcher.h"
+#include "touch_resampling_dispatcher.h"
 #include "config_changer.h"
 #include "cursor_controller.h"
 #include "touchspot_controller.h"
@@ -31,11 +33,13 @@
 #include "default_input_manager.h"
 #include "surface_input_dispatcher.h"
 #include "basic_seat.h"
+#include "recording_seat.h"
 #include "seat_observer_multiplexer.h"
 #include "../graphics/nested/input_platform.h"
 
 #include "mir/input/touch_visualizer.h"
 #include "mir/input/input_probe.h"
+#include "mir/input/input_recording.h"
 #include "mir/input/platform.h"
 #include "mir/input/xkb_mapper.h"
 #include "mir/options/configuration.h"
@@ -77,7 +81,10 @@ mir::DefaultServerConfiguration::the_event_filter_chain_dispatcher()
         [this]() -> std::shared_ptr<mi::EventFilterChainDispatcher>
         {
             std::initializer_list<std::shared_ptr<mi::EventFilter> const> filter_list {default_filter};
-            return std::make_shared<mi::EventFilterChainDispatcher>(filter_list, the_surface_input_dispatcher());
+            return std::make_shared<mi::EventFilterChainDispatcher>(
+                filter_list,
+                std::make_shared<mi::ReportingInputDispatcher>(
+                    mi::InputPipelineStage::filtered, the_surface_input_dispatcher(), the_input_report()));
         });
 }
 
@@ -119,12 +126,33 @@ mir::DefaultServerConfiguration::the_input_dispatcher()
             auto enable_repeat = options->get<bool>(options::enable_key_repeat_opt) &&
                 !options->is_set(options::host_socket_opt);
 
+            std::shared_ptr<mi::InputDispatcher> next_dispatcher = the_event_filter_chain_dispatcher();
+            if (options->get<bool>(options::touch_resampling_opt))
+                next_dispatcher = the_touch_resampling_dispatcher();
+
             return std::make_shared<mi::KeyRepeatDispatcher>(
-                the_event_filter_chain_dispatcher(), the_main_loop(), the_cookie_authority(),
+                std::make_shared<mi::ReportingInputDispatcher>(
+                    mi::InputPipelineStage::seat_dispatched, next_dispatcher, the_input_report()),
+                the_alarm_factory(), the_cookie_authority(),
                 enable_repeat, key_repeat_timeout, key_repeat_delay, false);
         });
 }
 
+std::shared_ptr<mi::TouchResamplingDispatcher>
+mir::DefaultServerConfiguration::the_touch_resampling_dispatcher()
+{
+    return touch_resampling_dispatcher(
+        [this]()
+        {
+            std::chrono::milliseconds const resample_latency{
+                the_options()->get<int>(options::touch_resampling_latency_opt)};
+
+            return std::make_shared<mi::TouchResamplingDispatcher>(
+                the_event_filter_chain_dispatcher(), the_alarm_factory(), the_clock(),
+                the_display_configuration_observer_registrar(), resample_latency);
+        });
+}
+
 std::shared_ptr<mi::CursorListener>
 mir::DefaultServerConfiguration::the_cursor_listener()
 {
@@ -283,8 +311,19 @@ std::shared_ptr<mi::DefaultInputDeviceHub> mir::DefaultServerConfiguration::the_
        {
            auto input_dispatcher = the_input_dispatcher();
            auto key_repeater = std::dynamic_pointer_cast<mi::KeyRepeatDispatcher>(input_dispatcher);
+
+           // Only the hub needs to see the recording seat: it is what feeds device events to the seat
+           auto seat = the_seat();
+           auto const options = the_options();
+           if (options->is_set(options::record_input_opt))
+           {
+               seat = std::make_shared<mi::RecordingSeat>(
+                   seat,
+                   std::make_shared<mi::InputRecordWriter>(options->get<std::string>(options::record_input_opt)));
+           }
+
            auto hub = std::make_shared<mi::DefaultInputDeviceHub>(
-               the_seat(),
+               seat,
                the_input_reading_multiplexer(),
                the_cookie_authority(),
                the_key_mapper(),
@@ -0,0 +1,303 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/input/input_recording.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <cstring>
+#include <stdexcept>
+
+namespace mi = mir::input;
+namespace mev = mir::events;
+
+namespace
+{
+char const magic[8] = {'M', 'I', 'R', 'I', 'N', 'R', 'E', 'C'};
+uint32_t const format_version = 1;
+
+enum class RecordType : uint8_t
+{
+    device_added = 1,
+    device_removed,
+    key,
+    pointer,
+    touch
+};
+}
+
+mi::InputRecordWriter::InputRecordWriter(std::string const& path)
+    : out{path, std::ios::binary | std::ios::trunc}
+{
+    if (!out)
+        BOOST_THROW_EXCEPTION(std::runtime_error("Failed to open input recording file: " + path));
+
+    out.write(magic, sizeof magic);
+    put(format_version);
+}
+
+mi::InputRecordWriter::~InputRecordWriter() = default;
+
+template<typename T>
+void mi::InputRecordWriter::put(T const& value)
+{
+    out.write(reinterpret_cast<char const*>(&value), sizeof value);
+}
+
+void mi::InputRecordWriter::put(std::string const& value)
+{
+    put(static_cast<uint32_t>(value.size()));
+    out.write(value.data(), value.size());
+}
+
+void mi::InputRecordWriter::device_added(
+    MirInputDeviceId id,
+    DeviceCapabilities capabilities,
+    std::string const& name,
+    std::string const& unique_id)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    put(RecordType::device_added);
+    put(id);
+    put(capabilities.value());
+    put(name);
+    put(unique_id);
+
+    // Devices come and go rarely; make sure what's recorded so far survives a crash
+    out.flush();
+}
+
+void mi::InputRecordWriter::device_removed(MirInputDeviceId id)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    put(RecordType::device_removed);
+    put(id);
+    out.flush();
+}
+
+void mi::InputRecordWriter::key_event(
+    MirInputDeviceId id,
+    Timestamp timestamp,
+    MirKeyboardAction action,
+    int scan_code)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    put(RecordType::key);
+    put(id);
+    put(static_cast<int64_t>(timestamp.count()));
+    put(static_cast<uint8_t>(action));
+    put(static_cast<int32_t>(scan_code));
+}
+
+void mi::InputRecordWriter::pointer_event(
+    MirInputDeviceId id,
+    Timestamp timestamp,
+    MirPointerAction action,
+    MirPointerButtons buttons,
+    float hscroll,
+    float vscroll,
+    float relative_x,
+    float relative_y)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    put(RecordType::pointer);
+    put(id);
+    put(static_cast<int64_t>(timestamp.count()));
+    put(static_cast<uint8_t>(action));
+    put(static_cast<uint32_t>(buttons));
+    put(hscroll);
+    put(vscroll);
+    put(relative_x);
+    put(relative_y);
+}
+
+void mi::InputRecordWriter::touch_event(
+    MirInputDeviceId id,
+    Timestamp timestamp,
+    std::vector<mev::ContactState> const& contacts)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    put(RecordType::touch);
+    put(id);
+    put(static_cast<int64_t>(timestamp.count()));
+    put(static_cast<uint8_t>(contacts.size()));
+    for (auto const& contact : contacts)
+    {
+        put(static_cast<int32_t>(contact.touch_id));
+        put(static_cast<uint8_t>(contact.action));
+        put(static_cast<uint8_t>(contact.tooltype));
+        put(contact.x);
+        put(contact.y);
+        put(contact.pressure);
+        put(contact.touch_major);
+        put(contact.touch_minor);
+    }
+}
+
+void mi::InputRecordWriter::record(MirEvent const& event)
+{
+    if (mir_event_get_type(&event) != mir_event_type_input)
+        return;
+
+    auto const input_event = mir_event_get_input_event(&event);
+    auto const id = mir_input_event_get_device_id(input_event);
+    Timestamp const timestamp{mir_input_event_get_event_time(input_event)};
+
+    switch (mir_input_event_get_type(input_event))
+    {
+    case mir_input_event_type_key:
+    {
+        auto const key = mir_input_event_get_keyboard_event(input_event);
+        key_event(id, timestamp, mir_keyboard_event_action(key), mir_keyboard_event_scan_code(key));
+        break;
+    }
+    case mir_input_event_type_pointer:
+    {
+        auto const pointer = mir_input_event_get_pointer_event(input_event);
+        pointer_event(
+            id,
+            timestamp,
+            mir_pointer_event_action(pointer),
+            mir_pointer_event_buttons(pointer),
+            mir_pointer_event_axis_value(pointer, mir_pointer_axis_hscroll),
+            mir_pointer_event_axis_value(pointer, mir_pointer_axis_vscroll),
+            mir_pointer_event_axis_value(pointer, mir_pointer_axis_relative_x),
+            mir_pointer_event_axis_value(pointer, mir_pointer_axis_relative_y));
+        break;
+    }
+    case mir_input_event_type_touch:
+    {
+        auto const touch = mir_input_event_get_touch_event(input_event);
+        std::vector<mev::ContactState> contacts;
+        for (size_t i = 0, count = mir_touch_event_point_count(touch); i != count; ++i)
+        {
+            contacts.push_back({
+                mir_touch_event_id(touch, i),
+                mir_touch_event_action(touch, i),
+                mir_touch_event_tooltype(touch, i),
+                mir_touch_event_axis_value(touch, i, mir_touch_axis_x),
+                mir_touch_event_axis_value(touch, i, mir_touch_axis_y),
+                mir_touch_event_axis_value(touch, i, mir_touch_axis_pressure),
+                mir_touch_event_axis_value(touch, i, mir_touch_axis_touch_major),
+                mir_touch_event_axis_value(touch, i, mir_touch_axis_touch_minor),
+                0.0f});
+        }
+        touch_event(id, timestamp, contacts);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+mi::InputRecordReader::InputRecordReader(std::string const& path)
+    : in{path, std::ios::binary}
+{
+    if (!in)
+        BOOST_THROW_EXCEPTION(std::runtime_error("Failed to open input recording file: " + path));
+
+    char file_magic[sizeof magic];
+    in.read(file_magic, sizeof file_magic);
+    if (!in || std::memcmp(file_magic, magic, sizeof magic) != 0)
+        BOOST_THROW_EXCEPTION(std::runtime_error("Not an input recording: " + path));
+
+    if (get<uint32_t>() != format_version)
+        BOOST_THROW_EXCEPTION(std::runtime_error("Unsupported input recording version: " + path));
+}
+
+template<typename T>
+T mi::InputRecordReader::get()
+{
+    T value;
+    if (!in.read(reinterpret_cast<char*>(&value), sizeof value))
+        BOOST_THROW_EXCEPTION(std::runtime_error("Truncated input recording"));
+    return value;
+}
+
+std::string mi::InputRecordReader::get_string()
+{
+    std::string value(get<uint32_t>(), '\0');
+    if (!in.read(&value[0], value.size()))
+        BOOST_THROW_EXCEPTION(std::runtime_error("Truncated input recording"));
+    return value;
+}
+
+bool mi::InputRecordReader::read_next(InputRecordHandler& handler)
+{
+    RecordType type;
+    if (!in.read(reinterpret_cast<char*>(&type), sizeof type))
+        return false;
+
+    auto const id = get<MirInputDeviceId>();
+
+    switch (type)
+    {
+    case RecordType::device_added:
+    {
+        DeviceCapabilities const capabilities{get<DeviceCapabilities::value_type>()};
+        auto const name = get_string();
+        auto const unique_id = get_string();
+        handler.device_added(id, capabilities, name, unique_id);
+        break;
+    }
+    case RecordType::device_removed:
+        handler.device_removed(id);
+        break;
+    case RecordType::key:
+    {
+        InputRecordHandler::Timestamp const timestamp{get<int64_t>()};
+        auto const action = static_cast<MirKeyboardAction>(get<uint8_t>());
+        handler.key_event(id, timestamp, action, get<int32_t>());
+        break;
+    }
+    case RecordType::pointer:
+    {
+        InputRecordHandler::Timestamp const timestamp{get<int64_t>()};
+        auto const action = static_cast<MirPointerAction>(get<uint8_t>());
+        auto const buttons = static_cast<MirPointerButtons>(get<uint32_t>());
+        auto const hscroll = get<float>();
+        auto const vscroll = get<float>();
+        auto const relative_x = get<float>();
+        auto const relative_y = get<float>();
+        handler.pointer_event(id, timestamp, action, buttons, hscroll, vscroll, relative_x, relative_y);
+        break;
+    }
+    case RecordType::touch:
+    {
+        InputRecordHandler::Timestamp const timestamp{get<int64_t>()};
+        std::vector<mev::ContactState> contacts(get<uint8_t>());
+        for (auto& contact : contacts)
+        {
+            contact.touch_id = get<int32_t>();
+            contact.action = static_cast<MirTouchAction>(get<uint8_t>());
+            contact.tooltype = static_cast<MirTouchTooltype>(get<uint8_t>());
+            contact.x = get<float>();
+            contact.y = get<float>();
+            contact.pressure = get<float>();
+            contact.touch_major = get<float>();
+            contact.touch_minor = get<float>();
+            // Events don't carry the orientation, so neither do recordings
+            contact.orientation = 0.0f;
+        }
+        handler.touch_event(id, timestamp, contacts);
+        break;
+    }
+    default:
+        BOOST_THROW_EXCEPTION(std::runtime_error("Unknown record in input recording"));
+    }
+
+    return true;
+}
@@ -99,15 +99,53 @@ void mi::KeyRepeatDispatcher::set_touch_button_device(MirInputDeviceId id)
 void mi::KeyRepeatDispatcher::remove_device(MirInputDeviceId id)
 {
     std::lock_guard<std::mutex> lock(repeat_state_mutex);
-    repeat_state_by_device.erase(id); // destructor cancels alarms
+    repeat_state_by_device.erase(
+        std::remove_if(
+            repeat_state_by_device.begin(),
+            repeat_state_by_device.end(),
+            [id](KeyboardState const& state) { return state.device_id == id; }),
+        repeat_state_by_device.end()); // destructor cancels alarms
     if (touch_button_device.is_set() && touch_button_device.value() == id)
         touch_button_device.consume();
 }
 
 mi::KeyRepeatDispatcher::KeyboardState& mi::KeyRepeatDispatcher::ensure_state_for_device_locked(std::lock_guard<std::mutex> const&, MirInputDeviceId id)
 {
-    repeat_state_by_device.insert(std::make_pair(id, KeyboardState()));
-    return repeat_state_by_device[id];
+    for (auto& state : repeat_state_by_device)
+    {
+        if (state.device_id == id)
+            return state;
+    }
+
+    repeat_state_by_device.push_back(KeyboardState{id, nullptr, false, 0, 0, mir_input_event_modifier_none});
+    return repeat_state_by_device.back();
+}
+
+void mi::KeyRepeatDispatcher::repeat_key_locked(std::lock_guard<std::mutex> const& lock, MirInputDeviceId id)
+{
+    for (auto const& state : repeat_state_by_device)
+    {
+        if (state.device_id == id && state.repeating)
+        {
+            dispatch_repeat_locked(lock, state);
+            state.repeat_alarm->reschedule_in(repeat_delay);
+            return;
+        }
+    }
+}
+
+void mi::KeyRepeatDispatcher::dispatch_repeat_locked(std::lock_guard<std::mutex> const&, KeyboardState const& state)
+{
+    auto const now = std::chrono::steady_clock::now().time_since_epoch();
+    auto const cookie = cookie_authority->make_cookie(now.count());
+    next_dispatcher->dispatch(mev::make_event(
+        state.device_id,
+        now,
+        cookie->serialize(),
+        mir_keyboard_action_repeat,
+        state.key_code,
+        state.scan_code,
+        state.modifiers));
 }
 
 bool mi::KeyRepeatDispatcher::dispatch(std::shared_ptr<MirEvent const> const& event)
@@ -146,51 +184,38 @@ bool mi::KeyRepeatDispatcher::handle_key_input(MirInputDeviceId id, MirKeyboardE
     {
     case mir_keyboard_action_up:
     {
-        auto it = device_state.repeat_alarms_by_scancode.find(scan_code);
-        if (it == device_state.repeat_alarms_by_scancode.end())
+        if (!device_state.repeating || device_state.scan_code != scan_code)
         {
             return false;
         }
-        device_state.repeat_alarms_by_scancode.erase(it);
+        device_state.repeating = false;
+        device_state.repeat_alarm->cancel();
         break;
     }
     case mir_keyboard_action_down:
     {
-        auto clone_event = [scan_code, id, this,
-             key_code = mir_keyboard_event_key_code(kev),
-             modifiers = mir_keyboard_event_modifiers(kev)]()
-             {
-                 auto const now = std::chrono::steady_clock::now().time_since_epoch();
-                 auto const cookie = cookie_authority->make_cookie(now.count());
-                 auto new_event = mev::make_event(
-                     id,
-                     now,
-                     cookie->serialize(),
-                     mir_keyboard_action_repeat,
-                     key_code,
-                     scan_code,
-                     modifiers);
-                 next_dispatcher->dispatch(std::move(new_event));
-             };
-
-        auto it = device_state.repeat_alarms_by_scancode.find(scan_code);
-        if (it != device_state.repeat_alarms_by_scancode.end())
+        if (device_state.repeating && device_state.scan_code == scan_code)
         {
             // When we receive a duplicated down we just replace the action
-            clone_event();
+            dispatch_repeat_locked(lg, device_state);
             return true;
         }
-        auto& capture_alarm = device_state.repeat_alarms_by_scancode[scan_code];
-        std::shared_ptr<mir::time::Alarm> alarm = alarm_factory->create_alarm(
-            [this, clone_event, &capture_alarm]() mutable
-            {
-                std::lock_guard<std::mutex> lg(repeat_state_mutex);
-                clone_event();
-
-                capture_alarm->reschedule_in(repeat_delay);
-            });
-        alarm->reschedule_in(repeat_timeout);
-        device_state.repeat_alarms_by_scancode[scan_code] = {alarm};
+
+        device_state.repeating = true;
+        device_state.scan_code = scan_code;
+        device_state.key_code = mir_keyboard_event_key_code(kev);
+        device_state.modifiers = mir_keyboard_event_modifiers(kev);
+
+        if (!device_state.repeat_alarm)
+        {
+            device_state.repeat_alarm = alarm_factory->create_alarm(
+                [this, id]
+                {
+                    std::lock_guard<std::mutex> lg(repeat_state_mutex);
+                    repeat_key_locked(lg, id);
+                });
+        }
+        device_state.repeat_alarm->reschedule_in(repeat_timeout);
     }
     case mir_keyboard_action_repeat:
         // Should we consume existing repeats?
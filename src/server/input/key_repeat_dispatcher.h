@@ -26,7 +26,7 @@
 #include <memory>
 #include <chrono>
 #include <mutex>
-#include <unordered_map>
+#include <vector>
 
 namespace mir
 {
@@ -74,12 +74,22 @@ private:
     bool const disable_repeat_on_touchscreen;
     optional_value<MirInputDeviceId> touch_button_device;
 
+    // Only the most recently pressed key on a device repeats, so each device
+    // needs at most one alarm. There are few devices: a flat table is cheaper
+    // to search than a map is to maintain.
     struct KeyboardState
     {
-        std::unordered_map<int, std::shared_ptr<mir::time::Alarm>> repeat_alarms_by_scancode;
+        MirInputDeviceId device_id;
+        std::unique_ptr<time::Alarm> repeat_alarm;
+        bool repeating;
+        int scan_code;
+        xkb_keysym_t key_code;
+        MirInputEventModifiers modifiers;
     };
-    std::unordered_map<MirInputDeviceId, KeyboardState> repeat_state_by_device;
+    std::vector<KeyboardState> repeat_state_by_device;
     KeyboardState& ensure_state_for_device_locked(std::lock_guard<std::mutex> const&, MirInputDeviceId id);
+    void repeat_key_locked(std::lock_guard<std::mutex> const&, MirInputDeviceId id);
+    void dispatch_repeat_locked(std::lock_guard<std::mutex> const&, KeyboardState const& state);
 
     bool handle_key_input(MirInputDeviceId id, MirKeyboardEvent const* ev);
 };
@@ -0,0 +1,93 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "recording_seat.h"
+
+#include "mir/input/input_recording.h"
+#include "mir/input/device.h"
+#include "mir/input/input_sink.h"
+
+namespace mi = mir::input;
+
+mi::RecordingSeat::RecordingSeat(std::shared_ptr<Seat> const& seat, std::shared_ptr<InputRecordWriter> const& writer)
+    : seat{seat},
+      writer{writer}
+{
+}
+
+void mi::RecordingSeat::add_device(Device const& device)
+{
+    writer->device_added(device.id(), device.capabilities(), device.name(), device.unique_id());
+    seat->add_device(device);
+}
+
+void mi::RecordingSeat::remove_device(Device const& device)
+{
+    writer->device_removed(device.id());
+    seat->remove_device(device);
+}
+
+void mi::RecordingSeat::dispatch_event(std::shared_ptr<MirEvent> const& event)
+{
+    // Record before the seat modifies the event
+    writer->record(*event);
+    seat->dispatch_event(event);
+}
+
+mir::EventUPtr mi::RecordingSeat::create_device_state()
+{
+    return seat->create_device_state();
+}
+
+mi::XkbModifiers mi::RecordingSeat::xkb_modifiers() const
+{
+    return seat->xkb_modifiers();
+}
+
+void mi::RecordingSeat::set_key_state(Device const& dev, std::vector<uint32_t> const& scan_codes)
+{
+    seat->set_key_state(dev, scan_codes);
+}
+
+void mi::RecordingSeat::set_pointer_state(Device const& dev, MirPointerButtons buttons)
+{
+    seat->set_pointer_state(dev, buttons);
+}
+
+void mi::RecordingSeat::set_cursor_position(float cursor_x, float cursor_y)
+{
+    seat->set_cursor_position(cursor_x, cursor_y);
+}
+
+void mi::RecordingSeat::set_confinement_regions(geometry::Rectangles const& regions)
+{
+    seat->set_confinement_regions(regions);
+}
+
+void mi::RecordingSeat::reset_confinement_regions()
+{
+    seat->reset_confinement_regions();
+}
+
+mir::geometry::Rectangle mi::RecordingSeat::bounding_rectangle() const
+{
+    return seat->bounding_rectangle();
+}
+
+mi::OutputInfo mi::RecordingSeat::output_info(uint32_t output_id) const
+{
+    return seat->output_info(output_id);
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "reporting_input_dispatcher.h"
+
+#include "mir_toolkit/event.h"
+
+namespace mi = mir::input;
+
+mi::ReportingInputDispatcher::ReportingInputDispatcher(
+    InputPipelineStage stage,
+    std::shared_ptr<InputDispatcher> const& next_dispatcher,
+    std::shared_ptr<InputReport> const& report)
+    : stage{stage},
+      next_dispatcher{next_dispatcher},
+      report{report}
+{
+}
+
+bool mi::ReportingInputDispatcher::dispatch(std::shared_ptr<MirEvent const> const& event)
+{
+    if (mir_event_get_type(event.get()) == mir_event_type_input)
+    {
+        auto const event_time = mir_input_event_get_event_time(mir_event_get_input_event(event.get()));
+        report->event_reached_stage(stage, event_time);
+    }
+
+    return next_dispatcher->dispatch(event);
+}
+
+void mi::ReportingInputDispatcher::start()
+{
+    next_dispatcher->start();
+}
+
+void mi::ReportingInputDispatcher::stop()
+{
+    next_dispatcher->stop();
+}
@@ -89,22 +89,25 @@ void mi::SeatInputDeviceTracker::dispatch(std::shared_ptr<MirEvent> const& event
 {
     if (mir_event_get_type(event.get()) == mir_event_type_input)
     {
-        std::lock_guard<std::mutex> lock(device_state_mutex);
-
         auto input_event = mir_event_get_input_event(event.get());
 
-        if (filter_input_event(input_event))
-            return;
+        {
+            std::lock_guard<std::mutex> lock(device_state_mutex);
 
-        update_seat_properties(input_event);
+            if (filter_input_event(input_event))
+                return;
 
-        key_mapper->map_event(*event);
+            update_seat_properties(input_event);
 
-        if (mir_input_event_type_pointer == mir_input_event_get_type(input_event))
-        {
-            mev::set_cursor_position(*event, cursor_x, cursor_y);
-            mev::set_button_state(*event, buttons);
+            if (mir_input_event_type_pointer == mir_input_event_get_type(input_event))
+            {
+                mev::set_cursor_position(*event, cursor_x, cursor_y);
+                mev::set_button_state(*event, buttons);
+            }
         }
+
+        // The key mapper keeps the keyboard state and guards it itself
+        key_mapper->map_event(*event);
     }
 
     dispatcher->dispatch(event);
@@ -205,6 +208,11 @@ mir::geometry::Point mi::SeatInputDeviceTracker::cursor_position() const
     return {cursor_x, cursor_y};
 }
 
+mi::XkbModifiers mi::SeatInputDeviceTracker::xkb_modifiers() const
+{
+    return key_mapper->xkb_modifiers();
+}
+
 MirPointerButtons mi::SeatInputDeviceTracker::button_state() const
 {
     std::lock_guard<std::mutex> lock(device_state_mutex);
@@ -21,6 +21,7 @@
 #define MIR_INPUT_SEAT_INPUT_DEVICE_TRACKER_H
 
 #include "mir/input/touch_visualizer.h"
+#include "mir/input/key_mapper.h"
 #include "mir/geometry/point.h"
 #include "mir/geometry/rectangles.h"
 #include "mir/geometry/size.h"
@@ -42,13 +43,12 @@ namespace input
 {
 class CursorListener;
 class InputDispatcher;
-class KeyMapper;
 class SeatObserver;
 
 /*
  * The SeatInputDeviceTracker bundles the input device properties of a group of devices defined by a seat:
  *  - a single cursor position,
- *  - modifier key states (i.e alt, ctrl ..)
+ *  - modifier key states (i.e alt, ctrl ..), kept by the key mapper
  *  - a single mouse button state for all pointing devices
  *  - visible touch spots
  */
@@ -68,6 +68,7 @@ public:
 
     MirPointerButtons button_state() const;
     geometry::Point cursor_position() const;
+    XkbModifiers xkb_modifiers() const;
     EventUPtr create_device_state() const;
 
     void set_key_state(MirInputDeviceId id, std::vector<uint32_t> const& scan_codes);
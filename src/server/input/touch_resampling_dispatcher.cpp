@@ -0,0 +1,376 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "touch_resampling_dispatcher.h"
+
+#include "mir/events/event_builders.h"
+#include "mir/events/event_private.h"
+#include "mir/graphics/display_configuration.h"
+#include "mir/graphics/display_configuration_observer.h"
+#include "mir/time/alarm_factory.h"
+#include "mir/time/alarm.h"
+#include "mir/time/clock.h"
+#include "mir/lockable_callback.h"
+
+#include <algorithm>
+
+namespace mi = mir::input;
+namespace mev = mir::events;
+namespace mf = mir::frontend;
+namespace mg = mir::graphics;
+
+using namespace std::chrono_literals;
+
+namespace
+{
+// Never extrapolate further than this, nor more than half the interval
+// between the samples we extrapolate from
+auto const max_prediction = std::chrono::nanoseconds{8ms};
+
+// Samples closer together than this give too noisy a velocity to extrapolate
+auto const min_prediction_interval = std::chrono::nanoseconds{2ms};
+
+// Enough history to interpolate within a frame at high touch sample rates
+size_t const max_history = 8;
+
+std::chrono::nanoseconds event_time(MirEvent const& event)
+{
+    return event.to_input()->event_time();
+}
+
+bool is_motion_only(MirTouchEvent const& touch)
+{
+    for (size_t i = 0; i != touch.pointer_count(); ++i)
+    {
+        if (touch.action(i) != mir_touch_action_change)
+            return false;
+    }
+    return true;
+}
+
+// Places each contact of `to` alpha of the way from its position in `from`
+// to its position in `to` (beyond it, for alpha > 1). Contacts that aren't
+// in `from` stay where they are.
+void blend(MirTouchEvent const& from, MirTouchEvent& to, float alpha)
+{
+    for (size_t i = 0; i != to.pointer_count(); ++i)
+    {
+        for (size_t j = 0; j != from.pointer_count(); ++j)
+        {
+            if (from.id(j) == to.id(i))
+            {
+                to.set_x(i, from.x(j) + alpha * (to.x(i) - from.x(j)));
+                to.set_y(i, from.y(j) + alpha * (to.y(i) - from.y(j)));
+                break;
+            }
+        }
+    }
+}
+
+/*
+ * The touch state at `sample_time`, or as near to it as the history allows:
+ * interpolated between the samples either side of it, or extrapolated a
+ * short way beyond the latest sample. Null if `sample_time` precedes the
+ * history (the oldest sample is the touch down, or already dispatched).
+ */
+mir::EventUPtr resample(
+    std::vector<std::shared_ptr<MirEvent const>> const& history,
+    std::chrono::nanoseconds sample_time)
+{
+    auto const latest = history.back();
+    auto const latest_time = event_time(*latest);
+
+    if (latest_time <= sample_time)
+    {
+        auto resampled = mev::clone_event(*latest);
+
+        if (history.size() < 2)
+            return resampled;
+
+        auto const& previous = *history[history.size() - 2];
+        auto const interval = latest_time - event_time(previous);
+
+        if (interval < min_prediction_interval)
+            return resampled;
+
+        auto const prediction = std::min({sample_time - latest_time, interval / 2, max_prediction});
+        auto const alpha = 1.0f + float(prediction.count()) / interval.count();
+
+        blend(*previous.to_input()->to_touch(), *resampled->to_input()->to_touch(), alpha);
+        resampled->to_input()->set_event_time(latest_time + prediction);
+        return resampled;
+    }
+
+    auto const after = std::find_if(history.begin(), history.end(),
+        [sample_time](auto const& sample) { return event_time(*sample) > sample_time; });
+
+    if (after == history.begin())
+        return {nullptr, [](MirEvent*) {}};
+
+    auto resampled = mev::clone_event(**after);
+
+    auto const& before = **(after - 1);
+    auto const before_time = event_time(before);
+    auto const alpha = float((sample_time - before_time).count()) / (event_time(**after) - before_time).count();
+
+    blend(*before.to_input()->to_touch(), *resampled->to_input()->to_touch(), alpha);
+    resampled->to_input()->set_event_time(sample_time);
+    return resampled;
+}
+}
+
+class mi::TouchResamplingDispatcher::FrameCallback : public mir::LockableCallback
+{
+public:
+    FrameCallback(TouchResamplingDispatcher* dispatcher)
+        : dispatcher{dispatcher}
+    {
+    }
+
+    void operator()() override
+    {
+        dispatcher->dispatch_frame_locked();
+    }
+
+    void lock() override
+    {
+        dispatcher->mutex.lock();
+    }
+
+    void unlock() override
+    {
+        dispatcher->mutex.unlock();
+    }
+
+private:
+    TouchResamplingDispatcher* const dispatcher;
+};
+
+struct mi::TouchResamplingDispatcher::RefreshRateTracker : mg::DisplayConfigurationObserver
+{
+    RefreshRateTracker(TouchResamplingDispatcher& dispatcher)
+        : dispatcher{dispatcher}
+    {
+    }
+
+    // With several outputs the fastest sets the pace of frame_started()
+    void update_refresh_rate(mg::DisplayConfiguration const& conf)
+    {
+        double fastest = 0;
+        conf.for_each_output(
+            [&fastest](mg::DisplayConfigurationOutput const& output)
+            {
+                if (!output.used || !output.connected || output.power_mode != mir_power_mode_on)
+                    return;
+                if (!output.valid() || (output.current_mode_index >= output.modes.size()))
+                    return;
+
+                fastest = std::max(fastest, output.modes[output.current_mode_index].vrefresh_hz);
+            });
+
+        if (fastest > 0)
+            dispatcher.set_refresh_rate(fastest);
+    }
+
+    void initial_configuration(std::shared_ptr<mg::DisplayConfiguration const> const& config) override
+    {
+        update_refresh_rate(*config);
+    }
+
+    void configuration_applied(std::shared_ptr<mg::DisplayConfiguration const> const& config) override
+    {
+        update_refresh_rate(*config);
+    }
+
+    void base_configuration_updated(std::shared_ptr<mg::DisplayConfiguration const> const&) override
+    {}
+
+    void session_configuration_applied(std::shared_ptr<mf::Session> const&,
+        std::shared_ptr<mg::DisplayConfiguration> const&) override
+    {}
+
+    void session_configuration_removed(std::shared_ptr<mf::Session> const&) override
+    {}
+
+    void configuration_failed(
+        std::shared_ptr<mg::DisplayConfiguration const> const&,
+        std::exception const&) override
+    {}
+
+    void catastrophic_configuration_error(
+        std::shared_ptr<mg::DisplayConfiguration const> const&,
+        std::exception const&) override
+    {}
+
+private:
+    TouchResamplingDispatcher& dispatcher;
+};
+
+mi::TouchResamplingDispatcher::TouchResamplingDispatcher(
+    std::shared_ptr<InputDispatcher> const& next_dispatcher,
+    std::shared_ptr<time::AlarmFactory> const& alarm_factory,
+    std::shared_ptr<time::Clock> const& clock,
+    std::shared_ptr<Registrar> const& registrar,
+    std::chrono::milliseconds resample_latency)
+    : next_dispatcher{next_dispatcher},
+      clock{clock},
+      resample_latency{resample_latency},
+      last_frame{clock->now()},
+      frame_period{std::chrono::duration_cast<time::Duration>(std::chrono::seconds{1}) / 60},
+      frame_alarm{alarm_factory->create_alarm(std::make_unique<FrameCallback>(this))},
+      refresh_rate_tracker{std::make_shared<RefreshRateTracker>(*this)}
+{
+    registrar->register_interest(refresh_rate_tracker);
+}
+
+mi::TouchResamplingDispatcher::~TouchResamplingDispatcher() = default;
+
+bool mi::TouchResamplingDispatcher::dispatch(std::shared_ptr<MirEvent const> const& event)
+{
+    if (event->type() != mir_event_type_input ||
+        event->to_input()->input_type() != mir_input_event_type_touch)
+    {
+        return next_dispatcher->dispatch(event);
+    }
+
+    std::lock_guard<std::mutex> lock{mutex};
+    auto& state = ensure_state_for_device_locked(event->to_input()->device_id());
+
+    if (is_motion_only(*event->to_input()->to_touch()))
+    {
+        if (state.history.size() == max_history)
+            state.history.erase(state.history.begin());
+        state.history.push_back(event);
+        state.motion_pending = true;
+
+        schedule_frame_locked();
+        return true;
+    }
+
+    // A touch beginning or ending supersedes any motion we're holding back,
+    // and later motion is resampled from here
+    state.history.assign(1, event);
+    state.motion_pending = false;
+    state.dispatched_up_to = event_time(*event);
+
+    return next_dispatcher->dispatch(event);
+}
+
+void mi::TouchResamplingDispatcher::start()
+{
+    next_dispatcher->start();
+}
+
+void mi::TouchResamplingDispatcher::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        frame_alarm->cancel();
+        touch_state_by_device.clear();
+    }
+
+    next_dispatcher->stop();
+}
+
+void mi::TouchResamplingDispatcher::frame_started()
+{
+    auto const now = clock->now();
+
+    std::lock_guard<std::mutex> lock{frame_mutex};
+    auto const interval = now - last_frame;
+
+    // With several outputs we follow the first frame of each period and
+    // ignore the others rather than have them drag the phase around
+    if (interval < frame_period / 2)
+        return;
+
+    // After an idle spell just pick up the new phase
+    if (interval < frame_period * 3 / 2)
+        frame_period += (interval - frame_period) / 8;
+
+    last_frame = now;
+}
+
+void mi::TouchResamplingDispatcher::set_refresh_rate(double hz)
+{
+    std::lock_guard<std::mutex> lock{frame_mutex};
+    frame_period = std::chrono::duration_cast<time::Duration>(std::chrono::duration<double>{1 / hz});
+}
+
+auto mi::TouchResamplingDispatcher::ensure_state_for_device_locked(MirInputDeviceId id) -> TouchState&
+{
+    for (auto& state : touch_state_by_device)
+    {
+        if (state.device_id == id)
+            return state;
+    }
+
+    touch_state_by_device.push_back(TouchState{id, {}, false, std::chrono::nanoseconds::min()});
+    return touch_state_by_device.back();
+}
+
+void mi::TouchResamplingDispatcher::schedule_frame_locked()
+{
+    if (frame_alarm->state() == time::Alarm::pending)
+        return;
+
+    auto const now = clock->now();
+
+    std::lock_guard<std::mutex> lock{frame_mutex};
+    auto const frames_since_last = (now - last_frame) / frame_period;
+    frame_alarm->reschedule_for(last_frame + (frames_since_last + 1) * frame_period);
+}
+
+void mi::TouchResamplingDispatcher::dispatch_frame_locked()
+{
+    auto const sample_time = clock->now().time_since_epoch() - resample_latency;
+    bool more_pending = false;
+
+    for (auto& state : touch_state_by_device)
+    {
+        if (!state.motion_pending)
+            continue;
+
+        auto resampled = resample(state.history, sample_time);
+
+        // Nothing to sample yet: wait for a frame after the motion we hold
+        if (!resampled)
+        {
+            more_pending = true;
+            continue;
+        }
+
+        // Keep event times monotonic even if we predicted further ahead than
+        // the samples that have arrived since
+        auto const resampled_time = std::max(event_time(*resampled), state.dispatched_up_to);
+        resampled->to_input()->set_event_time(resampled_time);
+        state.dispatched_up_to = resampled_time;
+
+        // Keep the latest sample no newer than what we dispatched to interpolate from
+        auto const first_newer = std::find_if(state.history.begin(), state.history.end(),
+            [resampled_time](auto const& sample) { return event_time(*sample) > resampled_time; });
+        if (first_newer - state.history.begin() > 1)
+            state.history.erase(state.history.begin(), first_newer - 1);
+
+        state.motion_pending = event_time(*state.history.back()) > resampled_time;
+        more_pending = more_pending || state.motion_pending;
+
+        next_dispatcher->dispatch(std::move(resampled));
+    }
+
+    if (more_pending)
+        schedule_frame_locked();
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_INPUT_TOUCH_RESAMPLING_DISPATCHER_H_
+#define MIR_INPUT_TOUCH_RESAMPLING_DISPATCHER_H_
+
+#include "mir/input/input_dispatcher.h"
+#include "mir/observer_registrar.h"
+#include "mir/time/types.h"
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mir
+{
+namespace graphics
+{
+class DisplayConfigurationObserver;
+}
+namespace time
+{
+class Alarm;
+class AlarmFactory;
+class Clock;
+}
+namespace input
+{
+
+/**
+ * Holds back touch motion and releases one resampled touch event per frame.
+ *
+ * Touch screens and displays run at unrelated rates, so between two frames
+ * a client sees no, one or two motion events and the content it draws
+ * judders. Motion is queued here and, as each frame starts, a single event
+ * is dispatched with its contacts interpolated (or briefly extrapolated) to
+ * \a resample_latency before the frame. Touches beginning or ending are
+ * dispatched straight away.
+ *
+ * The compositor calls frame_started() as it starts each frame; the frame
+ * phase is tracked from that. The frame period starts from the fastest
+ * refresh rate of the active outputs, follows it as the display
+ * configuration changes, and is refined from the frames seen in between.
+ */
+class TouchResamplingDispatcher : public InputDispatcher
+{
+public:
+    using Registrar = ObserverRegistrar<graphics::DisplayConfigurationObserver>;
+
+    TouchResamplingDispatcher(
+        std::shared_ptr<InputDispatcher> const& next_dispatcher,
+        std::shared_ptr<time::AlarmFactory> const& alarm_factory,
+        std::shared_ptr<time::Clock> const& clock,
+        std::shared_ptr<Registrar> const& registrar,
+        std::chrono::milliseconds resample_latency);
+    ~TouchResamplingDispatcher();
+
+    // InputDispatcher
+    bool dispatch(std::shared_ptr<MirEvent const> const& event) override;
+    void start() override;
+    void stop() override;
+
+    void frame_started();
+
+private:
+    struct TouchState
+    {
+        MirInputDeviceId device_id;
+        std::vector<std::shared_ptr<MirEvent const>> history; // oldest first
+        bool motion_pending;
+        std::chrono::nanoseconds dispatched_up_to;
+    };
+
+    // The *_locked() functions are called with `mutex` held, either by us or
+    // by frame_alarm through its FrameCallback
+    TouchState& ensure_state_for_device_locked(MirInputDeviceId id);
+    void schedule_frame_locked();
+    void dispatch_frame_locked();
+
+    void set_refresh_rate(double hz);
+
+    class FrameCallback;
+    struct RefreshRateTracker;
+
+    std::mutex mutex;
+
+    std::shared_ptr<InputDispatcher> const next_dispatcher;
+    std::shared_ptr<time::Clock> const clock;
+    std::chrono::nanoseconds const resample_latency;
+
+    // frame_started() is called by the compositor, which mustn't wait for
+    // input dispatch, so frame timing has a lock of its own
+    std::mutex frame_mutex;
+    time::Timestamp last_frame;
+    time::Duration frame_period;
+
+    // Few touch devices are connected at once
+    std::vector<TouchState> touch_state_by_device;
+
+    std::unique_ptr<time::Alarm> const frame_alarm;
+    std::shared_ptr<RefreshRateTracker> const refresh_rate_tracker;
+};
+
+}
+}
+
+#endif // MIR_INPUT_TOUCH_RESAMPLING_DISPATCHER_H_
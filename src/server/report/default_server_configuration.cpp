@@ -23,6 +23,9 @@
 #include "lttng_report_factory.h"
 #include "logging_report_factory.h"
 #include "null_report_factory.h"
+#include "metrics_report_factory.h"
+#include "metrics/registry.h"
+#include "metrics/scrape_endpoint.h"
 
 #include "mir/abnormal_exit.h"
 
@@ -44,6 +47,10 @@ std::unique_ptr<mir::report::ReportFactory> mir::DefaultServerConfiguration::rep
     {
         return std::make_unique<report::LttngReportFactory>();
     }
+    else if (opt == options::metrics_opt_value)
+    {
+        return std::make_unique<report::MetricsReportFactory>(the_metrics_registry(), the_clock());
+    }
     else if (opt == options::off_opt_value)
     {
         return std::make_unique<report::NullReportFactory>();
@@ -52,10 +59,31 @@ std::unique_ptr<mir::report::ReportFactory> mir::DefaultServerConfiguration::rep
     {
         throw AbnormalExit(std::string("Invalid ") + report_opt + " option: " + opt + " (valid options are: \"" +
             options::off_opt_value + "\" and \"" + options::log_opt_value +
-                           "\" and \"" + options::lttng_opt_value + "\")");
+                           "\" and \"" + options::lttng_opt_value +
+                           "\" and \"" + options::metrics_opt_value + "\")");
     }
 }
 
+auto mir::DefaultServerConfiguration::the_metrics_registry() -> std::shared_ptr<report::metrics::Registry>
+{
+    return metrics_registry(
+        [this]
+        {
+            auto const options = the_options();
+            auto const socket_file = options->is_set(options::metrics_socket_opt) ?
+                options->get<std::string>(options::metrics_socket_opt) :
+                options->get<std::string>(options::server_socket_opt) + "_metrics";
+
+            auto const registry = std::make_shared<report::metrics::Registry>();
+            auto const endpoint = std::make_shared<report::metrics::ScrapeEndpoint>(socket_file, registry);
+
+            // Serve the metrics for as long as anything records them
+            return std::shared_ptr<report::metrics::Registry>{
+                registry.get(),
+                [registry, endpoint](report::metrics::Registry*) {}};
+        });
+}
+
 std::shared_ptr<mir::report::Reports> mir::DefaultServerConfiguration::initialise_reports()
 {
     return std::make_unique<report::Reports>(*this, *the_options());
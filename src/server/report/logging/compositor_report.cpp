@@ -74,8 +74,74 @@ void mrl::CompositorReport::rendered_frame(SubCompositorId id)
     inst.bypassed = false;
 }
 
+void mrl::CompositorReport::frame_reached_stage(SubCompositorId id, mir::compositor::FrameStage stage)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& inst = instance[id];
+    auto const i = static_cast<int>(stage);
+    inst.stage_time_sum[i] += now() - inst.start_of_frame;
+    inst.nstage[i]++;
+}
+
+void mrl::CompositorReport::rendered_on_gpu(SubCompositorId id, std::chrono::nanoseconds gpu_time)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& inst = instance[id];
+    inst.gpu_time_sum += gpu_time;
+    inst.ngpu++;
+}
+
+void mrl::CompositorReport::Instance::log_stages(ml::Logger& logger, SubCompositorId id)
+{
+    auto const average_usec = [](std::chrono::nanoseconds sum, long n) -> long
+        { return n ? std::chrono::duration_cast<std::chrono::microseconds>(sum).count() / n : 0; };
+
+    long avg_stage_usec[stages];
+    bool reached_any = false;
+    for (int i = 0; i != stages; ++i)
+    {
+        auto const dn = nstage[i] - last_reported_nstage[i];
+        avg_stage_usec[i] = average_usec(stage_time_sum[i] - last_reported_stage_time_sum[i], dn);
+        reached_any = reached_any || dn;
+    }
+    long const avg_gpu_usec = average_usec(gpu_time_sum - last_reported_gpu_time_sum, ngpu - last_reported_ngpu);
+
+    // Only renderers that report their progress have anything to say here
+    if (reached_any)
+    {
+        auto const scene = avg_stage_usec[static_cast<int>(compositor::FrameStage::scene_snapshotted)];
+        auto const textures = avg_stage_usec[static_cast<int>(compositor::FrameStage::textures_bound)];
+        auto const submitted = avg_stage_usec[static_cast<int>(compositor::FrameStage::draw_submitted)];
+        auto const flipped = avg_stage_usec[static_cast<int>(compositor::FrameStage::flip_completed)];
+
+        char msg[256];
+        snprintf(msg, sizeof msg, "Display %p frame stages: "
+                 "scene snapshotted at %ld.%03ld ms, "
+                 "textures bound at %ld.%03ld ms, "
+                 "draw submitted at %ld.%03ld ms, "
+                 "flip completed at %ld.%03ld ms, "
+                 "GPU time %ld.%03ld ms",
+                 id,
+                 scene / 1000, scene % 1000,
+                 textures / 1000, textures % 1000,
+                 submitted / 1000, submitted % 1000,
+                 flipped / 1000, flipped % 1000,
+                 avg_gpu_usec / 1000, avg_gpu_usec % 1000
+                 );
+
+        logger.log(ml::Severity::informational, msg, component);
+    }
+
+    last_reported_stage_time_sum = stage_time_sum;
+    last_reported_nstage = nstage;
+    last_reported_gpu_time_sum = gpu_time_sum;
+    last_reported_ngpu = ngpu;
+}
+
 void mrl::CompositorReport::Instance::log(ml::Logger& logger, SubCompositorId id)
 {
+    log_stages(logger, id);
+
     // The first report is a valid sample, but don't log anything because
     // we need at least two samples for valid deltas.
     if (last_reported_total_time_sum > TimePoint())
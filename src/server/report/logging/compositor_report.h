@@ -21,6 +21,7 @@
 
 #include "mir/compositor/compositor_report.h"
 #include "mir/time/clock.h"
+#include <array>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
@@ -47,6 +48,8 @@ public:
     void renderables_in_frame(SubCompositorId id, graphics::RenderableList const& renderables) override;
     void rendered_frame(SubCompositorId id) override;
     void finished_frame(SubCompositorId id) override;
+    void frame_reached_stage(SubCompositorId id, compositor::FrameStage stage) override;
+    void rendered_on_gpu(SubCompositorId id, std::chrono::nanoseconds gpu_time) override;
     void started() override;
     void stopped() override;
     void scheduled() override;
@@ -76,7 +79,20 @@ private:
         long last_reported_nframes = 0;
         long last_reported_bypassed = 0;
 
+        // The time from the start of a frame to each stage, summed over the frames reaching it
+        static int const stages = static_cast<int>(compositor::FrameStage::flip_completed) + 1;
+        std::array<std::chrono::nanoseconds, stages> stage_time_sum{};
+        std::array<long, stages> nstage{};
+        std::chrono::nanoseconds gpu_time_sum{0};
+        long ngpu = 0;
+
+        std::array<std::chrono::nanoseconds, stages> last_reported_stage_time_sum{};
+        std::array<long, stages> last_reported_nstage{};
+        std::chrono::nanoseconds last_reported_gpu_time_sum{0};
+        long last_reported_ngpu = 0;
+
         void log(mir::logging::Logger& logger, SubCompositorId id);
+        void log_stages(mir::logging::Logger& logger, SubCompositorId id);
     };
 
     std::mutex mutex; // Protects the following...
@@ -23,15 +23,19 @@
 
 #include <linux/input.h>
 
+#include <algorithm>
 #include <sstream>
 #include <cstring>
-#include <mutex>
+#include <cstdio>
 
 namespace mrl = mir::report::logging;
 namespace ml = mir::logging;
 
-mrl::InputReport::InputReport(const std::shared_ptr<ml::Logger>& logger)
-    : logger(logger)
+mrl::InputReport::InputReport(const std::shared_ptr<ml::Logger>& logger,
+                              std::shared_ptr<mir::time::Clock> const& clock)
+    : logger(logger),
+      clock(clock),
+      last_latency_report(clock->now())
 {
 }
 
@@ -43,6 +47,17 @@ const char* mrl::InputReport::component()
 
 namespace
 {
+auto const min_latency_report_interval = std::chrono::seconds(1);
+
+char const* stage_names[] =
+{
+    "converted",
+    "seat dispatched",
+    "filtered",
+    "surface dispatched",
+    "sent to client"
+};
+
 #define PRINT_EV_ENUM(value, name) if (value == name) { return # name; }
 
 std::string print_evdev_type(int type)
@@ -173,3 +188,102 @@ void mrl::InputReport::failed_to_open_input_device(char const* device_name, char
 
     logger->log(ml::Severity::informational, ss.str(), component());
 }
+
+void mrl::InputReport::LatencyHistogram::add(int64_t latency_usec)
+{
+    auto const value = static_cast<uint64_t>(std::max<int64_t>(latency_usec, 0));
+
+    int bucket = value;
+    if (value >= sub_buckets)
+    {
+        // Keep the top five significant bits: the leading one and four below it
+        int const msb = 63 - __builtin_clzll(value);
+        int const shift = msb - 4;
+        bucket = (shift + 1) * sub_buckets + static_cast<int>((value >> shift) - sub_buckets);
+    }
+
+    count[std::min(bucket, buckets - 1)].fetch_add(1, std::memory_order_relaxed);
+
+    int64_t seen = max.load(std::memory_order_relaxed);
+    while (seen < static_cast<int64_t>(value) &&
+           !max.compare_exchange_weak(seen, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+namespace
+{
+template<typename Counts>
+int64_t percentile(Counts const& count, uint32_t total, int64_t max, int sub_buckets, int percent)
+{
+    uint64_t const wanted = (uint64_t{total} * percent + 99) / 100;
+    uint64_t seen = 0;
+
+    for (int bucket = 0; bucket != static_cast<int>(count.size()); ++bucket)
+    {
+        seen += count[bucket];
+        if (seen >= wanted)
+        {
+            if (bucket < sub_buckets)
+                return bucket;
+
+            int const shift = bucket / sub_buckets - 1;
+            return std::min<int64_t>(int64_t{sub_buckets + bucket % sub_buckets} << shift, max);
+        }
+    }
+
+    return max;
+}
+}
+
+void mrl::InputReport::LatencyHistogram::log(ml::Logger& logger, char const* stage_name)
+{
+    std::array<uint32_t, buckets> drained;
+    uint32_t total = 0;
+
+    for (int bucket = 0; bucket != buckets; ++bucket)
+        total += drained[bucket] = count[bucket].exchange(0, std::memory_order_relaxed);
+
+    auto const max = this->max.exchange(0, std::memory_order_relaxed);
+
+    if (!total)
+        return;
+
+    auto const p50 = percentile(drained, total, max, sub_buckets, 50);
+    auto const p90 = percentile(drained, total, max, sub_buckets, 90);
+    auto const p99 = percentile(drained, total, max, sub_buckets, 99);
+
+    char msg[192];
+    snprintf(msg, sizeof msg, "Latency to %s: %u events, "
+             "p50 %ld.%03ld ms, p90 %ld.%03ld ms, p99 %ld.%03ld ms, max %ld.%03ld ms",
+             stage_name,
+             total,
+             long(p50 / 1000), long(p50 % 1000),
+             long(p90 / 1000), long(p90 % 1000),
+             long(p99 / 1000), long(p99 % 1000),
+             long(max / 1000), long(max % 1000));
+
+    logger.log(ml::Severity::informational, msg, "input");
+}
+
+void mrl::InputReport::event_reached_stage(mir::input::InputPipelineStage stage, int64_t event_time)
+{
+    auto const now = clock->now();
+    auto const event_latency = now.time_since_epoch() - std::chrono::nanoseconds{event_time};
+
+    latency[static_cast<int>(stage)].add(
+        std::chrono::duration_cast<std::chrono::microseconds>(event_latency).count());
+
+    /*
+     * Percentiles are over whatever arrived since the last summary; the exact
+     * interval doesn't matter, only that it is short enough to show spikes.
+     * Whichever thread moves last_latency_report on is the one that logs.
+     */
+    auto last = last_latency_report.load(std::memory_order_relaxed);
+    if ((now - last) >= min_latency_report_interval &&
+        last_latency_report.compare_exchange_strong(last, now, std::memory_order_relaxed))
+    {
+        for (int i = 0; i != stages; ++i)
+            latency[i].log(*logger, stage_names[i]);
+    }
+}
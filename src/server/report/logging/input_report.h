@@ -20,7 +20,10 @@
 #define MIR_REPORT_LOGGING_INPUT_REPORT_H_
 
 #include "mir/input/input_report.h"
+#include "mir/time/clock.h"
 
+#include <array>
+#include <atomic>
 #include <memory>
 
 namespace mir
@@ -37,7 +40,8 @@ namespace logging
 class InputReport : public input::InputReport
 {
 public:
-    InputReport(std::shared_ptr<mir::logging::Logger> const& logger);
+    InputReport(std::shared_ptr<mir::logging::Logger> const& logger,
+                std::shared_ptr<time::Clock> const& clock);
     virtual ~InputReport() noexcept(true) = default;
 
     void received_event_from_kernel(int64_t when, int type, int code, int value) override;
@@ -47,9 +51,33 @@ public:
 
     void opened_input_device(char const* device_name, char const* input_platform) override;
     void failed_to_open_input_device(char const* device_name, char const* input_platform) override;
+
+    void event_reached_stage(input::InputPipelineStage stage, int64_t event_time) override;
 private:
     char const* component();
     std::shared_ptr<mir::logging::Logger> const logger;
+    std::shared_ptr<time::Clock> const clock;
+
+    // Log-linear histogram of latencies in microseconds: exact below 16us,
+    // then 16 buckets per power of two (so within ~6% of the true value).
+    // Counters are atomic so that reporting threads never wait on each other;
+    // log() drains them, so an event racing with it lands in one summary or the next.
+    struct LatencyHistogram
+    {
+        static int const sub_buckets = 16;
+        static int const buckets = 28 * sub_buckets;
+
+        std::array<std::atomic<uint32_t>, buckets> count{};
+        std::atomic<int64_t> max{0};
+
+        void add(int64_t latency_usec);
+        void log(mir::logging::Logger& logger, char const* stage_name);
+    };
+
+    static int const stages = static_cast<int>(input::InputPipelineStage::sent_to_client) + 1;
+
+    std::array<LatencyHistogram, stages> latency;
+    std::atomic<time::Timestamp> last_latency_report;
 };
 
 }
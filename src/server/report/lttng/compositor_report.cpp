@@ -62,3 +62,13 @@ void mir::report::lttng::CompositorReport::finished_frame(SubCompositorId id)
 {
     mir_tracepoint(mir_server_compositor, finished_frame, id);
 }
+
+void mir::report::lttng::CompositorReport::frame_reached_stage(SubCompositorId id, compositor::FrameStage stage)
+{
+    mir_tracepoint(mir_server_compositor, frame_reached_stage, id, static_cast<int>(stage));
+}
+
+void mir::report::lttng::CompositorReport::rendered_on_gpu(SubCompositorId id, std::chrono::nanoseconds gpu_time)
+{
+    mir_tracepoint(mir_server_compositor, rendered_on_gpu, id, gpu_time.count());
+}
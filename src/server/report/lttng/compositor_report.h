@@ -40,6 +40,8 @@ public:
     void renderables_in_frame(SubCompositorId id, graphics::RenderableList const& renderables) override;
     void rendered_frame(SubCompositorId id) override;
     void finished_frame(SubCompositorId id) override;
+    void frame_reached_stage(SubCompositorId id, compositor::FrameStage stage) override;
+    void rendered_on_gpu(SubCompositorId id, std::chrono::nanoseconds gpu_time) override;
     void started() override;
     void stopped() override;
     void scheduled() override;
@@ -77,6 +77,26 @@ TRACEPOINT_EVENT(
     )
 )
 
+TRACEPOINT_EVENT(
+    mir_server_compositor,
+    frame_reached_stage,
+    TP_ARGS(void const*, id, int, stage),
+    TP_FIELDS(
+        ctf_integer_hex(uintptr_t, id, (uintptr_t)(id))
+        ctf_integer(int, stage, stage)
+    )
+)
+
+TRACEPOINT_EVENT(
+    mir_server_compositor,
+    rendered_on_gpu,
+    TP_ARGS(void const*, id, int64_t, gpu_time),
+    TP_FIELDS(
+        ctf_integer_hex(uintptr_t, id, (uintptr_t)(id))
+        ctf_integer(int64_t, gpu_time, gpu_time)
+    )
+)
+
 TRACEPOINT_EVENT(
     mir_server_compositor,
     buffers_in_frame,
@@ -24,6 +24,8 @@
 #define TRACEPOINT_PROBE_DYNAMIC_LINKAGE
 #include "input_report_tp.h"
 
+#include <chrono>
+
 void mir::report::lttng::InputReport::received_event_from_kernel(int64_t when, int type, int code, int value)
 {
     mir_tracepoint(mir_server_input, received_event_from_kernel, when, type, code, value);
@@ -48,3 +50,10 @@ void mir::report::lttng::InputReport::failed_to_open_input_device(char const* na
 {
     mir_tracepoint(mir_server_input, failed_to_open_input_device, name, platform);
 }
+
+void mir::report::lttng::InputReport::event_reached_stage(mir::input::InputPipelineStage stage, int64_t event_time)
+{
+    int64_t const now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    mir_tracepoint(mir_server_input, event_reached_stage, static_cast<int>(stage), event_time, now - event_time);
+}
@@ -81,6 +81,17 @@ TRACEPOINT_EVENT(
     )
 )
 
+TRACEPOINT_EVENT(
+    mir_server_input,
+    event_reached_stage,
+    TP_ARGS(int, stage, int64_t, event_time, int64_t, latency),
+    TP_FIELDS(
+        ctf_integer(int, stage, stage)
+        ctf_integer(int64_t, event_time, event_time)
+        ctf_integer(int64_t, latency, latency)
+    )
+)
+
 #endif /* MIR_LTTNG_DISPLAY_REPORT_TP_H_ */
 
 #include <lttng/tracepoint-event.h>
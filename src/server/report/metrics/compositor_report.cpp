@@ -0,0 +1,144 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "compositor_report.h"
+#include "registry.h"
+
+#include "mir/graphics/renderable.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace mrm = mir::report::metrics;
+
+namespace
+{
+// Each compositing thread works through its displays' frames one at a time,
+// so the frame in progress is tracked per thread rather than under a lock
+struct Frame
+{
+    mrm::CompositorReport const* report;
+    mir::compositor::CompositorReport::SubCompositorId id;
+    mir::time::Timestamp began;
+    mir::time::Timestamp finished;
+    bool bypassed;
+};
+
+thread_local std::vector<Frame> frames_on_this_thread;
+
+auto frame_for(mrm::CompositorReport const* report, mir::compositor::CompositorReport::SubCompositorId id) -> Frame&
+{
+    auto const frame = std::find_if(frames_on_this_thread.begin(), frames_on_this_thread.end(),
+        [&](Frame const& frame) { return frame.report == report && frame.id == id; });
+
+    if (frame != frames_on_this_thread.end())
+        return *frame;
+
+    frames_on_this_thread.push_back({report, id, {}, {}, true});
+    return frames_on_this_thread.back();
+}
+}
+
+mrm::CompositorReport::CompositorReport(std::shared_ptr<Registry> const& registry, std::shared_ptr<time::Clock> const& clock) :
+    registry{registry},
+    clock{clock},
+    frames{registry->counter("mir_compositor_frames", "Frames composited")},
+    bypassed_frames{registry->counter("mir_compositor_bypassed_frames", "Frames scanned out directly from a client buffer")},
+    displays{registry->gauge("mir_compositor_displays", "Displays being composited")},
+    renderables{registry->gauge("mir_compositor_renderables", "Renderables in the most recent frame")},
+    frame_interval{registry->histogram("mir_compositor_frame_interval_seconds", "Time between frames on a display")},
+    render_time{registry->histogram("mir_compositor_render_time_seconds", "Time to render a frame")},
+    latency{registry->histogram("mir_compositor_latency_seconds", "Time from compositing being scheduled to a frame starting")},
+    gpu_time{registry->histogram("mir_compositor_gpu_time_seconds", "GPU time spent drawing a frame")}
+{
+    char const* const stage_names[stages] = {"scene_snapshotted", "textures_bound", "draw_submitted", "flip_completed"};
+
+    for (int stage = 0; stage != stages; ++stage)
+    {
+        stage_time[stage] = registry->histogram(
+            "mir_compositor_frame_stage_seconds", "Time from the start of a frame to reaching a stage",
+            {{"stage", stage_names[stage]}});
+    }
+}
+
+void mrm::CompositorReport::added_display(int, int, int, int, SubCompositorId)
+{
+    displays->add(1);
+}
+
+void mrm::CompositorReport::began_frame(SubCompositorId id)
+{
+    auto const now = clock->now();
+    auto& frame = frame_for(this, id);
+    frame.began = now;
+    frame.bypassed = true;
+
+    auto const scheduled = last_scheduled.load(std::memory_order_relaxed);
+    if (scheduled)
+        latency->record(now.time_since_epoch() - time::Timestamp::duration{scheduled});
+}
+
+void mrm::CompositorReport::renderables_in_frame(SubCompositorId, graphics::RenderableList const& list)
+{
+    renderables->set(list.size());
+}
+
+void mrm::CompositorReport::rendered_frame(SubCompositorId id)
+{
+    auto& frame = frame_for(this, id);
+    render_time->record(clock->now() - frame.began);
+    frame.bypassed = false;
+}
+
+void mrm::CompositorReport::finished_frame(SubCompositorId id)
+{
+    auto const now = clock->now();
+    auto& frame = frame_for(this, id);
+
+    if (frame.finished != time::Timestamp{})
+        frame_interval->record(now - frame.finished);
+    frame.finished = now;
+
+    frames->add();
+    if (frame.bypassed)
+        bypassed_frames->add();
+}
+
+void mrm::CompositorReport::frame_reached_stage(SubCompositorId id, compositor::FrameStage stage)
+{
+    auto const& frame = frame_for(this, id);
+    stage_time[static_cast<int>(stage)]->record(clock->now() - frame.began);
+}
+
+void mrm::CompositorReport::rendered_on_gpu(SubCompositorId, std::chrono::nanoseconds duration)
+{
+    gpu_time->record(duration);
+}
+
+void mrm::CompositorReport::started()
+{
+}
+
+void mrm::CompositorReport::stopped()
+{
+    // Displays are added again when compositing restarts
+    displays->set(0);
+}
+
+void mrm::CompositorReport::scheduled()
+{
+    last_scheduled.store(clock->now().time_since_epoch().count(), std::memory_order_relaxed);
+}
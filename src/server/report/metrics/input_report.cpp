@@ -0,0 +1,80 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "input_report.h"
+#include "registry.h"
+
+#include "mir/time/clock.h"
+
+namespace mrm = mir::report::metrics;
+
+namespace
+{
+char const* const latency_name = "mir_input_latency_seconds";
+char const* const latency_help = "Time from the kernel timestamping an input event to it reaching a pipeline stage";
+
+auto latency_for(mrm::Registry& registry, char const* stage) -> std::shared_ptr<mrm::Histogram>
+{
+    return registry.histogram(latency_name, latency_help, {{"stage", stage}});
+}
+}
+
+mrm::InputReport::InputReport(std::shared_ptr<Registry> const& registry, std::shared_ptr<time::Clock> const& clock) :
+    registry{registry},
+    clock{clock},
+    kernel_events{registry->counter("mir_input_kernel_events", "Events read from input devices")},
+    published_key_events{registry->counter("mir_input_published_events", "Events sent to clients", {{"type", "key"}})},
+    published_motion_events{registry->counter("mir_input_published_events", "Events sent to clients", {{"type", "motion"}})},
+    opened_devices{registry->counter("mir_input_devices_opened", "Input devices opened")},
+    failed_devices{registry->counter("mir_input_devices_failed", "Input devices that failed to open")},
+    latency{{
+        latency_for(*registry, "converted"),
+        latency_for(*registry, "seat_dispatched"),
+        latency_for(*registry, "filtered"),
+        latency_for(*registry, "surface_dispatched"),
+        latency_for(*registry, "sent_to_client")}}
+{
+}
+
+void mrm::InputReport::received_event_from_kernel(int64_t, int, int, int)
+{
+    kernel_events->add();
+}
+
+void mrm::InputReport::published_key_event(int, uint32_t, int64_t)
+{
+    published_key_events->add();
+}
+
+void mrm::InputReport::published_motion_event(int, uint32_t, int64_t)
+{
+    published_motion_events->add();
+}
+
+void mrm::InputReport::opened_input_device(char const*, char const*)
+{
+    opened_devices->add();
+}
+
+void mrm::InputReport::failed_to_open_input_device(char const*, char const*)
+{
+    failed_devices->add();
+}
+
+void mrm::InputReport::event_reached_stage(input::InputPipelineStage stage, int64_t event_time)
+{
+    latency[static_cast<int>(stage)]->record(clock->now().time_since_epoch() - std::chrono::nanoseconds{event_time});
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "message_processor_report.h"
+#include "registry.h"
+
+#include <functional>
+
+namespace mrm = mir::report::metrics;
+
+mrm::MessageProcessorReport::MessageProcessorReport(std::shared_ptr<Registry> const& registry, std::shared_ptr<time::Clock> const& clock) :
+    registry{registry},
+    clock{clock},
+    calls{registry->counter("mir_rpc_calls", "Remote procedure calls from clients")},
+    unknown_methods{registry->counter("mir_rpc_unknown_methods", "Calls to methods the server doesn't know")},
+    exceptions{registry->counter("mir_rpc_exceptions", "Calls that threw an exception")},
+    duration{registry->histogram("mir_rpc_duration_seconds", "Time from receiving a call to completing it")}
+{
+}
+
+auto mrm::MessageProcessorReport::shard_for(void const* mediator) -> Shard&
+{
+    return shards[std::hash<void const*>{}(mediator) % shards.size()];
+}
+
+void mrm::MessageProcessorReport::received_invocation(void const* mediator, int id, std::string const&)
+{
+    calls->add();
+
+    auto const now = clock->now();
+    auto& shard = shard_for(mediator);
+
+    std::lock_guard<std::mutex> lock{shard.mutex};
+    shard.started[{mediator, id}] = now;
+}
+
+void mrm::MessageProcessorReport::completed_invocation(void const* mediator, int id, bool)
+{
+    auto const now = clock->now();
+    auto& shard = shard_for(mediator);
+
+    std::unique_lock<std::mutex> lock{shard.mutex};
+    auto const call = shard.started.find({mediator, id});
+    if (call == shard.started.end())
+        return;
+
+    auto const start = call->second;
+    shard.started.erase(call);
+    lock.unlock();
+
+    duration->record(now - start);
+}
+
+void mrm::MessageProcessorReport::unknown_method(void const*, int, std::string const&)
+{
+    unknown_methods->add();
+}
+
+void mrm::MessageProcessorReport::exception_handled(void const*, int, std::exception const&)
+{
+    exceptions->add();
+}
+
+void mrm::MessageProcessorReport::exception_handled(void const*, std::exception const&)
+{
+    exceptions->add();
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_REPORT_METRICS_MESSAGE_PROCESSOR_REPORT_H_
+#define MIR_REPORT_METRICS_MESSAGE_PROCESSOR_REPORT_H_
+
+#include "mir/frontend/message_processor_report.h"
+#include "mir/time/clock.h"
+
+#include <array>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace mir
+{
+namespace report
+{
+namespace metrics
+{
+class Registry;
+class Counter;
+class Histogram;
+
+class MessageProcessorReport : public frontend::MessageProcessorReport
+{
+public:
+    MessageProcessorReport(std::shared_ptr<Registry> const& registry, std::shared_ptr<time::Clock> const& clock);
+
+    void received_invocation(void const* mediator, int id, std::string const& method) override;
+    void completed_invocation(void const* mediator, int id, bool result) override;
+    void unknown_method(void const* mediator, int id, std::string const& method) override;
+    void exception_handled(void const* mediator, int id, std::exception const& error) override;
+    void exception_handled(void const* mediator, std::exception const& error) override;
+
+private:
+    std::shared_ptr<Registry> const registry;
+    std::shared_ptr<time::Clock> const clock;
+    std::shared_ptr<Counter> const calls;
+    std::shared_ptr<Counter> const unknown_methods;
+    std::shared_ptr<Counter> const exceptions;
+    std::shared_ptr<Histogram> const duration;
+
+    // Calls may complete on another thread, so the start times are kept in a
+    // map. It's split by mediator so that connections don't contend for a lock.
+    struct Shard
+    {
+        std::mutex mutex;
+        std::map<std::pair<void const*, int>, time::Timestamp> started;
+    };
+
+    auto shard_for(void const* mediator) -> Shard&;
+
+    std::array<Shard, 8> shards;
+};
+}
+}
+}
+
+#endif /* MIR_REPORT_METRICS_MESSAGE_PROCESSOR_REPORT_H_ */
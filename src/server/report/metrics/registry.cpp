@@ -0,0 +1,274 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "registry.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <algorithm>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace mrm = mir::report::metrics;
+
+namespace
+{
+std::atomic<unsigned> next_shard{0};
+
+// Threads are spread over the shards in the order they first record a metric
+auto this_threads_shard() -> unsigned
+{
+    thread_local unsigned const shard = next_shard.fetch_add(1, std::memory_order_relaxed) % mrm::shards;
+    return shard;
+}
+
+auto escaped(std::string const& value) -> std::string
+{
+    std::string result;
+    for (auto const c : value)
+    {
+        switch (c)
+        {
+        case '\\': result += "\\\\"; break;
+        case '"':  result += "\\\""; break;
+        case '\n': result += "\\n";  break;
+        default:   result += c;
+        }
+    }
+    return result;
+}
+
+// The label set in exposition form: {name="value",...} (or "" for no labels)
+auto format_labels(mrm::Labels const& labels) -> std::string
+{
+    if (labels.empty())
+        return {};
+
+    std::string result{"{"};
+    for (auto const& label : labels)
+    {
+        if (result.size() > 1)
+            result += ',';
+        result += label.first + "=\"" + escaped(label.second) + '"';
+    }
+    return result + '}';
+}
+
+// Adds a label to an already formatted label set
+auto with_label(std::string const& labels, std::string const& label) -> std::string
+{
+    if (labels.empty())
+        return '{' + label + '}';
+
+    return labels.substr(0, labels.size() - 1) + ',' + label + '}';
+}
+
+void write_family_header(std::ostream& out, std::string const& name, char const* type, std::string const& help)
+{
+    out << "# TYPE " << name << ' ' << type << '\n';
+    out << "# HELP " << name << ' ' << escaped(help) << '\n';
+}
+
+auto bucket_for(std::uint64_t usec) -> int
+{
+    int bucket = usec;
+    if (usec >= mrm::Histogram::sub_buckets)
+    {
+        // Keep the top five significant bits: the leading one and four below it
+        int const msb = 63 - __builtin_clzll(usec);
+        int const shift = msb - 4;
+        bucket = (shift + 1) * mrm::Histogram::sub_buckets + static_cast<int>((usec >> shift) - mrm::Histogram::sub_buckets);
+    }
+
+    return std::min(bucket, mrm::Histogram::buckets - 1);
+}
+
+// The smallest duration counted in bucket
+auto bucket_floor_usec(int bucket) -> std::uint64_t
+{
+    if (bucket < mrm::Histogram::sub_buckets)
+        return bucket;
+
+    int const shift = bucket / mrm::Histogram::sub_buckets - 1;
+    return std::uint64_t(mrm::Histogram::sub_buckets + bucket % mrm::Histogram::sub_buckets) << shift;
+}
+}
+
+void mrm::Counter::add(std::uint64_t n)
+{
+    shard[this_threads_shard()].value.fetch_add(n, std::memory_order_relaxed);
+}
+
+auto mrm::Counter::value() const -> std::uint64_t
+{
+    std::uint64_t result{0};
+    for (auto const& s : shard)
+        result += s.value.load(std::memory_order_relaxed);
+    return result;
+}
+
+void mrm::Gauge::set(std::int64_t value)
+{
+    current.store(value, std::memory_order_relaxed);
+}
+
+void mrm::Gauge::add(std::int64_t n)
+{
+    current.fetch_add(n, std::memory_order_relaxed);
+}
+
+auto mrm::Gauge::value() const -> std::int64_t
+{
+    return current.load(std::memory_order_relaxed);
+}
+
+void mrm::Histogram::record(std::chrono::nanoseconds duration)
+{
+    auto const usec = static_cast<std::uint64_t>(
+        std::max<std::int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count(), 0));
+
+    auto& s = shard[this_threads_shard()];
+    s.count[bucket_for(usec)].fetch_add(1, std::memory_order_relaxed);
+    s.sum_usec.fetch_add(usec, std::memory_order_relaxed);
+}
+
+auto mrm::Histogram::summarize(std::vector<double> const& quantiles) -> Summary
+{
+    std::array<std::uint64_t, buckets> total{};
+    std::uint64_t sum_usec{0};
+
+    for (auto const& s : shard)
+    {
+        for (int bucket = 0; bucket != buckets; ++bucket)
+            total[bucket] += s.count[bucket].load(std::memory_order_relaxed);
+        sum_usec += s.sum_usec.load(std::memory_order_relaxed);
+    }
+
+    // Quantiles of everything since the last summary show spikes that would
+    // vanish into a lifetime distribution
+    std::array<std::uint64_t, buckets> recent;
+    std::uint64_t count{0};
+    std::uint64_t recent_count{0};
+    for (int bucket = 0; bucket != buckets; ++bucket)
+    {
+        recent[bucket] = total[bucket] - summarized[bucket];
+        count += total[bucket];
+        recent_count += recent[bucket];
+    }
+    summarized = total;
+
+    Summary summary{count, sum_usec * 1e-6, {}};
+
+    for (auto const q : quantiles)
+    {
+        auto const wanted = std::max<std::uint64_t>(std::uint64_t(q * recent_count + 0.5), 1);
+        std::uint64_t seen{0};
+        int bucket = 0;
+        while (bucket != buckets - 1 && (seen += recent[bucket]) < wanted)
+            ++bucket;
+
+        summary.quantile_seconds.emplace_back(q, recent_count ? bucket_floor_usec(bucket) * 1e-6 : 0.0);
+    }
+
+    return summary;
+}
+
+template<typename Metric>
+auto mrm::Registry::find_or_create(
+    std::map<std::string, Family<Metric>>& families,
+    std::string const& name, std::string const& help, Labels const& labels) -> std::shared_ptr<Metric>
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    auto family = families.find(name);
+    if (family == families.end())
+    {
+        check_name_unused(name);
+        family = families.emplace(name, Family<Metric>{help, {}}).first;
+    }
+
+    auto& metric = family->second.metrics[format_labels(labels)];
+    if (!metric)
+        metric = std::make_shared<Metric>();
+
+    return metric;
+}
+
+void mrm::Registry::check_name_unused(std::string const& name) const
+{
+    if (counters.count(name) || gauges.count(name) || histograms.count(name))
+        BOOST_THROW_EXCEPTION(std::logic_error{"Metric \"" + name + "\" already registered with another type"});
+}
+
+auto mrm::Registry::counter(std::string const& name, std::string const& help, Labels const& labels)
+-> std::shared_ptr<Counter>
+{
+    return find_or_create(counters, name, help, labels);
+}
+
+auto mrm::Registry::gauge(std::string const& name, std::string const& help, Labels const& labels)
+-> std::shared_ptr<Gauge>
+{
+    return find_or_create(gauges, name, help, labels);
+}
+
+auto mrm::Registry::histogram(std::string const& name, std::string const& help, Labels const& labels)
+-> std::shared_ptr<Histogram>
+{
+    return find_or_create(histograms, name, help, labels);
+}
+
+void mrm::Registry::write_openmetrics(std::ostream& out)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    auto const precision = out.precision(9);
+
+    for (auto const& family : counters)
+    {
+        write_family_header(out, family.first, "counter", family.second.help);
+        for (auto const& metric : family.second.metrics)
+            out << family.first << "_total" << metric.first << ' ' << metric.second->value() << '\n';
+    }
+
+    for (auto const& family : gauges)
+    {
+        write_family_header(out, family.first, "gauge", family.second.help);
+        for (auto const& metric : family.second.metrics)
+            out << family.first << metric.first << ' ' << metric.second->value() << '\n';
+    }
+
+    for (auto const& family : histograms)
+    {
+        write_family_header(out, family.first, "summary", family.second.help);
+        for (auto const& metric : family.second.metrics)
+        {
+            auto const summary = metric.second->summarize({0.5, 0.9, 0.99, 0.999});
+
+            for (auto const& quantile : summary.quantile_seconds)
+            {
+                std::ostringstream label;
+                label << "quantile=\"" << quantile.first << '"';
+                out << family.first << with_label(metric.first, label.str()) << ' ' << quantile.second << '\n';
+            }
+            out << family.first << "_sum" << metric.first << ' ' << summary.sum_seconds << '\n';
+            out << family.first << "_count" << metric.first << ' ' << summary.count << '\n';
+        }
+    }
+
+    out << "# EOF\n";
+    out.precision(precision);
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_REPORT_METRICS_REGISTRY_H_
+#define MIR_REPORT_METRICS_REGISTRY_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mir
+{
+namespace report
+{
+namespace metrics
+{
+/// Metrics are updated by several threads at once; each thread updates its own
+/// shard (so they don't contend for a cache line), and a scrape sums them.
+unsigned const shards = 8;
+
+/// Shards are padded apart (rather than aligned, as the allocator needn't honour that)
+std::size_t const cache_line = 64;
+
+/// A count that only goes up
+class Counter
+{
+public:
+    void add(std::uint64_t n = 1);
+    auto value() const -> std::uint64_t;
+
+private:
+    struct Shard
+    {
+        std::atomic<std::uint64_t> value{0};
+        char padding[cache_line - sizeof value];
+    };
+
+    std::array<Shard, shards> shard;
+};
+
+/// A value that goes up and down
+class Gauge
+{
+public:
+    void set(std::int64_t value);
+    void add(std::int64_t n);
+    auto value() const -> std::int64_t;
+
+private:
+    std::atomic<std::int64_t> current{0};
+};
+
+/**
+ * A distribution of durations, exposed as quantiles.
+ *
+ * Durations are counted in log-linear microsecond buckets: exact below 16us,
+ * then 16 buckets per power of two (so within ~6% of the true value).
+ */
+class Histogram
+{
+public:
+    void record(std::chrono::nanoseconds duration);
+
+    struct Summary
+    {
+        std::uint64_t count;
+        double sum_seconds;
+        /// Quantiles of the durations recorded since the previous summary
+        std::vector<std::pair<double, double>> quantile_seconds;
+    };
+
+    /// Not thread safe: the Registry serializes calls
+    auto summarize(std::vector<double> const& quantiles) -> Summary;
+
+    static int const sub_buckets = 16;
+    static int const buckets = 28 * sub_buckets;
+
+private:
+    struct Shard
+    {
+        std::array<std::atomic<std::uint32_t>, buckets> count{};
+        std::atomic<std::uint64_t> sum_usec{0};
+        char padding[cache_line];
+    };
+
+    std::array<Shard, shards> shard;
+    std::array<std::uint64_t, buckets> summarized{};
+};
+
+/// Labels distinguishing the metrics in a family, e.g. {{"stage", "filtered"}}
+using Labels = std::vector<std::pair<std::string, std::string>>;
+
+/**
+ * The metrics the "metrics" reports record, written out in the OpenMetrics
+ * text format on request.
+ *
+ * Asking for a metric that already exists returns the existing one, so
+ * several reports can share a metric.
+ */
+class Registry
+{
+public:
+    auto counter(std::string const& name, std::string const& help, Labels const& labels = {})
+        -> std::shared_ptr<Counter>;
+    auto gauge(std::string const& name, std::string const& help, Labels const& labels = {})
+        -> std::shared_ptr<Gauge>;
+    auto histogram(std::string const& name, std::string const& help, Labels const& labels = {})
+        -> std::shared_ptr<Histogram>;
+
+    void write_openmetrics(std::ostream& out);
+
+private:
+    template<typename Metric>
+    struct Family
+    {
+        std::string help;
+        std::map<std::string, std::shared_ptr<Metric>> metrics;
+    };
+
+    template<typename Metric>
+    auto find_or_create(
+        std::map<std::string, Family<Metric>>& families,
+        std::string const& name, std::string const& help, Labels const& labels) -> std::shared_ptr<Metric>;
+
+    void check_name_unused(std::string const& name) const;
+
+    std::mutex mutex;
+    std::map<std::string, Family<Counter>> counters;
+    std::map<std::string, Family<Gauge>> gauges;
+    std::map<std::string, Family<Histogram>> histograms;
+};
+}
+}
+}
+
+#endif /* MIR_REPORT_METRICS_REGISTRY_H_ */
@@ -0,0 +1,46 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "scene_report.h"
+#include "registry.h"
+
+namespace mrm = mir::report::metrics;
+
+mrm::SceneReport::SceneReport(std::shared_ptr<Registry> const& registry) :
+    registry{registry},
+    created{registry->counter("mir_scene_surfaces_created", "Surfaces created")},
+    in_scene{registry->gauge("mir_scene_surfaces", "Surfaces in the scene")}
+{
+}
+
+void mrm::SceneReport::surface_created(BasicSurfaceId, std::string const&)
+{
+    created->add();
+}
+
+void mrm::SceneReport::surface_added(BasicSurfaceId, std::string const&)
+{
+    in_scene->add(1);
+}
+
+void mrm::SceneReport::surface_removed(BasicSurfaceId, std::string const&)
+{
+    in_scene->add(-1);
+}
+
+void mrm::SceneReport::surface_deleted(BasicSurfaceId, std::string const&)
+{
+}
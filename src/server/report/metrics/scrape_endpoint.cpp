@@ -0,0 +1,130 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "scrape_endpoint.h"
+#include "registry.h"
+
+#include "mir/dispatch/readable_fd.h"
+#include "mir/dispatch/threaded_dispatcher.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <sstream>
+#include <system_error>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace mrm = mir::report::metrics;
+
+namespace
+{
+auto address_of(std::string const& socket_file) -> sockaddr_un
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+
+    if (socket_file.size() >= sizeof address.sun_path)
+        BOOST_THROW_EXCEPTION(std::invalid_argument{"Metrics socket path too long: " + socket_file});
+
+    socket_file.copy(address.sun_path, socket_file.size());
+    return address;
+}
+
+auto new_socket(int flags) -> mir::Fd
+{
+    mir::Fd fd{socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | flags, 0)};
+    if (fd < 0)
+        BOOST_THROW_EXCEPTION((std::system_error{errno, std::system_category(), "Failed to create metrics socket"}));
+    return fd;
+}
+
+// A socket file nothing is listening on is left over from a server that didn't exit cleanly
+bool is_stale(sockaddr_un const& address)
+{
+    auto const probe = new_socket(0);
+    return connect(probe, reinterpret_cast<sockaddr const*>(&address), sizeof address) != 0 && errno == ECONNREFUSED;
+}
+
+auto listen_on(std::string const& socket_file) -> mir::Fd
+{
+    auto const address = address_of(socket_file);
+    auto const fd = new_socket(SOCK_NONBLOCK);
+
+    auto const bind_to_address = [&]
+        { return bind(fd, reinterpret_cast<sockaddr const*>(&address), sizeof address) == 0; };
+
+    if (!bind_to_address())
+    {
+        if (errno != EADDRINUSE || !is_stale(address) || unlink(socket_file.c_str()) != 0 || !bind_to_address())
+        {
+            BOOST_THROW_EXCEPTION((std::system_error{
+                errno, std::system_category(), "Failed to bind metrics socket " + socket_file}));
+        }
+    }
+
+    if (listen(fd, SOMAXCONN) != 0)
+    {
+        BOOST_THROW_EXCEPTION((std::system_error{
+            errno, std::system_category(), "Failed to listen on metrics socket " + socket_file}));
+    }
+
+    return fd;
+}
+}
+
+mrm::ScrapeEndpoint::ScrapeEndpoint(std::string const& socket_file, std::shared_ptr<Registry> const& registry) :
+    socket_file{socket_file},
+    registry{registry},
+    socket{listen_on(socket_file)},
+    dispatcher{std::make_unique<dispatch::ThreadedDispatcher>(
+        "Mir/Metrics",
+        std::make_shared<dispatch::ReadableFd>(socket, [this] { serve_connection(); }))}
+{
+}
+
+mrm::ScrapeEndpoint::~ScrapeEndpoint()
+{
+    unlink(socket_file.c_str());
+}
+
+void mrm::ScrapeEndpoint::serve_connection()
+{
+    Fd const connection{accept4(socket, nullptr, nullptr, SOCK_CLOEXEC)};
+    if (connection < 0)
+        return; // The client gave up before we got to it
+
+    // Don't let a client that doesn't read hold up the next one indefinitely
+    timeval const timeout{1, 0};
+    setsockopt(connection, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof timeout);
+
+    std::ostringstream metrics;
+    registry->write_openmetrics(metrics);
+    auto const text = metrics.str();
+
+    for (std::size_t written = 0; written != text.size();)
+    {
+        auto const result = send(connection, text.data() + written, text.size() - written, MSG_NOSIGNAL);
+        if (result < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return;
+        }
+        written += result;
+    }
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "session_mediator_report.h"
+#include "registry.h"
+
+namespace mrm = mir::report::metrics;
+
+namespace
+{
+char const* const request_names[] =
+{
+    "connect",
+    "create_surface",
+    "submit_buffer",
+    "allocate_buffers",
+    "release_buffers",
+    "release_surface",
+    "disconnect",
+    "configure_surface",
+    "configure_surface_cursor",
+    "configure_display",
+    "set_base_display_configuration",
+    "preview_base_display_configuration",
+    "confirm_base_display_configuration",
+    "start_prompt_session",
+    "stop_prompt_session",
+    "create_buffer_stream",
+    "release_buffer_stream"
+};
+
+static_assert(sizeof request_names / sizeof request_names[0] == mrm::SessionMediatorReport::request_count,
+    "Every request needs a name");
+
+auto counters_for_requests(mrm::Registry& registry)
+-> std::array<std::shared_ptr<mrm::Counter>, mrm::SessionMediatorReport::request_count>
+{
+    std::array<std::shared_ptr<mrm::Counter>, mrm::SessionMediatorReport::request_count> result;
+
+    for (int i = 0; i != mrm::SessionMediatorReport::request_count; ++i)
+        result[i] = registry.counter("mir_session_requests", "Requests from clients", {{"request", request_names[i]}});
+
+    return result;
+}
+}
+
+mrm::SessionMediatorReport::SessionMediatorReport(std::shared_ptr<Registry> const& registry) :
+    registry{registry},
+    requests(counters_for_requests(*registry))
+{
+}
+
+void mrm::SessionMediatorReport::session_connect_called(std::string const&)
+{
+    requests[connect]->add();
+}
+
+void mrm::SessionMediatorReport::session_create_surface_called(std::string const&)
+{
+    requests[create_surface]->add();
+}
+
+void mrm::SessionMediatorReport::session_submit_buffer_called(std::string const&)
+{
+    requests[submit_buffer]->add();
+}
+
+void mrm::SessionMediatorReport::session_allocate_buffers_called(std::string const&)
+{
+    requests[allocate_buffers]->add();
+}
+
+void mrm::SessionMediatorReport::session_release_buffers_called(std::string const&)
+{
+    requests[release_buffers]->add();
+}
+
+void mrm::SessionMediatorReport::session_release_surface_called(std::string const&)
+{
+    requests[release_surface]->add();
+}
+
+void mrm::SessionMediatorReport::session_disconnect_called(std::string const&)
+{
+    requests[disconnect]->add();
+}
+
+void mrm::SessionMediatorReport::session_configure_surface_called(std::string const&)
+{
+    requests[configure_surface]->add();
+}
+
+void mrm::SessionMediatorReport::session_configure_surface_cursor_called(std::string const&)
+{
+    requests[configure_surface_cursor]->add();
+}
+
+void mrm::SessionMediatorReport::session_configure_display_called(std::string const&)
+{
+    requests[configure_display]->add();
+}
+
+void mrm::SessionMediatorReport::session_set_base_display_configuration_called(std::string const&)
+{
+    requests[set_base_display_configuration]->add();
+}
+
+void mrm::SessionMediatorReport::session_preview_base_display_configuration_called(std::string const&)
+{
+    requests[preview_base_display_configuration]->add();
+}
+
+void mrm::SessionMediatorReport::session_confirm_base_display_configuration_called(std::string const&)
+{
+    requests[confirm_base_display_configuration]->add();
+}
+
+void mrm::SessionMediatorReport::session_start_prompt_session_called(std::string const&, pid_t)
+{
+    requests[start_prompt_session]->add();
+}
+
+void mrm::SessionMediatorReport::session_stop_prompt_session_called(std::string const&)
+{
+    requests[stop_prompt_session]->add();
+}
+
+void mrm::SessionMediatorReport::session_create_buffer_stream_called(std::string const&)
+{
+    requests[create_buffer_stream]->add();
+}
+
+void mrm::SessionMediatorReport::session_release_buffer_stream_called(std::string const&)
+{
+    requests[release_buffer_stream]->add();
+}
+
+void mrm::SessionMediatorReport::session_error(std::string const&, char const* method, std::string const&)
+{
+    // Errors are rare enough to look the counter up each time
+    registry->counter("mir_session_errors", "Requests from clients that failed", {{"request", method}})->add();
+}
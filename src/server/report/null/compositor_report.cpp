@@ -40,6 +40,14 @@ void mrn::CompositorReport::finished_frame(SubCompositorId)
 {
 }
 
+void mrn::CompositorReport::frame_reached_stage(SubCompositorId, mir::compositor::FrameStage)
+{
+}
+
+void mrn::CompositorReport::rendered_on_gpu(SubCompositorId, std::chrono::nanoseconds)
+{
+}
+
 void mrn::CompositorReport::started()
 {
 }
@@ -39,3 +39,7 @@ void mrn::InputReport::opened_input_device(char const* /* name */, char const* /
 void mrn::InputReport::failed_to_open_input_device(char const* /* name */, char const* /* platform */)
 {
 }
+
+void mrn::InputReport::event_reached_stage(mir::input::InputPipelineStage /* stage */, int64_t /* event_time */)
+{
+}
@@ -18,11 +18,15 @@
 
 #include "gl_pixel_buffer.h"
 #include "mir/graphics/buffer.h"
+#include "mir/graphics/pixel_conversion.h"
 #include "mir/renderer/gl/context.h"
 #include "mir/renderer/gl/texture_source.h"
 
+#include <cstdio>
+#include <cstring>
 #include <stdexcept>
 #include <boost/throw_exception.hpp>
+#include <EGL/egl.h>
 #include MIR_SERVER_GL_H
 #include MIR_SERVER_GLEXT_H
 
@@ -39,19 +43,60 @@ bool is_big_endian()
     return (*reinterpret_cast<char*>(&n) != 1);
 }
 
-inline uint32_t abgr_to_argb(uint32_t p)
+/* GLES 3.0 names missing from the GLES 2.0 headers we build against */
+GLenum const pixel_pack_buffer{0x88EB};             // GL_PIXEL_PACK_BUFFER
+GLenum const stream_read{0x88E1};                   // GL_STREAM_READ
+GLbitfield const map_read_bit{0x0001};              // GL_MAP_READ_BIT
+GLenum const sync_gpu_commands_complete{0x9117};    // GL_SYNC_GPU_COMMANDS_COMPLETE
+GLbitfield const sync_flush_commands_bit{0x0001};   // GL_SYNC_FLUSH_COMMANDS_BIT
+GLenum const timeout_expired{0x911B};               // GL_TIMEOUT_EXPIRED
+GLenum const wait_failed{0x911D};                   // GL_WAIT_FAILED
+GLuint64 const one_second_ns{1000000000};
+
+bool supports_pack_buffers()
 {
-    return ((p << 16) & 0x00ff0000) | /* Move R to new position */
-           ((p) & 0x0000ff00) |       /* G remains at same position */
-           ((p >> 16) & 0x000000ff) | /* Move B to new position */
-           ((p) & 0xff000000);        /* A remains at same position */
+    auto const version = reinterpret_cast<char const*>(glGetString(GL_VERSION));
+    int major{0};
+
+    return version &&
+           sscanf(version, "OpenGL ES %d.", &major) == 1 &&
+           major >= 3;
 }
 
+template<typename Function>
+void resolve(Function& function, char const* name)
+{
+    function = reinterpret_cast<Function>(eglGetProcAddress(name));
+}
 }
 
+struct ms::GLPixelBuffer::PackBufferFunctions
+{
+    void* (GL_APIENTRYP glMapBufferRange)(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+    GLboolean (GL_APIENTRYP glUnmapBuffer)(GLenum target);
+    GLsync (GL_APIENTRYP glFenceSync)(GLenum condition, GLbitfield flags);
+    GLenum (GL_APIENTRYP glClientWaitSync)(GLsync sync, GLbitfield flags, GLuint64 timeout);
+    void (GL_APIENTRYP glDeleteSync)(GLsync sync);
+
+    PackBufferFunctions()
+    {
+        resolve(glMapBufferRange, "glMapBufferRange");
+        resolve(glUnmapBuffer, "glUnmapBuffer");
+        resolve(glFenceSync, "glFenceSync");
+        resolve(glClientWaitSync, "glClientWaitSync");
+        resolve(glDeleteSync, "glDeleteSync");
+    }
+
+    bool complete() const
+    {
+        return glMapBufferRange && glUnmapBuffer && glFenceSync && glClientWaitSync && glDeleteSync;
+    }
+};
+
 ms::GLPixelBuffer::GLPixelBuffer(std::unique_ptr<renderer::gl::Context> gl_context)
     : gl_context{std::move(gl_context)},
-      tex{0}, fbo{0}, gl_pixel_format{0}, pixels_need_y_flip{false}
+      tex{0}, fbo{0}, pbo{0}, fence{nullptr}, prepared{false},
+      gl_pixel_format{0}, pixels_need_y_flip{false}
 {
     /*
      * TODO: Handle systems that are big-endian, and therefore GL_BGRA doesn't
@@ -70,9 +115,13 @@ ms::GLPixelBuffer::~GLPixelBuffer() noexcept
      * This may be called from a different thread
      * than the one that called prepare
      */
-    if (tex != 0 || fbo != 0)
+    if (prepared)
         gl_context->make_current();
 
+    if (fence)
+        pack_buffers->glDeleteSync(fence);
+    if (pbo != 0)
+        glDeleteBuffers(1, &pbo);
     if (tex != 0)
         glDeleteTextures(1, &tex);
     if (fbo != 0)
@@ -83,6 +132,17 @@ void ms::GLPixelBuffer::prepare()
 {
     gl_context->make_current();
 
+    if (!prepared)
+    {
+        if (supports_pack_buffers())
+        {
+            std::unique_ptr<PackBufferFunctions> functions{new PackBufferFunctions};
+            if (functions->complete())
+                pack_buffers = std::move(functions);
+        }
+        prepared = true;
+    }
+
     if (tex == 0)
         glGenTextures(1, &tex);
 
@@ -99,10 +159,10 @@ void ms::GLPixelBuffer::fill_from(graphics::Buffer& buffer)
 {
     auto width = buffer.size().width.as_uint32_t();
     auto height = buffer.size().height.as_uint32_t();
-
-    pixels.resize(width * height * 4);
+    auto const byte_count = width * height * 4;
 
     prepare();
+    discard_readback();
 
     auto const texture_source =
         dynamic_cast<mir::renderer::gl::TextureSource*>(
@@ -113,51 +173,139 @@ void ms::GLPixelBuffer::fill_from(graphics::Buffer& buffer)
 
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, tex, 0);
 
+    /*
+     * With a pixel-pack buffer bound glReadPixels() only queues the copy
+     * (the destination is an offset into the buffer) so we don't wait for
+     * the GPU while the caller holds the source buffer.
+     */
+    void* destination{nullptr};
+    if (pack_buffers)
+    {
+        if (pbo == 0)
+            glGenBuffers(1, &pbo);
+        glBindBuffer(pixel_pack_buffer, pbo);
+        if (buffer.size() != size_)
+            glBufferData(pixel_pack_buffer, byte_count, nullptr, stream_read);
+    }
+    else
+    {
+        pixels.resize(byte_count);
+        destination = pixels.data();
+    }
+
+    read_pixels(width, height, destination);
+
+    if (pack_buffers)
+    {
+        fence = pack_buffers->glFenceSync(sync_gpu_commands_complete, 0);
+        glBindBuffer(pixel_pack_buffer, 0);
+
+        if (fence)
+        {
+            glFlush();
+        }
+        else
+        {
+            /* Without a fence we can't tell when the copy is done, so read synchronously */
+            pixels.resize(byte_count);
+            read_pixels(width, height, pixels.data());
+        }
+    }
+
+    size_ = buffer.size();
+    pixels_need_y_flip = true;
+}
+
+void ms::GLPixelBuffer::read_pixels(GLsizei width, GLsizei height, void* destination)
+{
     /* First try to get pixels as BGRA */
     glGetError();
     gl_pixel_format = GL_BGRA_EXT;
-    glReadPixels(0, 0, width, height, gl_pixel_format, GL_UNSIGNED_BYTE, pixels.data());
+    glReadPixels(0, 0, width, height, gl_pixel_format, GL_UNSIGNED_BYTE, destination);
 
     /* If getting pixels as BGRA failed, fall back to RGBA */
     if (glGetError() != GL_NO_ERROR)
     {
         gl_pixel_format = GL_RGBA;
-        glReadPixels(0, 0, width, height, gl_pixel_format, GL_UNSIGNED_BYTE, pixels.data());
+        glReadPixels(0, 0, width, height, gl_pixel_format, GL_UNSIGNED_BYTE, destination);
     }
-
-    size_ = buffer.size();
-    pixels_need_y_flip = true;
 }
 
-void const* ms::GLPixelBuffer::as_argb_8888()
+void ms::GLPixelBuffer::collect_readback()
 {
-    if (pixels_need_y_flip)
+    gl_context->make_current();
+
+    GLenum status;
+    do
     {
-        auto const stride_val = stride().as_uint32_t();
-        auto const height = size_.height.as_uint32_t();
+        status = pack_buffers->glClientWaitSync(fence, sync_flush_commands_bit, one_second_ns);
+    }
+    while (status == timeout_expired);
 
-        std::vector<char> tmp(stride_val);
+    pack_buffers->glDeleteSync(fence);
+    fence = nullptr;
 
-        for (unsigned int i = 0; i < height / 2; i++)
-        {
-            /* Store line i */
-            tmp.assign(&pixels[i * stride_val], &pixels[(i + 1) * stride_val]);
+    if (status == wait_failed)
+        BOOST_THROW_EXCEPTION(std::runtime_error("Failed to wait for pixel readback"));
 
-            /* Copy line height - i - 1 to line i */
-            copy_and_convert_pixel_line(&pixels[(height - i - 1) * stride_val],
-                                        &pixels[i * stride_val]);
+    auto const width = size_.width.as_uint32_t();
+    auto const height = size_.height.as_uint32_t();
+    auto const line_stride = stride().as_uint32_t();
 
-            /* Copy stored line (i) to height - i - 1 */
-            copy_and_convert_pixel_line(tmp.data(),
-                                        &pixels[(height - i - 1) * stride_val]);
-        }
+    glBindBuffer(pixel_pack_buffer, pbo);
+    auto const mapped = static_cast<char const*>(
+        pack_buffers->glMapBufferRange(pixel_pack_buffer, 0, line_stride * height, map_read_bit));
+    if (!mapped)
+    {
+        glBindBuffer(pixel_pack_buffer, 0);
+        BOOST_THROW_EXCEPTION(std::runtime_error("Failed to map pixel pack buffer"));
+    }
 
-        /* Process middle line if there is one */
-        if (height % 2 == 1)
-        {
-            copy_and_convert_pixel_line(&pixels[(height / 2) * stride_val],
-                                        &pixels[(height / 2) * stride_val]);
-        }
+    /*
+     * Flip (and convert pixels read as RGBA, which are abgr_8888) straight
+     * out of the mapping, rather than copying and then flipping in place
+     */
+    pixels.resize(line_stride * height);
+    for (uint32_t line = 0; line != height; ++line)
+    {
+        auto const src = mapped + line * line_stride;
+        auto const dst = pixels.data() + (height - line - 1) * line_stride;
+
+        if (gl_pixel_format == GL_RGBA)
+            mg::swap_red_blue_8888(src, dst, width);
+        else
+            memcpy(dst, src, line_stride);
+    }
+
+    pack_buffers->glUnmapBuffer(pixel_pack_buffer);
+    glBindBuffer(pixel_pack_buffer, 0);
+}
+
+void ms::GLPixelBuffer::discard_readback()
+{
+    if (fence)
+    {
+        pack_buffers->glDeleteSync(fence);
+        fence = nullptr;
+    }
+}
+
+void const* ms::GLPixelBuffer::as_argb_8888()
+{
+    if (pixels_need_y_flip && fence)
+    {
+        pixels_need_y_flip = false;
+        collect_readback();
+    }
+    else if (pixels_need_y_flip)
+    {
+        /* Pixels read as RGBA are abgr_8888, convert them while flipping */
+        mg::flip_in_place_8888(
+            pixels.data(),
+            stride().as_uint32_t(),
+            size_.width.as_uint32_t(),
+            size_.height.as_uint32_t(),
+            gl_pixel_format == GL_RGBA);
 
         pixels_need_y_flip = false;
     }
@@ -174,21 +322,3 @@ geom::Stride ms::GLPixelBuffer::stride() const
 {
     return geom::Stride{size_.width.as_uint32_t() * sizeof(uint32_t)};
 }
-
-void ms::GLPixelBuffer::copy_and_convert_pixel_line(char* src, char* dst)
-{
-    if (gl_pixel_format == GL_RGBA)
-    {
-        /* Convert from abgr_8888 to argb_8888 while copying */
-        auto pixels_src = reinterpret_cast<uint32_t*>(src);
-        auto pixels_dst = reinterpret_cast<uint32_t*>(dst);
-        auto const width = size_.width.as_uint32_t();
-
-        for (uint32_t n = 0; n < width; n++)
-            pixels_dst[n] = abgr_to_argb(pixels_src[n]);
-    }
-    else if (src != dst)
-    {
-        std::copy(src, src + stride().as_uint32_t(), dst);
-    }
-}
@@ -42,7 +42,14 @@ class Context;
 
 namespace scene
 {
-/** Extracts the pixels from a graphics::Buffer using GL facilities. */
+/**
+ * Extracts the pixels from a graphics::Buffer using GL facilities.
+ *
+ * Where the context supports pixel-pack buffers and fences (GLES 3.0 and
+ * later) fill_from() only queues the copy, and the wait for the GPU is
+ * deferred to as_argb_8888(). Otherwise, or if a fence can't be created,
+ * the pixels are read synchronously.
+ */
 class GLPixelBuffer : public PixelBuffer
 {
 public:
@@ -55,17 +62,24 @@ public:
     geometry::Stride stride() const;
 
 private:
+    struct PackBufferFunctions;
+
     void prepare();
-    void copy_and_convert_pixel_line(char* src, char* dst);
+    void read_pixels(GLsizei width, GLsizei height, void* destination);
+    void collect_readback();
+    void discard_readback();
 
     std::unique_ptr<renderer::gl::Context> const gl_context;
     GLuint tex;
     GLuint fbo;
+    GLuint pbo;
+    GLsync fence;
+    bool prepared;
+    std::unique_ptr<PackBufferFunctions const> pack_buffers;
     std::vector<char> pixels;
     GLuint gl_pixel_format;
     bool pixels_need_y_flip;
     geometry::Size size_;
-    geometry::Stride stride_;
 };
 
 }
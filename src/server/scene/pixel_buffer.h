@@ -41,6 +41,11 @@ public:
     /**
      * Fills the PixelBuffer with the contents of a graphics::Buffer.
      *
+     * Implementations may only start the copy here, and wait for it to
+     * complete in as_argb_8888(), so that callers holding the buffer are
+     * not stalled. The buffer must not be reused until as_argb_8888()
+     * returns.
+     *
      * \param [in] buffer the buffer to get the pixels of
      */
     virtual void fill_from(graphics::Buffer& buffer) = 0;
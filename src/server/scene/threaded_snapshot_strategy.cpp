@@ -73,9 +73,9 @@ public:
 
     void take_snapshot(WorkItem const& wi)
     {
-        wi.stream->with_most_recent_buffer_do([this](mir::graphics::Buffer& buffer) {
-            pixels->fill_from(buffer);
-        });
+        /* The pixels may still be on their way until as_argb_8888() returns */
+        auto const buffer = wi.stream->lock_snapshot_buffer();
+        pixels->fill_from(*buffer);
 
         wi.snapshot_taken(
             ms::Snapshot{pixels->size(),
@@ -18,11 +18,14 @@
 
 #include "mir/server.h"
 
+#include "mir/abnormal_exit.h"
 #include "mir/emergency_cleanup.h"
 #include "mir/fd.h"
 #include "mir/frontend/connector.h"
 #include "mir/graphics/graphic_buffer_allocator.h"
 #include "mir/graphics/display_buffer.h"
+#include "mir/input/cursor_images.h"
+#include "mir/input/input_manager.h"
 #include "mir/input/composite_event_filter.h"
 #include "mir/input/event_filter.h"
 #include "mir/options/default_configuration.h"
@@ -33,6 +36,7 @@
 #include "mir/main_loop.h"
 #include "mir/report_exception.h"
 #include "mir/run_mir.h"
+#include "mir/startup_trace.h"
 #include "mir/cookie/authority.h"
 
 // TODO these are used to frig a stub renderer when running headless
@@ -42,6 +46,7 @@
 
 #include "frontend_wayland/wayland_connector.h"
 
+#include <future>
 #include <iostream>
 
 namespace mo = mir::options;
@@ -75,6 +80,42 @@ struct TemporaryCompositeEventFilter : public mi::CompositeEventFilter
     std::vector<std::shared_ptr<mi::EventFilter>> prepend_event_filters;
     std::vector<std::shared_ptr<mi::EventFilter>> append_event_filters;
 };
+
+// Makes the subsystems that don't need the display on threads of their own, so that they start
+// while the display does. (The display's dependencies are still made on whichever thread needs
+// them first: the configuration's CachedPtrs make the others wait.)
+auto start_independent_subsystems(mir::DefaultServerConfiguration& config, mir::options::Option const& options)
+    -> std::vector<std::future<std::shared_ptr<void>>>
+{
+    std::vector<std::future<std::shared_ptr<void>>> subsystems;
+
+    if (!options.get<bool>(mo::parallel_startup_opt))
+        return subsystems;
+
+    subsystems.push_back(std::async(std::launch::async,
+        [&config]() -> std::shared_ptr<void> { return config.the_input_manager(); }));
+
+    subsystems.push_back(std::async(std::launch::async,
+        [&config]() -> std::shared_ptr<void> { return config.the_wayland_connector(); }));
+
+    subsystems.push_back(std::async(std::launch::async,
+        [&config]() -> std::shared_ptr<void> { return config.the_cursor_images(); }));
+
+    return subsystems;
+}
+
+bool startup_report_wanted(mir::options::Option const& options)
+{
+    auto const opt = options.get<std::string>(mo::startup_report_opt);
+
+    if (opt == mo::log_opt_value)
+        return true;
+    else if (opt == mo::off_opt_value)
+        return false;
+
+    throw mir::AbnormalExit(std::string("Invalid ") + mo::startup_report_opt + " option: " + opt +
+        " (valid options are: \"" + mo::off_opt_value + "\" and \"" + mo::log_opt_value + "\")");
+}
 }
 
 #define FOREACH_WRAPPER(MACRO)\
@@ -396,6 +437,10 @@ void mir::Server::run()
         mir::log_info("Starting");
         verify_accessing_allowed(self->server_config);
 
+        auto const options = self->server_config->the_options();
+        auto startup_trace = std::make_unique<StartupTrace>();
+        auto const report_startup = startup_report_wanted(*options);
+
         auto const emergency_cleanup = self->server_config->the_emergency_cleanup();
         auto const composite_event_filter = self->server_config->the_composite_event_filter();
 
@@ -406,10 +451,28 @@ void mir::Server::run()
 
         self->pre_init_callback();
 
+        auto subsystems = start_independent_subsystems(*self->server_config, *options);
+
         run_mir(
             *self->server_config,
             [&](DisplayServer&)
-                { self->init_callback(); },
+                {
+                    // The display server now holds the subsystems: this just passes on any failure
+                    for (auto& subsystem : subsystems)
+                        subsystem.get();
+
+                    self->init_callback();
+
+                    // The main loop runs once everything has started
+                    self->server_config->the_main_loop()->enqueue(
+                        this,
+                        [&]
+                        {
+                            if (report_startup)
+                                startup_trace->log();
+                            startup_trace.reset();
+                        });
+                },
             self->terminator);
 
         self->exit_status = true;
@@ -0,0 +1,500 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/time/timer_wheel_alarm_factory.h"
+#include "mir/time/alarm.h"
+#include "mir/time/clock.h"
+#include "mir/graphics/event_handler_register.h"
+#include "mir/lockable_callback.h"
+#include "mir/basic_callback.h"
+#include "mir/fd.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <system_error>
+#include <vector>
+
+namespace mt = mir::time;
+
+namespace
+{
+using Tick = uint64_t;
+
+// Four levels of 64 slots cover 2^24 ticks (~4.6 hours at 1ms resolution);
+// anything further out waits on an overflow list.
+int const bits_per_level = 6;
+int const slots_per_level = 1 << bits_per_level;
+int const levels = 4;
+int const overflow_level = levels;
+Tick const never = std::numeric_limits<Tick>::max();
+
+struct AlarmState : std::enable_shared_from_this<AlarmState>
+{
+    AlarmState(std::unique_ptr<mir::LockableCallback> callback)
+        : callback{std::move(callback)}
+    {
+    }
+
+    std::unique_ptr<mir::LockableCallback> const callback;
+
+    // Not held while the callback runs: the callback commonly takes a lock of
+    // its own that is also held while cancelling or rescheduling the alarm.
+    // So cancel() and destruction don't wait for a dispatch in progress.
+    std::mutex mutex;
+    mt::Alarm::State state{mt::Alarm::cancelled};
+    bool enabled{true};
+
+    // Guarded by the Wheel's mutex (and only written with `mutex` also held)
+    AlarmState* prev{nullptr};
+    AlarmState* next{nullptr};
+    bool linked{false};
+    int level{0};
+    int slot{0};
+    Tick expiry{0};
+    uint64_t generation{0};
+};
+
+struct Fired
+{
+    std::shared_ptr<AlarmState> alarm;
+    uint64_t generation;
+};
+}
+
+class mt::TimerWheelAlarmFactory::Wheel
+{
+public:
+    Wheel(std::shared_ptr<Clock> const& clock, std::chrono::milliseconds resolution);
+
+    Timestamp now() const;
+
+    void schedule(AlarmState& alarm, Timestamp time_point);
+    void unschedule(AlarmState& alarm);
+    void dispatch_expired();
+
+    mir::Fd const timer_fd;
+
+private:
+    Tick tick_at_or_after(Timestamp time_point) const;
+    Tick tick_at_or_before(Timestamp time_point) const;
+
+    void link_locked(AlarmState& alarm);
+    void unlink_locked(AlarmState& alarm);
+    AlarmState* take_list_locked(int level, int slot);
+    Tick next_event_locked() const;
+    void advance_to_locked(Tick target, std::vector<Fired>& fired);
+    void rearm_locked();
+
+    std::shared_ptr<Clock> const clock;
+    Duration const resolution;
+    Timestamp const origin;
+
+    std::mutex mutex;
+    Tick current{0};
+    Tick armed_for{never};
+    std::array<std::array<AlarmState*, slots_per_level>, levels> slots{};
+    std::array<uint64_t, levels> occupied{};
+    AlarmState* overflow{nullptr};
+};
+
+namespace
+{
+class AlarmImpl : public mt::Alarm
+{
+public:
+    AlarmImpl(
+        std::shared_ptr<mt::TimerWheelAlarmFactory::Wheel> const& wheel,
+        std::unique_ptr<mir::LockableCallback> callback)
+        : wheel{wheel},
+          alarm{std::make_shared<AlarmState>(std::move(callback))}
+    {
+    }
+
+    ~AlarmImpl() override
+    {
+        std::lock_guard<std::mutex> lock{alarm->mutex};
+        alarm->enabled = false;
+        wheel->unschedule(*alarm);
+    }
+
+    bool cancel() override
+    {
+        std::lock_guard<std::mutex> lock{alarm->mutex};
+
+        if (alarm->state == State::pending)
+        {
+            wheel->unschedule(*alarm);
+            alarm->state = State::cancelled;
+        }
+        return alarm->state == State::cancelled;
+    }
+
+    State state() const override
+    {
+        std::lock_guard<std::mutex> lock{alarm->mutex};
+        return alarm->state;
+    }
+
+    bool reschedule_in(std::chrono::milliseconds delay) override
+    {
+        return reschedule_for(wheel->now() + delay);
+    }
+
+    bool reschedule_for(mt::Timestamp time_point) override
+    {
+        std::lock_guard<std::mutex> lock{alarm->mutex};
+
+        auto const old_state = alarm->state;
+        alarm->state = State::pending;
+        wheel->schedule(*alarm, time_point);
+
+        return old_state == State::pending;
+    }
+
+private:
+    std::shared_ptr<mt::TimerWheelAlarmFactory::Wheel> const wheel;
+    std::shared_ptr<AlarmState> const alarm;
+};
+
+int make_timer_fd()
+{
+    auto const fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (fd == -1)
+    {
+        BOOST_THROW_EXCEPTION((
+            std::system_error{errno, std::system_category(), "Failed to create timerfd"}));
+    }
+    return fd;
+}
+}
+
+mt::TimerWheelAlarmFactory::Wheel::Wheel(
+    std::shared_ptr<Clock> const& clock,
+    std::chrono::milliseconds resolution)
+    : timer_fd{make_timer_fd()},
+      clock{clock},
+      resolution{std::max<Duration>(resolution, std::chrono::milliseconds{1})},
+      origin{clock->now()}
+{
+}
+
+mt::Timestamp mt::TimerWheelAlarmFactory::Wheel::now() const
+{
+    return clock->now();
+}
+
+Tick mt::TimerWheelAlarmFactory::Wheel::tick_at_or_after(Timestamp time_point) const
+{
+    if (time_point <= origin)
+        return 0;
+
+    return (time_point - origin + resolution - Duration{1}) / resolution;
+}
+
+Tick mt::TimerWheelAlarmFactory::Wheel::tick_at_or_before(Timestamp time_point) const
+{
+    if (time_point <= origin)
+        return 0;
+
+    return (time_point - origin) / resolution;
+}
+
+void mt::TimerWheelAlarmFactory::Wheel::schedule(AlarmState& alarm, Timestamp time_point)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    if (alarm.linked)
+        unlink_locked(alarm);
+
+    ++alarm.generation;
+    alarm.expiry = tick_at_or_after(time_point);
+    link_locked(alarm);
+
+    rearm_locked();
+}
+
+void mt::TimerWheelAlarmFactory::Wheel::unschedule(AlarmState& alarm)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    if (alarm.linked)
+    {
+        unlink_locked(alarm);
+        rearm_locked();
+    }
+}
+
+void mt::TimerWheelAlarmFactory::Wheel::link_locked(AlarmState& alarm)
+{
+    // An alarm lives on the lowest level whose higher-order tick bits match
+    // the current tick's; it is cascaded down as the wheel catches up with it.
+    auto const expiry = std::max(alarm.expiry, current);
+
+    int level = 0;
+    while (level < levels &&
+           (expiry >> (bits_per_level * (level + 1))) != (current >> (bits_per_level * (level + 1))))
+    {
+        ++level;
+    }
+
+    AlarmState** head;
+    if (level == overflow_level)
+    {
+        head = &overflow;
+    }
+    else
+    {
+        alarm.slot = (expiry >> (bits_per_level * level)) & (slots_per_level - 1);
+        head = &slots[level][alarm.slot];
+        occupied[level] |= uint64_t{1} << alarm.slot;
+    }
+
+    alarm.level = level;
+    alarm.prev = nullptr;
+    alarm.next = *head;
+    if (*head)
+        (*head)->prev = &alarm;
+    *head = &alarm;
+    alarm.linked = true;
+}
+
+void mt::TimerWheelAlarmFactory::Wheel::unlink_locked(AlarmState& alarm)
+{
+    auto const head = alarm.level == overflow_level ? &overflow : &slots[alarm.level][alarm.slot];
+
+    if (alarm.prev)
+        alarm.prev->next = alarm.next;
+    else
+        *head = alarm.next;
+
+    if (alarm.next)
+        alarm.next->prev = alarm.prev;
+
+    if (!*head && alarm.level != overflow_level)
+        occupied[alarm.level] &= ~(uint64_t{1} << alarm.slot);
+
+    alarm.prev = nullptr;
+    alarm.next = nullptr;
+    alarm.linked = false;
+}
+
+AlarmState* mt::TimerWheelAlarmFactory::Wheel::take_list_locked(int level, int slot)
+{
+    AlarmState* list;
+    if (level == overflow_level)
+    {
+        list = overflow;
+        overflow = nullptr;
+    }
+    else
+    {
+        list = slots[level][slot];
+        slots[level][slot] = nullptr;
+        occupied[level] &= ~(uint64_t{1} << slot);
+    }
+
+    for (auto alarm = list; alarm; alarm = alarm->next)
+        alarm->linked = false;
+
+    return list;
+}
+
+Tick mt::TimerWheelAlarmFactory::Wheel::next_event_locked() const
+{
+    // Level 0 slots hold exact expiry ticks; higher levels only tell us when
+    // a slot has to be cascaded. Either is a point at which we need to wake.
+    for (int level = 0; level != levels; ++level)
+    {
+        auto const shift = bits_per_level * level;
+        auto const index = (current >> shift) & (slots_per_level - 1);
+
+        auto const first = level == 0 ? index : index + 1;
+        if (first == slots_per_level)
+            continue;
+
+        auto const pending = occupied[level] & (~uint64_t{0} << first);
+        if (pending)
+        {
+            auto const slot = Tick(__builtin_ctzll(pending));
+            auto const block = (current >> (shift + bits_per_level)) << (shift + bits_per_level);
+            return block + (slot << shift);
+        }
+    }
+
+    if (overflow)
+    {
+        auto const shift = bits_per_level * levels;
+        return ((current >> shift) + 1) << shift;
+    }
+
+    return never;
+}
+
+void mt::TimerWheelAlarmFactory::Wheel::advance_to_locked(Tick target, std::vector<Fired>& fired)
+{
+    for (;;)
+    {
+        auto const next = next_event_locked();
+        if (next > target)
+        {
+            current = std::max(current, target);
+            return;
+        }
+
+        current = next;
+
+        for (int level = overflow_level; level != 0; --level)
+        {
+            auto const shift = bits_per_level * level;
+            if (current & ((Tick{1} << shift) - 1))
+                continue;
+
+            auto const slot = (current >> shift) & (slots_per_level - 1);
+            for (auto alarm = take_list_locked(level, slot); alarm;)
+            {
+                auto const next_alarm = alarm->next;
+                link_locked(*alarm);
+                alarm = next_alarm;
+            }
+        }
+
+        for (auto alarm = take_list_locked(0, current & (slots_per_level - 1)); alarm;)
+        {
+            auto const next_alarm = alarm->next;
+            alarm->prev = nullptr;
+            alarm->next = nullptr;
+            fired.push_back({alarm->shared_from_this(), alarm->generation});
+            alarm = next_alarm;
+        }
+    }
+}
+
+void mt::TimerWheelAlarmFactory::Wheel::rearm_locked()
+{
+    auto const next = next_event_locked();
+    if (next == armed_for)
+        return;
+
+    itimerspec spec{};
+    if (next != never)
+    {
+        auto const wait = std::max<Duration>(
+            clock->min_wait_until(origin + next * resolution),
+            std::chrono::nanoseconds{1});
+        auto const seconds = std::chrono::duration_cast<std::chrono::seconds>(wait);
+
+        spec.it_value.tv_sec = seconds.count();
+        spec.it_value.tv_nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(wait - seconds).count();
+    }
+
+    if (timerfd_settime(timer_fd, 0, &spec, nullptr) == -1)
+    {
+        BOOST_THROW_EXCEPTION((
+            std::system_error{errno, std::system_category(), "Failed to arm timerfd"}));
+    }
+
+    armed_for = next;
+}
+
+void mt::TimerWheelAlarmFactory::Wheel::dispatch_expired()
+{
+    uint64_t expirations;
+    if (read(timer_fd, &expirations, sizeof expirations) == -1 && errno != EAGAIN)
+    {
+        BOOST_THROW_EXCEPTION((
+            std::system_error{errno, std::system_category(), "Failed to read timerfd"}));
+    }
+
+    std::vector<Fired> fired;
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        armed_for = never;
+        advance_to_locked(tick_at_or_before(clock->now()), fired);
+        rearm_locked();
+    }
+
+    std::exception_ptr first_exception;
+
+    for (auto const& f : fired)
+    {
+        auto& alarm = *f.alarm;
+
+        {
+            std::lock_guard<std::mutex> lock{alarm.mutex};
+
+            // A reschedule after the alarm left the wheel supersedes this firing
+            if (!alarm.enabled || alarm.state != Alarm::pending || alarm.generation != f.generation)
+                continue;
+
+            alarm.state = Alarm::triggered;
+        }
+
+        // f.alarm keeps the callback alive even if the alarm is destroyed meanwhile
+        try
+        {
+            std::lock_guard<mir::LockableCallback> handler_lock{*alarm.callback};
+            (*alarm.callback)();
+        }
+        catch (...)
+        {
+            // Dispatch the other alarms before handing this to the main loop
+            if (!first_exception)
+                first_exception = std::current_exception();
+        }
+    }
+
+    if (first_exception)
+        std::rethrow_exception(first_exception);
+}
+
+mt::TimerWheelAlarmFactory::TimerWheelAlarmFactory(
+    std::shared_ptr<graphics::EventHandlerRegister> const& event_handler_register,
+    std::shared_ptr<Clock> const& clock,
+    std::chrono::milliseconds resolution)
+    : event_handler_register{event_handler_register},
+      wheel{std::make_shared<Wheel>(clock, resolution)}
+{
+    event_handler_register->register_fd_handler(
+        {wheel->timer_fd},
+        this,
+        [wheel = wheel](int) { wheel->dispatch_expired(); });
+}
+
+mt::TimerWheelAlarmFactory::~TimerWheelAlarmFactory()
+{
+    event_handler_register->unregister_fd_handler(this);
+}
+
+std::unique_ptr<mt::Alarm> mt::TimerWheelAlarmFactory::create_alarm(
+    std::function<void()> const& callback)
+{
+    return create_alarm(std::make_unique<BasicCallback>(callback));
+}
+
+std::unique_ptr<mt::Alarm> mt::TimerWheelAlarmFactory::create_alarm(
+    std::unique_ptr<LockableCallback> callback)
+{
+    return std::make_unique<AlarmImpl>(wheel, std::move(callback));
+}
@@ -23,6 +23,7 @@
 #include "mir/geometry/size.h"
 #include "mir/geometry/rectangle.h"
 #include "mir/raii.h"
+#include "mir/graphics/pixel_conversion.h"
 
 #include <EGL/egl.h>
 #include <GLES2/gl2.h>
@@ -304,13 +305,10 @@ public:
         MirGraphicsRegion const region{graphics_region_for(buffer_stream)};
         int const line_size{region.width * MIR_BYTES_PER_PIXEL(region.pixel_format)};
 
-        // Contents are rendered up-side down, read them bottom to top
-        auto addr = region.vaddr + (region.height - 1)*region.stride;
-        for (int i = 0; i < region.height; i++)
-        {
-            stream.write(addr, line_size);
-            addr -= region.stride;
-        }
+        // Contents are rendered up-side down, turn them the right way up
+        frame.resize(line_size * region.height);
+        mir::graphics::copy_flipped(region.vaddr, region.stride, frame.data(), line_size, line_size, region.height);
+        stream.write(frame.data(), frame.size());
 
         mir_buffer_stream_swap_buffers_sync(buffer_stream);
     }
@@ -318,6 +316,7 @@ public:
 private:
     MirBufferStream* const buffer_stream;
     std::string const pixel_format_;
+    std::vector<char> frame;
 };
 
 class EGLScreencast : public Screencast
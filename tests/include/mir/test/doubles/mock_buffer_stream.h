@@ -45,6 +45,8 @@ struct MockBufferStream : public compositor::BufferStream
             .WillByDefault(testing::Invoke(this, &MockBufferStream::buffers_ready));
         ON_CALL(*this, with_most_recent_buffer_do(testing::_))
             .WillByDefault(testing::InvokeArgument<0>(testing::ByRef(*buffer)));
+        ON_CALL(*this, lock_snapshot_buffer())
+            .WillByDefault(testing::Return(buffer));
         ON_CALL(*this, acquire_client_buffer(testing::_))
             .WillByDefault(testing::InvokeArgument<0>(nullptr));
         ON_CALL(*this, has_submitted_buffer())
@@ -59,6 +61,7 @@ struct MockBufferStream : public compositor::BufferStream
     MOCK_METHOD1(release_client_buffer, void(graphics::Buffer*));
     MOCK_METHOD1(lock_compositor_buffer,
                  std::shared_ptr<graphics::Buffer>(void const*));
+    MOCK_METHOD0(lock_snapshot_buffer, std::shared_ptr<graphics::Buffer>());
     MOCK_METHOD1(set_frame_posted_callback, void(std::function<void(geometry::Size const&)> const&));
 
     MOCK_METHOD0(get_stream_pixel_format, MirPixelFormat());
@@ -43,6 +43,10 @@ public:
                  void(compositor::CompositorReport::SubCompositorId));
     MOCK_METHOD1(finished_frame,
                  void(compositor::CompositorReport::SubCompositorId));
+    MOCK_METHOD2(frame_reached_stage,
+                 void(compositor::CompositorReport::SubCompositorId, compositor::FrameStage));
+    MOCK_METHOD2(rendered_on_gpu,
+                 void(compositor::CompositorReport::SubCompositorId, std::chrono::nanoseconds));
     MOCK_METHOD0(started, void());
     MOCK_METHOD0(stopped, void());
     MOCK_METHOD0(scheduled, void());
@@ -30,7 +30,8 @@ namespace doubles
 {
 ACTION(RunProtobufClosure)
 {
-    arg2->Run();
+    if (arg2)
+        arg2->Run();
 }
 
 struct MockProtobufServer : public client::rpc::DisplayServer
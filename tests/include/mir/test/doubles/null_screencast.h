@@ -47,7 +47,7 @@ public:
     {
         return nullptr;
     }
-    void capture(frontend::ScreencastSessionId, std::shared_ptr<graphics::Buffer> const&) {}
+    geometry::Rectangles capture(frontend::ScreencastSessionId, std::shared_ptr<graphics::Buffer> const&) { return {}; }
 };
 
 }
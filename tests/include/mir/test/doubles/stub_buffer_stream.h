@@ -47,6 +47,12 @@ public:
         return stub_compositor_buffer;
     }
 
+    std::shared_ptr<graphics::Buffer> lock_snapshot_buffer() override
+    {
+        thread_name = current_thread_name();
+        return stub_compositor_buffer;
+    }
+
     geometry::Size stream_size() override
     {
         return geometry::Size();
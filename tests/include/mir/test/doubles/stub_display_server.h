@@ -92,7 +92,7 @@ struct StubDisplayServer : public mir::frontend::detail::DisplayServer
         google::protobuf::Closure* /*done*/) override {}
     void screencast_to_buffer(
         mir::protobuf::ScreencastRequest const*,
-        mir::protobuf::Void*,
+        mir::protobuf::ScreencastCapture*,
         google::protobuf::Closure*) override {}
     void release_screencast(
         mir::protobuf::ScreencastId const* /*request*/,
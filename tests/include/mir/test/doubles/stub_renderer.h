@@ -36,6 +36,7 @@ public:
     void set_viewport(geometry::Rectangle const&) override {}
     void set_output_transform(glm::mat2 const&) override {}
     void suspend() override {}
+    void set_timing_observer(std::shared_ptr<renderer::FrameTimingObserver> const&) override {}
 
     void render(graphics::RenderableList const& renderables) const override
     {
@@ -0,0 +1,89 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_TEST_TEMPORARY_FILE_H_
+#define MIR_TEST_TEMPORARY_FILE_H_
+
+#include <string>
+#include <system_error>
+
+#include <ftw.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+namespace mir
+{
+namespace test
+{
+/// An empty file that is removed when this goes out of scope
+class TemporaryFile
+{
+public:
+    TemporaryFile() : path_{create()} {}
+    ~TemporaryFile() { unlink(path_.c_str()); }
+
+    std::string const& path() const { return path_; }
+
+private:
+    TemporaryFile(TemporaryFile const&) = delete;
+    TemporaryFile& operator=(TemporaryFile const&) = delete;
+
+    static std::string create()
+    {
+        char name[] = "/tmp/mir_test_file_XXXXXX";
+        auto const fd = mkstemp(name);
+        if (fd < 0)
+            throw std::system_error{errno, std::system_category(), "Failed to create temporary file"};
+        close(fd);
+        return name;
+    }
+
+    std::string const path_;
+};
+
+/// An empty directory that is removed, with whatever it then holds, when this goes out of scope
+class TemporaryDirectory
+{
+public:
+    TemporaryDirectory() : path_{create()} {}
+    ~TemporaryDirectory()
+    {
+        // Can't do anything useful in case of failure...
+        nftw(path_.c_str(), [](char const* path, struct stat const*, int, FTW*) { return remove(path); },
+             16, FTW_DEPTH | FTW_PHYS);
+    }
+
+    std::string const& path() const { return path_; }
+
+private:
+    TemporaryDirectory(TemporaryDirectory const&) = delete;
+    TemporaryDirectory& operator=(TemporaryDirectory const&) = delete;
+
+    static std::string create()
+    {
+        char name[] = "/tmp/mir_test_directory_XXXXXX";
+        if (!mkdtemp(name))
+            throw std::system_error{errno, std::system_category(), "Failed to create temporary directory"};
+        return name;
+    }
+
+    std::string const path_;
+};
+}
+}
+
+#endif /* MIR_TEST_TEMPORARY_FILE_H_ */
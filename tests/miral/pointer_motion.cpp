@@ -0,0 +1,293 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_window_manager_tools.h"
+#include "window_management_trace.h"
+
+#include <miral/pointer_motion_policy.h>
+
+#include <mir/events/event_builders.h>
+
+using namespace miral;
+using namespace testing;
+namespace mev = mir::events;
+
+namespace
+{
+struct MockPointerMotionPolicy : MockWindowManagerPolicy, PointerMotionPolicy
+{
+    using MockWindowManagerPolicy::MockWindowManagerPolicy;
+
+    MOCK_METHOD1(handle_pointer_event, bool(MirPointerEvent const* event));
+    MOCK_METHOD2(pointer_motion_needs_handling, bool(MirPointerEvent const* event, WindowLayoutSnapshot const& layout));
+    MOCK_METHOD2(handle_request_move, void(WindowInfo& window_info, MirInputEvent const* input_event));
+};
+
+struct PointerMotion : Test
+{
+    StubFocusController focus_controller;
+    StubDisplayLayout display_layout;
+    StubPersistentSurfaceStore persistent_surface_store;
+    StubDisplayConfigurationObserver display_configuration_observer;
+    std::shared_ptr<StubStubSession> session{std::make_shared<StubStubSession>()};
+
+    MockPointerMotionPolicy* policy{nullptr};
+
+    BasicWindowManager basic_window_manager{
+        &focus_controller,
+        mir::test::fake_shared(display_layout),
+        mir::test::fake_shared(persistent_surface_store),
+        display_configuration_observer,
+        [this](WindowManagerTools const& tools) -> std::unique_ptr<WindowManagementPolicy>
+            {
+                auto result = std::make_unique<NiceMock<MockPointerMotionPolicy>>(tools);
+                policy = result.get();
+                return std::move(result);
+            }
+    };
+
+    auto create_window(Size size) -> Window
+    {
+        Window window;
+        EXPECT_CALL(*policy, advise_new_window(_))
+            .WillOnce(Invoke([&](WindowInfo const& window_info){ window = window_info.window(); }));
+
+        mir::scene::SurfaceCreationParameters creation_parameters;
+        creation_parameters.size = size;
+        basic_window_manager.add_surface(session, creation_parameters, &TestWindowManagerTools::create_surface);
+        Mock::VerifyAndClearExpectations(policy);
+        return window;
+    }
+
+    void screen_motion(std::function<void(WindowLayoutSnapshot const& layout)> const& check)
+    {
+        auto const event = pointer_event(mir_pointer_action_motion, 0);
+
+        EXPECT_CALL(*policy, pointer_motion_needs_handling(_, _))
+            .WillOnce(Invoke([&](MirPointerEvent const*, WindowLayoutSnapshot const& layout)
+                {
+                    check(layout);
+                    return false;
+                }));
+
+        basic_window_manager.handle_pointer_event(pointer_event_of(event));
+    }
+
+    static auto pointer_event(MirPointerAction action, MirPointerButtons buttons) -> mir::EventUPtr
+    {
+        return mev::make_event(
+            MirInputDeviceId{0}, std::chrono::nanoseconds{0}, std::vector<uint8_t>{}, mir_input_event_modifier_none,
+            action, buttons, 42.0f, 7.0f, 0.0f, 0.0f, 1.0f, 1.0f);
+    }
+
+    static auto pointer_event_of(mir::EventUPtr const& event) -> MirPointerEvent const*
+    {
+        return mir_input_event_get_pointer_event(mir_event_get_input_event(event.get()));
+    }
+};
+}
+
+TEST_F(PointerMotion, motion_the_policy_screens_out_is_not_handled)
+{
+    auto const event = pointer_event(mir_pointer_action_motion, 0);
+
+    EXPECT_CALL(*policy, pointer_motion_needs_handling(_, _)).WillOnce(Return(false));
+    EXPECT_CALL(*policy, handle_pointer_event(_)).Times(0);
+
+    EXPECT_FALSE(basic_window_manager.handle_pointer_event(pointer_event_of(event)));
+}
+
+TEST_F(PointerMotion, motion_the_policy_needs_is_handled)
+{
+    auto const event = pointer_event(mir_pointer_action_motion, 0);
+
+    EXPECT_CALL(*policy, pointer_motion_needs_handling(_, _)).WillOnce(Return(true));
+    EXPECT_CALL(*policy, handle_pointer_event(_)).WillOnce(Return(true));
+
+    EXPECT_TRUE(basic_window_manager.handle_pointer_event(pointer_event_of(event)));
+}
+
+TEST_F(PointerMotion, motion_with_a_button_pressed_is_not_screened)
+{
+    auto const event = pointer_event(mir_pointer_action_motion, mir_pointer_button_primary);
+
+    EXPECT_CALL(*policy, pointer_motion_needs_handling(_, _)).Times(0);
+    EXPECT_CALL(*policy, handle_pointer_event(_)).WillOnce(Return(true));
+
+    EXPECT_TRUE(basic_window_manager.handle_pointer_event(pointer_event_of(event)));
+}
+
+TEST_F(PointerMotion, button_presses_are_not_screened)
+{
+    auto const event = pointer_event(mir_pointer_action_button_down, mir_pointer_button_primary);
+
+    EXPECT_CALL(*policy, pointer_motion_needs_handling(_, _)).Times(0);
+    EXPECT_CALL(*policy, handle_pointer_event(_)).WillOnce(Return(true));
+
+    EXPECT_TRUE(basic_window_manager.handle_pointer_event(pointer_event_of(event)));
+}
+
+TEST_F(PointerMotion, snapshot_shows_the_active_window)
+{
+    basic_window_manager.add_session(session);
+
+    Window window;
+    EXPECT_CALL(*policy, advise_new_window(_))
+        .WillOnce(Invoke([&](WindowInfo const& window_info){ window = window_info.window(); }));
+
+    mir::scene::SurfaceCreationParameters creation_parameters;
+    creation_parameters.size = Size{600, 400};
+    basic_window_manager.add_surface(session, creation_parameters, &TestWindowManagerTools::create_surface);
+    basic_window_manager.invoke_under_lock([&]{ basic_window_manager.select_active_window(window); });
+
+    auto const event = pointer_event(mir_pointer_action_motion, 0);
+
+    EXPECT_CALL(*policy, pointer_motion_needs_handling(_, _))
+        .WillOnce(Invoke([&](MirPointerEvent const*, WindowLayoutSnapshot const& layout)
+            {
+                EXPECT_THAT(layout.active_window(), Eq(window));
+                return false;
+            }));
+
+    basic_window_manager.handle_pointer_event(pointer_event_of(event));
+}
+
+TEST_F(PointerMotion, snapshot_shows_the_window_under_a_point)
+{
+    basic_window_manager.add_session(session);
+    auto const window = create_window(Size{600, 400});
+    auto const inside = window.top_left() + Displacement{10, 10};
+    auto const outside = window.top_left() + Displacement{610, 10};
+
+    screen_motion([&](WindowLayoutSnapshot const& layout)
+        {
+            EXPECT_THAT(layout.window_at(inside), Eq(window));
+            EXPECT_THAT(layout.window_at(outside), Eq(Window{}));
+        });
+}
+
+TEST_F(PointerMotion, snapshot_follows_a_window_that_moves)
+{
+    basic_window_manager.add_session(session);
+    auto const window = create_window(Size{600, 400});
+    auto const old_point = window.top_left() + Displacement{10, 10};
+    auto const new_point = window.top_left() + Displacement{1010, 10};
+
+    WindowSpecification mods;
+    mods.top_left() = window.top_left() + Displacement{1000, 0};
+    basic_window_manager.invoke_under_lock(
+        [&]{ basic_window_manager.modify_window(basic_window_manager.info_for(window), mods); });
+
+    screen_motion([&](WindowLayoutSnapshot const& layout)
+        {
+            EXPECT_THAT(layout.window_at(old_point), Eq(Window{}));
+            EXPECT_THAT(layout.window_at(new_point), Eq(window));
+        });
+}
+
+TEST_F(PointerMotion, snapshot_follows_a_window_moved_at_the_clients_request)
+{
+    basic_window_manager.add_session(session);
+    auto const window = create_window(Size{600, 400});
+    auto const old_point = window.top_left() + Displacement{10, 10};
+    auto const new_point = window.top_left() + Displacement{1010, 10};
+
+    auto const press = pointer_event(mir_pointer_action_button_down, mir_pointer_button_primary);
+    basic_window_manager.handle_pointer_event(pointer_event_of(press));
+
+    EXPECT_CALL(*policy, handle_request_move(_, _))
+        .WillOnce(Invoke([&](WindowInfo& window_info, MirInputEvent const*)
+            {
+                WindowSpecification mods;
+                mods.top_left() = window.top_left() + Displacement{1000, 0};
+                basic_window_manager.modify_window(window_info, mods);
+            }));
+
+    basic_window_manager.handle_request_move(session, window, 0);
+
+    screen_motion([&](WindowLayoutSnapshot const& layout)
+        {
+            EXPECT_THAT(layout.window_at(old_point), Eq(Window{}));
+            EXPECT_THAT(layout.window_at(new_point), Eq(window));
+        });
+}
+
+TEST_F(PointerMotion, snapshot_shows_the_window_on_top)
+{
+    basic_window_manager.add_session(session);
+    auto const lower = create_window(Size{600, 400});
+    auto const upper = create_window(Size{600, 400});
+    auto const overlap = Rectangle{lower.top_left(), lower.size()}.intersection_with({upper.top_left(), upper.size()});
+    ASSERT_THAT(overlap.size, Ne(Size{}));
+    auto const point = overlap.top_left;
+
+    screen_motion([&](WindowLayoutSnapshot const& layout)
+        { EXPECT_THAT(layout.window_at(point), Eq(upper)); });
+
+    basic_window_manager.invoke_under_lock([&]{ basic_window_manager.raise_tree(lower); });
+
+    screen_motion([&](WindowLayoutSnapshot const& layout)
+        { EXPECT_THAT(layout.window_at(point), Eq(lower)); });
+}
+
+TEST_F(PointerMotion, snapshot_doesnt_show_a_hidden_window)
+{
+    basic_window_manager.add_session(session);
+    auto const window = create_window(Size{600, 400});
+    auto const point = window.top_left() + Displacement{10, 10};
+
+    WindowSpecification mods;
+    mods.state() = mir_window_state_hidden;
+    basic_window_manager.invoke_under_lock(
+        [&]{ basic_window_manager.modify_window(basic_window_manager.info_for(window), mods); });
+
+    screen_motion([&](WindowLayoutSnapshot const& layout)
+        { EXPECT_THAT(layout.window_at(point), Eq(Window{})); });
+}
+
+TEST(PointerMotionTrace, motion_is_screened_by_the_traced_policy)
+{
+    StubFocusController focus_controller;
+    StubDisplayLayout display_layout;
+    StubPersistentSurfaceStore persistent_surface_store;
+    StubDisplayConfigurationObserver display_configuration_observer;
+
+    MockPointerMotionPolicy* policy{nullptr};
+
+    BasicWindowManager basic_window_manager{
+        &focus_controller,
+        mir::test::fake_shared(display_layout),
+        mir::test::fake_shared(persistent_surface_store),
+        display_configuration_observer,
+        [&](WindowManagerTools const& tools) -> std::unique_ptr<WindowManagementPolicy>
+            {
+                return std::make_unique<WindowManagementTrace>(tools,
+                    [&](WindowManagerTools const& tools) -> std::unique_ptr<WindowManagementPolicy>
+                        {
+                            auto result = std::make_unique<NiceMock<MockPointerMotionPolicy>>(tools);
+                            policy = result.get();
+                            return std::move(result);
+                        });
+            }
+    };
+
+    auto const event = PointerMotion::pointer_event(mir_pointer_action_motion, 0);
+
+    EXPECT_CALL(*policy, pointer_motion_needs_handling(_, _)).WillOnce(Return(false));
+    EXPECT_CALL(*policy, handle_pointer_event(_)).Times(0);
+
+    EXPECT_FALSE(basic_window_manager.handle_pointer_event(PointerMotion::pointer_event_of(event)));
+}
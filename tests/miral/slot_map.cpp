@@ -0,0 +1,88 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "slot_map.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <string>
+#include <vector>
+
+using namespace testing;
+
+namespace
+{
+struct SlotMap : Test
+{
+    miral::SlotMap<std::string> slot_map;
+};
+}
+
+TEST_F(SlotMap, finds_values_by_handle)
+{
+    auto const first = slot_map.emplace("first");
+    auto const second = slot_map.emplace("second");
+
+    ASSERT_THAT(slot_map.find(first), NotNull());
+    ASSERT_THAT(slot_map.find(second), NotNull());
+    EXPECT_THAT(*slot_map.find(first), Eq("first"));
+    EXPECT_THAT(*slot_map.find(second), Eq("second"));
+    EXPECT_THAT(slot_map.size(), Eq(2u));
+}
+
+TEST_F(SlotMap, default_handle_finds_nothing)
+{
+    slot_map.emplace("value");
+
+    EXPECT_THAT(slot_map.find(miral::SlotHandle{}), IsNull());
+}
+
+TEST_F(SlotMap, erased_handle_finds_nothing_even_when_slot_is_reused)
+{
+    auto const erased = slot_map.emplace("erased");
+    slot_map.erase(erased);
+    auto const reused = slot_map.emplace("reused");
+
+    EXPECT_THAT(reused.index, Eq(erased.index));
+    EXPECT_THAT(slot_map.find(erased), IsNull());
+    ASSERT_THAT(slot_map.find(reused), NotNull());
+    EXPECT_THAT(*slot_map.find(reused), Eq("reused"));
+    EXPECT_THAT(slot_map.size(), Eq(1u));
+}
+
+TEST_F(SlotMap, values_do_not_move_as_map_grows)
+{
+    auto const handle = slot_map.emplace("first");
+    auto const address = slot_map.find(handle);
+
+    for (auto i = 0; i != 10000; ++i)
+        slot_map.emplace(std::to_string(i));
+
+    EXPECT_THAT(slot_map.find(handle), Eq(address));
+}
+
+TEST_F(SlotMap, for_each_visits_only_live_values)
+{
+    slot_map.emplace("one");
+    slot_map.erase(slot_map.emplace("two"));
+    slot_map.emplace("three");
+
+    std::vector<std::string> visited;
+    slot_map.for_each([&](std::string const& value) { visited.push_back(value); });
+
+    EXPECT_THAT(visited, UnorderedElementsAre("one", "three"));
+}
@@ -0,0 +1,280 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "window_management_binary_trace.h"
+
+#include <mir_toolkit/common.h>
+
+#include "mir/test/temporary_file.h"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace mbt = miral::binary_trace;
+using namespace testing;
+
+namespace
+{
+auto record_of(mbt::Call call, std::uint64_t subject = 0) -> mbt::Record
+{
+    mbt::Record record{};
+    record.call = call;
+    record.subject = subject;
+    return record;
+}
+
+struct BinaryTrace : Test
+{
+    auto decoded() const -> std::string
+    {
+        std::ifstream in{filename, std::ios::binary};
+        std::stringstream out;
+        mbt::decode(in, out);
+        return out.str();
+    }
+
+    void append(mbt::Record const& record)
+    {
+        std::ofstream{filename, std::ios::binary | std::ios::app}
+            .write(reinterpret_cast<char const*>(&record), sizeof record);
+    }
+
+    mir::test::TemporaryFile const file;
+    std::string const& filename{file.path()};
+};
+}
+
+TEST(BinaryTraceRingBuffer, returns_records_in_the_order_pushed)
+{
+    mbt::RingBuffer buffer{4};
+
+    EXPECT_TRUE(buffer.push(record_of(mbt::Call::raise_tree, 1)));
+    EXPECT_TRUE(buffer.push(record_of(mbt::Call::raise_tree, 2)));
+
+    mbt::Record record;
+    ASSERT_TRUE(buffer.pop(record));
+    EXPECT_THAT(record.subject, Eq(1u));
+    ASSERT_TRUE(buffer.pop(record));
+    EXPECT_THAT(record.subject, Eq(2u));
+    EXPECT_FALSE(buffer.pop(record));
+}
+
+TEST(BinaryTraceRingBuffer, drops_records_when_full)
+{
+    mbt::RingBuffer buffer{2};
+
+    EXPECT_TRUE(buffer.push(record_of(mbt::Call::raise_tree, 1)));
+    EXPECT_TRUE(buffer.push(record_of(mbt::Call::raise_tree, 2)));
+    EXPECT_FALSE(buffer.push(record_of(mbt::Call::raise_tree, 3)));
+    EXPECT_THAT(buffer.dropped(), Eq(1u));
+
+    mbt::Record record;
+    ASSERT_TRUE(buffer.pop(record));
+    EXPECT_TRUE(buffer.push(record_of(mbt::Call::raise_tree, 4)));
+}
+
+TEST(BinaryTraceRingBuffer, pushes_several_records_together_or_not_at_all)
+{
+    mbt::RingBuffer buffer{4};
+    mbt::Record const records[]{
+        record_of(mbt::Call::window_name, 2), record_of(mbt::Call::window_name, 3), record_of(mbt::Call::window_name, 4)};
+
+    EXPECT_TRUE(buffer.push(record_of(mbt::Call::raise_tree, 1)));
+    EXPECT_FALSE(buffer.push(records, 4));
+    EXPECT_TRUE(buffer.push(records, 3));
+    EXPECT_FALSE(buffer.push(records, 1));
+    EXPECT_THAT(buffer.dropped(), Eq(5u));
+
+    mbt::Record record;
+    ASSERT_TRUE(buffer.pop(record));
+    EXPECT_FALSE(buffer.push(records, 2));
+    EXPECT_TRUE(buffer.push(records, 1));
+
+    std::vector<std::uint64_t> subjects;
+    while (buffer.pop(record))
+        subjects.push_back(record.subject);
+
+    EXPECT_THAT(subjects, ElementsAre(2u, 3u, 4u, 2u));
+}
+
+TEST(BinaryTraceRingBuffer, loses_nothing_pushed_from_several_threads)
+{
+    auto const per_thread = 1000u;
+    mbt::RingBuffer buffer{4 * per_thread};
+
+    std::vector<std::thread> threads;
+    for (auto t = 1u; t <= 4; ++t)
+    {
+        threads.emplace_back([&buffer, t]
+            {
+                for (auto i = 0u; i != per_thread; ++i)
+                    buffer.push(record_of(mbt::Call::raise_tree, t));
+            });
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    std::vector<unsigned> counts(5);
+    mbt::Record record;
+    while (buffer.pop(record))
+        ++counts[record.subject];
+
+    EXPECT_THAT(counts, ElementsAre(0u, per_thread, per_thread, per_thread, per_thread));
+    EXPECT_THAT(buffer.dropped(), Eq(0u));
+}
+
+TEST(BinaryTraceRingBuffer, keeps_records_pushed_together_next_to_one_another)
+{
+    auto const per_thread = 1000u;
+    mbt::RingBuffer buffer{4 * 3 * per_thread};
+
+    std::vector<std::thread> threads;
+    for (auto t = 1u; t <= 4; ++t)
+    {
+        threads.emplace_back([&buffer, t]
+            {
+                mbt::Record const records[]{
+                    record_of(mbt::Call::window_name, t), record_of(mbt::Call::window_name, t),
+                    record_of(mbt::Call::window_name, t)};
+
+                for (auto i = 0u; i != per_thread; ++i)
+                    buffer.push(records, 3);
+            });
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    mbt::Record first, second, third;
+    while (buffer.pop(first))
+    {
+        ASSERT_TRUE(buffer.pop(second));
+        ASSERT_TRUE(buffer.pop(third));
+        EXPECT_THAT(second.subject, Eq(first.subject));
+        EXPECT_THAT(third.subject, Eq(first.subject));
+    }
+
+    EXPECT_THAT(buffer.dropped(), Eq(0u));
+}
+
+TEST_F(BinaryTrace, decodes_calls_with_the_names_recorded)
+{
+    {
+        mbt::Writer writer{filename};
+
+        writer.write(mbt::Call::window_name, 42, "a window with a name too long to fit in one record");
+
+        auto record = record_of(mbt::Call::advise_move_to, 42);
+        record.args.value[0] = mir_window_type_normal;
+        record.args.value[1] = mir_window_state_restored;
+        record.args.value[2] = 10;
+        record.args.value[3] = 20;
+        record.args.value[4] = 640;
+        record.args.value[5] = 480;
+        record.args.value[6] = 30;
+        record.args.value[7] = 40;
+        writer.write(record);
+
+        record = record_of(mbt::Call::active_window);
+        record.args.object = 42;
+        writer.write(record);
+
+        writer.write(record_of(mbt::Call::end_of_batch));
+    }
+
+    auto const text = decoded();
+
+    EXPECT_THAT(text, HasSubstr(
+        "] advise_move_to window_info={name=a window with a name too long to fit in one record, "
+        "type=normal, state=restored, top_left=(10, 20), size=(640, 480)} "
+        "top_left=(30, 40)\n"));
+    EXPECT_THAT(text, HasSubstr("] active_window -> a window with a name too long to fit in one record\n"));
+    EXPECT_THAT(text, HasSubstr("] ====\n"));
+}
+
+TEST_F(BinaryTrace, truncates_text_too_long_for_the_records_allowed)
+{
+    std::string const name(mbt::Writer::max_text_records * mbt::Record::max_text + 10, 'x');
+
+    {
+        mbt::Writer writer{filename};
+        writer.write(mbt::Call::window_name, 42, name.c_str());
+
+        auto record = record_of(mbt::Call::active_window);
+        record.args.object = 42;
+        writer.write(record);
+    }
+
+    EXPECT_THAT(decoded(), HasSubstr("] active_window -> " + name.substr(0, name.size() - 10) + "\n"));
+}
+
+TEST_F(BinaryTrace, drops_text_continued_from_a_record_that_is_missing)
+{
+    {
+        mbt::Writer writer{filename};
+        writer.write(mbt::Call::window_name, 42, "start");
+    }
+
+    auto orphan = record_of(mbt::Call::window_name, 42);
+    orphan.flags = mbt::Record::continued_text;
+    std::strcpy(orphan.text, "orphan");
+    append(orphan);
+
+    auto record = record_of(mbt::Call::active_window);
+    record.args.object = 42;
+    append(record);
+
+    auto const text = decoded();
+
+    EXPECT_THAT(text, HasSubstr("] active_window -> start\n"));
+    EXPECT_THAT(text, Not(HasSubstr("orphan")));
+}
+
+TEST_F(BinaryTrace, drops_text_that_does_not_end)
+{
+    {
+        mbt::Writer writer{filename};
+        writer.write(mbt::Call::window_name, 42, "start");
+    }
+
+    auto unfinished = record_of(mbt::Call::window_name, 42);
+    unfinished.flags = mbt::Record::more_text;
+    std::strcpy(unfinished.text, "unfinished");
+    append(unfinished);
+
+    auto record = record_of(mbt::Call::active_window);
+    record.args.object = 42;
+    append(record);
+
+    auto const text = decoded();
+
+    EXPECT_THAT(text, HasSubstr("] active_window -> start\n"));
+    EXPECT_THAT(text, Not(HasSubstr("unfinished")));
+}
+
+TEST_F(BinaryTrace, rejects_a_file_that_is_not_a_trace)
+{
+    std::ofstream{filename} << "not a trace";
+
+    EXPECT_THROW(decoded(), std::runtime_error);
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "xcursor_loader.h"
+
+#include <mir/graphics/cursor_image.h>
+#include <mir_test_framework/executable_path.h>
+#include <mir_test_framework/temporary_environment_value.h>
+#include <mir/test/temporary_file.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <fstream>
+#include <sys/stat.h>
+
+namespace geom = mir::geometry;
+namespace mtf = mir_test_framework;
+using namespace testing;
+
+namespace
+{
+struct XCursorLoader : Test
+{
+    mtf::TemporaryEnvironmentValue const cursor_path{
+        "XCURSOR_PATH", (mtf::test_data_path() + "/testing-cursor-theme").c_str()};
+
+    geom::Size const size{24, 24};
+    miral::XCursorLoader loader{"default"};
+};
+}
+
+TEST_F(XCursorLoader, loads_the_cursor_asked_for)
+{
+    auto const green = loader.image("green", size);
+
+    ASSERT_THAT(green, NotNull());
+    EXPECT_THAT(green->size(), Eq(size));
+    EXPECT_THAT(green, Ne(loader.image("blue", size)));
+}
+
+TEST_F(XCursorLoader, loads_each_cursor_once)
+{
+    EXPECT_THAT(loader.image("green", size), Eq(loader.image("green", size)));
+}
+
+TEST_F(XCursorLoader, falls_back_to_the_arrow)
+{
+    auto const arrow = loader.image("arrow", size);
+
+    ASSERT_THAT(arrow, NotNull());
+    EXPECT_THAT(loader.image("no-such-cursor", size), Eq(arrow));
+}
+
+TEST_F(XCursorLoader, only_loads_cursors_from_the_theme)
+{
+    EXPECT_THAT(loader.image("../default/cursors/green", size), Eq(loader.image("arrow", size)));
+}
+
+TEST_F(XCursorLoader, has_nothing_for_a_missing_theme)
+{
+    miral::XCursorLoader missing{"no-such-theme"};
+
+    EXPECT_THAT(missing.image("arrow", size), IsNull());
+}
+
+TEST_F(XCursorLoader, keeps_cursors_that_are_in_use)
+{
+    auto const green = loader.image("green", size);
+
+    for (auto i = 0; i != 1000; ++i)
+    {
+        loader.image("no-such-cursor-" + std::to_string(i), size);
+        ASSERT_THAT(loader.image("green", size), Eq(green));
+    }
+}
+
+TEST_F(XCursorLoader, forgets_cursors_that_have_not_been_used_recently)
+{
+    auto const green = loader.image("green", size);
+
+    for (auto i = 0; i != 1000; ++i)
+        loader.image("no-such-cursor-" + std::to_string(i), size);
+
+    auto const reloaded = loader.image("green", size);
+    ASSERT_THAT(reloaded, NotNull());
+    EXPECT_THAT(reloaded, Ne(green));
+}
+
+TEST_F(XCursorLoader, gives_up_on_a_theme_that_inherits_too_much)
+{
+    mir::test::TemporaryDirectory const themes;
+    mkdir((themes.path() + "/fan").c_str(), 0700);
+    std::ofstream{themes.path() + "/fan/index.theme"} << "[Icon Theme]\nInherits=fan,fan,fan,fan\n";
+
+    mtf::TemporaryEnvironmentValue const fan_path{"XCURSOR_PATH", themes.path().c_str()};
+    miral::XCursorLoader fan{"fan"};
+
+    // Following every inherited theme to the maximum depth would take 4^16 lookups
+    EXPECT_THAT(fan.image("arrow", size), IsNull());
+}
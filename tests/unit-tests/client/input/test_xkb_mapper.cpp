@@ -499,3 +499,41 @@ TEST_F(XKBMapperWithUsKeymap, compose_key_sequence_contains_text_on_key_down)
     map_event(keyboard, mir_keyboard_action_down, KEY_U);
     map_event(keyboard, mir_keyboard_action_up, KEY_U);
 }
+
+TEST_F(XKBMapperWithUsKeymap, modifiers_reflect_the_keys_held)
+{
+    map_key(keyboard, mir_keyboard_action_down, KEY_LEFTSHIFT);
+    EXPECT_THAT(mapper.modifiers(), Eq(MirInputEventModifiers{mir_input_event_modifier_shift_left | mir_input_event_modifier_shift}));
+
+    map_key(keyboard, mir_keyboard_action_up, KEY_LEFTSHIFT);
+    EXPECT_THAT(mapper.modifiers(), Eq(MirInputEventModifiers{mir_input_event_modifier_none}));
+}
+
+TEST_F(XKBMapperWithUsKeymap, xkb_modifiers_reflect_depressed_and_locked_modifiers)
+{
+    EXPECT_THAT(mapper.xkb_modifiers(), Eq(mi::XkbModifiers{0, 0, 0, 0}));
+
+    map_key(keyboard, mir_keyboard_action_down, KEY_LEFTSHIFT);
+    EXPECT_THAT(mapper.xkb_modifiers().depressed, Ne(0u));
+
+    map_key(keyboard, mir_keyboard_action_up, KEY_LEFTSHIFT);
+    map_key(keyboard, mir_keyboard_action_down, KEY_CAPSLOCK);
+    map_key(keyboard, mir_keyboard_action_up, KEY_CAPSLOCK);
+    EXPECT_THAT(mapper.xkb_modifiers().depressed, Eq(0u));
+    EXPECT_THAT(mapper.xkb_modifiers().locked, Ne(0u));
+}
+
+TEST_F(XKBMapperWithUsKeymap, xkb_modifiers_combine_all_keyboards)
+{
+    auto const other_keyboard = MirInputDeviceId{1};
+
+    map_key(keyboard, mir_keyboard_action_down, KEY_LEFTSHIFT);
+    auto const shift = mapper.xkb_modifiers().depressed;
+    map_key(keyboard, mir_keyboard_action_up, KEY_LEFTSHIFT);
+
+    map_key(other_keyboard, mir_keyboard_action_down, KEY_LEFTCTRL);
+    auto const ctrl = mapper.xkb_modifiers().depressed;
+
+    map_key(keyboard, mir_keyboard_action_down, KEY_LEFTSHIFT);
+    EXPECT_THAT(mapper.xkb_modifiers().depressed, Eq(shift | ctrl));
+}
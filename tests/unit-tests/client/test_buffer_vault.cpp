@@ -29,6 +29,7 @@
 #include "mir_protobuf.pb.h"
 #include "mir/test/doubles/mock_client_buffer.h"
 #include "mir/test/doubles/mock_mir_buffer.h"
+#include "mir/test/doubles/advanceable_clock.h"
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
@@ -112,7 +113,8 @@ struct BufferVault : public testing::Test
             mt::fake_shared(buffer_factory),
             mt::fake_shared(mock_requests),
             surface_map,
-            size, format, usage, initial_nbuffers);
+            size, format, usage, initial_nbuffers, 0,
+            mt::fake_shared(clock));
     }
 
     unsigned int initial_nbuffers {3};
@@ -127,6 +129,7 @@ struct BufferVault : public testing::Test
     NiceMock<MockServerRequests> mock_requests;
     mcl::BufferFactory buffer_factory;
     std::shared_ptr<mcl::ConnectionSurfaceMap> surface_map;
+    mtd::AdvanceableClock clock;
     mp::Buffer package;
     mp::Buffer package2;
     mp::Buffer package3;
@@ -144,7 +147,8 @@ struct StartedBufferVault : BufferVault
     mcl::BufferVault vault{
         mt::fake_shared(mock_platform_factory), mt::fake_shared(buffer_factory),
         mt::fake_shared(mock_requests), surface_map,
-        size, format, usage, initial_nbuffers};
+        size, format, usage, initial_nbuffers, 0,
+        mt::fake_shared(clock)};
 };
 
 }
@@ -156,6 +160,35 @@ TEST_F(BufferVault, creates_all_buffers_on_start)
     make_vault();
 }
 
+TEST_F(BufferVault, only_requests_buffers_the_server_has_not_preallocated)
+{
+    unsigned int const preallocated{2};
+    EXPECT_CALL(mock_requests, allocate_buffer(size, format, usage))
+        .Times(initial_nbuffers - preallocated);
+
+    mcl::BufferVault vault{
+        mt::fake_shared(mock_platform_factory), mt::fake_shared(buffer_factory),
+        mt::fake_shared(mock_requests), surface_map,
+        size, format, usage, initial_nbuffers, preallocated,
+        mt::fake_shared(clock)};
+}
+
+TEST_F(BufferVault, adopts_preallocated_buffers)
+{
+    EXPECT_CALL(mock_requests, allocate_buffer(_,_,_))
+        .Times(0);
+
+    mcl::BufferVault vault{
+        mt::fake_shared(mock_platform_factory), mt::fake_shared(buffer_factory),
+        mt::fake_shared(mock_requests), surface_map,
+        size, format, usage, initial_nbuffers, initial_nbuffers,
+        mt::fake_shared(clock)};
+
+    EXPECT_NO_THROW(buffer_factory.generate_buffer(package));
+    EXPECT_NO_THROW(buffer_factory.generate_buffer(package2));
+    EXPECT_NO_THROW(buffer_factory.generate_buffer(package3));
+}
+
 TEST_F(BufferVault, withdrawing_and_never_filling_up_will_timeout)
 {
     using namespace std::literals::chrono_literals;
@@ -621,3 +654,44 @@ TEST_F(StartedBufferVault, can_increase_count_after_resize)
         vault.wire_transfer_inbound(package4.buffer_id());
     }
 }
+
+TEST_F(StartedBufferVault, allocates_ahead_when_server_holds_buffers_for_several_frames)
+{
+    using namespace std::chrono_literals;
+
+    EXPECT_CALL(mock_requests, allocate_buffer(_,_,_))
+        .Times(2);
+    vault.set_interval(0);
+
+    for (auto i = 0; i != 3; ++i)
+    {
+        auto buffer = vault.withdraw().get();
+        vault.deposit(buffer);
+        vault.wire_transfer_outbound(buffer, []{});
+        clock.advance_by(16ms);
+    }
+
+    vault.wire_transfer_inbound(package.buffer_id());
+    vault.withdraw().get();
+    Mock::VerifyAndClearExpectations(&mock_requests);
+}
+
+TEST_F(StartedBufferVault, doesnt_allocate_ahead_when_server_queues_buffers)
+{
+    using namespace std::chrono_literals;
+
+    EXPECT_CALL(mock_requests, allocate_buffer(_,_,_))
+        .Times(0);
+
+    for (auto i = 0; i != 3; ++i)
+    {
+        auto buffer = vault.withdraw().get();
+        vault.deposit(buffer);
+        vault.wire_transfer_outbound(buffer, []{});
+        clock.advance_by(16ms);
+    }
+
+    vault.wire_transfer_inbound(package.buffer_id());
+    vault.withdraw().get();
+    Mock::VerifyAndClearExpectations(&mock_requests);
+}
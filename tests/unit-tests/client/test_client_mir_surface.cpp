@@ -58,6 +58,7 @@
 #include <cstring>
 #include <map>
 #include <atomic>
+#include <thread>
 
 #include <fcntl.h>
 
@@ -618,3 +619,56 @@ TEST_F(MirClientSurfaceTest, initial_sizes_are_from_response_from_server)
     EXPECT_THAT(params.width, Eq(size.width.as_int()));
     EXPECT_THAT(params.height, Eq(size.height.as_int()));
 }
+
+namespace
+{
+struct CallbackRecord
+{
+    std::thread::id thread;
+    mt::Signal called;
+    mt::Signal unblock;
+};
+
+void record_callback_and_wait(MirWindow*, MirEvent const*, void* context)
+{
+    auto const record = static_cast<CallbackRecord*>(context);
+    record->thread = std::this_thread::get_id();
+    record->called.raise();
+    record->unblock.wait_for(std::chrono::seconds{5});
+}
+}
+
+TEST_F(MirClientSurfaceTest, runs_event_callback_off_the_thread_handling_the_event)
+{
+    using namespace testing;
+
+    CallbackRecord record;
+    record.unblock.raise();
+    auto const surface = create_and_wait_for_surface_with(*client_comm_channel);
+    surface->set_event_handler(&record_callback_and_wait, &record);
+
+    surface->handle_event(*mir::events::make_event(
+        mir::frontend::SurfaceId(2), mir_window_attrib_focus, mir_window_focus_state_focused));
+
+    ASSERT_TRUE(record.called.wait_for(std::chrono::seconds{5}));
+    EXPECT_THAT(record.thread, Ne(std::this_thread::get_id()));
+}
+
+TEST_F(MirClientSurfaceTest, updates_window_state_without_waiting_for_a_slow_event_callback)
+{
+    using namespace testing;
+
+    CallbackRecord record;
+    auto const surface = create_and_wait_for_surface_with(*client_comm_channel);
+    surface->set_event_handler(&record_callback_and_wait, &record);
+
+    surface->handle_event(*mir::events::make_event(
+        mir::frontend::SurfaceId(2), mir_window_attrib_focus, mir_window_focus_state_focused));
+    ASSERT_TRUE(record.called.wait_for(std::chrono::seconds{5}));
+
+    surface->handle_event(*mir::events::make_event(
+        mir::frontend::SurfaceId(2), mir_window_attrib_focus, mir_window_focus_state_unfocused));
+    EXPECT_THAT(surface->attrib(mir_window_attrib_focus), Eq(mir_window_focus_state_unfocused));
+
+    record.unblock.raise();
+}
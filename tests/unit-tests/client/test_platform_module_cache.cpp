@@ -0,0 +1,118 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/client/platform_module_cache.h"
+#include "mir/test/temporary_file.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <fstream>
+
+#include <unistd.h>
+
+namespace mcl = mir::client;
+using namespace testing;
+
+namespace
+{
+struct PlatformModuleCache : Test
+{
+    PlatformModuleCache()
+    {
+        std::ofstream{module} << "not really a module";
+    }
+
+    mir::test::TemporaryDirectory const temporary_directory;
+    std::string const& directory{temporary_directory.path()};
+    std::string const module{directory + "/module.so.5"};
+    std::string const cache_file{directory + "/cache/client-platform-modules"};
+    std::string const key{"mir:stub-graphics 1.2.3 /usr/lib/client-modules"};
+};
+}
+
+TEST_F(PlatformModuleCache, knows_nothing_at_first)
+{
+    mcl::PlatformModuleCache cache{cache_file};
+
+    EXPECT_FALSE(cache.lookup(key));
+}
+
+TEST_F(PlatformModuleCache, remembers_module_across_instances)
+{
+    mcl::PlatformModuleCache{cache_file}.record(key, module);
+
+    mcl::PlatformModuleCache cache{cache_file};
+    auto const cached = cache.lookup(key);
+
+    ASSERT_TRUE(cached);
+    EXPECT_THAT(cached.value(), Eq(module));
+}
+
+TEST_F(PlatformModuleCache, keeps_entries_for_other_keys)
+{
+    mcl::PlatformModuleCache cache{cache_file};
+    auto const other_module = directory + "/other.so.5";
+    std::ofstream{other_module} << "not really a module either";
+
+    cache.record(key, module);
+    cache.record("mir:other-graphics 1.2.3", other_module);
+
+    ASSERT_TRUE(cache.lookup(key));
+    EXPECT_THAT(cache.lookup(key).value(), Eq(module));
+}
+
+TEST_F(PlatformModuleCache, replaces_earlier_module_for_key)
+{
+    mcl::PlatformModuleCache cache{cache_file};
+    auto const other_module = directory + "/other.so.5";
+    std::ofstream{other_module} << "not really a module either";
+
+    cache.record(key, module);
+    cache.record(key, other_module);
+
+    ASSERT_TRUE(cache.lookup(key));
+    EXPECT_THAT(cache.lookup(key).value(), Eq(other_module));
+}
+
+TEST_F(PlatformModuleCache, forgets_module_that_has_changed)
+{
+    mcl::PlatformModuleCache cache{cache_file};
+    cache.record(key, module);
+
+    std::ofstream{module, std::ios::app} << ", and now it's been upgraded";
+
+    EXPECT_FALSE(cache.lookup(key));
+}
+
+TEST_F(PlatformModuleCache, forgets_module_that_has_been_removed)
+{
+    mcl::PlatformModuleCache cache{cache_file};
+    cache.record(key, module);
+
+    unlink(module.c_str());
+
+    EXPECT_FALSE(cache.lookup(key));
+}
+
+TEST_F(PlatformModuleCache, does_nothing_without_a_file)
+{
+    mcl::PlatformModuleCache cache{""};
+
+    cache.record(key, module);
+
+    EXPECT_FALSE(cache.lookup(key));
+}
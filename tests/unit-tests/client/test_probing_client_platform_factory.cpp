@@ -18,15 +18,21 @@
 
 #include "mir/client/client_platform.h"
 #include "src/client/probing_client_platform_factory.h"
+#include "src/client/platform_module_cache.h"
+#include "mir/shared_library_prober_report.h"
 #include "src/server/report/null_report_factory.h"
 
 #include "mir/test/doubles/mock_client_context.h"
+#include "mir/test/temporary_file.h"
 #include "mir_test_framework/executable_path.h"
 #include "mir_test_framework/stub_platform_helpers.h"
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <dlfcn.h>
+#include <fstream>
+#include <unistd.h>
+#include <cstdlib>
 #include <unordered_map>
 
 namespace mtf = mir_test_framework;
@@ -136,6 +142,20 @@ std::vector<std::string> all_available_modules()
     return modules;
 }
 
+class MockSharedLibraryProberReport : public mir::SharedLibraryProberReport
+{
+public:
+    MOCK_METHOD1(probing_path, void(boost::filesystem::path const&));
+    MOCK_METHOD2(probing_failed, void(boost::filesystem::path const&, std::exception const&));
+    MOCK_METHOD1(loading_library, void(boost::filesystem::path const&));
+    MOCK_METHOD2(loading_failed, void(boost::filesystem::path const&, std::exception const&));
+};
+
+std::string directory_of(std::string const& file)
+{
+    return file.substr(0, file.rfind('/'));
+}
+
 bool loaded(std::string const& path)
 {
     void* x = dlopen(path.c_str(), RTLD_LAZY | RTLD_NOLOAD);
@@ -151,7 +171,7 @@ TEST(ProbingClientPlatformFactory, ThrowsErrorWhenConstructedWithNoPlatforms)
     std::vector<std::shared_ptr<mir::SharedLibrary>> empty_modules;
     EXPECT_THROW(mir::client::ProbingClientPlatformFactory(
                      mir::report::null_shared_library_prober_report(),
-                     {}, {}, nullptr),
+                     {}, {}, nullptr, nullptr),
                  std::runtime_error);
 }
 
@@ -162,7 +182,7 @@ TEST(ProbingClientPlatformFactory, ThrowsErrorWhenNoPlatformPluginProbesSuccessf
     mir::client::ProbingClientPlatformFactory factory(
         mir::report::null_shared_library_prober_report(),
         all_available_modules(),
-        {}, nullptr);
+        {}, nullptr, nullptr);
 
     NiceMock<mtd::MockClientContext> context;
     ON_CALL(context, populate_server_package(_))
@@ -201,7 +221,7 @@ TEST(ProbingClientPlatformFactory, DoesNotLeakTheUsedDriverModuleOnShutdown)
     mir::client::ProbingClientPlatformFactory factory(
         mir::report::null_shared_library_prober_report(),
         {preferred_module},
-        {}, nullptr);
+        {}, nullptr, nullptr);
 
     std::shared_ptr<mir::client::ClientPlatform> platform;
     NiceMock<mtd::MockClientContext> context;
@@ -227,7 +247,7 @@ TEST(ProbingClientPlatformFactory, DoesNotLeakUnusedDriverModulesOnStartup)
     mir::client::ProbingClientPlatformFactory factory(
         mir::report::null_shared_library_prober_report(),
         modules,
-        {}, nullptr);
+        {}, nullptr, nullptr);
 
     std::shared_ptr<mir::client::ClientPlatform> platform;
     NiceMock<mtd::MockClientContext> context;
@@ -264,7 +284,7 @@ TEST(ProbingClientPlatformFactory, DISABLED_CreatesMesaPlatformOnMesaKMS)
     mir::client::ProbingClientPlatformFactory factory(
         mir::report::null_shared_library_prober_report(),
         all_available_modules(),
-        {}, nullptr);
+        {}, nullptr, nullptr);
 
     NiceMock<mtd::MockClientContext> context;
     all_available_fixtures().at("mesa-kms").setup_context(context);
@@ -284,7 +304,7 @@ TEST(ProbingClientPlatformFactory, DISABLED_CreatesMesaPlatformOnMesaX11)
     mir::client::ProbingClientPlatformFactory factory(
         mir::report::null_shared_library_prober_report(),
         all_available_modules(),
-        {}, nullptr);
+        {}, nullptr, nullptr);
 
     NiceMock<mtd::MockClientContext> context;
     all_available_fixtures().at("mesa-x11").setup_context(context);
@@ -304,7 +324,7 @@ TEST(ProbingClientPlatformFactory, DISABLED_CreatesEglstreamPlatformOnEglstreamK
     mir::client::ProbingClientPlatformFactory factory(
         mir::report::null_shared_library_prober_report(),
         all_available_modules(),
-        {}, nullptr);
+        {}, nullptr, nullptr);
 
     NiceMock<mtd::MockClientContext> context;
     all_available_fixtures().at("eglstream-kms").setup_context(context);
@@ -325,10 +345,99 @@ TEST(ProbingClientPlatformFactory, IgnoresNonClientPlatformModules)
     mir::client::ProbingClientPlatformFactory factory(
         mir::report::null_shared_library_prober_report(),
         modules,
-        {}, nullptr);
+        {}, nullptr, nullptr);
 
     NiceMock<mtd::MockClientContext> context;
     dummy_fixture().setup_context(context);
 
     auto platform = factory.create_client_platform(&context);
 }
+
+TEST(ProbingClientPlatformFactory, LoadsOnlyTheModuleTheServerNames)
+{
+    using namespace testing;
+    auto const module = dummy_fixture().client_module_filename;
+    auto const report = std::make_shared<NiceMock<MockSharedLibraryProberReport>>();
+
+    mir::client::ProbingClientPlatformFactory factory(
+        report,
+        {},
+        {directory_of(module)}, nullptr, nullptr);
+
+    NiceMock<mtd::MockClientContext> context;
+    dummy_fixture().setup_context(context);
+    ON_CALL(context, client_module_hint()).WillByDefault(Return("dummy"));
+
+    EXPECT_CALL(*report, loading_library(Eq(module))).Times(1);
+    EXPECT_CALL(*report, loading_library(Ne(module))).Times(0);
+
+    factory.create_client_platform(&context);
+}
+
+TEST(ProbingClientPlatformFactory, LoadsOnlyTheModuleItChoseLastTime)
+{
+    using namespace testing;
+    auto const module = dummy_fixture().client_module_filename;
+    auto const report = std::make_shared<NiceMock<MockSharedLibraryProberReport>>();
+
+    mir::test::TemporaryDirectory const cache_directory;
+    auto const cache_file = cache_directory.path() + "/client-platform-modules";
+    auto const cache = std::make_shared<mir::client::PlatformModuleCache>(cache_file);
+
+    mir::client::ProbingClientPlatformFactory factory(
+        report,
+        {},
+        {directory_of(module)}, nullptr, cache);
+
+    NiceMock<mtd::MockClientContext> context;
+    dummy_fixture().setup_context(context);
+
+    factory.create_client_platform(&context);
+
+    Mock::VerifyAndClearExpectations(report.get());
+    EXPECT_CALL(*report, loading_library(Eq(module))).Times(1);
+    EXPECT_CALL(*report, loading_library(Ne(module))).Times(0);
+
+    factory.create_client_platform(&context);
+}
+
+TEST(ProbingClientPlatformFactory, IgnoresACachedModuleThatIsNotOnThePath)
+{
+    using namespace testing;
+    auto const module = dummy_fixture().client_module_filename;
+    auto const report = std::make_shared<NiceMock<MockSharedLibraryProberReport>>();
+
+    mir::test::TemporaryDirectory const cache_directory;
+    auto const cache_file = cache_directory.path() + "/client-platform-modules";
+    auto const cache = std::make_shared<mir::client::PlatformModuleCache>(cache_file);
+
+    mir::client::ProbingClientPlatformFactory factory(
+        report,
+        {},
+        {directory_of(module)}, nullptr, cache);
+
+    NiceMock<mtd::MockClientContext> context;
+    dummy_fixture().setup_context(context);
+
+    factory.create_client_platform(&context);
+
+    // Whoever can write the cache points it at a module of their own
+    auto const planted = cache_directory.path() + "/planted.so";
+    {
+        std::ifstream in{module, std::ios::binary};
+        std::ofstream out{planted, std::ios::binary};
+        out << in.rdbuf();
+    }
+    std::string key;
+    {
+        std::ifstream in{cache_file};
+        std::getline(in, key, '\t');
+    }
+    cache->record(key, planted);
+
+    Mock::VerifyAndClearExpectations(report.get());
+    EXPECT_CALL(*report, loading_library(Eq(planted))).Times(0);
+    EXPECT_CALL(*report, loading_library(Eq(module))).Times(1);
+
+    factory.create_client_platform(&context);
+}
@@ -35,6 +35,7 @@
 #include "mir/test/doubles/null_client_event_sink.h"
 #include "mir/test/doubles/mock_mir_buffer_stream.h"
 #include "mir/test/doubles/mock_client_buffer.h"
+#include "mir/test/doubles/mock_rpc_report.h"
 #include "mir/test/fd_utils.h"
 #include "mir/test/gmock_fixes.h"
 
@@ -248,7 +249,7 @@ public:
                   std::make_shared<mcl::BufferFactory>(),
                   std::make_shared<mcl::DisplayConfiguration>(),
                   std::make_shared<mir::input::InputDevices>(surface_map),
-                  std::make_shared<mclr::NullRpcReport>(),
+                  rpc_report,
                   std::make_shared<mir::input::receiver::NullInputReceiverReport>(),
                   lifecycle,
                   std::make_shared<mir::client::PingHandler>(),
@@ -257,6 +258,8 @@ public:
     {
     }
 
+    std::shared_ptr<testing::NiceMock<mtd::MockRpcReport>> const rpc_report{
+        std::make_shared<testing::NiceMock<mtd::MockRpcReport>>()};
     MockStreamTransport* transport;
     std::shared_ptr<mcl::LifecycleControl> lifecycle;
     std::shared_ptr<mcl::SurfaceMap> surface_map;
@@ -870,3 +873,115 @@ TEST_F(MirProtobufRpcChannelTest, ignores_delete_message_for_unknown_buffer)
 
     channel->on_data_available();
 }
+
+TEST_F(MirProtobufRpcChannelTest, asks_for_no_reply_when_there_is_nothing_to_complete)
+{
+    mclr::DisplayServer channel_user{channel};
+    mir::protobuf::BufferRequest request;
+    mir::protobuf::Void reply;
+
+    channel_user.submit_buffer(&request, nullptr, nullptr);
+    channel_user.submit_buffer(&request, &reply, google::protobuf::NewCallback([](){}));
+
+    ASSERT_EQ(2u, transport->sent_messages.size());
+
+    mir::protobuf::wire::Invocation wire_request;
+    wire_request.ParseFromArray(transport->sent_messages.front().data() + sizeof(uint16_t),
+                                transport->sent_messages.front().size() - sizeof(uint16_t));
+    EXPECT_TRUE(wire_request.no_reply());
+
+    wire_request.ParseFromArray(transport->sent_messages.back().data() + sizeof(uint16_t),
+                                transport->sent_messages.back().size() - sizeof(uint16_t));
+    EXPECT_FALSE(wire_request.no_reply());
+}
+
+namespace
+{
+void reply_to_last_invocation(MockStreamTransport& transport, mir::protobuf::Void const& response)
+{
+    mir::protobuf::wire::Invocation wire_request;
+    wire_request.ParseFromArray(transport.sent_messages.back().data() + sizeof(uint16_t),
+                                transport.sent_messages.back().size() - sizeof(uint16_t));
+
+    mir::protobuf::wire::Result wire_reply;
+    wire_reply.set_id(wire_request.id());
+    wire_reply.set_response(response.SerializeAsString());
+
+    std::vector<uint8_t> buffer(wire_reply.ByteSize() + sizeof(uint16_t));
+    *reinterpret_cast<uint16_t*>(buffer.data()) = htobe16(wire_reply.ByteSize());
+    wire_reply.SerializeToArray(buffer.data() + sizeof(uint16_t), buffer.size() - sizeof(uint16_t));
+    transport.add_server_message(buffer);
+}
+}
+
+TEST_F(MirProtobufRpcChannelTest, ignores_result_for_invocation_without_reply)
+{
+    using namespace testing;
+    mclr::DisplayServer channel_user{channel};
+    mir::protobuf::BufferRequest request;
+
+    channel_user.submit_buffer(&request, nullptr, nullptr);
+
+    // As a server that doesn't know about no_reply would send
+    reply_to_last_invocation(*transport, mir::protobuf::Void{});
+
+    EXPECT_CALL(*rpc_report, orphaned_result(_)).Times(0);
+
+    EXPECT_NO_THROW(channel->on_data_available());
+    EXPECT_TRUE(transport->all_data_consumed());
+}
+
+TEST_F(MirProtobufRpcChannelTest, recognises_error_for_invocation_without_reply)
+{
+    using namespace testing;
+    mclr::DisplayServer channel_user{channel};
+    mir::protobuf::BufferRequest request;
+
+    channel_user.submit_buffer(&request, nullptr, nullptr);
+
+    mir::protobuf::Void error;
+    error.set_error("no such buffer");
+    reply_to_last_invocation(*transport, error);
+
+    EXPECT_CALL(*rpc_report, orphaned_result(_)).Times(0);
+    EXPECT_CALL(*rpc_report, complete_response(_));
+
+    EXPECT_NO_THROW(channel->on_data_available());
+    EXPECT_TRUE(transport->all_data_consumed());
+}
+
+TEST_F(MirProtobufRpcChannelTest, reports_result_for_unknown_invocation_as_orphaned)
+{
+    using namespace testing;
+    mclr::DisplayServer channel_user{channel};
+    mir::protobuf::BufferRequest request;
+    mir::protobuf::Void reply;
+
+    channel_user.submit_buffer(&request, &reply, google::protobuf::NewCallback([](){}));
+    reply_to_last_invocation(*transport, mir::protobuf::Void{});
+    channel->on_data_available();
+
+    // A second result for the same invocation
+    reply_to_last_invocation(*transport, mir::protobuf::Void{});
+
+    EXPECT_CALL(*rpc_report, orphaned_result(_));
+
+    channel->on_data_available();
+}
+
+TEST(EventSequencer, processes_events_in_sequence_whatever_order_they_arrive)
+{
+    using namespace testing;
+
+    std::vector<std::string> processed;
+    mclr::detail::EventSequencer sequencer{[&](std::string const& raw) { processed.push_back(raw); }};
+
+    sequencer.deliver(1, "second");
+    sequencer.deliver(2, "third");
+    EXPECT_THAT(processed, IsEmpty());
+
+    sequencer.deliver(0, "first");
+    sequencer.deliver(3, "fourth");
+
+    EXPECT_THAT(processed, ElementsAre("first", "second", "third", "fourth"));
+}
@@ -35,6 +35,7 @@
 #include "mir/test/doubles/stub_scene.h"
 #include "mir/test/doubles/stub_scene_element.h"
 #include "mir/test/doubles/mock_scene.h"
+#include "mir/scene/observer.h"
 
 #include "mir/test/as_render_target.h"
 #include "mir/test/fake_shared.h"
@@ -512,3 +513,95 @@ TEST_F(CompositingScreencastTest, uses_requested_number_of_buffers)
 }
 
 
+
+TEST_F(CompositingScreencastTest, skips_compositing_into_buffer_that_is_already_current)
+{
+    using namespace testing;
+
+    mtd::StubGLBuffer stub_buffer;
+    NiceMock<mtd::MockScene> mock_scene;
+    MockDisplayBufferCompositorFactory mock_db_compositor_factory;
+
+    EXPECT_CALL(mock_db_compositor_factory.mock_db_compositor, composite_(_))
+        .Times(1);
+
+    mc::CompositingScreencast screencast{
+        mt::fake_shared(mock_scene),
+        mt::fake_shared(stub_display),
+        mt::fake_shared(stub_buffer_allocator),
+        mt::fake_shared(mock_db_compositor_factory)};
+
+    auto session_id = screencast.create_session(
+        default_region, default_size, default_pixel_format,
+        0, default_mirror_mode);
+
+    auto const buffer = mt::fake_shared(stub_buffer);
+    auto const first_damage = screencast.capture(session_id, buffer);
+    auto const second_damage = screencast.capture(session_id, buffer);
+
+    EXPECT_THAT(first_damage, Eq(geom::Rectangles{{{0, 0}, stub_buffer.size()}}));
+    EXPECT_THAT(second_damage.size(), Eq(0u));
+}
+
+TEST_F(CompositingScreencastTest, composites_into_buffer_again_after_scene_changes)
+{
+    using namespace testing;
+
+    mtd::StubGLBuffer stub_buffer;
+    NiceMock<mtd::MockScene> mock_scene;
+    MockDisplayBufferCompositorFactory mock_db_compositor_factory;
+    std::shared_ptr<mir::scene::Observer> observer;
+
+    ON_CALL(mock_scene, add_observer(_))
+        .WillByDefault(SaveArg<0>(&observer));
+    EXPECT_CALL(mock_db_compositor_factory.mock_db_compositor, composite_(_))
+        .Times(2);
+
+    mc::CompositingScreencast screencast{
+        mt::fake_shared(mock_scene),
+        mt::fake_shared(stub_display),
+        mt::fake_shared(stub_buffer_allocator),
+        mt::fake_shared(mock_db_compositor_factory)};
+
+    auto session_id = screencast.create_session(
+        default_region, default_size, default_pixel_format,
+        0, default_mirror_mode);
+
+    auto const buffer = mt::fake_shared(stub_buffer);
+    screencast.capture(session_id, buffer);
+
+    ASSERT_THAT(observer, NotNull());
+    observer->scene_changed();
+
+    auto const damage = screencast.capture(session_id, buffer);
+    EXPECT_THAT(damage, Eq(geom::Rectangles{{{0, 0}, stub_buffer.size()}}));
+}
+
+TEST_F(CompositingScreencastTest, composites_into_each_buffer_that_is_not_current)
+{
+    using namespace testing;
+
+    mtd::StubGLBuffer stub_buffer1;
+    mtd::StubGLBuffer stub_buffer2;
+    NiceMock<mtd::MockScene> mock_scene;
+    MockDisplayBufferCompositorFactory mock_db_compositor_factory;
+
+    EXPECT_CALL(mock_db_compositor_factory.mock_db_compositor, composite_(_))
+        .Times(2);
+
+    mc::CompositingScreencast screencast{
+        mt::fake_shared(mock_scene),
+        mt::fake_shared(stub_display),
+        mt::fake_shared(stub_buffer_allocator),
+        mt::fake_shared(mock_db_compositor_factory)};
+
+    auto session_id = screencast.create_session(
+        default_region, default_size, default_pixel_format,
+        0, default_mirror_mode);
+
+    screencast.capture(session_id, mt::fake_shared(stub_buffer1));
+    auto const damage = screencast.capture(session_id, mt::fake_shared(stub_buffer2));
+
+    /* The second buffer is composited, but shows the same as the first */
+    EXPECT_THAT(damage.size(), Eq(0u));
+}
@@ -184,6 +184,48 @@ TEST_F(DefaultDisplayBufferCompositor, rendering_reports_everything)
     compositor.composite(make_scene_elements({}));
 }
 
+TEST_F(DefaultDisplayBufferCompositor, reports_renderer_progress_as_frame_stages)
+{
+    using namespace testing;
+    auto report = std::make_shared<mtd::MockCompositorReport>();
+    std::shared_ptr<mir::renderer::FrameTimingObserver> observer;
+    auto const gpu_time = std::chrono::milliseconds{3};
+
+    EXPECT_CALL(mock_renderer, set_timing_observer(_))
+        .WillOnce(SaveArg<0>(&observer));
+    EXPECT_CALL(mock_renderer, render(_))
+        .WillOnce(InvokeWithoutArgs([&]
+            {
+                observer->gpu_completed(gpu_time);
+                observer->textures_bound();
+                observer->draw_submitted();
+            }));
+
+    Sequence seq;
+    EXPECT_CALL(*report, began_frame(_))
+        .InSequence(seq);
+    EXPECT_CALL(*report, frame_reached_stage(_, mc::FrameStage::scene_snapshotted))
+        .InSequence(seq);
+    EXPECT_CALL(*report, rendered_on_gpu(_, std::chrono::nanoseconds{gpu_time}))
+        .InSequence(seq);
+    EXPECT_CALL(*report, frame_reached_stage(_, mc::FrameStage::textures_bound))
+        .InSequence(seq);
+    EXPECT_CALL(*report, frame_reached_stage(_, mc::FrameStage::draw_submitted))
+        .InSequence(seq);
+    EXPECT_CALL(*report, rendered_frame(_))
+        .InSequence(seq);
+    EXPECT_CALL(*report, finished_frame(_))
+        .InSequence(seq);
+    EXPECT_CALL(*report, renderables_in_frame(_,_))
+        .Times(AnyNumber());
+
+    mc::DefaultDisplayBufferCompositor compositor(
+        display_buffer,
+        mt::fake_shared(mock_renderer),
+        report);
+    compositor.composite(make_scene_elements({}));
+}
+
 TEST_F(DefaultDisplayBufferCompositor, calls_renderer_in_sequence)
 {
     using namespace testing;
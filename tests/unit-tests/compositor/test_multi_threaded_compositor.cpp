@@ -93,6 +93,48 @@ private:
     std::vector<StubDisplaySyncGroup> buffers;
 };
 
+// Replaces its first output group on each configure(), keeping the others
+class PartlyReconfiguringDisplay : public mtd::NullDisplay
+{
+public:
+    PartlyReconfiguringDisplay(unsigned int ngroups)
+    {
+        for (auto i = 0u; i != ngroups; ++i)
+            groups.push_back(make_group());
+    }
+
+    void for_each_display_sync_group(std::function<void(mg::DisplaySyncGroup&)> const& f) override
+    {
+        for (auto& group : groups)
+            f(*group);
+    }
+
+    void for_each_display_sync_group_invalidated_by(
+        mg::DisplayConfiguration const&,
+        std::function<void(mg::DisplaySyncGroup&)> const& f) override
+    {
+        f(*groups.front());
+    }
+
+    void configure(mg::DisplayConfiguration const&) override
+    {
+        groups.front() = make_group();
+
+        if (fail_to_configure)
+            BOOST_THROW_EXCEPTION(std::runtime_error("Failed to configure display"));
+    }
+
+    bool fail_to_configure{false};
+
+private:
+    static std::unique_ptr<mtd::StubDisplaySyncGroup> make_group()
+    {
+        return std::make_unique<mtd::StubDisplaySyncGroup>(geom::Size{1920, 1080});
+    }
+
+    std::vector<std::unique_ptr<mtd::StubDisplaySyncGroup>> groups;
+};
+
 class StubScene : public mtd::StubScene
 {
 public:
@@ -457,6 +499,8 @@ TEST(MultiThreadedCompositor, reports_in_the_right_places)
         .Times(1);
     EXPECT_CALL(*mock_report, scheduled())
         .Times(2);
+    EXPECT_CALL(*mock_report, frame_reached_stage(_, mc::FrameStage::flip_completed))
+        .Times(AtLeast(1));
 
     EXPECT_CALL(*mock_report, stopped())
         .Times(AtLeast(1));
@@ -944,3 +988,52 @@ TEST(MultiThreadedCompositor, can_schedule_from_display_observer_when_removing_d
         display, stub_scene, db_compositor_factory, mock_display_listener, mock_report, default_delay, true};
     compositor.start();
 }
+
+TEST(MultiThreadedCompositor, configuring_display_only_restarts_compositing_to_invalidated_output_groups)
+{
+    using namespace testing;
+    unsigned int const ngroups{3};
+    auto display = std::make_shared<PartlyReconfiguringDisplay>(ngroups);
+    auto mock_scene = std::make_shared<NiceMock<mtd::MockScene>>();
+    auto db_compositor_factory = std::make_shared<mtd::NullDisplayBufferCompositorFactory>();
+    auto mock_report = std::make_shared<testing::NiceMock<mtd::MockCompositorReport>>();
+
+    mc::MultiThreadedCompositor compositor{
+        display, mock_scene, db_compositor_factory, null_display_listener, mock_report, default_delay, true};
+
+    compositor.start();
+
+    EXPECT_CALL(*mock_scene, unregister_compositor(_)).Times(1);
+    EXPECT_CALL(*mock_scene, register_compositor(_)).Times(1);
+    EXPECT_CALL(*mock_report, stopped()).Times(0);
+
+    compositor.configure_display(*display, mtd::NullDisplayConfiguration{});
+
+    Mock::VerifyAndClearExpectations(mock_scene.get());
+    Mock::VerifyAndClearExpectations(mock_report.get());
+}
+
+TEST(MultiThreadedCompositor, composites_to_every_output_group_when_configuring_display_fails)
+{
+    using namespace testing;
+    unsigned int const ngroups{3};
+    auto display = std::make_shared<PartlyReconfiguringDisplay>(ngroups);
+    auto mock_scene = std::make_shared<NiceMock<mtd::MockScene>>();
+    auto db_compositor_factory = std::make_shared<mtd::NullDisplayBufferCompositorFactory>();
+    auto mock_report = std::make_shared<testing::NiceMock<mtd::MockCompositorReport>>();
+
+    mc::MultiThreadedCompositor compositor{
+        display, mock_scene, db_compositor_factory, null_display_listener, mock_report, default_delay, true};
+
+    compositor.start();
+
+    display->fail_to_configure = true;
+    EXPECT_CALL(*mock_scene, register_compositor(_)).Times(1);
+
+    EXPECT_THROW(compositor.configure_display(*display, mtd::NullDisplayConfiguration{}), std::runtime_error);
+
+    Mock::VerifyAndClearExpectations(mock_scene.get());
+
+    EXPECT_CALL(*mock_scene, unregister_compositor(_)).Times(ngroups);
+    compositor.stop();
+}
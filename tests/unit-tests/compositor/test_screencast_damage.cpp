@@ -0,0 +1,126 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/compositor/screencast_damage.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace mc = mir::compositor;
+namespace geom = mir::geometry;
+
+using namespace testing;
+
+namespace
+{
+struct ScreencastDamage : Test
+{
+    geom::Rectangle const region{{100, 200}, {400, 300}};
+    geom::Size const buffer_size{400, 300};
+    mc::ScreencastDamage damage{region};
+
+    ScreencastDamage()
+    {
+        // Start from a capture that has taken the initial full damage
+        damage.take(buffer_size, mir_mirror_mode_none);
+    }
+};
+}
+
+TEST(ScreencastDamageInitially, reports_everything)
+{
+    mc::ScreencastDamage damage{{{0, 0}, {640, 480}}};
+
+    EXPECT_THAT(damage.take({320, 240}, mir_mirror_mode_none),
+                Eq(geom::Rectangles{{{0, 0}, {320, 240}}}));
+}
+
+TEST_F(ScreencastDamage, reports_nothing_when_nothing_changed)
+{
+    auto const generation = damage.generation();
+
+    EXPECT_THAT(damage.take(buffer_size, mir_mirror_mode_none).size(), Eq(0u));
+    EXPECT_THAT(damage.generation(), Eq(generation));
+}
+
+TEST_F(ScreencastDamage, ignores_damage_outside_capture_region)
+{
+    auto const generation = damage.generation();
+
+    damage.add({{0, 0}, {100, 100}});
+    damage.add({{500, 200}, {10, 10}});
+
+    EXPECT_THAT(damage.take(buffer_size, mir_mirror_mode_none).size(), Eq(0u));
+    EXPECT_THAT(damage.generation(), Eq(generation));
+}
+
+TEST_F(ScreencastDamage, reports_damage_relative_to_capture_region)
+{
+    auto const generation = damage.generation();
+
+    damage.add({{50, 250}, {100, 20}});
+
+    EXPECT_THAT(damage.take(buffer_size, mir_mirror_mode_none),
+                Eq(geom::Rectangles{{{0, 50}, {50, 20}}}));
+    EXPECT_THAT(damage.generation(), Ne(generation));
+}
+
+TEST_F(ScreencastDamage, scales_damage_to_buffer_rounding_outwards)
+{
+    damage.add({{101, 201}, {3, 3}});
+
+    EXPECT_THAT(damage.take({200, 150}, mir_mirror_mode_none),
+                Eq(geom::Rectangles{{{0, 0}, {2, 2}}}));
+}
+
+TEST_F(ScreencastDamage, mirrors_damage_with_the_image)
+{
+    damage.add({{100, 200}, {10, 20}});
+    EXPECT_THAT(damage.take(buffer_size, mir_mirror_mode_horizontal),
+                Eq(geom::Rectangles{{{390, 0}, {10, 20}}}));
+
+    damage.add({{100, 200}, {10, 20}});
+    EXPECT_THAT(damage.take(buffer_size, mir_mirror_mode_vertical),
+                Eq(geom::Rectangles{{{0, 280}, {10, 20}}}));
+}
+
+TEST_F(ScreencastDamage, drops_repeated_damage)
+{
+    damage.add({{150, 250}, {10, 10}});
+    damage.add({{150, 250}, {10, 10}});
+    damage.add({{152, 252}, {5, 5}});
+
+    EXPECT_THAT(damage.take(buffer_size, mir_mirror_mode_none).size(), Eq(1u));
+}
+
+TEST_F(ScreencastDamage, merges_excessive_damage_into_bounding_rectangle)
+{
+    for (int i = 0; i <= static_cast<int>(mc::ScreencastDamage::max_rectangles); ++i)
+        damage.add({{100 + 2 * i, 200 + 2 * i}, {1, 1}});
+
+    auto const n = static_cast<int>(mc::ScreencastDamage::max_rectangles);
+    EXPECT_THAT(damage.take(buffer_size, mir_mirror_mode_none),
+                Eq(geom::Rectangles{{{0, 0}, {2 * n + 1, 2 * n + 1}}}));
+}
+
+TEST_F(ScreencastDamage, scene_changes_damage_everything)
+{
+    damage.add({{150, 250}, {10, 10}});
+    damage.add_everything();
+
+    EXPECT_THAT(damage.take(buffer_size, mir_mirror_mode_none),
+                Eq(geom::Rectangles{{{0, 0}, buffer_size}}));
+}
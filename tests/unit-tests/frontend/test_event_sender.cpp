@@ -23,6 +23,8 @@
 #include "src/server/frontend/event_sender.h"
 
 #include "mir/events/event_builders.h"
+#include "mir/events/event_private.h"
+#include "mir/events/event_ring.h"
 #include "mir/client_visible_error.h"
 
 #include "mir/test/display_config_matchers.h"
@@ -32,6 +34,7 @@
 #include "mir/test/doubles/stub_buffer.h"
 #include "mir/test/doubles/stub_input_device.h"
 #include "mir/test/doubles/mock_platform_ipc_operations.h"
+#include "mir/test/doubles/mock_input_report.h"
 #include "mir/input/device.h"
 #include "mir/input/device_capability.h"
 #include "mir/input/mir_input_config.h"
@@ -112,11 +115,15 @@ struct MockMsgSender : public mf::MessageSender
 struct EventSender : public testing::Test
 {
     EventSender()
-        : event_sender(mt::fake_shared(mock_msg_sender), mt::fake_shared(mock_buffer_packer))
+        : event_sender(
+            mt::fake_shared(mock_msg_sender),
+            mt::fake_shared(mock_buffer_packer),
+            mt::fake_shared(mock_input_report))
     {
     }
     MockMsgSender mock_msg_sender;
     mtd::MockPlatformIpcOperations mock_buffer_packer;
+    testing::NiceMock<mtd::MockInputReport> mock_input_report;
     mfd::EventSender event_sender;
 };
 
@@ -307,3 +314,135 @@ TEST_F(EventSender, sends_errors)
 
     event_sender.handle_error(error);
 }
+
+TEST_F(EventSender, reports_input_event_before_and_after_sending_it)
+{
+    using namespace testing;
+
+    std::chrono::nanoseconds const event_time{123456789};
+    auto const event = mev::make_event(
+        MirInputDeviceId{1}, event_time, std::vector<uint8_t>{}, mir_keyboard_action_down, 0, 42, mir_input_event_modifier_none);
+
+    {
+        InSequence seq;
+        EXPECT_CALL(mock_input_report, event_reached_stage(mi::InputPipelineStage::surface_dispatched, event_time.count()));
+        EXPECT_CALL(mock_msg_sender, send(_, _, _));
+        EXPECT_CALL(mock_input_report, event_reached_stage(mi::InputPipelineStage::sent_to_client, event_time.count()));
+    }
+
+    event_sender.handle_event(*event);
+}
+
+TEST_F(EventSender, does_not_report_non_input_events)
+{
+    using namespace testing;
+
+    auto const event = mev::make_event(mir::frontend::SurfaceId{1}, mir_window_attrib_focus, mir_window_focus_state_focused);
+
+    EXPECT_CALL(mock_input_report, event_reached_stage(_, _)).Times(0);
+    EXPECT_CALL(mock_msg_sender, send(_, _, _));
+
+    event_sender.handle_event(*event);
+}
+
+TEST_F(EventSender, delivers_input_events_through_event_ring)
+{
+    using namespace testing;
+
+    auto const ring = std::make_shared<mev::EventRing>();
+    mev::EventRing client_ring{ring->shm_fd(), ring->wakeup_fd()};
+    mfd::EventSender ring_sender{
+        mt::fake_shared(mock_msg_sender), mt::fake_shared(mock_buffer_packer), mt::fake_shared(mock_input_report), ring};
+
+    auto const event = mev::make_event(
+        MirInputDeviceId{1}, std::chrono::nanoseconds{7}, std::vector<uint8_t>{}, mir_keyboard_action_down, 0, 42, mir_input_event_modifier_none);
+
+    EXPECT_CALL(mock_msg_sender, send(_, _, _)).Times(0);
+    ring_sender.handle_event(*event);
+
+    std::string raw;
+    ASSERT_TRUE(client_ring.pop(raw));
+    auto const received = MirEvent::deserialize(raw);
+    ASSERT_THAT(received->type(), Eq(mir_event_type_input));
+    EXPECT_THAT(received->to_input()->to_keyboard()->scan_code(), Eq(42));
+}
+
+TEST_F(EventSender, delivers_noninput_events_through_event_ring_too)
+{
+    using namespace testing;
+
+    auto const ring = std::make_shared<mev::EventRing>();
+    mev::EventRing client_ring{ring->shm_fd(), ring->wakeup_fd()};
+    mfd::EventSender ring_sender{
+        mt::fake_shared(mock_msg_sender), mt::fake_shared(mock_buffer_packer), mt::fake_shared(mock_input_report), ring};
+
+    auto const event = mev::make_event(mf::SurfaceId{1}, mir_window_attrib_focus, mir_window_focus_state_focused);
+
+    EXPECT_CALL(mock_msg_sender, send(_, _, _)).Times(0);
+    ring_sender.handle_event(*event);
+
+    EXPECT_FALSE(ring->empty());
+}
+
+TEST_F(EventSender, sends_events_over_the_socket_until_the_client_maps_the_event_ring)
+{
+    using namespace testing;
+
+    auto const ring = std::make_shared<mev::EventRing>();
+    mfd::EventSender ring_sender{
+        mt::fake_shared(mock_msg_sender), mt::fake_shared(mock_buffer_packer), mt::fake_shared(mock_input_report), ring};
+
+    auto const event = mev::make_event(mf::SurfaceId{1}, mir_window_attrib_focus, mir_window_focus_state_focused);
+
+    EXPECT_CALL(mock_msg_sender, send(_, _, _)).Times(1);
+    ring_sender.handle_event(*event);
+    Mock::VerifyAndClearExpectations(&mock_msg_sender);
+
+    mev::EventRing client_ring{ring->shm_fd(), ring->wakeup_fd()};
+
+    EXPECT_CALL(mock_msg_sender, send(_, _, _)).Times(0);
+    ring_sender.handle_event(*event);
+
+    std::string raw;
+    uint64_t number;
+    ASSERT_TRUE(client_ring.pop(raw, number));
+    EXPECT_THAT(number, Eq(1u));
+}
+
+TEST_F(EventSender, numbers_events_in_the_order_sent_whether_through_event_ring_or_socket)
+{
+    using namespace testing;
+
+    auto const ring = std::make_shared<mev::EventRing>();
+    mev::EventRing client_ring{ring->shm_fd(), ring->wakeup_fd()};
+    mfd::EventSender ring_sender{
+        mt::fake_shared(mock_msg_sender), mt::fake_shared(mock_buffer_packer), mt::fake_shared(mock_input_report), ring};
+
+    auto const event = mev::make_event(
+        MirInputDeviceId{1}, std::chrono::nanoseconds{7}, std::vector<uint8_t>{}, mir_keyboard_action_down, 0, 42, mir_input_event_modifier_none);
+
+    while (ring->push(MirEvent::serialize(event.get())))
+        ;
+
+    std::string sent;
+    EXPECT_CALL(mock_msg_sender, send(_, _, _))
+        .WillOnce(Invoke([&](char const* data, size_t length, mf::FdSets const&) { sent.assign(data, length); }));
+    ring_sender.handle_event(*event);
+
+    mir::protobuf::wire::Result result;
+    ASSERT_TRUE(result.ParseFromString(sent));
+    mir::protobuf::EventSequence sequence;
+    ASSERT_TRUE(sequence.ParseFromString(result.events(0)));
+    ASSERT_THAT(sequence.event_size(), Eq(1));
+    EXPECT_THAT(sequence.event(0).sequence(), Eq(0u));
+
+    std::string raw;
+    uint64_t number;
+    while (client_ring.pop(raw, number))
+        ;
+
+    ring_sender.handle_event(*event);
+
+    ASSERT_TRUE(client_ring.pop(raw, number));
+    EXPECT_THAT(number, Eq(1u));
+}
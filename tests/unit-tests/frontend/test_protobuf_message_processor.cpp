@@ -43,6 +43,11 @@ struct StubProtobufMessageSender : mfd::ProtobufMessageSender
     }
 };
 
+struct MockProtobufMessageSender : mfd::ProtobufMessageSender
+{
+    MOCK_METHOD3(send_response, void(gp::uint32, gp::MessageLite*, mf::FdSets const&));
+};
+
 struct StubMessageProcessorReport : mf::MessageProcessorReport
 {
     void received_invocation(void const*, int, std::string const&) override
@@ -87,6 +92,18 @@ struct StubDisplayServer : mtd::StubDisplayServer
         changed_during_create_bstream_closure = before != after;
     }
 
+    void submit_buffer(
+        mp::BufferRequest const*,
+        mp::Void* response,
+        google::protobuf::Closure* closure) override
+    {
+        if (fail_submission)
+            response->set_error("submission failed");
+        closure->Run();
+    }
+
+    bool fail_submission{false};
+
     bool changed_during_create_surface_closure;
     bool changed_during_create_bstream_closure;
 };
@@ -151,3 +168,76 @@ TEST(ProtobufMessageProcessor, doesnt_inject_buffers_when_creating_bstream)
     mp->dispatch(invocation, fds);
     EXPECT_FALSE(stub_display_server.changed_during_create_bstream_closure);
 }
+
+namespace
+{
+mpw::Invocation submit_buffer_invocation(bool no_reply)
+{
+    mpw::Invocation raw_invocation;
+    mp::BufferRequest request;
+    request.mutable_id()->set_value(1);
+    request.mutable_buffer()->set_buffer_id(2);
+    std::string str_parameters;
+    request.SerializeToString(&str_parameters);
+    raw_invocation.set_id(3);
+    raw_invocation.set_parameters(str_parameters);
+    raw_invocation.set_method_name("submit_buffer");
+    raw_invocation.set_no_reply(no_reply);
+    return raw_invocation;
+}
+}
+
+TEST(ProtobufMessageProcessor, responds_to_submit_buffer)
+{
+    using namespace testing;
+    MockProtobufMessageSender mock_msg_sender;
+    StubMessageProcessorReport stub_report;
+    StubDisplayServer stub_display_server;
+    std::shared_ptr<mfd::MessageProcessor> const processor = std::make_shared<mfd::ProtobufMessageProcessor>(
+        mt::fake_shared(mock_msg_sender),
+        mt::fake_shared(stub_display_server),
+        mt::fake_shared(stub_report));
+
+    EXPECT_CALL(mock_msg_sender, send_response(3, _, _));
+
+    auto const raw_invocation = submit_buffer_invocation(false);
+    std::vector<mir::Fd> fds;
+    processor->dispatch(mfd::Invocation{raw_invocation}, fds);
+}
+
+TEST(ProtobufMessageProcessor, doesnt_respond_to_submit_buffer_without_reply)
+{
+    using namespace testing;
+    MockProtobufMessageSender mock_msg_sender;
+    StubMessageProcessorReport stub_report;
+    StubDisplayServer stub_display_server;
+    std::shared_ptr<mfd::MessageProcessor> const processor = std::make_shared<mfd::ProtobufMessageProcessor>(
+        mt::fake_shared(mock_msg_sender),
+        mt::fake_shared(stub_display_server),
+        mt::fake_shared(stub_report));
+
+    EXPECT_CALL(mock_msg_sender, send_response(_, _, _)).Times(0);
+
+    auto const raw_invocation = submit_buffer_invocation(true);
+    std::vector<mir::Fd> fds;
+    processor->dispatch(mfd::Invocation{raw_invocation}, fds);
+}
+
+TEST(ProtobufMessageProcessor, reports_submit_buffer_errors_even_without_reply)
+{
+    using namespace testing;
+    MockProtobufMessageSender mock_msg_sender;
+    StubMessageProcessorReport stub_report;
+    StubDisplayServer stub_display_server;
+    stub_display_server.fail_submission = true;
+    std::shared_ptr<mfd::MessageProcessor> const processor = std::make_shared<mfd::ProtobufMessageProcessor>(
+        mt::fake_shared(mock_msg_sender),
+        mt::fake_shared(stub_display_server),
+        mt::fake_shared(stub_report));
+
+    EXPECT_CALL(mock_msg_sender, send_response(3, _, _));
+
+    auto const raw_invocation = submit_buffer_invocation(true);
+    std::vector<mir::Fd> fds;
+    processor->dispatch(mfd::Invocation{raw_invocation}, fds);
+}
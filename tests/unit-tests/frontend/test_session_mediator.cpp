@@ -891,6 +891,35 @@ TEST_F(SessionMediator, allocates_native_buffers)
     EXPECT_THAT(allocator->allocated_buffers.size(), Eq(1));
 }
 
+TEST_F(SessionMediator, sends_preallocated_buffers_with_new_surface)
+{
+    using namespace testing;
+    auto const preallocated = 2;
+
+    mediator.connect(&connect_parameters, &connection, null_callback.get());
+    surface_parameters.set_preallocate_buffers(preallocated);
+    mediator.create_surface(&surface_parameters, &surface_response, null_callback.get());
+
+    ASSERT_THAT(surface_response.buffer_stream().preallocated_buffer_size(), Eq(preallocated));
+    ASSERT_THAT(allocator->allocated_buffers.size(), Eq(preallocated));
+    for (auto i = 0; i < preallocated; i++)
+    {
+        EXPECT_THAT(surface_response.buffer_stream().preallocated_buffer(i).buffer_id(),
+            Eq(allocator->allocated_buffers[i].lock()->id().as_value()));
+    }
+}
+
+TEST_F(SessionMediator, limits_how_many_buffers_it_preallocates)
+{
+    using namespace testing;
+
+    mediator.connect(&connect_parameters, &connection, null_callback.get());
+    surface_parameters.set_preallocate_buffers(1000);
+    mediator.create_surface(&surface_parameters, &surface_response, null_callback.get());
+
+    EXPECT_THAT(surface_response.buffer_stream().preallocated_buffer_size(), Lt(1000));
+}
+
 TEST_F(SessionMediator, removes_buffer)
 {
     using namespace testing;
@@ -1001,7 +1030,7 @@ TEST_F(SessionMediator, events_sent_before_surface_creation_reply_are_buffered)
         std::unique_ptr<mf::EventSink> create_sink(
             std::shared_ptr<mf::MessageSender> const& sender)
         {
-            return std::make_unique<mf::detail::EventSender>(sender, ops);
+            return std::make_unique<mf::detail::EventSender>(sender, ops, mr::null_input_report());
         }
 
     private:
@@ -1340,7 +1369,50 @@ TEST_F(SessionMediator, screencast_to_buffer_looks_up_and_fills_appropriate_buff
     screencast_request.mutable_id()->set_value(screencast_id.as_value());
     screencast_request.set_buffer_id(allocator->allocated_buffers.front().lock()->id().as_value());
 
-    mediator->screencast_to_buffer(&screencast_request, &null, null_callback.get());
+    mp::ScreencastCapture capture;
+    mediator->screencast_to_buffer(&screencast_request, &capture, null_callback.get());
+}
+
+TEST_F(SessionMediator, screencast_to_buffer_reports_damage)
+{
+    mp::Void null;
+    mp::ScreencastParameters screencast_parameters;
+    screencast_parameters.set_num_buffers(0);
+    mp::Screencast screencast;
+    mp::BufferAllocation request;
+    auto buffer_request = request.add_buffer_requests();
+    buffer_request->set_width(100);
+    buffer_request->set_height(129);
+    buffer_request->set_pixel_format(mir_pixel_format_abgr_8888);
+    buffer_request->set_buffer_usage(mir_buffer_usage_hardware);
+    mf::ScreencastSessionId screencast_id{7};
+    geom::Rectangles const damage{{{10, 20}, {30, 40}}, {{50, 60}, {5, 6}}};
+    auto mock_screencast = std::make_shared<NiceMock<mtd::MockScreencast>>();
+
+    ON_CALL(*mock_screencast, create_session(_,_,_,_,_))
+        .WillByDefault(Return(screencast_id));
+    EXPECT_CALL(*mock_screencast, capture(screencast_id, _))
+        .WillOnce(Return(damage));
+
+    auto mediator = create_session_mediator_with_screencast(mock_screencast);
+    mediator->connect(&connect_parameters, &connection, null_callback.get());
+    mediator->allocate_buffers(&request, &null, null_callback.get());
+    mediator->create_screencast(&screencast_parameters, &screencast, null_callback.get());
+
+    mp::ScreencastRequest screencast_request;
+    screencast_request.mutable_id()->set_value(screencast_id.as_value());
+    screencast_request.set_buffer_id(allocator->allocated_buffers.front().lock()->id().as_value());
+
+    mp::ScreencastCapture capture;
+    mediator->screencast_to_buffer(&screencast_request, &capture, null_callback.get());
+
+    EXPECT_TRUE(capture.damage_reported());
+    ASSERT_THAT(capture.damage_size(), Eq(2));
+    EXPECT_THAT(capture.damage(0).left(), Eq(10));
+    EXPECT_THAT(capture.damage(0).top(), Eq(20));
+    EXPECT_THAT(capture.damage(0).width(), Eq(30u));
+    EXPECT_THAT(capture.damage(0).height(), Eq(40u));
+    EXPECT_THAT(capture.damage(1).left(), Eq(50));
 }
 
 TEST_F(SessionMediator, buffer_releases_are_sent_from_specified_executor)
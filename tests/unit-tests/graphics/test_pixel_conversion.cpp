@@ -0,0 +1,225 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/graphics/pixel_conversion.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace mg = mir::graphics;
+using namespace testing;
+
+namespace
+{
+// Pixel counts that exercise both the vector loops and the scalar tails
+size_t const pixel_counts[] = {0, 1, 3, 4, 7, 8, 9, 15, 16, 17, 31, 33, 100};
+
+std::vector<uint8_t> pattern(size_t size)
+{
+    std::vector<uint8_t> bytes(size);
+    for (size_t i = 0; i != size; ++i)
+        bytes[i] = static_cast<uint8_t>(i * 37 + 11);
+    return bytes;
+}
+
+uint32_t word_at(std::vector<uint8_t> const& bytes, size_t pixel)
+{
+    uint32_t value;
+    std::memcpy(&value, &bytes[4 * pixel], sizeof value);
+    return value;
+}
+}
+
+TEST(PixelConversion, swaps_red_and_blue)
+{
+    for (auto const count : pixel_counts)
+    {
+        auto const src = pattern(4 * count);
+        std::vector<uint8_t> dst(4 * count);
+
+        mg::swap_red_blue_8888(src.data(), dst.data(), count);
+
+        for (size_t i = 0; i != count; ++i)
+        {
+            auto const p = word_at(src, i);
+            EXPECT_THAT(word_at(dst, i),
+                Eq((p & 0xff00ff00) | ((p >> 16) & 0xff) | ((p & 0xff) << 16))) << "pixel " << i << " of " << count;
+        }
+    }
+}
+
+TEST(PixelConversion, swaps_red_and_blue_in_place)
+{
+    auto const original = pattern(4 * 33);
+    auto pixels = original;
+
+    mg::swap_red_blue_8888(pixels.data(), pixels.data(), 33);
+    mg::swap_red_blue_8888(pixels.data(), pixels.data(), 33);
+
+    EXPECT_THAT(pixels, ContainerEq(original));
+}
+
+TEST(PixelConversion, expands_888_with_opaque_alpha)
+{
+    for (auto const swap : {false, true})
+    {
+        for (auto const count : pixel_counts)
+        {
+            auto const src = pattern(3 * count);
+            std::vector<uint8_t> dst(4 * count);
+
+            mg::expand_888_to_8888(src.data(), dst.data(), count, swap);
+
+            for (size_t i = 0; i != count; ++i)
+            {
+                EXPECT_THAT(dst[4*i + 0], Eq(src[3*i + (swap ? 2 : 0)]));
+                EXPECT_THAT(dst[4*i + 1], Eq(src[3*i + 1]));
+                EXPECT_THAT(dst[4*i + 2], Eq(src[3*i + (swap ? 0 : 2)]));
+                EXPECT_THAT(dst[4*i + 3], Eq(0xff));
+            }
+        }
+    }
+}
+
+TEST(PixelConversion, pack_is_the_inverse_of_expand)
+{
+    for (auto const swap : {false, true})
+    {
+        for (auto const count : pixel_counts)
+        {
+            auto const original = pattern(3 * count);
+            std::vector<uint8_t> expanded(4 * count);
+            std::vector<uint8_t> packed(3 * count);
+
+            mg::expand_888_to_8888(original.data(), expanded.data(), count, swap);
+            mg::pack_8888_to_888(expanded.data(), packed.data(), count, swap);
+
+            EXPECT_THAT(packed, ContainerEq(original));
+        }
+    }
+}
+
+TEST(PixelConversion, expands_565_to_full_range)
+{
+    uint16_t const src[] = {0x0000, 0xffff, 0xf800, 0x07e0, 0x001f, 0x8410, 0x0000, 0xffff, 0xf800};
+    uint32_t const expected[] = {
+        0xff000000, 0xffffffff, 0xffff0000, 0xff00ff00, 0xff0000ff, 0xff848284, 0xff000000, 0xffffffff, 0xffff0000};
+    uint32_t dst[9];
+
+    mg::expand_565_to_8888(src, dst, 9);
+
+    EXPECT_THAT(dst, ElementsAreArray(expected));
+}
+
+TEST(PixelConversion, premultiplies_colour_channels_by_alpha)
+{
+    for (auto const count : pixel_counts)
+    {
+        auto const src = pattern(4 * count);
+        std::vector<uint8_t> dst(4 * count);
+
+        mg::premultiply_alpha_8888(src.data(), dst.data(), count);
+
+        for (size_t i = 0; i != count; ++i)
+        {
+            auto const alpha = src[4*i + 3];
+            for (size_t channel = 0; channel != 3; ++channel)
+            {
+                auto const exact = src[4*i + channel] * alpha / 255.0;
+                EXPECT_THAT(dst[4*i + channel], Eq(static_cast<uint8_t>(exact + 0.5)));
+            }
+            EXPECT_THAT(dst[4*i + 3], Eq(alpha));
+        }
+    }
+}
+
+TEST(PixelConversion, premultiplies_the_same_with_and_without_vector_instructions)
+{
+    // Every combination of colour and alpha, in runs long enough for any kernel
+    std::vector<uint8_t> src(4 * 256 * 256);
+    for (size_t i = 0; i != 256 * 256; ++i)
+    {
+        src[4*i + 0] = static_cast<uint8_t>(i);
+        src[4*i + 1] = static_cast<uint8_t>(255 - i);
+        src[4*i + 2] = static_cast<uint8_t>(i * 7);
+        src[4*i + 3] = static_cast<uint8_t>(i >> 8);
+    }
+
+    for (auto const offset : pixel_counts)
+    {
+        auto const count = 256 * 256 - offset;
+        std::vector<uint8_t> vector_dst(4 * count);
+        std::vector<uint8_t> scalar_dst(4 * count);
+
+        mg::premultiply_alpha_8888(src.data() + 4 * offset, vector_dst.data(), count);
+        mg::detail::premultiply_alpha_8888_scalar(src.data() + 4 * offset, scalar_dst.data(), count);
+
+        auto const difference = std::mismatch(vector_dst.begin(), vector_dst.end(), scalar_dst.begin());
+        EXPECT_THAT(difference.first, Eq(vector_dst.end()))
+            << "byte " << (difference.first - vector_dst.begin()) << " starting at pixel " << offset;
+    }
+}
+
+TEST(PixelConversion, premultiplies_in_place)
+{
+    auto pixels = pattern(4 * 33);
+    std::vector<uint8_t> expected(pixels.size());
+    mg::detail::premultiply_alpha_8888_scalar(pixels.data(), expected.data(), 33);
+
+    mg::premultiply_alpha_8888(pixels.data(), pixels.data(), 33);
+
+    EXPECT_THAT(pixels, ContainerEq(expected));
+}
+
+TEST(PixelConversion, copies_flipped)
+{
+    size_t const src_stride = 8, dst_stride = 6, line_size = 5, height = 3;
+    auto const src = pattern(src_stride * height);
+    std::vector<uint8_t> dst(dst_stride * height);
+
+    mg::copy_flipped(src.data(), src_stride, dst.data(), dst_stride, line_size, height);
+
+    for (size_t line = 0; line != height; ++line)
+    {
+        EXPECT_THAT(
+            std::vector<uint8_t>(&dst[line * dst_stride], &dst[line * dst_stride + line_size]),
+            ElementsAreArray(&src[(height - line - 1) * src_stride], line_size));
+    }
+}
+
+TEST(PixelConversion, flips_in_place_swapping_red_and_blue)
+{
+    size_t const width = 9, height = 5, stride = width * 4;
+    auto const original = pattern(stride * height);
+
+    auto flipped = original;
+    mg::flip_in_place_8888(flipped.data(), stride, width, height, true);
+
+    for (size_t line = 0; line != height; ++line)
+    {
+        std::vector<uint8_t> expected(stride);
+        mg::swap_red_blue_8888(&original[(height - line - 1) * stride], expected.data(), width);
+
+        EXPECT_THAT(
+            std::vector<uint8_t>(&flipped[line * stride], &flipped[(line + 1) * stride]),
+            ContainerEq(expected));
+    }
+}
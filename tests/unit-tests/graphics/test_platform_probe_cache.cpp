@@ -0,0 +1,120 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/graphics/platform_probe_cache.h"
+
+#include "mir_test_framework/udev_environment.h"
+#include "mir/test/temporary_file.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <fstream>
+
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace mg = mir::graphics;
+namespace mtf = mir_test_framework;
+using namespace testing;
+
+namespace
+{
+struct PlatformProbeCache : Test
+{
+    PlatformProbeCache()
+    {
+        std::ofstream{module} << "not really a module";
+    }
+
+    mir::test::TemporaryDirectory const temporary_directory;
+    std::string const& directory{temporary_directory.path()};
+    std::string const module{directory + "/graphics-module.so.16"};
+    std::string const cache_file{directory + "/cache/graphics-platform"};
+    mtf::UdevEnvironment udev;
+};
+}
+
+TEST_F(PlatformProbeCache, knows_nothing_at_first)
+{
+    mg::PlatformProbeCache cache{cache_file};
+
+    EXPECT_FALSE(cache.lookup(mg::platform_fingerprint({module})));
+}
+
+TEST_F(PlatformProbeCache, remembers_choice_across_instances)
+{
+    auto const fingerprint = mg::platform_fingerprint({module});
+    mg::PlatformProbeCache{cache_file}.record(fingerprint, {module, mg::best});
+
+    mg::PlatformProbeCache cache{cache_file};
+    auto const choice = cache.lookup(fingerprint);
+
+    ASSERT_TRUE(choice);
+    EXPECT_THAT(choice.value().module, Eq(module));
+    EXPECT_THAT(choice.value().priority, Eq(mg::best));
+}
+
+TEST_F(PlatformProbeCache, ignores_choice_for_another_fingerprint)
+{
+    mg::PlatformProbeCache cache{cache_file};
+    cache.record(mg::platform_fingerprint({module}), {module, mg::best});
+
+    EXPECT_FALSE(cache.lookup(mg::platform_fingerprint({})));
+}
+
+TEST_F(PlatformProbeCache, does_nothing_without_a_file)
+{
+    mg::PlatformProbeCache cache{""};
+    auto const fingerprint = mg::platform_fingerprint({module});
+
+    cache.record(fingerprint, {module, mg::best});
+
+    EXPECT_FALSE(cache.lookup(fingerprint));
+}
+
+TEST_F(PlatformProbeCache, fingerprint_is_stable)
+{
+    udev.add_standard_device("standard-drm-devices");
+
+    EXPECT_THAT(mg::platform_fingerprint({module}), Eq(mg::platform_fingerprint({module})));
+}
+
+TEST_F(PlatformProbeCache, fingerprint_changes_when_a_module_is_modified)
+{
+    auto const before = mg::platform_fingerprint({module});
+
+    timeval const long_ago[2] = {{1, 0}, {1, 0}};
+    ASSERT_THAT(utimes(module.c_str(), long_ago), Eq(0));
+
+    EXPECT_THAT(mg::platform_fingerprint({module}), Ne(before));
+}
+
+TEST_F(PlatformProbeCache, fingerprint_changes_when_a_module_is_added)
+{
+    auto const before = mg::platform_fingerprint({module});
+
+    EXPECT_THAT(mg::platform_fingerprint({module, directory + "/another-module.so.16"}), Ne(before));
+}
+
+TEST_F(PlatformProbeCache, fingerprint_changes_when_drm_devices_change)
+{
+    auto const before = mg::platform_fingerprint({module});
+
+    udev.add_standard_device("standard-drm-devices");
+
+    EXPECT_THAT(mg::platform_fingerprint({module}), Ne(before));
+}
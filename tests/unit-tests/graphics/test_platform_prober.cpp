@@ -17,14 +17,19 @@
  */
 
 #include <gtest/gtest.h>
+#include <gmock/gmock.h>
 
 #include "mir/graphics/platform.h"
 #include "mir/graphics/platform_probe.h"
+#include "mir/graphics/platform_probe_cache.h"
+#include "mir/shared_library_prober.h"
+#include "mir/shared_library_prober_report.h"
 #include "mir/options/program_option.h"
 
 #include "mir/raii.h"
 
 #include "mir/test/doubles/mock_egl.h"
+#include "mir/test/temporary_file.h"
 #if defined(MIR_BUILD_PLATFORM_MESA_KMS) || defined(MIR_BUILD_PLATFORM_MESA_X11)
 #include "mir/test/doubles/mock_drm.h"
 #endif
@@ -78,6 +83,32 @@ std::shared_ptr<void> ensure_mesa_probing_succeeds()
     return env;
 }
 
+class MockSharedLibraryProberReport : public mir::SharedLibraryProberReport
+{
+public:
+    MOCK_METHOD1(probing_path, void(boost::filesystem::path const&));
+    MOCK_METHOD2(probing_failed, void(boost::filesystem::path const&, std::exception const&));
+    MOCK_METHOD1(loading_library, void(boost::filesystem::path const&));
+    MOCK_METHOD2(loading_failed, void(boost::filesystem::path const&, std::exception const&));
+};
+
+struct ServerPlatformProbeCache : ::testing::Test
+{
+    std::string fingerprint()
+    {
+        return mir::graphics::platform_fingerprint(
+            mir::library_files_for_path(mtf::server_platform_path(), null_report));
+    }
+
+    std::shared_ptr<void> const block_mesa = ensure_mesa_probing_fails();
+    mir::test::TemporaryDirectory const directory;
+    mir::graphics::PlatformProbeCache cache{directory.path() + "/graphics-platform"};
+    std::string const dummy_platform{mtf::server_platform("graphics-dummy.so")};
+    mir::options::ProgramOption options;
+    ::testing::NiceMock<MockSharedLibraryProberReport> null_report;
+    ::testing::NiceMock<MockSharedLibraryProberReport> report;
+};
+
 class ServerPlatformProbeMockDRM : public ::testing::Test
 {
 #if defined(MIR_BUILD_PLATFORM_MESA_KMS) || defined(MIR_BUILD_PLATFORM_MESA_X11)
@@ -188,3 +219,65 @@ TEST_F(ServerPlatformProbeMockDRM, IgnoresNonPlatformModules)
     auto module = mir::graphics::module_for_device(modules, options);
     EXPECT_NE(nullptr, module);
 }
+
+TEST_F(ServerPlatformProbeCache, records_the_module_chosen)
+{
+    using namespace testing;
+
+    auto module = mir::graphics::module_for_device(mtf::server_platform_path(), cache, options, report);
+    ASSERT_NE(nullptr, module);
+
+    auto const choice = cache.lookup(fingerprint());
+    ASSERT_TRUE(choice);
+    EXPECT_THAT(choice.value().module, Eq(dummy_platform));
+    EXPECT_THAT(choice.value().priority, Eq(mir::graphics::dummy));
+}
+
+TEST_F(ServerPlatformProbeCache, loads_only_the_module_chosen_for_the_same_hardware)
+{
+    using namespace testing;
+    cache.record(fingerprint(), {dummy_platform, mir::graphics::dummy});
+
+    EXPECT_CALL(report, loading_library(Eq(dummy_platform))).Times(1);
+    EXPECT_CALL(report, loading_library(Ne(dummy_platform))).Times(0);
+
+    auto module = mir::graphics::module_for_device(mtf::server_platform_path(), cache, options, report);
+    ASSERT_NE(nullptr, module);
+
+    auto descriptor = module->load_function<mir::graphics::DescribeModule>(describe_module);
+    EXPECT_THAT(descriptor()->name, HasSubstr("mir:stub-graphics"));
+}
+
+TEST_F(ServerPlatformProbeCache, ignores_a_chosen_module_that_is_not_on_the_path)
+{
+    using namespace testing;
+    std::string const elsewhere{"/tmp/not-a-platform.so"};
+    cache.record(fingerprint(), {elsewhere, mir::graphics::dummy});
+
+    EXPECT_CALL(report, loading_library(Eq(elsewhere))).Times(0);
+
+    auto module = mir::graphics::module_for_device(mtf::server_platform_path(), cache, options, report);
+    EXPECT_NE(nullptr, module);
+}
+
+TEST_F(ServerPlatformProbeCache, probes_every_module_when_the_chosen_one_probes_worse)
+{
+    using namespace testing;
+    cache.record(fingerprint(), {dummy_platform, mir::graphics::best});
+
+    EXPECT_CALL(report, loading_library(Ne(dummy_platform))).Times(AtLeast(1));
+
+    auto module = mir::graphics::module_for_device(mtf::server_platform_path(), cache, options, report);
+    EXPECT_NE(nullptr, module);
+}
+
+TEST_F(ServerPlatformProbeCache, probes_every_module_when_the_hardware_changes)
+{
+    using namespace testing;
+    cache.record("another fingerprint", {dummy_platform, mir::graphics::dummy});
+
+    EXPECT_CALL(report, loading_library(Ne(dummy_platform))).Times(AtLeast(1));
+
+    auto module = mir::graphics::module_for_device(mtf::server_platform_path(), cache, options, report);
+    EXPECT_NE(nullptr, module);
+}
@@ -89,16 +89,35 @@ TEST_F(ShmBufferTest, has_correct_properties)
     EXPECT_EQ(pixel_format, shm_buffer.pixel_format());
 }
 
-TEST_F(ShmBufferTest, cant_upload_bgr_888)
+TEST_F(ShmBufferTest, uploads_bgr_888_as_rgba)
 {
-    EXPECT_CALL(mock_gl, glTexImage2D(GL_TEXTURE_2D, 0, _,
-                                      size.width.as_int(), size.height.as_int(),
-                                      0, _, _,
-                                      stub_shm_file->fake_mapping))
-                .Times(0);
+    struct MappedShmFile : mir::ShmFile
+    {
+        void* base_ptr() const { return const_cast<unsigned char*>(mapping.data()); }
+        int fd() const { return 17; }
+
+        std::vector<unsigned char> mapping;
+    };
 
-    PlatformlessShmBuffer buf(std::make_unique<StubShmFile>(), size, mir_pixel_format_bgr_888);
+    geom::Size const small_size{2, 1};
+    auto shm_file = std::make_unique<MappedShmFile>();
+    shm_file->mapping = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06};
+
+    std::vector<unsigned char> uploaded;
+    EXPECT_CALL(mock_gl, glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA,
+                                      small_size.width.as_int(), small_size.height.as_int(),
+                                      0, GL_RGBA, GL_UNSIGNED_BYTE, _))
+        .WillOnce(WithArg<8>(Invoke(
+            [&](void const* pixels)
+            {
+                auto const bytes = static_cast<unsigned char const*>(pixels);
+                uploaded.assign(bytes, bytes + 8);
+            })));
+
+    PlatformlessShmBuffer buf(std::move(shm_file), small_size, mir_pixel_format_bgr_888);
     buf.gl_bind_to_texture();
+
+    EXPECT_THAT(uploaded, ElementsAre(0x03, 0x02, 0x01, 0xff, 0x06, 0x05, 0x04, 0xff));
 }
 
 TEST_F(ShmBufferTest, uploads_rgb_888_correctly)
@@ -240,6 +240,40 @@ TEST_F(SoftwareCursor, creates_renderable_with_filled_buffer)
     EXPECT_THAT(buffer->written_pixels, ElementsAreArray(image_data, image_size));
 }
 
+TEST_F(SoftwareCursor, converts_image_to_abgr_buffer_format)
+{
+    using namespace testing;
+
+    struct ArgbCursorImage : mg::CursorImage
+    {
+        void const* as_argb_8888() const override { return pixels; }
+        geom::Size size() const override { return {2, 1}; }
+        geom::Displacement hotspot() const override { return {0, 0}; }
+
+        uint32_t const pixels[2] = {0x80112233, 0xff445566};
+    } const argb_image;
+
+    struct AbgrBufferAllocator : mtd::StubBufferAllocator
+    {
+        std::vector<MirPixelFormat> supported_pixel_formats() override { return {mir_pixel_format_abgr_8888}; }
+    } abgr_allocator;
+
+    mg::SoftwareCursor abgr_cursor{
+        mt::fake_shared(abgr_allocator),
+        mt::fake_shared(mock_input_scene)};
+
+    std::shared_ptr<mg::Renderable> cursor_renderable;
+    EXPECT_CALL(mock_input_scene, add_input_visualization(_)).
+        WillOnce(SaveArg<0>(&cursor_renderable));
+
+    abgr_cursor.show(argb_image);
+
+    auto buffer = static_cast<mtd::StubBuffer*>(cursor_renderable->buffer().get());
+    uint32_t const expected[] = {0x80332211, 0xff665544};
+    EXPECT_THAT(buffer->written_pixels,
+        ElementsAreArray(reinterpret_cast<unsigned char const*>(expected), sizeof expected));
+}
+
 TEST_F(SoftwareCursor, does_not_hide_or_move_when_already_hidden)
 {
     using namespace testing;
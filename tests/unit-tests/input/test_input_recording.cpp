@@ -0,0 +1,115 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/input/input_recording.h"
+#include "mir/events/event_builders.h"
+#include "mir/test/temporary_file.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <fstream>
+#include <unistd.h>
+
+namespace mi = mir::input;
+namespace mev = mir::events;
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace
+{
+struct MockInputRecordHandler : mi::InputRecordHandler
+{
+    MOCK_METHOD4(device_added, void(MirInputDeviceId, mi::DeviceCapabilities, std::string const&, std::string const&));
+    MOCK_METHOD1(device_removed, void(MirInputDeviceId));
+    MOCK_METHOD4(key_event, void(MirInputDeviceId, Timestamp, MirKeyboardAction, int));
+    MOCK_METHOD8(pointer_event, void(MirInputDeviceId, Timestamp, MirPointerAction, MirPointerButtons,
+                                     float, float, float, float));
+    MOCK_METHOD3(touch_event, void(MirInputDeviceId, Timestamp, std::vector<mev::ContactState> const&));
+};
+
+struct InputRecording : Test
+{
+    mir::test::TemporaryFile const file;
+    std::string const& path{file.path()};
+    NiceMock<MockInputRecordHandler> handler;
+};
+}
+
+TEST_F(InputRecording, replays_records_in_order)
+{
+    std::vector<mev::ContactState> const contacts{
+        {0, mir_touch_action_down, mir_touch_tooltype_finger, 10, 20, 0.5f, 3, 2, 0},
+        {1, mir_touch_action_change, mir_touch_tooltype_finger, 30, 40, 0.7f, 4, 3, 0}};
+    {
+        mi::InputRecordWriter writer{path};
+        writer.device_added(3, mi::DeviceCapability::keyboard | mi::DeviceCapability::alpha_numeric, "kbd", "kbd-uid");
+        writer.key_event(3, 5ms, mir_keyboard_action_down, 30);
+        writer.pointer_event(4, 6ms, mir_pointer_action_motion, mir_pointer_button_primary, 0, 1, -2.5f, 3.5f);
+        writer.touch_event(5, 7ms, contacts);
+        writer.device_removed(3);
+    }
+
+    {
+        InSequence seq;
+        EXPECT_CALL(handler, device_added(3, mi::DeviceCapability::keyboard | mi::DeviceCapability::alpha_numeric,
+                                          "kbd", "kbd-uid"));
+        EXPECT_CALL(handler, key_event(3, mi::InputRecordHandler::Timestamp{5ms}, mir_keyboard_action_down, 30));
+        EXPECT_CALL(handler, pointer_event(4, mi::InputRecordHandler::Timestamp{6ms}, mir_pointer_action_motion,
+                                           MirPointerButtons{mir_pointer_button_primary}, 0, 1, -2.5f, 3.5f));
+        EXPECT_CALL(handler, touch_event(5, mi::InputRecordHandler::Timestamp{7ms}, ContainerEq(contacts)));
+        EXPECT_CALL(handler, device_removed(3));
+    }
+
+    mi::InputRecordReader reader{path};
+    while (reader.read_next(handler))
+        ;
+}
+
+TEST_F(InputRecording, records_input_events)
+{
+    {
+        mi::InputRecordWriter writer{path};
+        writer.record(*mev::make_event(MirInputDeviceId{2}, 8ms, std::vector<uint8_t>{},
+                                       mir_keyboard_action_up, 0, 42, mir_input_event_modifier_none));
+    }
+
+    EXPECT_CALL(handler, key_event(2, mi::InputRecordHandler::Timestamp{8ms}, mir_keyboard_action_up, 42));
+
+    mi::InputRecordReader reader{path};
+    EXPECT_TRUE(reader.read_next(handler));
+    EXPECT_FALSE(reader.read_next(handler));
+}
+
+TEST_F(InputRecording, rejects_files_that_are_not_recordings)
+{
+    std::ofstream{path} << "not a recording";
+
+    EXPECT_THROW(mi::InputRecordReader{path}, std::runtime_error);
+}
+
+TEST_F(InputRecording, rejects_truncated_recordings)
+{
+    {
+        mi::InputRecordWriter writer{path};
+        writer.key_event(3, 5ms, mir_keyboard_action_down, 30);
+    }
+    truncate(path.c_str(), 16);
+
+    mi::InputRecordReader reader{path};
+    EXPECT_THROW(reader.read_next(handler), std::runtime_error);
+}
@@ -216,6 +216,25 @@ TEST_F(KeyRepeatDispatcher, stops_repeat_on_device_removal)
     EXPECT_THAT(alarm_canceled, Eq(true));
 }
 
+TEST_F(KeyRepeatDispatcher, reuses_device_alarm_for_the_most_recently_pressed_key)
+{
+    MockAlarm *mock_alarm = new MockAlarm;
+    std::function<void()> alarm_function;
+
+    EXPECT_CALL(*mock_alarm_factory, create_alarm_adapter(_)).Times(1).
+        WillOnce(DoAll(SaveArg<0>(&alarm_function), Return(mock_alarm)));
+    EXPECT_CALL(*mock_alarm, reschedule_in(repeat_time)).Times(2).WillRepeatedly(Return(true));
+    EXPECT_CALL(*mock_alarm, reschedule_in(repeat_delay)).Times(1).WillOnce(Return(true));
+    EXPECT_CALL(*mock_next_dispatcher, dispatch(mt::KeyDownEvent())).Times(2);
+    EXPECT_CALL(*mock_next_dispatcher, dispatch(mt::KeyRepeatEvent())).Times(1);
+
+    auto const other_scan_code = 42;
+    dispatcher.dispatch(a_key_down_event());
+    dispatcher.dispatch(mev::make_event(test_device, std::chrono::nanoseconds(0), std::vector<uint8_t>{},
+                                        mir_keyboard_action_down, 0, other_scan_code, mir_input_event_modifier_none));
+    alarm_function();
+}
+
 TEST_F(KeyRepeatDispatcherOnArale, no_repeat_alarm_on_mtk_tpd)
 {
     EXPECT_CALL(*mock_alarm_factory, create_alarm_adapter(_)).Times(0);
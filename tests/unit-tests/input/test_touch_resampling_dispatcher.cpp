@@ -0,0 +1,329 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/input/touch_resampling_dispatcher.h"
+
+#include "mir/events/event_builders.h"
+#include "mir/graphics/display_configuration_observer.h"
+#include "mir/time/timer_wheel_alarm_factory.h"
+
+#include "mir/test/fake_shared.h"
+#include "mir/test/doubles/advanceable_clock.h"
+#include "mir/test/doubles/mock_event_handler_register.h"
+#include "mir/test/doubles/mock_input_dispatcher.h"
+#include "mir/test/doubles/stub_display_configuration.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace mi = mir::input;
+namespace mev = mir::events;
+namespace mg = mir::graphics;
+namespace geom = mir::geometry;
+namespace mt = mir::test;
+namespace mtd = mt::doubles;
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace
+{
+MirInputDeviceId const touch_screen{7};
+
+struct FakeDisplayConfigurationObserverRegistrar : mir::ObserverRegistrar<mg::DisplayConfigurationObserver>
+{
+    using Observer = mg::DisplayConfigurationObserver;
+
+    void register_interest(std::weak_ptr<Observer> const& obs) override
+    {
+        observer = obs;
+        observer.lock()->initial_configuration(mt::fake_shared(config));
+    }
+
+    void register_interest(std::weak_ptr<Observer> const& obs, mir::Executor&) override
+    {
+        register_interest(obs);
+    }
+
+    void unregister_interest(Observer const&) override
+    {
+        observer.reset();
+    }
+
+    void set_refresh_rate(double hz)
+    {
+        config.outputs[0].modes[0].vrefresh_hz = hz;
+        observer.lock()->configuration_applied(mt::fake_shared(config));
+    }
+
+    mtd::StubDisplayConfig config{{geom::Rectangle{{0, 0}, {100, 100}}}};
+    std::weak_ptr<Observer> observer;
+};
+
+struct TouchResamplingDispatcher : Test
+{
+    TouchResamplingDispatcher()
+    {
+        ON_CALL(event_handler_register, register_fd_handler(_, _, _))
+            .WillByDefault(SaveArg<2>(&fd_handler));
+        ON_CALL(next_dispatcher, dispatch(_))
+            .WillByDefault(Invoke([this](auto const& event) { dispatched.push_back(event); return true; }));
+
+        alarm_factory = std::make_unique<mir::time::TimerWheelAlarmFactory>(
+            mt::fake_shared(event_handler_register), clock);
+        dispatcher = std::make_unique<mi::TouchResamplingDispatcher>(
+            mt::fake_shared(next_dispatcher), mt::fake_shared(*alarm_factory), clock,
+            mt::fake_shared(display_config), resample_latency);
+    }
+
+    ~TouchResamplingDispatcher()
+    {
+        dispatcher.reset();
+    }
+
+    // Time since the dispatcher was created
+    std::chrono::nanoseconds elapsed() const
+    {
+        return clock->now() - start;
+    }
+
+    void advance_to(std::chrono::nanoseconds time)
+    {
+        clock->advance_by(time - elapsed());
+        fd_handler(0);
+    }
+
+    // Alarms fire on a millisecond tick, so a frame is handled on the tick after it
+    void advance_to_frame(int frame)
+    {
+        advance_to(std::chrono::milliseconds{(frame * frame_period + 1ms - 1ns) / 1ms});
+    }
+
+    void touch(MirTouchAction action, float x)
+    {
+        auto event = mev::make_event(touch_screen, (start + elapsed()).time_since_epoch(), std::vector<uint8_t>{}, mir_input_event_modifier_none);
+        mev::add_touch(*event, 0, action, mir_touch_tooltype_finger, x, 0, 1, 1, 1, 1);
+        dispatcher->dispatch(std::move(event));
+    }
+
+    float x_of(std::shared_ptr<MirEvent const> const& event)
+    {
+        auto const touch_event = mir_input_event_get_touch_event(mir_event_get_input_event(event.get()));
+        return mir_touch_event_axis_value(touch_event, 0, mir_touch_axis_x);
+    }
+
+    std::chrono::nanoseconds time_of(std::shared_ptr<MirEvent const> const& event)
+    {
+        return std::chrono::nanoseconds{mir_input_event_get_event_time(mir_event_get_input_event(event.get()))} -
+            start.time_since_epoch();
+    }
+
+    std::chrono::milliseconds const resample_latency{5};
+    std::chrono::nanoseconds const frame_period{std::chrono::nanoseconds{std::chrono::seconds{1}} / 60};
+
+    FakeDisplayConfigurationObserverRegistrar display_config;
+    std::shared_ptr<mtd::AdvanceableClock> const clock{std::make_shared<mtd::AdvanceableClock>()};
+    mir::time::Timestamp const start{clock->now()};
+    NiceMock<mtd::MockEventHandlerRegister> event_handler_register;
+    std::function<void(int)> fd_handler;
+    std::unique_ptr<mir::time::AlarmFactory> alarm_factory;
+    NiceMock<mtd::MockInputDispatcher> next_dispatcher;
+    std::vector<std::shared_ptr<MirEvent const>> dispatched;
+    std::unique_ptr<mi::TouchResamplingDispatcher> dispatcher;
+};
+}
+
+TEST_F(TouchResamplingDispatcher, forwards_non_touch_events_immediately)
+{
+    auto key = mev::make_event(touch_screen, 0ns, std::vector<uint8_t>{}, mir_keyboard_action_down, 0, 42, mir_input_event_modifier_none);
+    dispatcher->dispatch(std::move(key));
+
+    EXPECT_THAT(dispatched, SizeIs(1));
+}
+
+TEST_F(TouchResamplingDispatcher, forwards_touch_down_and_up_immediately)
+{
+    touch(mir_touch_action_down, 0);
+    EXPECT_THAT(dispatched, SizeIs(1));
+
+    advance_to(4ms);
+    touch(mir_touch_action_up, 0);
+    EXPECT_THAT(dispatched, SizeIs(2));
+}
+
+TEST_F(TouchResamplingDispatcher, holds_motion_until_the_next_frame)
+{
+    touch(mir_touch_action_down, 0);
+    advance_to(2ms);
+    touch(mir_touch_action_change, 20);
+    advance_to(6ms);
+    touch(mir_touch_action_change, 60);
+
+    advance_to(frame_period - 1ms);
+    EXPECT_THAT(dispatched, SizeIs(1));
+
+    advance_to_frame(1);
+    EXPECT_THAT(dispatched, SizeIs(2));
+}
+
+TEST_F(TouchResamplingDispatcher, dispatches_one_motion_event_per_frame)
+{
+    touch(mir_touch_action_down, 0);
+    for (auto t = 2ms; t < 60ms; t += 2ms)
+    {
+        advance_to(t);
+        touch(mir_touch_action_change, t.count() * 10.0f);
+    }
+
+    advance_to(60ms);
+
+    // Frames at 16.7, 33.3 and 50ms
+    EXPECT_THAT(dispatched, SizeIs(4));
+}
+
+TEST_F(TouchResamplingDispatcher, interpolates_motion_to_the_resample_time)
+{
+    touch(mir_touch_action_down, 0);
+    for (auto t = 2ms; t <= 14ms; t += 4ms)
+    {
+        advance_to(t);
+        touch(mir_touch_action_change, t.count() * 10.0f);
+    }
+
+    advance_to_frame(1);
+
+    ASSERT_THAT(dispatched, SizeIs(2));
+    auto const sample_time = elapsed() - resample_latency;
+    EXPECT_THAT(time_of(dispatched.back()), Eq(sample_time));
+    EXPECT_THAT(x_of(dispatched.back()), FloatNear(sample_time.count() * 1e-5f, 0.01f));
+}
+
+TEST_F(TouchResamplingDispatcher, extrapolates_motion_a_limited_distance)
+{
+    touch(mir_touch_action_down, 0);
+    advance_to(2ms);
+    touch(mir_touch_action_change, 20);
+    advance_to(6ms);
+    touch(mir_touch_action_change, 60);
+
+    advance_to_frame(1);
+
+    // No further than half the 4ms sample interval past the latest sample
+    ASSERT_THAT(dispatched, SizeIs(2));
+    EXPECT_THAT(time_of(dispatched.back()), Eq(8ms));
+    EXPECT_THAT(x_of(dispatched.back()), FloatNear(80, 0.01f));
+}
+
+TEST_F(TouchResamplingDispatcher, dispatches_nothing_without_new_motion)
+{
+    touch(mir_touch_action_down, 0);
+    advance_to(2ms);
+    touch(mir_touch_action_change, 20);
+
+    advance_to_frame(1);
+    advance_to_frame(4);
+
+    EXPECT_THAT(dispatched, SizeIs(2));
+}
+
+TEST_F(TouchResamplingDispatcher, holds_motion_newer_than_the_resample_time_after_a_touch_down)
+{
+    advance_to(15ms);
+    touch(mir_touch_action_down, 0);
+    advance_to(16ms);
+    touch(mir_touch_action_change, 10);
+
+    advance_to_frame(1);
+    EXPECT_THAT(dispatched, SizeIs(1));
+
+    advance_to_frame(2);
+    ASSERT_THAT(dispatched, SizeIs(2));
+    auto const touch_event = mir_input_event_get_touch_event(mir_event_get_input_event(dispatched.back().get()));
+    EXPECT_THAT(mir_touch_event_action(touch_event, 0), Eq(mir_touch_action_change));
+    EXPECT_THAT(x_of(dispatched.back()), FloatEq(10));
+}
+
+TEST_F(TouchResamplingDispatcher, touch_up_discards_held_motion)
+{
+    touch(mir_touch_action_down, 0);
+    advance_to(2ms);
+    touch(mir_touch_action_change, 20);
+    advance_to(4ms);
+    touch(mir_touch_action_up, 40);
+
+    advance_to_frame(2);
+
+    ASSERT_THAT(dispatched, SizeIs(2));
+    EXPECT_THAT(x_of(dispatched.back()), FloatEq(40));
+}
+
+TEST_F(TouchResamplingDispatcher, follows_the_phase_of_compositor_frames)
+{
+    advance_to(30ms);
+    dispatcher->frame_started();
+
+    touch(mir_touch_action_down, 0);
+    advance_to(32ms);
+    touch(mir_touch_action_change, 20);
+
+    // The frame after the one at 30ms is at 46.7ms, not 50ms
+    advance_to(46ms);
+    EXPECT_THAT(dispatched, SizeIs(1));
+
+    advance_to(47ms);
+    EXPECT_THAT(dispatched, SizeIs(2));
+}
+
+TEST_F(TouchResamplingDispatcher, follows_the_display_refresh_rate)
+{
+    display_config.set_refresh_rate(120);
+
+    advance_to(30ms);
+    dispatcher->frame_started();
+
+    touch(mir_touch_action_down, 0);
+    advance_to(32ms);
+    touch(mir_touch_action_change, 20);
+
+    // At 120Hz the frame after the one at 30ms is at 38.3ms
+    advance_to(38ms);
+    EXPECT_THAT(dispatched, SizeIs(1));
+
+    advance_to(39ms);
+    EXPECT_THAT(dispatched, SizeIs(2));
+}
+
+TEST_F(TouchResamplingDispatcher, takes_the_refresh_rate_of_the_initial_display_configuration)
+{
+    display_config.config.outputs[0].modes[0].vrefresh_hz = 30;
+    dispatcher = std::make_unique<mi::TouchResamplingDispatcher>(
+        mt::fake_shared(next_dispatcher), mt::fake_shared(*alarm_factory), clock,
+        mt::fake_shared(display_config), resample_latency);
+
+    advance_to(60ms);
+    dispatcher->frame_started();
+
+    touch(mir_touch_action_down, 0);
+    advance_to(62ms);
+    touch(mir_touch_action_change, 20);
+
+    // At 30Hz the frame after the one at 60ms is at 93.3ms
+    advance_to(93ms);
+    EXPECT_THAT(dispatched, SizeIs(1));
+
+    advance_to(94ms);
+    EXPECT_THAT(dispatched, SizeIs(2));
+}
@@ -0,0 +1,220 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/logging/async_logger.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ml = mir::logging;
+
+using namespace testing;
+
+namespace
+{
+struct Line
+{
+    ml::Severity severity;
+    std::string text;
+};
+
+struct AsyncLogger : Test
+{
+    std::mutex mutex;
+    std::vector<Line> lines;
+    std::atomic<bool> stalled{false};
+
+    ml::AsyncLogger::Writer const writer{
+        [this](ml::Severity severity, std::string const& line, bool)
+        {
+            while (stalled)
+                std::this_thread::yield();
+
+            std::lock_guard<std::mutex> lock{mutex};
+            lines.push_back({severity, line});
+        }};
+
+    auto written() -> std::vector<std::string>
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        std::vector<std::string> result;
+        for (auto const& line : lines)
+            result.push_back(line.text);
+        return result;
+    }
+
+    auto written_count() -> std::size_t
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        return lines.size();
+    }
+};
+
+// Everything after the "[timestamp] "
+auto without_time(std::string const& line) -> std::string
+{
+    return line.substr(line.find("] ") + 2);
+}
+}
+
+TEST_F(AsyncLogger, writes_messages_in_the_console_format)
+{
+    ml::AsyncLogger logger{writer, 4096, 4};
+
+    logger.log(ml::Severity::informational, "Hello", "test");
+    logger.log("test", ml::Severity::warning, "Answer: %d", 42);
+    logger.flush();
+
+    auto const output = written();
+    ASSERT_THAT(output.size(), Eq(2u));
+    EXPECT_THAT(output[0], StartsWith("["));
+    EXPECT_THAT(without_time(output[0]), Eq("test: Hello\n"));
+    EXPECT_THAT(without_time(output[1]), Eq("<WARNING> test: Answer: 42\n"));
+}
+
+TEST_F(AsyncLogger, writes_messages_without_being_flushed)
+{
+    ml::AsyncLogger logger{writer, 4096, 4};
+
+    logger.log(ml::Severity::informational, "Hello", "test");
+
+    auto const timeout = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+    while (written_count() == 0 && std::chrono::steady_clock::now() < timeout)
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+
+    EXPECT_THAT(written_count(), Eq(1u));
+}
+
+TEST_F(AsyncLogger, writes_errors_before_log_returns)
+{
+    ml::AsyncLogger logger{writer, 4096, 4};
+
+    logger.log(ml::Severity::debug, "Before", "test");
+    logger.log(ml::Severity::critical, "Fatal", "test");
+
+    auto const output = written();
+    ASSERT_THAT(output.size(), Eq(2u));
+    EXPECT_THAT(without_time(output[1]), Eq("<CRITICAL> test: Fatal\n"));
+}
+
+TEST_F(AsyncLogger, writes_pending_messages_on_destruction)
+{
+    {
+        ml::AsyncLogger logger{writer, 64*1024, 4};
+
+        for (auto i = 0; i != 100; ++i)
+            logger.log("test", ml::Severity::informational, "Message %d", i);
+    }
+
+    EXPECT_THAT(written_count(), Eq(100u));
+}
+
+TEST_F(AsyncLogger, counts_and_reports_messages_that_do_not_fit)
+{
+    // Room for a message or two, and the writer stalled until we flush
+    ml::AsyncLogger logger{writer, 128, 4};
+    stalled = true;
+
+    for (auto i = 0; i != 10; ++i)
+        logger.log(ml::Severity::informational, "A message that takes up space", "test");
+
+    stalled = false;
+    logger.flush();
+
+    EXPECT_THAT(logger.dropped(), Gt(0u));
+
+    std::uint64_t messages{0};
+    std::uint64_t reported_dropped{0};
+    for (auto const& line : written())
+    {
+        unsigned long count;
+        if (sscanf(without_time(line).c_str(), "<WARNING> logging: %lu messages dropped", &count) == 1)
+            reported_dropped += count;
+        else
+            ++messages;
+    }
+
+    EXPECT_THAT(reported_dropped, Eq(logger.dropped()));
+    EXPECT_THAT(messages + logger.dropped(), Eq(10u));
+}
+
+TEST_F(AsyncLogger, drops_messages_from_threads_beyond_the_limit)
+{
+    ml::AsyncLogger logger{writer, 4096, 1};
+
+    logger.log(ml::Severity::informational, "Main", "test");
+
+    std::thread{[&]{ logger.log(ml::Severity::informational, "Other", "test"); }}.join();
+    logger.flush();
+
+    EXPECT_THAT(logger.dropped(), Eq(1u));
+    EXPECT_THAT(without_time(written().front()), Eq("test: Main\n"));
+}
+
+TEST_F(AsyncLogger, reuses_the_buffers_of_threads_that_have_exited)
+{
+    ml::AsyncLogger logger{writer, 4096, 1};
+
+    std::thread{[&]{ logger.log(ml::Severity::informational, "First", "test"); }}.join();
+    logger.flush();
+    std::thread{[&]{ logger.log(ml::Severity::informational, "Second", "test"); }}.join();
+    logger.flush();
+
+    EXPECT_THAT(logger.dropped(), Eq(0u));
+    EXPECT_THAT(written_count(), Eq(2u));
+}
+
+TEST_F(AsyncLogger, writes_every_threads_messages_in_order)
+{
+    auto const thread_count = 4;
+    auto const message_count = 200;
+
+    {
+        ml::AsyncLogger logger{writer, 64*1024, thread_count};
+
+        std::vector<std::thread> threads;
+        for (auto t = 0; t != thread_count; ++t)
+        {
+            threads.emplace_back([&, t]
+                {
+                    for (auto i = 0; i != message_count; ++i)
+                        logger.log("test", ml::Severity::informational, "%d:%d", t, i);
+                });
+        }
+
+        for (auto& thread : threads)
+            thread.join();
+    }
+
+    auto const output = written();
+    ASSERT_THAT(output.size(), Eq(std::size_t(thread_count*message_count)));
+
+    std::vector<int> next(thread_count, 0);
+    for (auto const& line : output)
+    {
+        int t, i;
+        ASSERT_THAT(sscanf(without_time(line).c_str(), "test: %d:%d", &t, &i), Eq(2));
+        EXPECT_THAT(i, Eq(next[t]++));
+    }
+}
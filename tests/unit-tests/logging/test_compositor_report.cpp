@@ -21,7 +21,9 @@
 #include "mir/test/doubles/advanceable_clock.h"
 
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <string>
+#include <vector>
 #include <cstdio>
 
 using namespace std;
@@ -39,6 +41,7 @@ public:
     void log(ml::Severity, string const& message, string const&)
     {
         last = message;
+        all.push_back(message);
     }
     string const& last_message() const
     {
@@ -48,6 +51,11 @@ public:
     {
         return last.find(substr) != string::npos;
     }
+    bool any_message_contains(char const* substr)
+    {
+        return any_of(all.begin(), all.end(),
+            [&](string const& message) { return message.find(substr) != string::npos; });
+    }
     bool scrape(float& fps, float& frame_time) const
     {
         return sscanf(last.c_str(), "Display %*s averaged %f FPS, %f ms/frame",
@@ -55,6 +63,7 @@ public:
     }
 private:
     string last;
+    vector<string> all;
 };
 
 struct LoggingCompositorReport : ::testing::Test
@@ -189,3 +198,33 @@ TEST_F(LoggingCompositorReport, bypass_has_no_render_time)
 
     report.stopped();
 }
+
+TEST_F(LoggingCompositorReport, reports_average_time_to_each_frame_stage)
+{
+    const void* const id = "My Screen";
+
+    report.started();
+
+    for (int f = 0; f < 3; ++f)
+    {
+        report.began_frame(id);
+        clock->advance_by(chrono::microseconds(500));
+        report.frame_reached_stage(id, mir::compositor::FrameStage::scene_snapshotted);
+        clock->advance_by(chrono::microseconds(1500));
+        report.frame_reached_stage(id, mir::compositor::FrameStage::textures_bound);
+        clock->advance_by(chrono::microseconds(1000));
+        report.frame_reached_stage(id, mir::compositor::FrameStage::draw_submitted);
+        report.rendered_on_gpu(id, chrono::microseconds(2250));
+        report.rendered_frame(id);
+        report.finished_frame(id);
+        clock->advance_by(chrono::microseconds(4000));
+        report.frame_reached_stage(id, mir::compositor::FrameStage::flip_completed);
+        clock->advance_by(chrono::seconds(1));
+    }
+
+    EXPECT_TRUE(recorder->any_message_contains(
+        "scene snapshotted at 0.500 ms, textures bound at 2.000 ms, draw submitted at 3.000 ms, "
+        "flip completed at 7.000 ms, GPU time 2.250 ms"));
+
+    report.stopped();
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/report/logging/input_report.h"
+#include "mir/logging/logger.h"
+#include "mir/test/doubles/advanceable_clock.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mtd = mir::test::doubles;
+namespace mrl = mir::report::logging;
+namespace ml = mir::logging;
+namespace mi = mir::input;
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace
+{
+class Recorder : public ml::Logger
+{
+public:
+    void log(ml::Severity, std::string const& message, std::string const&) override
+    {
+        messages.push_back(message);
+    }
+
+    std::vector<std::string> messages;
+};
+
+struct LatencySummary
+{
+    unsigned events;
+    float p50, p90, p99, max;
+};
+
+bool scrape(std::string const& message, char const* stage, LatencySummary& summary)
+{
+    auto const format = std::string{"Latency to "} + stage + ": %u events, p50 %f ms, p90 %f ms, p99 %f ms, max %f ms";
+    return sscanf(message.c_str(), format.c_str(),
+                  &summary.events, &summary.p50, &summary.p90, &summary.p99, &summary.max) == 5;
+}
+
+struct LoggingInputReport : Test
+{
+    void report_event_with_latency(mi::InputPipelineStage stage, std::chrono::microseconds latency)
+    {
+        auto const event_time = clock->now().time_since_epoch() - latency;
+        report.event_reached_stage(stage, std::chrono::nanoseconds{event_time}.count());
+    }
+
+    std::shared_ptr<mtd::AdvanceableClock> const clock{std::make_shared<mtd::AdvanceableClock>()};
+    std::shared_ptr<Recorder> const recorder{std::make_shared<Recorder>()};
+    mrl::InputReport report{recorder, clock};
+};
+}
+
+TEST_F(LoggingInputReport, summarises_latency_percentiles_once_a_second)
+{
+    for (int i = 1; i <= 100; ++i)
+        report_event_with_latency(mi::InputPipelineStage::converted, std::chrono::microseconds{i * 100});
+
+    EXPECT_THAT(recorder->messages, IsEmpty());
+
+    clock->advance_by(1s);
+    report_event_with_latency(mi::InputPipelineStage::converted, 10ms);
+
+    ASSERT_THAT(recorder->messages, SizeIs(1));
+
+    LatencySummary summary;
+    ASSERT_TRUE(scrape(recorder->messages[0], "converted", summary)) << recorder->messages[0];
+
+    EXPECT_THAT(summary.events, Eq(101u));
+    EXPECT_THAT(summary.p50, FloatNear(5.0f, 0.25f));
+    EXPECT_THAT(summary.p90, FloatNear(9.0f, 0.5f));
+    EXPECT_THAT(summary.p99, FloatNear(9.9f, 0.5f));
+    EXPECT_THAT(summary.max, FloatEq(10.0f));
+}
+
+TEST_F(LoggingInputReport, summarises_each_stage_separately)
+{
+    report_event_with_latency(mi::InputPipelineStage::converted, 100us);
+    report_event_with_latency(mi::InputPipelineStage::filtered, 200us);
+    clock->advance_by(1s);
+    report_event_with_latency(mi::InputPipelineStage::sent_to_client, 2ms);
+
+    ASSERT_THAT(recorder->messages, SizeIs(3));
+
+    LatencySummary summary;
+    EXPECT_TRUE(scrape(recorder->messages[0], "converted", summary));
+    EXPECT_THAT(summary.events, Eq(1u));
+    EXPECT_TRUE(scrape(recorder->messages[1], "filtered", summary));
+    EXPECT_THAT(summary.events, Eq(1u));
+    EXPECT_TRUE(scrape(recorder->messages[2], "sent to client", summary));
+    EXPECT_THAT(summary.max, FloatEq(2.0f));
+}
+
+TEST_F(LoggingInputReport, starts_a_fresh_summary_after_logging)
+{
+    report_event_with_latency(mi::InputPipelineStage::converted, 5ms);
+    clock->advance_by(1s);
+    report_event_with_latency(mi::InputPipelineStage::converted, 5ms);
+    recorder->messages.clear();
+
+    report_event_with_latency(mi::InputPipelineStage::converted, 1ms);
+    clock->advance_by(1s);
+    report_event_with_latency(mi::InputPipelineStage::converted, 1ms);
+
+    ASSERT_THAT(recorder->messages, SizeIs(1));
+
+    LatencySummary summary;
+    ASSERT_TRUE(scrape(recorder->messages[0], "converted", summary));
+    EXPECT_THAT(summary.events, Eq(2u));
+    EXPECT_THAT(summary.max, FloatEq(1.0f));
+}
+
+TEST_F(LoggingInputReport, counts_every_event_reported_concurrently)
+{
+    int const threads = 4;
+    int const events_per_thread = 10000;
+
+    std::vector<std::thread> reporters;
+    for (int i = 0; i != threads; ++i)
+    {
+        reporters.emplace_back([this]
+            {
+                for (int j = 0; j != events_per_thread; ++j)
+                    report_event_with_latency(mi::InputPipelineStage::filtered, 1ms);
+            });
+    }
+
+    for (auto& reporter : reporters)
+        reporter.join();
+
+    clock->advance_by(1s);
+    report_event_with_latency(mi::InputPipelineStage::filtered, 1ms);
+
+    ASSERT_THAT(recorder->messages, SizeIs(1));
+
+    LatencySummary summary;
+    ASSERT_TRUE(scrape(recorder->messages[0], "filtered", summary));
+    EXPECT_THAT(summary.events, Eq(unsigned(threads * events_per_thread + 1)));
+}
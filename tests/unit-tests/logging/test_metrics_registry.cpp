@@ -0,0 +1,204 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/report/metrics/registry.h"
+#include "src/server/report/metrics/scrape_endpoint.h"
+#include "src/server/report/metrics/input_report.h"
+#include "mir/default_server_configuration.h"
+#include "mir/scene/scene_report.h"
+#include "mir/test/doubles/advanceable_clock.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace mrm = mir::report::metrics;
+namespace mtd = mir::test::doubles;
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace
+{
+struct MetricsRegistry : Test
+{
+    std::shared_ptr<mrm::Registry> const registry{std::make_shared<mrm::Registry>()};
+
+    auto openmetrics() -> std::string
+    {
+        std::ostringstream out;
+        registry->write_openmetrics(out);
+        return out.str();
+    }
+};
+
+auto scrape(std::string const& socket_file) -> std::string
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    socket_file.copy(address.sun_path, sizeof address.sun_path - 1);
+
+    auto const fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (connect(fd, reinterpret_cast<sockaddr const*>(&address), sizeof address) != 0)
+    {
+        close(fd);
+        return {};
+    }
+
+    std::string result;
+    char buffer[256];
+    for (ssize_t size; (size = read(fd, buffer, sizeof buffer)) > 0;)
+        result.append(buffer, size);
+
+    close(fd);
+    return result;
+}
+}
+
+TEST_F(MetricsRegistry, writes_counters_and_gauges_in_openmetrics_format)
+{
+    registry->counter("frames", "Frames drawn")->add(3);
+    registry->gauge("windows", "Windows open", {{"type", "normal"}})->set(7);
+
+    EXPECT_THAT(openmetrics(), Eq(
+        "# TYPE frames counter\n"
+        "# HELP frames Frames drawn\n"
+        "frames_total 3\n"
+        "# TYPE windows gauge\n"
+        "# HELP windows Windows open\n"
+        "windows{type=\"normal\"} 7\n"
+        "# EOF\n"));
+}
+
+TEST_F(MetricsRegistry, asking_for_a_metric_again_returns_the_same_one)
+{
+    auto const first = registry->counter("requests", "Requests", {{"request", "connect"}});
+    auto const second = registry->counter("requests", "Requests", {{"request", "connect"}});
+    auto const other = registry->counter("requests", "Requests", {{"request", "disconnect"}});
+
+    EXPECT_THAT(first, Eq(second));
+    EXPECT_THAT(first, Ne(other));
+}
+
+TEST_F(MetricsRegistry, a_name_cannot_be_reused_for_another_type_of_metric)
+{
+    registry->counter("surfaces", "Surfaces");
+
+    EXPECT_THROW(registry->gauge("surfaces", "Surfaces"), std::logic_error);
+}
+
+TEST_F(MetricsRegistry, counts_from_several_threads_are_summed)
+{
+    auto const counter = registry->counter("events", "Events");
+
+    std::vector<std::thread> threads;
+    for (auto i = 0; i != 4; ++i)
+        threads.emplace_back([&] { for (auto j = 0; j != 1000; ++j) counter->add(); });
+
+    for (auto& thread : threads)
+        thread.join();
+
+    EXPECT_THAT(counter->value(), Eq(4000u));
+}
+
+TEST_F(MetricsRegistry, histogram_quantiles_are_within_bucket_precision)
+{
+    auto const histogram = registry->histogram("latency_seconds", "Latency");
+
+    for (auto i = 1; i <= 1000; ++i)
+        histogram->record(std::chrono::microseconds{i * 10});
+
+    auto const summary = histogram->summarize({0.5, 0.99});
+
+    EXPECT_THAT(summary.count, Eq(1000u));
+    EXPECT_THAT(summary.sum_seconds, DoubleNear(5.005, 1e-6));
+    EXPECT_THAT(summary.quantile_seconds[0].second, DoubleNear(0.005, 0.005 * 0.07));
+    EXPECT_THAT(summary.quantile_seconds[1].second, DoubleNear(0.0099, 0.0099 * 0.07));
+}
+
+TEST_F(MetricsRegistry, histogram_quantiles_cover_durations_since_the_previous_summary)
+{
+    auto const histogram = registry->histogram("latency_seconds", "Latency");
+
+    histogram->record(1s);
+    histogram->summarize({0.5});
+    histogram->record(1ms);
+
+    auto const summary = histogram->summarize({0.5});
+
+    EXPECT_THAT(summary.count, Eq(2u));
+    EXPECT_THAT(summary.quantile_seconds[0].second, DoubleNear(0.001, 0.001 * 0.07));
+}
+
+TEST_F(MetricsRegistry, writes_histograms_as_summaries)
+{
+    // A bucket boundary, so the quantiles are exact
+    registry->histogram("latency_seconds", "Latency", {{"stage", "filtered"}})->record(1024us);
+
+    EXPECT_THAT(openmetrics(), AllOf(
+        HasSubstr("# TYPE latency_seconds summary\n"),
+        HasSubstr("latency_seconds{stage=\"filtered\",quantile=\"0.5\"} 0.001024\n"),
+        HasSubstr("latency_seconds_sum{stage=\"filtered\"} 0.001024\n"),
+        HasSubstr("latency_seconds_count{stage=\"filtered\"} 1\n")));
+}
+
+TEST_F(MetricsRegistry, input_report_records_latency_by_stage)
+{
+    auto const clock = std::make_shared<mtd::AdvanceableClock>();
+    mrm::InputReport report{registry, clock};
+
+    auto const event_time = clock->now().time_since_epoch().count();
+    clock->advance_by(3ms);
+    report.event_reached_stage(mir::input::InputPipelineStage::filtered, event_time);
+
+    EXPECT_THAT(openmetrics(),
+        HasSubstr("mir_input_latency_seconds_count{stage=\"filtered\"} 1\n"));
+}
+
+TEST_F(MetricsRegistry, scrape_endpoint_serves_metrics_on_a_socket)
+{
+    auto const socket_file = "/tmp/mir_metrics_test_" + std::to_string(getpid());
+    auto const shared_registry = std::make_shared<mrm::Registry>();
+    shared_registry->counter("frames", "Frames drawn")->add(42);
+
+    {
+        mrm::ScrapeEndpoint endpoint{socket_file, shared_registry};
+
+        EXPECT_THAT(scrape(socket_file), AllOf(HasSubstr("frames_total 42\n"), EndsWith("# EOF\n")));
+    }
+
+    EXPECT_THAT(access(socket_file.c_str(), F_OK), Ne(0));
+}
+
+TEST_F(MetricsRegistry, reports_from_the_server_configuration_are_served_on_the_metrics_socket)
+{
+    auto const socket_file = "/tmp/mir_metrics_test_" + std::to_string(getpid());
+    char const* argv[] = {"dummy", "--scene-report=metrics", "--metrics-socket", socket_file.c_str()};
+    mir::DefaultServerConfiguration config{sizeof argv/sizeof argv[0], argv};
+
+    auto const report = config.the_scene_report();
+    report->surface_created(nullptr, "surface");
+
+    EXPECT_THAT(scrape(socket_file), HasSubstr("mir_scene_surfaces_created_total 1\n"));
+}
@@ -130,6 +130,31 @@ TEST_F(MesaClientBufferTest, secure_for_cpu_write_maps_buffer_fd)
     ASSERT_EQ(pf, mem_region->format);
 }
 
+TEST_F(MesaClientBufferTest, secure_for_cpu_write_keeps_mapping_until_destruction)
+{
+    void *map_addr{reinterpret_cast<void*>(0xabcdef)};
+
+    EXPECT_CALL(*buffer_file_ops, map(package->fd[0],_,_))
+        .WillOnce(Return(map_addr));
+    EXPECT_CALL(*buffer_file_ops, unmap(_,_))
+        .Times(0);
+
+    {
+        mclg::ClientBuffer buffer(buffer_file_ops, package, size, pf);
+
+        buffer.secure_for_cpu_write().reset();
+        auto mem_region = buffer.secure_for_cpu_write();
+        EXPECT_EQ(map_addr, mem_region->vaddr.get());
+        mem_region.reset();
+
+        Mock::VerifyAndClearExpectations(buffer_file_ops.get());
+        EXPECT_CALL(*buffer_file_ops, unmap(map_addr,_))
+            .Times(1);
+        EXPECT_CALL(*buffer_file_ops, close(package->fd[0]))
+            .Times(1);
+    }
+}
+
 TEST_F(MesaClientBufferTest, secure_for_cpu_write_throws_on_map_failure)
 {
     EXPECT_CALL(*buffer_file_ops, map(package->fd[0],_,_))
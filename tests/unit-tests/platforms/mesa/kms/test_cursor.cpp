@@ -442,6 +442,19 @@ TEST_F(MesaCursorTest, show_cursor_pads_missing_data)
     cursor.show(SinglePixelCursorImage());
 }
 
+TEST_F(MesaCursorTest, showing_a_recent_image_again_writes_nothing)
+{
+    using namespace testing;
+
+    cursor.show(stub_image);
+    cursor.show(SinglePixelCursorImage());
+
+    EXPECT_CALL(mock_gbm, gbm_bo_write(_, _, _)).Times(0);
+    EXPECT_CALL(*output_container.outputs[0], set_cursor(_));
+
+    cursor.show(StubCursorImage());
+}
+
 TEST_F(MesaCursorTest, pads_missing_data_when_buffer_size_differs)
 {
     using namespace ::testing;
@@ -536,6 +536,71 @@ TEST_F(MesaDisplayMultiMonitorTest, configure_clears_unused_connected_outputs)
     }
 }
 
+TEST_F(MesaDisplayMultiMonitorTest, configure_leaves_unchanged_outputs_alone)
+{
+    using namespace testing;
+
+    int const num_connected_outputs{2};
+    int const num_disconnected_outputs{0};
+
+    setup_outputs(num_connected_outputs, num_disconnected_outputs);
+
+    auto display = create_display_side_by_side(create_platform());
+
+    mg::DisplaySyncGroup* unchanged_group{nullptr};
+    mg::DisplaySyncGroup* changed_group{nullptr};
+    display->for_each_display_sync_group(
+        [&](mg::DisplaySyncGroup& group)
+        {
+            group.for_each_display_buffer(
+                [&](mg::DisplayBuffer& db)
+                {
+                    (db.view_area().top_left.x == geom::X{0} ? unchanged_group : changed_group) = &group;
+                });
+        });
+    ASSERT_THAT(unchanged_group, NotNull());
+    ASSERT_THAT(changed_group, NotNull());
+
+    /* Change the mode of the output on the right */
+    auto conf = display->configuration();
+    conf->for_each_output(
+        [&](mg::UserDisplayConfigurationOutput& output)
+        {
+            if (output.used && output.top_left.x != geom::X{0})
+                output.current_mode_index = 2;
+        });
+
+    std::vector<mg::DisplaySyncGroup*> invalidated;
+    display->for_each_display_sync_group_invalidated_by(
+        *conf,
+        [&](mg::DisplaySyncGroup& group) { invalidated.push_back(&group); });
+
+    EXPECT_THAT(invalidated, ElementsAre(changed_group));
+
+    Mock::VerifyAndClearExpectations(&mock_drm);
+
+    EXPECT_CALL(mock_drm,
+                drmModeSetCrtc(mtd::IsFdOfDevice(drm_device), _, _, _, _,
+                               Pointee(connector_ids[0]), _, _))
+                    .Times(0);
+    EXPECT_CALL(mock_drm,
+                drmModeSetCrtc(mtd::IsFdOfDevice(drm_device), _, _, _, _,
+                               Pointee(connector_ids[1]), _, _))
+                    .Times(AtLeast(1));
+
+    display->configure(*conf);
+
+    Mock::VerifyAndClearExpectations(&mock_drm);
+
+    std::vector<mg::DisplaySyncGroup*> groups;
+    display->for_each_display_sync_group(
+        [&](mg::DisplaySyncGroup& group) { groups.push_back(&group); });
+
+    EXPECT_THAT(groups, Contains(unchanged_group));
+    EXPECT_THAT(groups, Not(Contains(changed_group)));
+    EXPECT_THAT(groups.size(), Eq(2u));
+}
+
 TEST_F(MesaDisplayMultiMonitorTest, resume_clears_unused_connected_outputs)
 {
     using namespace testing;
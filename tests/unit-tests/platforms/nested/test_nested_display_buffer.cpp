@@ -242,32 +242,32 @@ TEST_F(NestedDisplayBuffer, accepts_double_submissions_of_same_buffer_after_buff
 {
     StubNestedBuffer nested_buffer1; 
     StubNestedBuffer nested_buffer2; 
-    mg::RenderableList list1 =
-        { std::make_shared<mtd::StubRenderable>(mt::fake_shared(nested_buffer1), rectangle) };
-    mg::RenderableList list2 =
-        { std::make_shared<mtd::StubRenderable>(mt::fake_shared(nested_buffer2), rectangle) };
+    auto const renderable = std::make_shared<mtd::StubRenderable>(mt::fake_shared(nested_buffer1), rectangle);
+    mg::RenderableList list = { renderable };
 
     auto display_buffer = create_display_buffer(host_connection);
-    EXPECT_TRUE(display_buffer->overlay(list1));
-    EXPECT_TRUE(display_buffer->overlay(list2));
+    EXPECT_TRUE(display_buffer->overlay(list));
+    renderable->set_buffer(mt::fake_shared(nested_buffer2));
+    EXPECT_TRUE(display_buffer->overlay(list));
     nested_buffer1.trigger();
-    EXPECT_TRUE(display_buffer->overlay(list1));
+    renderable->set_buffer(mt::fake_shared(nested_buffer1));
+    EXPECT_TRUE(display_buffer->overlay(list));
 }
 
 TEST_F(NestedDisplayBuffer, throws_on_interleaving_without_trigger)
 {
     StubNestedBuffer nested_buffer1; 
     StubNestedBuffer nested_buffer2; 
-    mg::RenderableList list1 =
-        { std::make_shared<mtd::StubRenderable>(mt::fake_shared(nested_buffer1), rectangle) };
-    mg::RenderableList list2 =
-        { std::make_shared<mtd::StubRenderable>(mt::fake_shared(nested_buffer2), rectangle) };
+    auto const renderable = std::make_shared<mtd::StubRenderable>(mt::fake_shared(nested_buffer1), rectangle);
+    mg::RenderableList list = { renderable };
 
     auto display_buffer = create_display_buffer(host_connection);
-    EXPECT_TRUE(display_buffer->overlay(list1));
-    EXPECT_TRUE(display_buffer->overlay(list2));
+    EXPECT_TRUE(display_buffer->overlay(list));
+    renderable->set_buffer(mt::fake_shared(nested_buffer2));
+    EXPECT_TRUE(display_buffer->overlay(list));
+    renderable->set_buffer(mt::fake_shared(nested_buffer1));
     EXPECT_THROW({
-        EXPECT_TRUE(display_buffer->overlay(list1));
+        EXPECT_TRUE(display_buffer->overlay(list));
     }, std::logic_error);
 }
 
@@ -321,8 +321,9 @@ TEST_F(NestedDisplayBuffer, recreates_chain)
     auto mock_stream = std::make_unique<NiceMock<MockNestedStream>>();
     auto mock_chain = std::make_unique<NiceMock<MockNestedChain>>();
     auto mock_chain2 = std::make_unique<NiceMock<MockNestedChain>>();
+    // Submitted to the first chain, released when it's dropped, submitted to the second
     EXPECT_CALL(nested_buffer, on_ownership_notification(_))
-        .Times(2);
+        .Times(3);
     EXPECT_CALL(*mock_chain, submit_buffer(Ref(nested_buffer)));
     ON_CALL(*mock_chain, handle())
         .WillByDefault(Return(reinterpret_cast<MirPresentationChain*>(&fake_chain_handle)));
@@ -417,21 +418,156 @@ TEST_F(NestedDisplayBuffer, rejects_list_containing_buffers_with_different_size_
     EXPECT_FALSE(display_buffer->overlay(list));
 }
 
-/* Once we have synchronous MirWindow scene updates, we can probably
- * passthrough more than one renderable if needed
- */
-TEST_F(NestedDisplayBuffer, rejects_list_containing_multiple_onscreen_renderables)
+TEST_F(NestedDisplayBuffer, passes_through_each_renderable_above_a_fullscreen_one_on_its_own_chain)
 {
-    StubNestedBuffer nested_buffer; 
+    NiceMock<MockHostSurface> mock_host_surface;
+    mtd::MockHostConnection mock_host_connection;
+    NiceMock<MockNestedBuffer> background_buffer;
+    NiceMock<MockNestedBuffer> window_buffer;
+    geom::Rectangle small_rect { {10, 10}, { 5, 5 }};
+    mg::RenderableList list = {
+        std::make_shared<mtd::StubRenderable>(mt::fake_shared(background_buffer), rectangle),
+        std::make_shared<mtd::StubRenderable>(mt::fake_shared(window_buffer), small_rect) };
+
+    auto mock_stream = std::make_unique<NiceMock<MockNestedStream>>();
+    auto mock_chain1 = std::make_unique<NiceMock<MockNestedChain>>();
+    auto mock_chain2 = std::make_unique<NiceMock<MockNestedChain>>();
+    EXPECT_CALL(*mock_chain1, submit_buffer(Ref(background_buffer)));
+    EXPECT_CALL(*mock_chain2, submit_buffer(Ref(window_buffer)));
+
+    EXPECT_CALL(mock_host_connection, create_surface(_,_,_,_,_))
+        .WillOnce(Return(mt::fake_shared(mock_host_surface)));
+    EXPECT_CALL(mock_host_connection, create_stream(_))
+        .WillOnce(InvokeWithoutArgs([&] { return std::move(mock_stream); }));
+    EXPECT_CALL(mock_host_connection, create_chain())
+        .Times(2)
+        .WillOnce(InvokeWithoutArgs([&] { return std::move(mock_chain1); }))
+        .WillOnce(InvokeWithoutArgs([&] { return std::move(mock_chain2); }));
+    EXPECT_CALL(mock_host_surface, apply_spec(_));
+
+    auto display_buffer = create_display_buffer(mt::fake_shared(mock_host_connection));
+    EXPECT_TRUE(display_buffer->overlay(list));
+}
+
+TEST_F(NestedDisplayBuffer, only_applies_spec_again_when_passthrough_layout_changes)
+{
+    NiceMock<MockHostSurface> mock_host_surface;
+    mtd::StubHostConnection host_connection(mt::fake_shared(mock_host_surface));
+
+    StubNestedBuffer background_buffer;
+    StubNestedBuffer window_buffer;
+    geom::Rectangle small_rect { {10, 10}, { 5, 5 }};
+    geom::Rectangle moved_rect { {20, 10}, { 5, 5 }};
+    auto const background = std::make_shared<mtd::StubRenderable>(mt::fake_shared(background_buffer), rectangle);
+
+    auto display_buffer = create_display_buffer(mt::fake_shared(host_connection));
+
+    EXPECT_CALL(mock_host_surface, apply_spec(_))
+        .Times(2);
+    EXPECT_TRUE(display_buffer->overlay(
+        { background, std::make_shared<mtd::StubRenderable>(mt::fake_shared(window_buffer), small_rect) }));
+    EXPECT_TRUE(display_buffer->overlay(
+        { background, std::make_shared<mtd::StubRenderable>(mt::fake_shared(window_buffer), small_rect) }));
+    EXPECT_TRUE(display_buffer->overlay(
+        { background, std::make_shared<mtd::StubRenderable>(mt::fake_shared(window_buffer), moved_rect) }));
+}
+
+TEST_F(NestedDisplayBuffer, keeps_each_renderable_on_its_own_chain_when_restacked)
+{
+    int fake_chain_handles[3];
+    NiceMock<MockHostSurface> mock_host_surface;
+    mtd::MockHostConnection mock_host_connection;
+    StubNestedBuffer background_buffer;
+    StubNestedBuffer lower_buffer;
+    StubNestedBuffer upper_buffer;
+    geom::Rectangle small_rect { {10, 10}, { 5, 5 }};
+    auto const background = std::make_shared<mtd::StubRenderable>(mt::fake_shared(background_buffer), rectangle);
+    auto const lower = std::make_shared<mtd::StubRenderable>(mt::fake_shared(lower_buffer), small_rect);
+    auto const upper = std::make_shared<mtd::StubRenderable>(mt::fake_shared(upper_buffer), small_rect);
+
+    auto mock_stream = std::make_unique<NiceMock<MockNestedStream>>();
+    std::vector<std::unique_ptr<NiceMock<MockNestedChain>>> mock_chains;
+    for (auto& handle : fake_chain_handles)
+    {
+        mock_chains.push_back(std::make_unique<NiceMock<MockNestedChain>>());
+        ON_CALL(*mock_chains.back(), handle())
+            .WillByDefault(Return(reinterpret_cast<MirPresentationChain*>(&handle)));
+    }
+    EXPECT_CALL(*mock_chains[0], submit_buffer(Ref(background_buffer)));
+    EXPECT_CALL(*mock_chains[1], submit_buffer(Ref(lower_buffer)));
+    EXPECT_CALL(*mock_chains[2], submit_buffer(Ref(upper_buffer)));
+
+    EXPECT_CALL(mock_host_connection, create_surface(_,_,_,_,_))
+        .WillOnce(Return(mt::fake_shared(mock_host_surface)));
+    EXPECT_CALL(mock_host_connection, create_stream(_))
+        .WillOnce(InvokeWithoutArgs([&] { return std::move(mock_stream); }));
+    EXPECT_CALL(mock_host_connection, create_chain())
+        .Times(3)
+        .WillOnce(InvokeWithoutArgs([&] { return std::move(mock_chains[0]); }))
+        .WillOnce(InvokeWithoutArgs([&] { return std::move(mock_chains[1]); }))
+        .WillOnce(InvokeWithoutArgs([&] { return std::move(mock_chains[2]); }));
+    EXPECT_CALL(mock_host_surface, apply_spec(_))
+        .Times(2);
+
+    auto display_buffer = create_display_buffer(mt::fake_shared(mock_host_connection));
+    EXPECT_TRUE(display_buffer->overlay({ background, lower, upper }));
+    EXPECT_NO_THROW(EXPECT_TRUE(display_buffer->overlay({ background, upper, lower })));
+}
+
+TEST_F(NestedDisplayBuffer, releases_buffers_on_the_chain_of_a_renderable_that_goes_away)
+{
+    StubNestedBuffer background_buffer;
+    auto const window_buffer = std::make_shared<StubNestedBuffer>();
+    geom::Rectangle small_rect { {10, 10}, { 5, 5 }};
+    auto const background = std::make_shared<mtd::StubRenderable>(mt::fake_shared(background_buffer), rectangle);
+    auto const window = std::make_shared<mtd::StubRenderable>(window_buffer, small_rect);
+
+    auto display_buffer = create_display_buffer(host_connection);
+
+    auto const use_count = window_buffer.use_count();
+    EXPECT_TRUE(display_buffer->overlay({ background, window }));
+    EXPECT_THAT(window_buffer.use_count(), Gt(use_count));
+    EXPECT_TRUE(display_buffer->overlay({ background }));
+    EXPECT_THAT(window_buffer.use_count(), Eq(use_count));
+}
+
+TEST_F(NestedDisplayBuffer, rejects_list_without_a_fullscreen_renderable)
+{
+    StubNestedBuffer nested_buffer;
     geom::Rectangle small_rect { {0, 0}, { 5, 5 }};
     mg::RenderableList list = {
-        std::make_shared<mtd::StubRenderable>(mt::fake_shared(nested_buffer), rectangle),
         std::make_shared<mtd::StubRenderable>(mt::fake_shared(nested_buffer), small_rect) };
 
     auto display_buffer = create_display_buffer(host_connection);
     EXPECT_FALSE(display_buffer->overlay(list));
 }
 
+TEST_F(NestedDisplayBuffer, rejects_list_with_unknown_buffers_above_fullscreen_renderable)
+{
+    StubNestedBuffer nested_buffer;
+    mtd::StubBuffer foreign_buffer(std::make_shared<FunkyBuffer>());
+    geom::Rectangle small_rect { {0, 0}, { 5, 5 }};
+    mg::RenderableList list = {
+        std::make_shared<mtd::StubRenderable>(mt::fake_shared(nested_buffer), rectangle),
+        std::make_shared<mtd::StubRenderable>(mt::fake_shared(foreign_buffer), small_rect) };
+
+    auto display_buffer = create_display_buffer(host_connection);
+    EXPECT_FALSE(display_buffer->overlay(list));
+}
+
+TEST_F(NestedDisplayBuffer, rejects_list_with_renderables_partly_offscreen)
+{
+    StubNestedBuffer background_buffer;
+    StubNestedBuffer window_buffer;
+    geom::Rectangle straddling_rect { {1020, 10}, { 10, 10 }};
+    mg::RenderableList list = {
+        std::make_shared<mtd::StubRenderable>(mt::fake_shared(background_buffer), rectangle),
+        std::make_shared<mtd::StubRenderable>(mt::fake_shared(window_buffer), straddling_rect) };
+
+    auto display_buffer = create_display_buffer(host_connection);
+    EXPECT_FALSE(display_buffer->overlay(list));
+}
+
 TEST_F(NestedDisplayBuffer, accepts_list_containing_multiple_renderables_with_fullscreen_on_top)
 {
     StubNestedBuffer nested_buffer; 
@@ -21,6 +21,7 @@
 
 #include "mir/test/doubles/mock_gl_buffer.h"
 #include "mir/test/doubles/mock_gl.h"
+#include "mir/test/doubles/mock_egl.h"
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
@@ -101,6 +102,71 @@ ACTION(FillPixelsRGBA)
     }
 }
 
+/* Stand-ins for the GLES 3.0 entry points, which MockGL doesn't provide */
+std::vector<uint32_t> pack_buffer_contents;
+GLsync const fake_fence{reinterpret_cast<GLsync>(0x5f)};
+GLsync fence_to_create{fake_fence};
+int fences_waited_for{0};
+int fences_deleted{0};
+
+void* fake_glMapBufferRange(GLenum, GLintptr, GLsizeiptr, GLbitfield)
+{
+    return pack_buffer_contents.data();
+}
+
+GLboolean fake_glUnmapBuffer(GLenum)
+{
+    return GL_TRUE;
+}
+
+GLsync fake_glFenceSync(GLenum, GLbitfield)
+{
+    return fence_to_create;
+}
+
+GLenum fake_glClientWaitSync(GLsync, GLbitfield, GLuint64)
+{
+    ++fences_waited_for;
+    return 0x911A; // GL_ALREADY_SIGNALED
+}
+
+void fake_glDeleteSync(GLsync)
+{
+    ++fences_deleted;
+}
+
+struct GLPixelBufferWithPackBuffersTest : GLPixelBufferTest
+{
+    GLPixelBufferWithPackBuffersTest()
+    {
+        using namespace testing;
+        typedef mtd::MockEGL::generic_function_pointer_t func_ptr_t;
+
+        ON_CALL(mock_gl, glGetString(GL_VERSION))
+            .WillByDefault(Return(reinterpret_cast<GLubyte const*>("OpenGL ES 3.0 Mesa")));
+        ON_CALL(mock_egl, eglGetProcAddress(StrEq("glMapBufferRange")))
+            .WillByDefault(Return(reinterpret_cast<func_ptr_t>(fake_glMapBufferRange)));
+        ON_CALL(mock_egl, eglGetProcAddress(StrEq("glUnmapBuffer")))
+            .WillByDefault(Return(reinterpret_cast<func_ptr_t>(fake_glUnmapBuffer)));
+        ON_CALL(mock_egl, eglGetProcAddress(StrEq("glFenceSync")))
+            .WillByDefault(Return(reinterpret_cast<func_ptr_t>(fake_glFenceSync)));
+        ON_CALL(mock_egl, eglGetProcAddress(StrEq("glClientWaitSync")))
+            .WillByDefault(Return(reinterpret_cast<func_ptr_t>(fake_glClientWaitSync)));
+        ON_CALL(mock_egl, eglGetProcAddress(StrEq("glDeleteSync")))
+            .WillByDefault(Return(reinterpret_cast<func_ptr_t>(fake_glDeleteSync)));
+
+        auto const size = mock_buffer.size();
+        pack_buffer_contents.resize(size.width.as_uint32_t() * size.height.as_uint32_t());
+        for (uint32_t i = 0; i < pack_buffer_contents.size(); ++i)
+            pack_buffer_contents[i] = i;
+
+        fence_to_create = fake_fence;
+        fences_waited_for = 0;
+        fences_deleted = 0;
+    }
+
+    testing::NiceMock<mtd::MockEGL> mock_egl;
+};
 }
 
 TEST_F(GLPixelBufferTest, returns_empty_if_not_initialized)
@@ -225,3 +291,85 @@ TEST_F(GLPixelBufferTest, returns_data_from_rgba_buffer_texture)
     EXPECT_EQ(width - 1,
               static_cast<uint32_t const*>(data)[width * height - 1]);
 }
+
+TEST_F(GLPixelBufferWithPackBuffersTest, reads_into_pack_buffer_without_waiting)
+{
+    using namespace testing;
+    GLuint const pbo{30};
+    GLenum const pixel_pack_buffer{0x88EB};
+    uint32_t const width{mock_buffer.size().width.as_uint32_t()};
+    uint32_t const height{mock_buffer.size().height.as_uint32_t()};
+
+    EXPECT_CALL(mock_gl, glGenBuffers(_,_))
+        .WillOnce(SetArgPointee<1>(pbo));
+    EXPECT_CALL(mock_gl, glBufferData(pixel_pack_buffer, width * height * 4, nullptr, _));
+    /* The pixels go to offset 0 of the pack buffer, not to client memory */
+    EXPECT_CALL(mock_gl, glReadPixels(0, 0, width, height,
+                                      GL_BGRA_EXT, GL_UNSIGNED_BYTE, nullptr));
+    EXPECT_CALL(mock_gl, glDeleteBuffers(_, Pointee(pbo)));
+
+    ms::GLPixelBuffer pixels{std::move(context)};
+
+    pixels.fill_from(mock_buffer);
+    EXPECT_THAT(fences_waited_for, Eq(0));
+
+    auto data = pixels.as_argb_8888();
+    EXPECT_THAT(fences_waited_for, Eq(1));
+    EXPECT_THAT(fences_deleted, Eq(1));
+
+    EXPECT_EQ(mock_buffer.size(), pixels.size());
+    EXPECT_EQ(geom::Stride{width * 4}, pixels.stride());
+
+    /* Check that data has been y-flipped on the way out of the pack buffer */
+    EXPECT_EQ(1,
+              static_cast<uint32_t const*>(data)[width * (height - 1) + 1]);
+    EXPECT_EQ(width * (height - 1),
+              static_cast<uint32_t const*>(data)[0]);
+    EXPECT_EQ(width - 1,
+              static_cast<uint32_t const*>(data)[width * height - 1]);
+}
+
+TEST_F(GLPixelBufferWithPackBuffersTest, discards_readback_that_was_never_collected)
+{
+    ms::GLPixelBuffer pixels{std::move(context)};
+
+    pixels.fill_from(mock_buffer);
+    pixels.fill_from(mock_buffer);
+    pixels.as_argb_8888();
+
+    EXPECT_EQ(1, fences_waited_for);
+    EXPECT_EQ(2, fences_deleted);
+}
+
+TEST_F(GLPixelBufferWithPackBuffersTest, reads_synchronously_if_a_fence_cannot_be_created)
+{
+    using namespace testing;
+    uint32_t const width{mock_buffer.size().width.as_uint32_t()};
+    uint32_t const height{mock_buffer.size().height.as_uint32_t()};
+
+    fence_to_create = nullptr;
+
+    {
+        InSequence s;
+        EXPECT_CALL(mock_gl, glReadPixels(0, 0, width, height,
+                                          GL_BGRA_EXT, GL_UNSIGNED_BYTE, nullptr));
+        EXPECT_CALL(mock_gl, glReadPixels(0, 0, width, height,
+                                          GL_BGRA_EXT, GL_UNSIGNED_BYTE, NotNull()))
+            .WillOnce(FillPixels());
+    }
+
+    ms::GLPixelBuffer pixels{std::move(context)};
+
+    pixels.fill_from(mock_buffer);
+    auto data = pixels.as_argb_8888();
+
+    EXPECT_THAT(fences_waited_for, Eq(0));
+    EXPECT_THAT(fences_deleted, Eq(0));
+
+    EXPECT_EQ(1,
+              static_cast<uint32_t const*>(data)[width * (height - 1) + 1]);
+    EXPECT_EQ(width * (height - 1),
+              static_cast<uint32_t const*>(data)[0]);
+    EXPECT_EQ(width - 1,
+              static_cast<uint32_t const*>(data)[width * height - 1]);
+}
@@ -121,3 +121,36 @@ TEST_F(ThreadedSnapshotStrategyTest, names_snapshot_thread)
 
     EXPECT_THAT(buffer_access.thread_name, Eq("Mir/Snapshot"));
 }
+
+TEST_F(ThreadedSnapshotStrategyTest, holds_the_buffer_until_its_pixels_are_read)
+{
+    using namespace testing;
+
+    MockPixelBuffer pixel_buffer;
+    std::weak_ptr<mg::Buffer> const buffer{buffer_access.stub_compositor_buffer};
+    long buffer_users_while_reading{0};
+
+    ON_CALL(pixel_buffer, size()).WillByDefault(Return(geom::Size{}));
+    ON_CALL(pixel_buffer, stride()).WillByDefault(Return(geom::Stride{}));
+    EXPECT_CALL(pixel_buffer, fill_from(_));
+    EXPECT_CALL(pixel_buffer, as_argb_8888())
+        .WillOnce(InvokeWithoutArgs(
+            [&]
+            {
+                buffer_users_while_reading = buffer.use_count();
+                return nullptr;
+            }));
+
+    ms::ThreadedSnapshotStrategy strategy{mt::fake_shared(pixel_buffer)};
+
+    mt::Signal snapshot_taken;
+
+    strategy.take_snapshot_of(
+        mt::fake_shared(buffer_access),
+        [&](ms::Snapshot const&) { snapshot_taken.raise(); });
+
+    snapshot_taken.wait_for(std::chrono::seconds{5});
+
+    /* One reference is the stub's own, the other is the snapshotter's */
+    EXPECT_THAT(buffer_users_while_reading, Eq(2));
+}
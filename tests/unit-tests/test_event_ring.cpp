@@ -0,0 +1,170 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/events/event_ring.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <thread>
+
+#include <fcntl.h>
+#include <linux/memfd.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace mev = mir::events;
+using namespace testing;
+
+namespace
+{
+bool readable(mir::Fd const& fd)
+{
+    pollfd pfd{fd, POLLIN, 0};
+    return poll(&pfd, 1, 0) == 1;
+}
+
+struct EventRing : Test
+{
+    mev::EventRing producer;
+    mev::EventRing consumer{producer.shm_fd(), producer.wakeup_fd()};
+};
+}
+
+TEST_F(EventRing, consumer_pops_events_in_the_order_they_were_pushed)
+{
+    EXPECT_TRUE(producer.push("first"));
+    EXPECT_TRUE(producer.push("second"));
+
+    std::string event;
+    ASSERT_TRUE(consumer.pop(event));
+    EXPECT_THAT(event, Eq("first"));
+    ASSERT_TRUE(consumer.pop(event));
+    EXPECT_THAT(event, Eq("second"));
+    EXPECT_FALSE(consumer.pop(event));
+}
+
+TEST_F(EventRing, is_empty_once_consumer_has_caught_up)
+{
+    EXPECT_TRUE(producer.empty());
+
+    producer.push("event");
+    EXPECT_FALSE(producer.empty());
+
+    std::string event;
+    consumer.pop(event);
+    EXPECT_TRUE(producer.empty());
+}
+
+TEST_F(EventRing, only_wakes_consumer_when_it_may_have_found_the_ring_empty)
+{
+    EXPECT_FALSE(readable(consumer.wakeup_fd()));
+
+    producer.push("first");
+    EXPECT_TRUE(readable(consumer.wakeup_fd()));
+
+    consumer.clear_wakeup();
+    producer.push("second");
+    EXPECT_FALSE(readable(consumer.wakeup_fd()));
+
+    std::string event;
+    while (consumer.pop(event))
+        ;
+    producer.push("third");
+    EXPECT_TRUE(readable(consumer.wakeup_fd()));
+}
+
+TEST_F(EventRing, rejects_events_too_large_for_a_slot)
+{
+    EXPECT_FALSE(producer.push(std::string(mev::EventRing::max_event_size + 1, 'x')));
+    EXPECT_TRUE(producer.push(std::string(mev::EventRing::max_event_size, 'x')));
+}
+
+TEST_F(EventRing, rejects_events_when_full_until_consumer_catches_up)
+{
+    int pushed{0};
+    while (producer.push(std::to_string(pushed)))
+        ++pushed;
+
+    EXPECT_THAT(pushed, Gt(0));
+
+    std::string event;
+    ASSERT_TRUE(consumer.pop(event));
+    EXPECT_THAT(event, Eq("0"));
+    EXPECT_TRUE(producer.push("more"));
+}
+
+TEST(EventRingWithoutConsumer, rejects_events_until_a_consumer_maps_it)
+{
+    mev::EventRing producer;
+    EXPECT_FALSE(producer.push("event"));
+
+    mev::EventRing consumer{producer.shm_fd(), producer.wakeup_fd()};
+    EXPECT_TRUE(producer.push("event"));
+}
+
+TEST_F(EventRing, rejects_memory_of_the_wrong_size)
+{
+    EXPECT_THROW(mev::EventRing(producer.wakeup_fd(), producer.wakeup_fd()), std::exception);
+}
+
+TEST_F(EventRing, memory_cannot_be_resized_by_the_consumer)
+{
+    EXPECT_THAT(ftruncate(consumer.shm_fd(), 0), Lt(0));
+    EXPECT_THAT(ftruncate(consumer.shm_fd(), 1024*1024), Lt(0));
+    EXPECT_TRUE(producer.push("event"));
+}
+
+TEST_F(EventRing, rejects_memory_that_could_be_resized)
+{
+    struct stat info;
+    ASSERT_THAT(fstat(producer.shm_fd(), &info), Eq(0));
+
+    mir::Fd unsealed{static_cast<int>(syscall(SYS_memfd_create, "unsealed", MFD_CLOEXEC))};
+    ASSERT_THAT(ftruncate(unsealed, info.st_size), Eq(0));
+
+    EXPECT_THROW(mev::EventRing(unsealed, producer.wakeup_fd()), std::exception);
+}
+
+TEST_F(EventRing, delivers_every_event_across_threads)
+{
+    int const count{10000};
+
+    std::thread consumer_thread{
+        [this]
+        {
+            std::string event;
+            for (int expected = 0; expected != count;)
+            {
+                pollfd pfd{consumer.wakeup_fd(), POLLIN, 0};
+                poll(&pfd, 1, -1);
+                consumer.clear_wakeup();
+
+                while (consumer.pop(event))
+                    EXPECT_THAT(event, Eq(std::to_string(expected++)));
+            }
+        }};
+
+    for (int i = 0; i != count; ++i)
+    {
+        while (!producer.push(std::to_string(i)))
+            std::this_thread::yield();
+    }
+
+    consumer_thread.join();
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/seqlock.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <atomic>
+#include <thread>
+
+using namespace testing;
+
+namespace
+{
+struct Quad
+{
+    uint32_t a, b, c, d;
+};
+}
+
+TEST(Seqlock, loads_initial_value)
+{
+    mir::Seqlock<Quad> const seqlock{Quad{1, 2, 3, 4}};
+
+    auto const value = seqlock.load();
+
+    EXPECT_THAT(value.a, Eq(1u));
+    EXPECT_THAT(value.d, Eq(4u));
+}
+
+TEST(Seqlock, loads_last_stored_value)
+{
+    mir::Seqlock<Quad> seqlock;
+
+    seqlock.store(Quad{5, 6, 7, 8});
+    seqlock.store(Quad{9, 10, 11, 12});
+
+    auto const value = seqlock.load();
+
+    EXPECT_THAT(value.a, Eq(9u));
+    EXPECT_THAT(value.b, Eq(10u));
+    EXPECT_THAT(value.c, Eq(11u));
+    EXPECT_THAT(value.d, Eq(12u));
+}
+
+TEST(Seqlock, readers_never_see_a_partial_store)
+{
+    mir::Seqlock<Quad> seqlock{Quad{0, 0, 0, 0}};
+    std::atomic<bool> done{false};
+    std::atomic<int> torn_reads{0};
+
+    std::thread reader{[&]
+        {
+            while (!done)
+            {
+                auto const value = seqlock.load();
+                if (value.a != value.b || value.a != value.c || value.a != value.d)
+                    ++torn_reads;
+            }
+        }};
+
+    for (uint32_t i = 1; i != 100000; ++i)
+        seqlock.store(Quad{i, i, i, i});
+
+    done = true;
+    reader.join();
+
+    EXPECT_THAT(torn_reads, Eq(0));
+}
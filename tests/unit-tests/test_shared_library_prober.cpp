@@ -246,3 +246,15 @@ TEST_F(SharedLibraryProber, does_not_log_failure_on_success)
     // libthis-arch should always be loadable...
     EXPECT_TRUE(probing_map.at("libthis-arch.so"));
 }
+
+TEST_F(SharedLibraryProber, lists_library_files_without_loading_them)
+{
+    using namespace testing;
+    NiceMock<MockSharedLibraryProberReport> report;
+
+    EXPECT_CALL(report, loading_library(_)).Times(0);
+
+    auto const files = mir::library_files_for_path(library_path, report);
+
+    EXPECT_THAT(files, Contains(library_path + "/libthis-arch.so"));
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/startup_trace.h"
+#include "mir/cached_ptr.h"
+
+#include <atomic>
+#include <future>
+#include <thread>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace
+{
+auto names_of(std::vector<mir::StartupTrace::Step> const& steps) -> std::vector<std::string>
+{
+    std::vector<std::string> names;
+    for (auto const& step : steps)
+        names.push_back(step.name);
+    return names;
+}
+}
+
+TEST(StartupTrace, records_steps_in_the_order_they_started)
+{
+    mir::StartupTrace trace;
+
+    {
+        mir::StartupTrace::Scope const first{"first"};
+    }
+    {
+        mir::StartupTrace::Scope const second{"second"};
+    }
+
+    EXPECT_THAT(names_of(trace.steps()), ElementsAre("first", "second"));
+}
+
+TEST(StartupTrace, records_nothing_taken_outside_the_trace)
+{
+    {
+        mir::StartupTrace::Scope const before{"before"};
+    }
+
+    mir::StartupTrace trace;
+    {
+        mir::StartupTrace::Scope const during{"during"};
+    }
+
+    EXPECT_THAT(names_of(trace.steps()), ElementsAre("during"));
+}
+
+TEST(StartupTrace, steps_within_a_step_are_deeper_and_not_exclusive_to_it)
+{
+    mir::StartupTrace trace;
+
+    {
+        mir::StartupTrace::Scope const outer{"outer"};
+        mir::StartupTrace::Scope const inner{"inner"};
+        std::this_thread::sleep_for(10ms);
+    }
+
+    auto const steps = trace.steps();
+    ASSERT_THAT(names_of(steps), ElementsAre("outer", "inner"));
+
+    EXPECT_THAT(steps[0].depth, Eq(0u));
+    EXPECT_THAT(steps[1].depth, Eq(1u));
+    EXPECT_THAT(steps[0].duration, Ge(steps[1].duration));
+    EXPECT_THAT(steps[1].duration, Ge(10ms));
+    EXPECT_THAT(steps[0].exclusive, Lt(10ms));
+}
+
+TEST(StartupTrace, distinguishes_steps_taken_on_another_thread)
+{
+    mir::StartupTrace trace;
+
+    {
+        mir::StartupTrace::Scope const here{"here"};
+    }
+    std::thread{[] { mir::StartupTrace::Scope const there{"there"}; }}.join();
+
+    auto const steps = trace.steps();
+    ASSERT_THAT(names_of(steps), ElementsAre("here", "there"));
+    EXPECT_THAT(steps[0].thread, Eq(0u));
+    EXPECT_THAT(steps[1].thread, Eq(1u));
+    EXPECT_THAT(steps[1].depth, Eq(0u));
+}
+
+TEST(StartupTrace, records_what_cached_ptr_makes)
+{
+    mir::CachedPtr<int> cached;
+    auto const held = cached([] { return std::make_shared<int>(42); });
+
+    mir::StartupTrace trace;
+    cached([] { return std::make_shared<int>(0); });
+    mir::CachedPtr<long> another;
+    auto const also_held = another([] { return std::make_shared<long>(42); });
+
+    EXPECT_THAT(names_of(trace.steps()), ElementsAre(HasSubstr("CachedPtr<long>")));
+}
+
+TEST(CachedPtr, makes_one_object_for_concurrent_callers)
+{
+    mir::CachedPtr<int> cached;
+    std::atomic<int> made{0};
+
+    auto const make = [&]
+        {
+            ++made;
+            std::this_thread::sleep_for(10ms);
+            return std::make_shared<int>(42);
+        };
+
+    auto first = std::async(std::launch::async, [&] { return cached(make); });
+    auto second = std::async(std::launch::async, [&] { return cached(make); });
+
+    EXPECT_THAT(first.get(), Eq(second.get()));
+    EXPECT_THAT(made.load(), Eq(1));
+}
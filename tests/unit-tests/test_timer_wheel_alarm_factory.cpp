@@ -0,0 +1,256 @@
+/*
+ * Copyright © 2018 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/time/timer_wheel_alarm_factory.h"
+#include "mir/time/alarm.h"
+
+#include "mir/test/fake_shared.h"
+#include "mir/test/wait_object.h"
+#include "mir/test/doubles/advanceable_clock.h"
+#include "mir/test/doubles/mock_event_handler_register.h"
+#include "mir/test/doubles/mock_lockable_callback.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace mt = mir::test;
+namespace mtd = mir::test::doubles;
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace
+{
+struct TimerWheelAlarmFactory : Test
+{
+    TimerWheelAlarmFactory()
+    {
+        ON_CALL(event_handler_register, register_fd_handler(_, _, _))
+            .WillByDefault(SaveArg<2>(&fd_handler));
+
+        factory = std::make_unique<mir::time::TimerWheelAlarmFactory>(
+            mt::fake_shared(event_handler_register), clock);
+    }
+
+    void advance_by(mir::time::Duration step)
+    {
+        clock->advance_by(step);
+        fd_handler(0);
+    }
+
+    std::shared_ptr<mtd::AdvanceableClock> const clock{std::make_shared<mtd::AdvanceableClock>()};
+    NiceMock<mtd::MockEventHandlerRegister> event_handler_register;
+    std::function<void(int)> fd_handler;
+    std::unique_ptr<mir::time::AlarmFactory> factory;
+};
+}
+
+TEST_F(TimerWheelAlarmFactory, registers_and_unregisters_a_single_fd_handler)
+{
+    NiceMock<mtd::MockEventHandlerRegister> handler_register;
+
+    EXPECT_CALL(handler_register, register_fd_handler(_, _, _)).Times(1);
+    EXPECT_CALL(handler_register, unregister_fd_handler(_)).Times(1);
+
+    mir::time::TimerWheelAlarmFactory local_factory{mt::fake_shared(handler_register), clock};
+    auto const a = local_factory.create_alarm([]{});
+    auto const b = local_factory.create_alarm([]{});
+    a->reschedule_in(10ms);
+    b->reschedule_in(10min);
+}
+
+TEST_F(TimerWheelAlarmFactory, alarm_starts_in_cancelled_state)
+{
+    auto const alarm = factory->create_alarm([]{});
+
+    EXPECT_THAT(alarm->state(), Eq(mir::time::Alarm::cancelled));
+}
+
+TEST_F(TimerWheelAlarmFactory, alarm_fires_after_delay_and_not_before)
+{
+    int calls{0};
+    auto const alarm = factory->create_alarm([&]{ ++calls; });
+
+    alarm->reschedule_in(100ms);
+    EXPECT_THAT(alarm->state(), Eq(mir::time::Alarm::pending));
+
+    advance_by(99ms);
+    EXPECT_THAT(calls, Eq(0));
+
+    advance_by(1ms);
+    EXPECT_THAT(calls, Eq(1));
+    EXPECT_THAT(alarm->state(), Eq(mir::time::Alarm::triggered));
+
+    advance_by(1s);
+    EXPECT_THAT(calls, Eq(1));
+}
+
+TEST_F(TimerWheelAlarmFactory, alarms_fire_in_order_across_wheel_levels)
+{
+    std::vector<int> fired;
+    std::vector<std::unique_ptr<mir::time::Alarm>> alarms;
+    std::vector<std::chrono::milliseconds> const delays{3ms, 70ms, 5000ms, 300000ms, 20000000ms};
+
+    for (auto i = 0u; i != delays.size(); ++i)
+    {
+        alarms.push_back(factory->create_alarm([&fired, i]{ fired.push_back(i); }));
+        alarms.back()->reschedule_in(delays[i]);
+    }
+
+    for (auto i = 0u; i != delays.size(); ++i)
+    {
+        advance_by(delays[i] - (i ? delays[i-1] : 0ms) - 1ms);
+        EXPECT_THAT(fired.size(), Eq(i));
+        advance_by(1ms);
+        EXPECT_THAT(fired.size(), Eq(i + 1));
+    }
+
+    EXPECT_THAT(fired, ElementsAre(0, 1, 2, 3, 4));
+}
+
+TEST_F(TimerWheelAlarmFactory, cancelled_alarm_doesnt_fire)
+{
+    int calls{0};
+    auto const alarm = factory->create_alarm([&]{ ++calls; });
+
+    alarm->reschedule_in(10ms);
+    EXPECT_TRUE(alarm->cancel());
+    advance_by(20ms);
+
+    EXPECT_THAT(calls, Eq(0));
+    EXPECT_THAT(alarm->state(), Eq(mir::time::Alarm::cancelled));
+}
+
+TEST_F(TimerWheelAlarmFactory, destroyed_alarm_doesnt_fire)
+{
+    int calls{0};
+    auto alarm = factory->create_alarm([&]{ ++calls; });
+
+    alarm->reschedule_in(10ms);
+    alarm.reset();
+    advance_by(20ms);
+
+    EXPECT_THAT(calls, Eq(0));
+}
+
+TEST_F(TimerWheelAlarmFactory, reschedule_supersedes_previous_schedule)
+{
+    int calls{0};
+    auto const alarm = factory->create_alarm([&]{ ++calls; });
+
+    EXPECT_FALSE(alarm->reschedule_in(10ms));
+    EXPECT_TRUE(alarm->reschedule_in(100ms));
+
+    advance_by(50ms);
+    EXPECT_THAT(calls, Eq(0));
+
+    advance_by(50ms);
+    EXPECT_THAT(calls, Eq(1));
+}
+
+TEST_F(TimerWheelAlarmFactory, can_reschedule_from_within_callback)
+{
+    int calls{0};
+    std::unique_ptr<mir::time::Alarm> alarm;
+    alarm = factory->create_alarm([&]{ ++calls; alarm->reschedule_in(10ms); });
+
+    alarm->reschedule_in(10ms);
+    for (int i = 0; i != 5; ++i)
+        advance_by(10ms);
+
+    EXPECT_THAT(calls, Eq(5));
+    EXPECT_THAT(alarm->state(), Eq(mir::time::Alarm::pending));
+}
+
+TEST_F(TimerWheelAlarmFactory, can_destroy_alarm_from_within_callback)
+{
+    std::unique_ptr<mir::time::Alarm> alarm;
+    alarm = factory->create_alarm([&]{ alarm.reset(); });
+
+    alarm->reschedule_in(10ms);
+    advance_by(10ms);
+
+    EXPECT_THAT(alarm, IsNull());
+}
+
+TEST_F(TimerWheelAlarmFactory, alarm_callback_preserves_lock_ordering)
+{
+    auto handler = std::make_unique<mtd::MockLockableCallback>();
+    {
+        InSequence s;
+        EXPECT_CALL(*handler, lock());
+        EXPECT_CALL(*handler, functor());
+        EXPECT_CALL(*handler, unlock());
+    }
+
+    auto const alarm = factory->create_alarm(std::move(handler));
+
+    alarm->reschedule_in(5ms);
+    advance_by(5ms);
+}
+
+TEST_F(TimerWheelAlarmFactory, cancel_and_reschedule_dont_wait_for_a_running_callback)
+{
+    // The callback takes a lock that's held while cancelling and rescheduling
+    std::mutex state_mutex;
+    mt::WaitObject callback_started;
+    auto const alarm = factory->create_alarm(
+        [&]
+        {
+            callback_started.notify_ready();
+            std::lock_guard<std::mutex> lock{state_mutex};
+        });
+
+    alarm->reschedule_in(10ms);
+
+    std::unique_lock<std::mutex> state_lock{state_mutex};
+    std::thread dispatcher{[this]{ advance_by(10ms); }};
+    callback_started.wait_until_ready(std::chrono::seconds{5});
+
+    auto cancelled = std::async(std::launch::async,
+        [&]
+        {
+            alarm->reschedule_in(10ms);
+            return alarm->cancel();
+        });
+
+    EXPECT_THAT(cancelled.wait_for(std::chrono::seconds{5}), Eq(std::future_status::ready));
+
+    state_lock.unlock();
+    dispatcher.join();
+
+    EXPECT_TRUE(cancelled.get());
+    EXPECT_THAT(alarm->state(), Eq(mir::time::Alarm::cancelled));
+}
+
+TEST_F(TimerWheelAlarmFactory, exception_from_callback_doesnt_stop_other_alarms_firing)
+{
+    int calls{0};
+    auto const throwing = factory->create_alarm([&]{ ++calls; throw std::runtime_error{"callback failed"}; });
+    auto const other = factory->create_alarm([&]{ ++calls; });
+
+    other->reschedule_in(10ms);
+    throwing->reschedule_in(10ms);
+
+    EXPECT_THROW(advance_by(10ms), std::runtime_error);
+    EXPECT_THAT(calls, Eq(2));
+    EXPECT_THAT(other->state(), Eq(mir::time::Alarm::triggered));
+}